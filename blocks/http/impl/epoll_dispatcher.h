@@ -0,0 +1,408 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The epoll-based engine of `HTTPServerPOSIX`.
+//
+// A single thread accepts the connections and reads the requests into per-connection buffers, without blocking,
+// using `epoll`. Once enough of the request has been received, the connection is switched back into the blocking
+// mode, and is passed on, along with the data read so far, to one of the fixed pool of worker threads. The worker
+// thread then parses the request with the very same `HTTPServerConnection` and runs the handler.
+//
+// Thus, slow clients do not occupy the worker threads, and slow handlers do not stall the other clients.
+//
+// The persistent, keep-alive, connections are given back to the `epoll` thread once the response has been sent,
+// along with the pipelined requests received past the end of the served one, if any. The connections with no
+// requests coming in for longer than the idle timeout are closed.
+
+#ifndef BLOCKS_HTTP_IMPL_EPOLL_DISPATCHER_H
+#define BLOCKS_HTTP_IMPL_EPOLL_DISPATCHER_H
+
+#include "../../../port.h"
+
+#ifdef CURRENT_POSIX
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdlib>
+#include <deque>
+#include <functional>
+#include <iostream>  // TODO(dkorolev): More robust logging here.
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+#include <fcntl.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+
+#include "../../../bricks/net/exceptions.h"
+#include "../../../bricks/net/http/constants.h"
+#include "../../../bricks/net/tcp/tcp.h"
+
+namespace current {
+namespace http {
+
+namespace epoll_impl {
+
+inline void SetSocketBlockingMode(int fd, bool blocking) {
+  const int flags = ::fcntl(fd, F_GETFL, 0);
+  if (flags == -1 || ::fcntl(fd, F_SETFL, blocking ? (flags & ~O_NONBLOCK) : (flags | O_NONBLOCK)) == -1) {
+    CURRENT_THROW(current::net::SocketFcntlException());  // LCOV_EXCL_LINE
+  }
+}
+
+inline bool HTTPHeaderNameEquals(const std::string& data, size_t begin, size_t end, const char* name) {
+  for (; begin < end && *name; ++begin, ++name) {
+    const char c = (data[begin] != '_') ? static_cast<char>(std::tolower(data[begin])) : '-';
+    if (c != std::tolower(*name)) {
+      return false;
+    }
+  }
+  return begin == end && !*name;
+}
+
+// Whether enough of the request has been received to parse it without waiting for the client.
+// The requests with chunked or large bodies, as well as the ones with oversized headers, are passed on as soon as
+// their headers are in, or as soon as the headers are known to be oversized. The rest of such a request is then
+// read by the worker thread.
+inline bool EnoughOfHTTPRequestReceived(const std::string& data) {
+  using namespace current::net::constants;
+  const size_t headers_end = data.find("\r\n\r\n");
+  if (headers_end == std::string::npos) {
+    return data.length() > kMaxHTTPPrebufferedHeaderSizeInBytes;
+  }
+  size_t body_length = 0u;
+  // Skip the very first line, which is the `METHOD /path HTTP/1.1` one.
+  size_t line_begin = data.find(kCRLF) + kCRLFLength;
+  while (line_begin <= headers_end) {
+    const size_t line_end = data.find(kCRLF, line_begin);
+    const size_t colon = data.find(kHeaderKeyValueSeparator, line_begin);
+    if (colon < line_end) {
+      size_t value_begin = colon + 1;
+      while (value_begin < line_end && data[value_begin] == ' ') {
+        ++value_begin;
+      }
+      if (HTTPHeaderNameEquals(data, line_begin, colon, kContentLengthHeaderKey)) {
+        body_length = static_cast<size_t>(std::strtoull(data.c_str() + value_begin, nullptr, 10));
+      } else if (HTTPHeaderNameEquals(data, line_begin, colon, kTransferEncodingHeaderKey) &&
+                 HTTPHeaderNameEquals(data, value_begin, line_end, kTransferEncodingChunkedValue)) {
+        return true;
+      }
+    }
+    line_begin = line_end + kCRLFLength;
+  }
+  return body_length > kMaxHTTPPrebufferedBodySizeInBytes || data.length() >= headers_end + 4u + body_length;
+}
+
+}  // namespace epoll_impl
+
+class EpollHTTPConnectionDispatcher final {
+ public:
+  using connection_t = std::unique_ptr<current::net::Connection>;
+  // The second parameter, if set, is to be called with the connection to keep it alive once the response is sent.
+  using keep_alive_t = std::function<void(current::net::Connection&&)>;
+  using serve_t = std::function<void(connection_t, keep_alive_t)>;
+
+  // Starts `worker_threads` threads to run `serve` on the connections with the requests received.
+  // Zero `worker_threads` stands for `std::thread::hardware_concurrency()`.
+  // Each connection is kept alive for up to `max_requests_per_connection` requests, one disables keep-alive.
+  EpollHTTPConnectionDispatcher(size_t worker_threads,
+                                size_t max_requests_per_connection,
+                                std::chrono::milliseconds idle_timeout,
+                                serve_t serve)
+      : max_requests_per_connection_(max_requests_per_connection),
+        idle_timeout_(idle_timeout),
+        serve_(std::move(serve)),
+        epoll_fd_(::epoll_create1(0)),
+        wakeup_fd_(::eventfd(0, EFD_NONBLOCK)) {
+    if (epoll_fd_ == -1 || wakeup_fd_ == -1) {
+      CURRENT_THROW(current::net::SocketCreateException());  // LCOV_EXCL_LINE
+    }
+    AddToEpoll(wakeup_fd_);
+    if (!worker_threads) {
+      worker_threads = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1u));
+    }
+    for (size_t i = 0; i < worker_threads; ++i) {
+      workers_.emplace_back([this]() { WorkerThread(); });
+    }
+  }
+
+  ~EpollHTTPConnectionDispatcher() {
+    Stop();
+    JoinWorkers();
+    ::close(wakeup_fd_);
+    ::close(epoll_fd_);
+  }
+
+  // Accepts the connections and receives the requests until `Stop()` is called. Blocks the calling thread.
+  // Before returning, waits for the worker threads to complete the requests they are serving.
+  void Run(current::net::Socket& socket) {
+    const int listen_fd = socket.socket;
+    AddToEpoll(listen_fd);
+    std::vector<struct epoll_event> events(1024);
+    // Wake up periodically to close the idle connections, at a fraction of the idle timeout, but not too often.
+    const int sweep_period_ms = static_cast<int>(
+        std::max(static_cast<int64_t>(idle_timeout_.count() / 4), static_cast<int64_t>(10)));
+    auto next_sweep = std::chrono::steady_clock::now() + idle_timeout_;
+    while (!stopping_) {
+      const int n = ::epoll_wait(
+          epoll_fd_, &events[0], static_cast<int>(events.size()), pending_.empty() ? -1 : sweep_period_ms);
+      if (n < 0) {
+        if (errno == EINTR) {
+          continue;  // LCOV_EXCL_LINE
+        }
+        std::cerr << "HTTP: `epoll_wait()` failed, errno " << errno << ".\n";  // LCOV_EXCL_LINE
+        break;                                                                 // LCOV_EXCL_LINE
+      }
+      const auto now = std::chrono::steady_clock::now();
+      for (int i = 0; i < n && !stopping_; ++i) {
+        const int fd = events[i].data.fd;
+        if (fd == listen_fd) {
+          Accept(socket, now);
+        } else if (fd == wakeup_fd_) {
+          ResumeKeptAliveConnections(now);
+        } else {
+          Receive(fd, now);
+        }
+      }
+      if (now >= next_sweep) {
+        CloseIdleConnections(now);
+        next_sweep = now + std::chrono::milliseconds(sweep_period_ms);
+      }
+    }
+    pending_.clear();
+    JoinWorkers();
+  }
+
+  void Stop() {
+    stopping_ = true;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      condition_variable_.notify_all();
+    }
+    WakeUp();
+  }
+
+ private:
+  using clock_t = std::chrono::steady_clock;
+
+  struct PendingConnection final {
+    connection_t connection;
+    std::string received_data;
+    size_t requests_served;
+    clock_t::time_point last_activity;
+    PendingConnection(connection_t connection, size_t requests_served, clock_t::time_point now)
+        : connection(std::move(connection)), requests_served(requests_served), last_activity(now) {}
+  };
+
+  struct ReceivedRequest final {
+    connection_t connection;
+    size_t requests_served = 0u;
+  };
+
+  void AddToEpoll(int fd) {
+    struct epoll_event event;
+    event.events = EPOLLIN;
+    event.data.fd = fd;
+    if (::epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) == -1) {
+      CURRENT_THROW(current::net::SocketFcntlException());  // LCOV_EXCL_LINE
+    }
+  }
+
+  void WakeUp() {
+    const uint64_t one = 1u;
+    if (::write(wakeup_fd_, &one, sizeof(one)) != sizeof(one)) {
+      // The counter of the `eventfd` is already non-zero, so `epoll_wait()` will return regardless.
+    }
+  }
+
+  void Accept(current::net::Socket& socket, clock_t::time_point now) {
+    try {
+      connection_t connection = std::make_unique<current::net::Connection>(socket.Accept());
+      const int fd = connection->socket;
+      epoll_impl::SetSocketBlockingMode(fd, false);
+      AddToEpoll(fd);
+      pending_[fd] = std::make_unique<PendingConnection>(std::move(connection), 0u, now);
+    } catch (const current::Exception& e) {                        // LCOV_EXCL_LINE
+      std::cerr << "HTTP: accept failed: " << e.what() << '\n';  // LCOV_EXCL_LINE
+    }
+  }
+
+  // Called from any thread, once the response has been sent, to serve more requests from this connection.
+  void KeepAlive(connection_t connection, size_t requests_served) {
+    if (!stopping_) {
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        kept_alive_.push_back(ReceivedRequest{std::move(connection), requests_served});
+      }
+      WakeUp();
+    }
+  }
+
+  void ResumeKeptAliveConnections(clock_t::time_point now) {
+    uint64_t counter;
+    if (::read(wakeup_fd_, &counter, sizeof(counter)) != sizeof(counter)) {
+      // Nothing to reset, the `eventfd` has already been read from.
+    }
+    std::vector<ReceivedRequest> kept_alive;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      kept_alive.swap(kept_alive_);
+    }
+    for (ReceivedRequest& request : kept_alive) {
+      try {
+        const int fd = request.connection->socket;
+        epoll_impl::SetSocketBlockingMode(fd, false);
+        AddToEpoll(fd);
+        auto pending = std::make_unique<PendingConnection>(std::move(request.connection), request.requests_served, now);
+        // The pipelined requests, if any, may well have been received in full already.
+        pending->received_data = pending->connection->TakeReceivedData();
+        pending_[fd] = std::move(pending);
+        Receive(fd, now);
+      } catch (const current::Exception& e) {                                        // LCOV_EXCL_LINE
+        std::cerr << "HTTP: could not keep the connection alive: " << e.what() << '\n';  // LCOV_EXCL_LINE
+      }
+    }
+  }
+
+  void Receive(int fd, clock_t::time_point now) {
+    const auto cit = pending_.find(fd);
+    if (cit == pending_.end()) {
+      return;  // LCOV_EXCL_LINE
+    }
+    PendingConnection& pending = *cit->second;
+    pending.last_activity = now;
+    bool closed = false;
+    char chunk[16 * 1024];
+    while (true) {
+      const ssize_t retval = ::recv(fd, chunk, sizeof(chunk), 0);
+      if (retval > 0) {
+        pending.received_data.append(chunk, static_cast<size_t>(retval));
+      } else if (retval < 0 && errno == EINTR) {
+        continue;  // LCOV_EXCL_LINE
+      } else {
+        closed = (retval == 0 || (errno != EAGAIN && errno != EWOULDBLOCK));
+        break;
+      }
+    }
+    // Skip the blank lines between the requests, so that an idle connection with a stray CRLF is not dispatched.
+    const size_t first_non_blank = pending.received_data.find_first_not_of("\r\n");
+    pending.received_data.erase(0, std::min(first_non_blank, pending.received_data.length()));
+    const bool ready =
+        !pending.received_data.empty() && epoll_impl::EnoughOfHTTPRequestReceived(pending.received_data);
+    if (ready || closed) {
+      ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+      ReceivedRequest request{std::move(pending.connection), pending.requests_served};
+      std::string received_data = std::move(pending.received_data);
+      pending_.erase(cit);
+      if (ready) {
+        try {
+          epoll_impl::SetSocketBlockingMode(fd, true);
+          request.connection->PrependReceivedData(std::move(received_data));
+          std::lock_guard<std::mutex> lock(mutex_);
+          queue_.push_back(std::move(request));
+          condition_variable_.notify_one();
+        } catch (const current::Exception& e) {                                        // LCOV_EXCL_LINE
+          std::cerr << "HTTP: could not dispatch the request: " << e.what() << '\n';  // LCOV_EXCL_LINE
+        }
+      }
+    }
+  }
+
+  void CloseIdleConnections(clock_t::time_point now) {
+    for (auto it = pending_.begin(); it != pending_.end();) {
+      if (now - it->second->last_activity >= idle_timeout_) {
+        ::epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, it->first, nullptr);
+        it = pending_.erase(it);
+      } else {
+        ++it;
+      }
+    }
+  }
+
+  void WorkerThread() {
+    while (true) {
+      ReceivedRequest request;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        condition_variable_.wait(lock, [this]() { return stopping_ || !queue_.empty(); });
+        if (stopping_) {
+          return;
+        }
+        request = std::move(queue_.front());
+        queue_.pop_front();
+      }
+      const size_t requests_served = request.requests_served + 1u;
+      keep_alive_t keep_alive;
+      if (requests_served < max_requests_per_connection_) {
+        keep_alive = [this, requests_served](current::net::Connection&& connection) {
+          KeepAlive(std::make_unique<current::net::Connection>(std::move(connection)), requests_served);
+        };
+      }
+      serve_(std::move(request.connection), std::move(keep_alive));
+    }
+  }
+
+  void JoinWorkers() {
+    for (std::thread& worker : workers_) {
+      if (worker.joinable()) {
+        worker.join();
+      }
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.clear();
+    kept_alive_.clear();
+  }
+
+  const size_t max_requests_per_connection_;
+  const std::chrono::milliseconds idle_timeout_;
+  const serve_t serve_;
+  const int epoll_fd_;
+  const int wakeup_fd_;
+  std::atomic_bool stopping_{false};
+
+  // The connections the requests are being received from. Only accessed from the thread running `Run()`.
+  std::unordered_map<int, std::unique_ptr<PendingConnection>> pending_;
+
+  // The connections with the requests received, to be served by the worker threads,
+  // and the kept alive connections, to be returned into `epoll`.
+  std::mutex mutex_;
+  std::condition_variable condition_variable_;
+  std::deque<ReceivedRequest> queue_;
+  std::vector<ReceivedRequest> kept_alive_;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace http
+}  // namespace current
+
+#endif  // CURRENT_POSIX
+
+#endif  // BLOCKS_HTTP_IMPL_EPOLL_DISPATCHER_H
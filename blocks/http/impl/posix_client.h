@@ -30,14 +30,19 @@ SOFTWARE.
 
 #include "../types.h"
 
+#include <deque>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <set>
+#include <utility>
 
 #include "../../url/url.h"
 
 #include "../../../bricks/net/http/http.h"
 #include "../../../bricks/file/file.h"
+#include "../../../bricks/util/singleton.h"
 
 namespace current {
 namespace http {
@@ -59,6 +64,123 @@ struct HTTPRedirectHelper : current::net::HTTPDefaultHelper {
 };
 }  // namespace impl
 
+CURRENT_STRUCT(HTTPClientConnectionPoolStats) {
+  CURRENT_FIELD(connections_opened, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(connections_opened, "The number of the new connections established.");
+  CURRENT_FIELD(connections_reused, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(connections_reused, "The number of the requests sent over the kept-alive connections.");
+  CURRENT_FIELD(connections_idle, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(connections_idle, "The number of the kept-alive connections in the pool right now.");
+  CURRENT_FIELD(connections_evicted, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(connections_evicted, "The number of the connections closed to respect the idle limit.");
+  CURRENT_FIELD(stale_connections_discarded, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(stale_connections_discarded,
+                            "The number of the pooled connections found closed by the server before being reused.");
+  CURRENT_FIELD(requests_retried, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(requests_retried,
+                            "The number of the idempotent requests retried over a new connection, "
+                            "as the reused one turned out to be closed.");
+};
+
+// The pool of the kept-alive HTTP client connections, per (host, port).
+// Used by `HTTP(GET(...))` et. al. transparently, unless `.KeepAlive(false)` is set for the request.
+// A connection is returned into the pool after the response if the server has agreed to keep it alive.
+// Usage: `current::Singleton<current::http::HTTPClientConnectionPool>().SetMaxIdleConnectionsPerHost(...)`, etc.
+class HTTPClientConnectionPool final {
+ public:
+  using connection_t = std::unique_ptr<current::net::Connection>;
+
+  // Zero disables keeping the connections alive altogether.
+  void SetMaxIdleConnectionsPerHost(size_t value) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    max_idle_connections_per_host_ = value;
+    for (auto& host : idle_) {
+      while (host.second.size() > value) {
+        host.second.pop_front();
+        --stats_.connections_idle;
+        ++stats_.connections_evicted;
+      }
+    }
+  }
+
+  HTTPClientConnectionPoolStats Stats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+  }
+
+  // Closes all the idle connections.
+  void Clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    idle_.clear();
+    stats_.connections_idle = 0u;
+  }
+
+  // Returns the most recently used idle connection to `host:port` that still looks alive, or null.
+  connection_t Acquire(const std::string& host, int port) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    const auto it = idle_.find(std::make_pair(host, port));
+    if (it != idle_.end()) {
+      while (!it->second.empty()) {
+        connection_t connection = std::move(it->second.back());
+        it->second.pop_back();
+        --stats_.connections_idle;
+        if (LooksAlive(*connection)) {
+          ++stats_.connections_reused;
+          return connection;
+        } else {
+          ++stats_.stale_connections_discarded;
+        }
+      }
+    }
+    return nullptr;
+  }
+
+  connection_t Connect(const std::string& host, int port) {
+    connection_t connection = std::make_unique<current::net::Connection>(current::net::ClientSocket(host, port));
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.connections_opened;
+    return connection;
+  }
+
+  void Release(const std::string& host, int port, connection_t connection) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (max_idle_connections_per_host_) {
+      auto& connections = idle_[std::make_pair(host, port)];
+      if (connections.size() >= max_idle_connections_per_host_) {
+        connections.pop_front();
+        --stats_.connections_idle;
+        ++stats_.connections_evicted;
+      }
+      connections.push_back(std::move(connection));
+      ++stats_.connections_idle;
+    }
+  }
+
+  void RecordRetry() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++stats_.requests_retried;
+  }
+
+ private:
+  // An idle kept-alive connection has nothing to read. If it does, the server has closed it, or it is out of sync.
+  static bool LooksAlive(current::net::Connection& connection) {
+#ifndef CURRENT_WINDOWS
+    char c;
+    const ssize_t retval = ::recv(connection.socket, &c, 1, MSG_PEEK | MSG_DONTWAIT);
+    return retval < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+#else
+    // Rely on retrying the idempotent requests.
+    static_cast<void>(connection);
+    return true;
+#endif  // CURRENT_WINDOWS
+  }
+
+  mutable std::mutex mutex_;
+  size_t max_idle_connections_per_host_ = 16u;
+  std::map<std::pair<std::string, int>, std::deque<connection_t>> idle_;
+  HTTPClientConnectionPoolStats stats_;
+};
+
 template <class HTTP_HELPER>
 class GenericHTTPClientPOSIX final {
  private:
@@ -94,46 +216,31 @@ class GenericHTTPClientPOSIX final {
           port = 80;
         }
       }
-      current::net::Connection connection(current::net::Connection(current::net::ClientSocket(parsed_url.host, port)));
-      connection.BlockingWrite(
-          request_method_ + ' ' + parsed_url.path + parsed_url.ComposeParameters() + " HTTP/1.1\r\n", true);
-      connection.BlockingWrite("Host: " + parsed_url.host + "\r\n", true);
-      if (!request_user_agent_.empty()) {
-        connection.BlockingWrite("User-Agent: " + request_user_agent_ + "\r\n", true);
-      }
-      for (const auto& h : request_headers_) {
-        connection.BlockingWrite(h.header + ": " + h.value + "\r\n", true);
-      }
-      if (!request_headers_.cookies.empty()) {
-        connection.BlockingWrite("Cookie: " + request_headers_.CookiesAsString() + "\r\n", true);
-      }
-      if (!request_body_content_type_.empty()) {
-        connection.BlockingWrite("Content-Type: " + request_body_content_type_ + "\r\n", true);
-      }
-      if (!request_body_contents_.empty() || current::net::NeedContentLengthHeader(request_method_)) {
-        // NOTE(dkorolev): The `try/catch/throw` combo here is a hack for the unit test for HTTP 413 to pass.
-        // It swallows the `SocketWriteException` exception for huge payloads, as Current's HTTP server logic
-        // does intentionally close the HTTP connection prematurely if `Content-Length` exceeds a reasonable limit.
+      HTTPClientConnectionPool& pool = current::Singleton<HTTPClientConnectionPool>();
+      HTTPClientConnectionPool::connection_t connection =
+          keep_alive_ ? pool.Acquire(parsed_url.host, port) : nullptr;
+      if (connection) {
         try {
-#ifndef CURRENT_WINDOWS
-          connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n", true);
-          connection.BlockingWrite("\r\n", true);
-          connection.BlockingWrite(request_body_contents_, false);
-#else
-          // TODO(grixa): this fix for the PayloadTooLarge test on Windows is temporary, need to revisit it.
-          connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n\r\n" +
-                                       request_body_contents_,
-                                   false);
-#endif
-        } catch (const net::SocketWriteException&) {
-          if (request_body_contents_.length() <= net::constants::kMaxHTTPPayloadSizeInBytes) {
+          SendRequestAndReceiveResponse(*connection, parsed_url);
+        } catch (const current::net::SocketException&) {
+          // The server may have closed the kept-alive connection right as it was being reused.
+          // Retry the idempotent requests over a new connection, and let the others fail.
+          if (!current::net::IsIdempotentHTTPMethod(request_method_)) {
             throw;
           }
+          pool.RecordRetry();
+          connection = pool.Connect(parsed_url.host, port);
+          SendRequestAndReceiveResponse(*connection, parsed_url);
         }
       } else {
-        connection.BlockingWrite("\r\n", false);
+        connection = pool.Connect(parsed_url.host, port);
+        SendRequestAndReceiveResponse(*connection, parsed_url);
+      }
+      // The response to `HEAD` has no body regardless of its `Content-Length`, so do not risk reusing that connection.
+      if (keep_alive_ && request_method_ != "HEAD" && http_request_->KeepAliveRequested() &&
+          http_request_->BodyLengthKnown() && connection->TakeReceivedData().empty()) {
+        pool.Release(parsed_url.host, port, std::move(connection));
       }
-      http_request_.reset(new CustomHTTPRequestData(connection, request_data_construction_params_));
       // TODO(dkorolev): Rename `Path()`, it's only called so now because of HTTP request/response format.
       // Elaboration:
       // HTTP request  message is: `GET /path HTTP/1.1`, "/path" is the second component of it.
@@ -158,6 +265,49 @@ class GenericHTTPClientPOSIX final {
 
   const CustomHTTPRequestData& HTTPRequest() const { return *http_request_.get(); }
 
+ private:
+  void SendRequestAndReceiveResponse(current::net::Connection& connection, const URL& parsed_url) {
+    connection.BlockingWrite(
+        request_method_ + ' ' + parsed_url.path + parsed_url.ComposeParameters() + " HTTP/1.1\r\n", true);
+    connection.BlockingWrite("Host: " + parsed_url.host + "\r\n", true);
+    if (!request_user_agent_.empty()) {
+      connection.BlockingWrite("User-Agent: " + request_user_agent_ + "\r\n", true);
+    }
+    for (const auto& h : request_headers_) {
+      connection.BlockingWrite(h.header + ": " + h.value + "\r\n", true);
+    }
+    if (!request_headers_.cookies.empty()) {
+      connection.BlockingWrite("Cookie: " + request_headers_.CookiesAsString() + "\r\n", true);
+    }
+    if (!request_body_content_type_.empty()) {
+      connection.BlockingWrite("Content-Type: " + request_body_content_type_ + "\r\n", true);
+    }
+    if (!request_body_contents_.empty() || current::net::NeedContentLengthHeader(request_method_)) {
+      // NOTE(dkorolev): The `try/catch/throw` combo here is a hack for the unit test for HTTP 413 to pass.
+      // It swallows the `SocketWriteException` exception for huge payloads, as Current's HTTP server logic
+      // does intentionally close the HTTP connection prematurely if `Content-Length` exceeds a reasonable limit.
+      try {
+#ifndef CURRENT_WINDOWS
+        connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n", true);
+        connection.BlockingWrite("\r\n", true);
+        connection.BlockingWrite(request_body_contents_, false);
+#else
+        // TODO(grixa): this fix for the PayloadTooLarge test on Windows is temporary, need to revisit it.
+        connection.BlockingWrite("Content-Length: " + std::to_string(request_body_contents_.length()) + "\r\n\r\n" +
+                                     request_body_contents_,
+                                 false);
+#endif
+      } catch (const net::SocketWriteException&) {
+        if (request_body_contents_.length() <= net::constants::kMaxHTTPPayloadSizeInBytes) {
+          throw;
+        }
+      }
+    } else {
+      connection.BlockingWrite("\r\n", false);
+    }
+    http_request_.reset(new CustomHTTPRequestData(connection, request_data_construction_params_));
+  }
+
  public:
   // Request parameters.
   std::string request_method_ = "";
@@ -168,6 +318,7 @@ class GenericHTTPClientPOSIX final {
   current::net::http::Headers request_headers_;
   const typename HTTP_HELPER::ConstructionParams request_data_construction_params_;
   bool allow_redirects_ = false;
+  bool keep_alive_ = true;
 
   // Output parameters.
   current::net::HTTPResponseCodeValue response_code_ = HTTPResponseCode.InvalidCode;
@@ -187,6 +338,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const HEAD& request, HTTPClientPOSIX& client) {
@@ -195,6 +347,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const POST& request, HTTPClientPOSIX& client) {
@@ -205,6 +358,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const POSTFromFile& request, HTTPClientPOSIX& client) {
@@ -216,6 +370,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
         current::FileSystem::ReadFileAsString(request.file_name);  // Can throw FileException.
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const PUT& request, HTTPClientPOSIX& client) {
@@ -226,6 +381,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const PATCH& request, HTTPClientPOSIX& client) {
@@ -236,6 +392,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_body_contents_ = request.body;
     client.request_body_content_type_ = request.content_type;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const DELETE& request, HTTPClientPOSIX& client) {
@@ -244,6 +401,7 @@ struct ImplWrapper<HTTPClientPOSIX> {
     client.request_user_agent_ = request.custom_user_agent;  // LCOV_EXCL_LINE  -- tested in GET above.
     client.request_headers_ = request.custom_headers;
     client.allow_redirects_ = request.allow_redirects;
+    client.keep_alive_ = request.keep_alive;
   }
 
   inline static void PrepareInput(const KeepResponseInMemory&, HTTPClientPOSIX&) {}
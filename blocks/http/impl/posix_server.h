@@ -26,6 +26,8 @@ SOFTWARE.
 #define BLOCKS_HTTP_IMPL_POSIX_SERVER_H
 
 #include <atomic>
+#include <chrono>
+#include <functional>
 #include <string>
 #include <map>
 #include <memory>
@@ -35,6 +37,8 @@ SOFTWARE.
 #include "../types.h"
 #include "../request.h"
 
+#include "epoll_dispatcher.h"
+
 #include "../../url/url.h"
 
 #include "../../../typesystem/optional.h"
@@ -156,19 +160,60 @@ struct StaticFileServer {
   }
 };
 
+// The engine to serve the requests with.
+// * `SingleThreaded`: A single thread per port accepts the connections, parses the requests, and runs the handlers.
+// * `Epoll`: A single thread per port accepts the connections and receives the requests using `epoll`,
+//            and a fixed pool of worker threads parses these requests and runs the handlers. Linux-only.
+enum class HTTPServerEngine : int { SingleThreaded = 0, Epoll = 1 };
+
+// The options of the HTTP server. Usage: `HTTP(port, HTTPServerOptions().SetEngine(HTTPServerEngine::Epoll))`.
+// Only the first `HTTP(port, ...)` call for the given port, which is the one to start the server, respects them.
+struct HTTPServerOptions {
+  HTTPServerEngine engine = HTTPServerEngine::SingleThreaded;
+  // The number of the worker threads of the `Epoll` engine; zero stands for `std::thread::hardware_concurrency()`.
+  size_t worker_threads = 0u;
+  // HTTP/1.1 keep-alive, supported by the `Epoll` engine. The `SingleThreaded` one closes the connection after each
+  // response, since a persistent connection would block it. Set `max_requests_per_connection` to one to disable.
+  size_t max_requests_per_connection = 1000u;
+  // The connections that do not send a request for this long are closed.
+  std::chrono::milliseconds idle_timeout = std::chrono::seconds(60);
+
+  HTTPServerOptions& SetEngine(HTTPServerEngine value) {
+    engine = value;
+    return *this;
+  }
+  HTTPServerOptions& SetWorkerThreads(size_t value) {
+    worker_threads = value;
+    return *this;
+  }
+  HTTPServerOptions& SetMaxRequestsPerConnection(size_t value) {
+    max_requests_per_connection = value;
+    return *this;
+  }
+  HTTPServerOptions& SetIdleTimeout(std::chrono::milliseconds value) {
+    idle_timeout = value;
+    return *this;
+  }
+};
+
 // HTTP server bound to a specific port.
 class HTTPServerPOSIX final {
  public:
+  using options_t = HTTPServerOptions;
+
   // The constructor starts listening on the specified port.
   // Since instances of `HTTPServerPOSIX` are created via a singleton,
   // a listening thread will only be created once per port, on the first access to that port.
-  explicit HTTPServerPOSIX(current::net::BarePort port)
+  explicit HTTPServerPOSIX(current::net::BarePort port, const HTTPServerOptions& options = HTTPServerOptions())
       : terminating_(false),
         port_(static_cast<uint16_t>(port)),
+        epoll_dispatcher_(CreateEpollDispatcherIfRequested(options)),
         thread_([this, port]() { Thread(current::net::Socket(port)); }) {}
-  explicit HTTPServerPOSIX(current::net::ReservedLocalPort reserved_port)
+  explicit HTTPServerPOSIX(current::net::ReservedLocalPort reserved_port,
+                           const HTTPServerOptions& options = HTTPServerOptions())
       : terminating_(false),
         port_(reserved_port),
+        epoll_dispatcher_(CreateEpollDispatcherIfRequested(options)),
         thread_([this](current::net::Socket socket) { Thread(std::move(socket)); }, std::move(reserved_port)) {}
 
   uint16_t LocalPort() const { return port_; }
@@ -178,6 +223,16 @@ class HTTPServerPOSIX final {
   // unregistering all handlers will still keep the listening thread up, and it will serve 404-s.
   ~HTTPServerPOSIX() {
     terminating_ = true;
+#ifdef CURRENT_POSIX
+    if (epoll_dispatcher_) {
+      // The `Epoll` engine is woken up directly, and it waits for the in-flight requests to be served.
+      epoll_dispatcher_->Stop();
+      if (thread_.joinable()) {
+        thread_.join();
+      }
+      return;
+    }
+#endif  // CURRENT_POSIX
     // Notify the server thread that it should terminate.
     // Effectively, call `HTTP(GET("/healthz"))`, but in a way that avoids client <=> server dependency.
     // LCOV_EXCL_START
@@ -413,60 +468,37 @@ class HTTPServerPOSIX final {
     return nullptr;
   }
 
+#ifdef CURRENT_POSIX
+  std::unique_ptr<EpollHTTPConnectionDispatcher> CreateEpollDispatcherIfRequested(const HTTPServerOptions& options) {
+    if (options.engine == HTTPServerEngine::Epoll) {
+      return std::make_unique<EpollHTTPConnectionDispatcher>(
+          options.worker_threads,
+          options.max_requests_per_connection,
+          options.idle_timeout,
+          [this](EpollHTTPConnectionDispatcher::connection_t connection,
+                 EpollHTTPConnectionDispatcher::keep_alive_t keep_alive) {
+            Serve(std::move(*connection), std::move(keep_alive));
+          });
+    } else {
+      return nullptr;
+    }
+  }
+#else
+  // The `Epoll` engine is Linux-only, the `SingleThreaded` one is used elsewhere.
+  std::nullptr_t CreateEpollDispatcherIfRequested(const HTTPServerOptions&) { return nullptr; }
+#endif  // CURRENT_POSIX
+
   void Thread(current::net::Socket socket) {
+#ifdef CURRENT_POSIX
+    if (epoll_dispatcher_) {
+      epoll_dispatcher_->Run(socket);
+      return;
+    }
+#endif  // CURRENT_POSIX
     // TODO(dkorolev): Benchmark QPS.
     while (!terminating_) {
       try {
-        auto connection = std::make_unique<current::net::HTTPServerConnection>(socket.Accept());
-        if (terminating_) {
-          // Already terminating. Will not send the response, and this
-          // lack of response should not result in an exception.
-          connection->DoNotSendAnyResponse();
-          break;
-        }
-        URLPathArgs url_path_args;
-        const auto handler = FindHandler(connection->HTTPRequest().URL().path, url_path_args);
-        if (Exists(handler)) {
-          // OK, here's the tricky part with error handling and exceptions in this multithreaded world.
-          // * On the one hand, the connection should be std::move-d into the request,
-          //   since it might end up being served in another thread, via a message queue, etc.
-          //   Thus, the user code is responsible for closing the connection.
-          //   Not to mention that the std::move-d away connection can easily outlive this scope.
-          // * On the other hand, if an exception occurs in user code, we need to return a 500,
-          //   which should obviously happen before the connection object is destructed.
-          //   This seems like a good reason to not std::move it away, or move it away with some flag,
-          //   but I thought hard of it, and don't think it's a good choice -- D.K.
-          //
-          // Solution: Do nothing here. No matter how tempting it is, it won't work across threads. Period.
-          //
-          // The implementation of HTTP connection will return an "INTERNAL SERVER ERROR"
-          // if no response was sent. That's what the user gets. In debugger, they can put a breakpoint there
-          // and see what caused the error.
-          //
-          // It is the job of the user of this library to ensure no exceptions leave their code.
-          // In practice, a top-level try-catch for `const current::Exception& e` is good enough.
-          try {
-            (*Value(handler))(Request(std::move(connection), url_path_args));
-          } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
-            // WARNING: This `catch` is really not sufficient, it just logs a message
-            // if a user exception occurred in the same thread that ran the handler.
-            // DO NOT COUNT ON IT.
-            std::cerr << "HTTP route failed in user code: " << e.what() << '\n';  // LCOV_EXCL_LINE
-          }
-        } else {
-          connection->SendHTTPResponse(current::net::DefaultNotFoundMessage(),
-                                       HTTPResponseCode.NotFound,
-                                       current::net::http::Headers(),
-                                       current::net::constants::kDefaultHTMLContentType);
-        }
-      } catch (const current::net::ChunkSizeNotAValidHEXValue&) {
-        // The `ChunkSizeNotAValidHEXValue` situation, if emerged, is already handled with a "400 BAD REQUEST" response.
-      } catch (const current::net::HTTPPayloadTooLarge&) {
-        // The `HTTPPayloadTooLarge` situation, if emerged, is already handled with a "413 ENTITY TOO LARGE" response.
-      } catch (const current::net::HTTPRequestBodyLengthNotProvided&) {
-        // The `HTTPRequestBodyLengthNotProvided` situation, if emerged, is already handled with "411 LENGTH REQUIRED".
-      } catch (const current::net::EmptySocketException&) {  // LCOV_EXCL_LINE
-        // Silently discard errors if no data was sent in.
+        Serve(socket.Accept());
       } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
         // TODO(dkorolev): More reliable logging.
         std::cerr << "HTTP route failed: " << e.what() << '\n';  // LCOV_EXCL_LINE
@@ -474,6 +506,71 @@ class HTTPServerPOSIX final {
     }
   }
 
+  // Parses the request from the accepted connection, and runs the handler for it.
+  // Called from the listening thread by the `SingleThreaded` engine, and from the worker threads by the `Epoll` one.
+  // If `keep_alive` is set, and the client wants the connection kept alive, it is passed on to it after the response.
+  void Serve(current::net::Connection&& accepted_connection,
+             std::function<void(current::net::Connection&&)> keep_alive = nullptr) {
+    try {
+      auto connection = std::make_unique<current::net::HTTPServerConnection>(std::move(accepted_connection));
+      if (keep_alive) {
+        connection->SetKeepAliveHandler(std::move(keep_alive));
+      }
+      if (terminating_) {
+        // Already terminating. Will not send the response, and this
+        // lack of response should not result in an exception.
+        connection->DoNotSendAnyResponse();
+        return;
+      }
+      URLPathArgs url_path_args;
+      const auto handler = FindHandler(connection->HTTPRequest().URL().path, url_path_args);
+      if (Exists(handler)) {
+        // OK, here's the tricky part with error handling and exceptions in this multithreaded world.
+        // * On the one hand, the connection should be std::move-d into the request,
+        //   since it might end up being served in another thread, via a message queue, etc.
+        //   Thus, the user code is responsible for closing the connection.
+        //   Not to mention that the std::move-d away connection can easily outlive this scope.
+        // * On the other hand, if an exception occurs in user code, we need to return a 500,
+        //   which should obviously happen before the connection object is destructed.
+        //   This seems like a good reason to not std::move it away, or move it away with some flag,
+        //   but I thought hard of it, and don't think it's a good choice -- D.K.
+        //
+        // Solution: Do nothing here. No matter how tempting it is, it won't work across threads. Period.
+        //
+        // The implementation of HTTP connection will return an "INTERNAL SERVER ERROR"
+        // if no response was sent. That's what the user gets. In debugger, they can put a breakpoint there
+        // and see what caused the error.
+        //
+        // It is the job of the user of this library to ensure no exceptions leave their code.
+        // In practice, a top-level try-catch for `const current::Exception& e` is good enough.
+        try {
+          (*Value(handler))(Request(std::move(connection), url_path_args));
+        } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
+          // WARNING: This `catch` is really not sufficient, it just logs a message
+          // if a user exception occurred in the same thread that ran the handler.
+          // DO NOT COUNT ON IT.
+          std::cerr << "HTTP route failed in user code: " << e.what() << '\n';  // LCOV_EXCL_LINE
+        }
+      } else {
+        connection->SendHTTPResponse(current::net::DefaultNotFoundMessage(),
+                                     HTTPResponseCode.NotFound,
+                                     current::net::http::Headers(),
+                                     current::net::constants::kDefaultHTMLContentType);
+      }
+    } catch (const current::net::ChunkSizeNotAValidHEXValue&) {
+      // The `ChunkSizeNotAValidHEXValue` situation, if emerged, is already handled with a "400 BAD REQUEST" response.
+    } catch (const current::net::HTTPPayloadTooLarge&) {
+      // The `HTTPPayloadTooLarge` situation, if emerged, is already handled with a "413 ENTITY TOO LARGE" response.
+    } catch (const current::net::HTTPRequestBodyLengthNotProvided&) {
+      // The `HTTPRequestBodyLengthNotProvided` situation, if emerged, is already handled with "411 LENGTH REQUIRED".
+    } catch (const current::net::EmptySocketException&) {  // LCOV_EXCL_LINE
+      // Silently discard errors if no data was sent in.
+    } catch (const current::Exception& e) {  // LCOV_EXCL_LINE
+      // TODO(dkorolev): More reliable logging.
+      std::cerr << "HTTP route failed: " << e.what() << '\n';  // LCOV_EXCL_LINE
+    }
+  }
+
   void ValidateRoute(const std::string& path) {
     if (path.empty() || path[0] != '/') {
       CURRENT_THROW(PathDoesNotStartWithSlash("HTTP URL path does not start with a slash: `" + path + "`."));
@@ -542,6 +639,12 @@ class HTTPServerPOSIX final {
 
   std::atomic_bool terminating_;
   const uint16_t port_;
+#ifdef CURRENT_POSIX
+  // Set for the `Epoll` engine only, null for the `SingleThreaded` one.
+  const std::unique_ptr<EpollHTTPConnectionDispatcher> epoll_dispatcher_;
+#else
+  const std::nullptr_t epoll_dispatcher_;
+#endif  // CURRENT_POSIX
   std::thread thread_;
 
   // TODO(dkorolev): Look into read-write mutexes here.
@@ -33,7 +33,9 @@ SOFTWARE.
 #include "docu/server/docu_03httpserver_04_test.cc"
 #include "docu/server/docu_03httpserver_05_test.cc"
 
+#include <atomic>
 #include <string>
+#include <thread>
 
 #include "api.h"
 
@@ -1951,6 +1953,235 @@ TEST(HTTPAPI, PayloadTooLarge) {
   }
 }
 
+#ifdef CURRENT_POSIX
+TEST(HTTPAPI, EpollEngine) {
+  using namespace current::http;
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server =
+      HTTP(std::move(reserved_port), HTTPServerOptions().SetEngine(HTTPServerEngine::Epoll).SetWorkerThreads(4));
+
+  std::atomic_bool slow_handler_released(false);
+  const auto scope = http_server.Register("/get", [](Request r) { r("OK\n"); }) +
+                     http_server.Register("/post", [](Request r) { r("Data: " + r.body); }) +
+                     http_server.Register("/slow",
+                                          [&slow_handler_released](Request r) {
+                                            while (!slow_handler_released) {
+                                              std::this_thread::yield();
+                                            }
+                                            r("Slow\n");
+                                          }) +
+                     http_server.Register("/release", [&slow_handler_released](Request r) {
+                       slow_handler_released = true;
+                       r("Released\n");
+                     });
+
+  {
+    const auto response = HTTP(GET(Printf("http://localhost:%d/get", port)));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ("OK\n", response.body);
+  }
+  {
+    const auto response = HTTP(GET(Printf("http://localhost:%d/nope", port)));
+    EXPECT_EQ(404, static_cast<int>(response.code));
+    EXPECT_EQ(DefaultNotFoundMessage(), response.body);
+  }
+  {
+    const auto response = HTTP(POST(Printf("http://localhost:%d/post", port), "BODY"));
+    EXPECT_EQ("Data: BODY", response.body);
+  }
+  {
+    // The body larger than what the acceptor thread receives by itself is read by the worker thread.
+    const std::string body(current::net::constants::kMaxHTTPPrebufferedBodySizeInBytes * 3, '.');
+    const auto response = HTTP(POST(Printf("http://localhost:%d/post", port), body));
+    EXPECT_EQ("Data: " + body, response.body);
+  }
+  {
+    // A slow handler does not block the other requests.
+    std::thread slow_request([port]() {
+      const auto response = HTTP(GET(Printf("http://localhost:%d/slow", port)));
+      EXPECT_EQ("Slow\n", response.body);
+    });
+    EXPECT_EQ("Released\n", HTTP(GET(Printf("http://localhost:%d/release", port))).body);
+    slow_request.join();
+  }
+  {
+    // A slow client does not block the other requests either.
+    Connection slow_client(current::net::ClientSocket("localhost", port));
+    slow_client.BlockingWrite("POST /post HTTP/1.1\r\n", true);
+    slow_client.BlockingWrite("Content-Length: 4\r\n", false);
+
+    EXPECT_EQ("OK\n", HTTP(GET(Printf("http://localhost:%d/get", port))).body);
+
+    slow_client.BlockingWrite("\r\nBO", false);
+    EXPECT_EQ("OK\n", HTTP(GET(Printf("http://localhost:%d/get", port))).body);
+
+    slow_client.BlockingWrite("DY", false);
+    const std::string golden =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Connection: keep-alive\r\n"
+        "Content-Length: 10\r\n"
+        "\r\n"
+        "Data: BODY";
+    std::string response(golden.length(), ' ');
+    ASSERT_EQ(golden.length(), slow_client.BlockingRead(&response[0], golden.length(), Connection::FillFullBuffer));
+    EXPECT_EQ(golden, response);
+  }
+  {
+    // The chunked request body is passed on to the worker thread as soon as the headers are in.
+    Connection connection(current::net::ClientSocket("localhost", port));
+    connection.BlockingWrite("POST /post HTTP/1.1\r\nTransfer-Encoding: chunked\r\n\r\n", false);
+    connection.BlockingWrite("2\r\nBO\r\n", false);
+    connection.BlockingWrite("2\r\nDY\r\n0\r\n\r\n", false);
+    const std::string golden =
+        "HTTP/1.1 200 OK\r\n"
+        "Content-Type: text/plain\r\n"
+        "Connection: keep-alive\r\n"
+        "Content-Length: 10\r\n"
+        "\r\n"
+        "Data: BODY";
+    std::string response(golden.length(), ' ');
+    ASSERT_EQ(golden.length(), connection.BlockingRead(&response[0], golden.length(), Connection::FillFullBuffer));
+    EXPECT_EQ(golden, response);
+  }
+}
+
+TEST(HTTPAPI, EpollEngineKeepAliveAndPipelining) {
+  using namespace current::http;
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server = HTTP(std::move(reserved_port),
+                           HTTPServerOptions()
+                               .SetEngine(HTTPServerEngine::Epoll)
+                               .SetWorkerThreads(2)
+                               .SetMaxRequestsPerConnection(4)
+                               .SetIdleTimeout(std::chrono::milliseconds(100)));
+  const auto scope = http_server.Register("/get", [](Request r) { r("OK\n"); }) +
+                     http_server.Register("/post", [](Request r) { r("Data: " + r.body); }) +
+                     http_server.Register("/chunked", [](Request r) {
+                       auto response =
+                           r.connection.SendChunkedHTTPResponse(HTTPResponseCode.OK, Headers(), "text/plain");
+                       response.Send("A");
+                       response.Send("B");
+                     });
+
+  const auto response = [](const std::string& connection_type, const std::string& body) {
+    return "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: " + connection_type +
+           "\r\nContent-Length: " + current::ToString(body.length()) + "\r\n\r\n" + body;
+  };
+  const auto expect_to_receive = [](const std::string& golden, Connection& connection) {
+    std::string received(golden.length(), ' ');
+    ASSERT_EQ(golden.length(), connection.BlockingRead(&received[0], golden.length(), Connection::FillFullBuffer));
+    EXPECT_EQ(golden, received);
+  };
+  const auto expect_closed = [](Connection& connection) {
+    char c;
+    ASSERT_THROW(connection.BlockingRead(&c, 1u), current::net::EmptySocketException);
+  };
+
+  {
+    // Two requests pipelined into one write, then the chunked response, then the one that asks to close.
+    Connection connection(current::net::ClientSocket("localhost", port));
+    connection.BlockingWrite("GET /get HTTP/1.1\r\n\r\nPOST /post HTTP/1.1\r\nContent-Length: 4\r\n\r\nBODY", false);
+    expect_to_receive(response("keep-alive", "OK\n") + response("keep-alive", "Data: BODY"), connection);
+    connection.BlockingWrite("GET /chunked HTTP/1.1\r\nConnection: keep-alive\r\n\r\n", false);
+    expect_to_receive(
+        "HTTP/1.1 200 OK\r\nContent-Type: text/plain\r\nConnection: keep-alive\r\n"
+        "Transfer-Encoding: chunked\r\n\r\n1\r\nA\r\n1\r\nB\r\n0\r\n\r\n",
+        connection);
+    connection.BlockingWrite("GET /get HTTP/1.1\r\nConnection: close\r\n\r\n", false);
+    expect_to_receive(response("close", "OK\n"), connection);
+    expect_closed(connection);
+  }
+  {
+    // HTTP/1.0 connections are only kept alive if explicitly asked to.
+    Connection connection(current::net::ClientSocket("localhost", port));
+    connection.BlockingWrite("GET /get HTTP/1.0\r\n\r\n", false);
+    expect_to_receive(response("close", "OK\n"), connection);
+    expect_closed(connection);
+  }
+  {
+    // At most four requests are served per connection.
+    Connection connection(current::net::ClientSocket("localhost", port));
+    for (int i = 0; i < 3; ++i) {
+      connection.BlockingWrite("GET /get HTTP/1.0\r\nConnection: Keep-Alive\r\n\r\n", false);
+      expect_to_receive(response("keep-alive", "OK\n"), connection);
+    }
+    connection.BlockingWrite("GET /get HTTP/1.1\r\n\r\n", false);
+    expect_to_receive(response("close", "OK\n"), connection);
+    expect_closed(connection);
+  }
+  {
+    // Idle connections are closed after the timeout.
+    Connection connection(current::net::ClientSocket("localhost", port));
+    connection.BlockingWrite("GET /get HTTP/1.1\r\n\r\n", false);
+    expect_to_receive(response("keep-alive", "OK\n"), connection);
+    std::this_thread::sleep_for(std::chrono::milliseconds(500));
+    expect_closed(connection);
+  }
+}
+
+TEST(HTTPAPI, ClientConnectionPool) {
+  using namespace current::http;
+  auto& pool = current::Singleton<HTTPClientConnectionPool>();
+  pool.Clear();
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server = HTTP(std::move(reserved_port),
+                           HTTPServerOptions()
+                               .SetEngine(HTTPServerEngine::Epoll)
+                               .SetWorkerThreads(2)
+                               .SetIdleTimeout(std::chrono::milliseconds(100)));
+  const auto scope = http_server.Register("/get", [](Request r) { r("OK\n"); }) +
+                     http_server.Register("/post", [](Request r) { r("Data: " + r.body); });
+  const std::string url = Printf("http://localhost:%d/get", port);
+
+  const HTTPClientConnectionPoolStats stats = pool.Stats();
+  const auto delta = [&pool, &stats]() {
+    const HTTPClientConnectionPoolStats now = pool.Stats();
+    return Printf("opened=%d, reused=%d, idle=%d, evicted=%d, stale=%d",
+                  static_cast<int>(now.connections_opened - stats.connections_opened),
+                  static_cast<int>(now.connections_reused - stats.connections_reused),
+                  static_cast<int>(now.connections_idle),
+                  static_cast<int>(now.connections_evicted - stats.connections_evicted),
+                  static_cast<int>(now.stale_connections_discarded - stats.stale_connections_discarded));
+  };
+
+  EXPECT_EQ("OK\n", HTTP(GET(url)).body);
+  EXPECT_EQ("opened=1, reused=0, idle=1, evicted=0, stale=0", delta());
+  EXPECT_EQ("OK\n", HTTP(GET(url)).body);
+  EXPECT_EQ("Data: BODY", HTTP(POST(Printf("http://localhost:%d/post", port), "BODY")).body);
+  EXPECT_EQ("opened=1, reused=2, idle=1, evicted=0, stale=0", delta());
+
+  // Opting out of the pool.
+  EXPECT_EQ("OK\n", HTTP(GET(url).KeepAlive(false)).body);
+  EXPECT_EQ("opened=2, reused=2, idle=1, evicted=0, stale=0", delta());
+
+  // The connection closed by the server is detected as stale, and a new one is established.
+  std::this_thread::sleep_for(std::chrono::milliseconds(500));
+  EXPECT_EQ("OK\n", HTTP(GET(url)).body);
+  EXPECT_EQ("opened=3, reused=2, idle=1, evicted=0, stale=1", delta());
+
+  pool.SetMaxIdleConnectionsPerHost(0u);
+  EXPECT_EQ("opened=3, reused=2, idle=0, evicted=1, stale=1", delta());
+  EXPECT_EQ("OK\n", HTTP(GET(url)).body);
+  EXPECT_EQ("opened=4, reused=2, idle=0, evicted=1, stale=1", delta());
+  pool.SetMaxIdleConnectionsPerHost(16u);
+
+  {
+    // The single-threaded engine closes the connections, and they are not pooled.
+    auto single_threaded_reserved_port = current::net::ReserveLocalPort();
+    const int single_threaded_port = single_threaded_reserved_port;
+    const auto single_threaded_scope =
+        HTTP(std::move(single_threaded_reserved_port)).Register("/get", [](Request r) { r("Closed\n"); });
+    EXPECT_EQ("Closed\n", HTTP(GET(Printf("http://localhost:%d/get", single_threaded_port))).body);
+    EXPECT_EQ("opened=5, reused=2, idle=0, evicted=1, stale=1", delta());
+  }
+}
+#endif  // CURRENT_POSIX
+
 CURRENT_STRUCT_T(HTTPAPITemplatedTestObject) {
   CURRENT_FIELD(text, std::string, "OK");
   CURRENT_FIELD(data, T);
@@ -59,6 +59,7 @@ struct HTTPRequestBase {
   std::string custom_user_agent = "";
   current::net::http::Headers custom_headers;
   bool allow_redirects = false;
+  bool keep_alive = true;
 
   HTTPRequestBase(const std::string& url) : url(url) {}
 
@@ -72,6 +73,13 @@ struct HTTPRequestBase {
     return static_cast<T&>(*this);
   }
 
+  // By default, the connection is taken from and returned to the pool of the kept-alive client connections.
+  // See `HTTPClientConnectionPool` in `impl/posix_client.h`.
+  T& KeepAlive(bool keep_alive_setting = true) {
+    keep_alive = keep_alive_setting;
+    return static_cast<T&>(*this);
+  }
+
   T& SetHeader(const std::string& key, const std::string& value) {
     custom_headers.emplace_back(key, value);
     return static_cast<T&>(*this);
@@ -341,6 +349,29 @@ struct HTTPImpl {
     return *server;
   }
 
+  // The options, such as the serving engine, only take effect if the server on this port is not yet running.
+  [[nodiscard]] server_impl_t& operator()(current::net::BarePort port,
+                                          const typename server_impl_t::options_t& options) {
+    HandlersSingleton& handlers = current::Singleton<HandlersSingleton>();
+    std::lock_guard<std::mutex> lock(handlers.mutex);
+    std::unique_ptr<server_impl_t>& server = handlers.servers[static_cast<size_t>(port)];
+    if (!server) {
+      server = std::make_unique<server_impl_t>(port, options);
+    }
+    return *server;
+  }
+
+  [[nodiscard]] server_impl_t& operator()(current::net::ReservedLocalPort port,
+                                          const typename server_impl_t::options_t& options) {
+    HandlersSingleton& handlers = current::Singleton<HandlersSingleton>();
+    std::lock_guard<std::mutex> lock(handlers.mutex);
+    std::unique_ptr<server_impl_t>& server = handlers.servers[static_cast<uint16_t>(port)];
+    if (!server) {
+      server = std::make_unique<server_impl_t>(std::move(port), options);
+    }
+    return *server;
+  }
+
   // TODO(dkorolev): Deprecate the below some time in the future. And perhaps add an `http_port_t`.
   [[nodiscard]] server_impl_t& operator()(int port) {
     CURRENT_ASSERT(port > 0 && port < 65536);
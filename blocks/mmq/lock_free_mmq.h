@@ -0,0 +1,354 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef BLOCKS_MMQ_LOCK_FREE_MMQ_H
+#define BLOCKS_MMQ_LOCK_FREE_MMQ_H
+
+// The lock-free flavor of MMQ, selected via the `CONCURRENCY` template argument of `MMQ`, see "mmq.h".
+//
+// The circular buffer is a sequence-numbered ring, as in Dmitry Vyukov's bounded queue: each slot carries its own
+// atomic sequence number, which tells whether the slot is free for the publisher at a given position,
+// or is ready to be consumed. No mutex is taken on the hot path, neither by the publishers nor by the consumer.
+//
+// MMQ assigns strictly increasing indexes and timestamps to the messages, and rejects the timestamps going back.
+// So, unlike in a plain Vyukov queue, a publisher does not just claim a position. It claims the head of the queue
+// for the few instructions it takes to validate and assign the index and the timestamp, by setting `kClaimedBit`
+// in `head_` with a single CAS. The message itself is then moved into the slot with no contention.
+// With `MMQConcurrency::LockFreeSPSC` there is only one publisher, so even that CAS is replaced by plain stores.
+//
+// Strictly speaking, the multi-producer mode is thus not lock-free: the claimed head is a tiny spinlock, and
+// a publisher preempted while holding it stalls the other ones. They spin briefly and then yield the CPU,
+// so that the preempted publisher gets to run and release the head.
+//
+// The consumer drains all the ready messages before going to sleep, and the publishers only notify it when
+// it actually sleeps, so the wakeups are batched. With `BUSY_SPIN = true` the consumer never sleeps,
+// trading one CPU core for the lowest possible latency.
+//
+// Both overflow strategies are supported: with `DROP_ON_OVERFLOW` the message is discarded if the buffer is full,
+// otherwise the publisher spins for a while, and then sleeps until the consumer frees a slot.
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "../ss/ss.h"
+
+#include "../../bricks/time/chrono.h"
+
+namespace current {
+namespace mmq {
+
+enum class MMQConcurrency : int { Mutex = 0, LockFreeMPSC = 1, LockFreeSPSC = 2 };
+
+constexpr size_t kMMQCacheLineSize = 64u;
+constexpr size_t kMMQSpinIterationsBeforeSleeping = 1000u;
+constexpr size_t kMMQSpinIterationsBeforeYielding = 64u;
+
+template <typename MESSAGE,
+          typename CONSUMER,
+          size_t DEFAULT_BUFFER_SIZE = 1024,
+          bool DROP_ON_OVERFLOW = false,
+          bool SINGLE_PRODUCER = false,
+          bool BUSY_SPIN = false>
+class LockFreeMMQImpl {
+  static_assert(current::ss::IsEntrySubscriber<CONSUMER, MESSAGE>::value, "");
+
+ public:
+  using message_t = MESSAGE;
+  using consumer_t = CONSUMER;
+
+  LockFreeMMQImpl(consumer_t& consumer, size_t buffer_size = DEFAULT_BUFFER_SIZE)
+      : consumer_(consumer), circular_buffer_size_(buffer_size), circular_buffer_(circular_buffer_size_) {
+    for (size_t i = 0u; i < circular_buffer_size_; ++i) {
+      circular_buffer_[i].sequence.store(i, std::memory_order_relaxed);
+    }
+    consumer_thread_ = std::thread(&LockFreeMMQImpl::ConsumerThread, this);
+  }
+
+  // The destructor waits for the consumer thread to export all the messages the slots for which have been
+  // allocated, including the ones still being moved into their slots, and terminate.
+  ~LockFreeMMQImpl() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      destructing_.store(true);
+      consumer_condition_variable_.notify_one();
+      publishers_condition_variable_.notify_all();
+    }
+    consumer_thread_.join();
+  }
+
+ protected:
+  template <current::locks::MutexLockStatus, typename TIMESTAMP>  // `MutexLockStatus` is unused by MMQ.
+  idxts_t PublisherPublishImpl(const message_t& message, TIMESTAMP&& timestamp) {
+    Entry* entry = Allocate(std::forward<TIMESTAMP>(timestamp));
+    if (entry) {
+      entry->message_body = message;
+      return Commit(*entry);
+    } else {
+      return idxts_t();
+    }
+  }
+
+  template <current::locks::MutexLockStatus, typename TIMESTAMP>  // `MutexLockStatus` is unused by MMQ.
+  idxts_t PublisherPublishImpl(message_t&& message, TIMESTAMP&& timestamp) {
+    Entry* entry = Allocate(std::forward<TIMESTAMP>(timestamp));
+    if (entry) {
+      entry->message_body = std::move(message);
+      return Commit(*entry);
+    } else {
+      return idxts_t();
+    }
+  }
+
+ private:
+  LockFreeMMQImpl(const LockFreeMMQImpl&) = delete;
+  LockFreeMMQImpl(LockFreeMMQImpl&&) = delete;
+  void operator=(const LockFreeMMQImpl&) = delete;
+  void operator=(LockFreeMMQImpl&&) = delete;
+
+  // The slot of the circular buffer. Given the position `p` of the slot in the infinite stream of messages,
+  // `sequence == p` means the slot is free for the message at position `p`, and `sequence == p + 1` means
+  // the message at position `p` is ready to be exported.
+  struct alignas(kMMQCacheLineSize) Entry {
+    std::atomic<uint64_t> sequence;
+    idxts_t index_timestamp;
+    message_t message_body;
+  };
+
+  constexpr static uint64_t kClaimedBit = static_cast<uint64_t>(1) << 63;
+
+  static void Pause() {
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_ia32_pause();
+#else
+    std::this_thread::yield();
+#endif
+  }
+
+  // Spins for a while, and then yields the CPU, so that the thread being waited for runs even if it was preempted.
+  static void Backoff(size_t& spins) {
+    if (++spins < kMMQSpinIterationsBeforeYielding) {
+      Pause();
+    } else {
+      std::this_thread::yield();
+    }
+  }
+
+  // Claims the head of the queue, returns the position of the message to publish.
+  uint64_t ClaimHead() {
+    if (SINGLE_PRODUCER) {
+      const uint64_t position = head_.load(std::memory_order_relaxed);
+      head_.store(position | kClaimedBit, std::memory_order_relaxed);
+      // Make sure the consumer reading the last index and timestamp under the seqlock sees the claimed bit first.
+      std::atomic_thread_fence(std::memory_order_release);
+      return position;
+    } else {
+      uint64_t position = head_.load(std::memory_order_relaxed);
+      size_t spins = 0u;
+      while (true) {
+        if (position & kClaimedBit) {
+          Backoff(spins);
+          position = head_.load(std::memory_order_relaxed);
+        } else if (head_.compare_exchange_weak(position, position | kClaimedBit, std::memory_order_acquire)) {
+          std::atomic_thread_fence(std::memory_order_release);
+          return position;
+        }
+      }
+    }
+  }
+
+  void ReleaseHead(uint64_t position) { head_.store(position, std::memory_order_release); }
+
+  // The position of the next message to publish, i.e. the number of the slots allocated so far.
+  uint64_t AllocatedHead() const {
+    size_t spins = 0u;
+    while (true) {
+      const uint64_t head = head_.load(std::memory_order_acquire);
+      if (!(head & kClaimedBit)) {
+        return head;
+      }
+      Backoff(spins);
+    }
+  }
+
+  bool IsFree(const Entry& entry, uint64_t position) const {
+    return entry.sequence.load(std::memory_order_acquire) == position;
+  }
+
+  // Returns the slot to move the message into, or `nullptr` if the message is to be dropped.
+  template <typename TIMESTAMP>
+  Entry* Allocate(TIMESTAMP&& user_timestamp) {
+    static_assert(time::IsTimestamp<std::decay_t<TIMESTAMP>>::value, "");
+    size_t spins = 0u;
+    while (true) {
+      if (destructing_.load(std::memory_order_relaxed)) {
+        return nullptr;  // LCOV_EXCL_LINE
+      }
+      const uint64_t position = ClaimHead();
+      Entry& entry = circular_buffer_[position % circular_buffer_size_];
+      if (IsFree(entry, position)) {
+        // NOTE: `Now()` must be called while the head is claimed, so that the timestamps are strictly increasing.
+        const auto timestamp = current::time::TimestampAsMicroseconds(user_timestamp);
+        if (!(timestamp > last_idx_ts_.us)) {
+          const auto expected = last_idx_ts_.us + std::chrono::microseconds(1);
+          ReleaseHead(position);
+          CURRENT_THROW(ss::InconsistentTimestampException(expected, timestamp));
+        }
+        ++last_idx_ts_.index;
+        last_idx_ts_.us = (DROP_ON_OVERFLOW || timestamp.count() >= 0) ? timestamp : current::time::Now();
+        entry.index_timestamp = last_idx_ts_;
+        published_index_.store(last_idx_ts_.index, std::memory_order_relaxed);
+        published_us_.store(last_idx_ts_.us.count(), std::memory_order_relaxed);
+        ReleaseHead(position + 1u);
+        return &entry;
+      }
+      ReleaseHead(position);
+      if (DROP_ON_OVERFLOW) {
+        // Overflow. Discarding the message.
+        return nullptr;
+      }
+      // Overflow. Wait for the consumer to free the slot, spinning first, and then sleeping.
+      if (++spins < kMMQSpinIterationsBeforeSleeping) {
+        Pause();
+      } else {
+        std::unique_lock<std::mutex> lock(mutex_);
+        publishers_waiting_.fetch_add(1u);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        publishers_condition_variable_.wait(lock, [this, &entry, position] {
+          return IsFree(entry, position) || entry.sequence.load(std::memory_order_acquire) > position ||
+                 head_.load(std::memory_order_relaxed) != position || destructing_.load();
+        });
+        publishers_waiting_.fetch_sub(1u);
+        spins = 0u;
+      }
+    }
+  }
+
+  idxts_t Commit(Entry& entry) {
+    const idxts_t result = entry.index_timestamp;
+    const uint64_t position = static_cast<uint64_t>(result.index - 1u);
+    entry.sequence.store(position + 1u, std::memory_order_release);
+    if (!BUSY_SPIN) {
+      // Only wake up the consumer if it is asleep. The fence pairs with the one in `ConsumerThread()`.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (consumer_waiting_.load(std::memory_order_relaxed)) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        consumer_condition_variable_.notify_one();
+      }
+    }
+    return result;
+  }
+
+  // Reads the most recently published index and timestamp, using `head_` as the seqlock sequence.
+  idxts_t LastIndexAndTimestamp() const {
+    size_t spins = 0u;
+    while (true) {
+      const uint64_t before = head_.load(std::memory_order_acquire);
+      if (!(before & kClaimedBit)) {
+        const idxts_t result(published_index_.load(std::memory_order_relaxed),
+                             std::chrono::microseconds(published_us_.load(std::memory_order_relaxed)));
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (head_.load(std::memory_order_relaxed) == before) {
+          return result;
+        }
+      }
+      Backoff(spins);
+    }
+  }
+
+  // The thread which exports the ready messages from the tail of the buffer and feeds them to the consumer.
+  void ConsumerThread() {
+    uint64_t tail = 0u;
+    size_t spins = 0u;
+    while (true) {
+      Entry& entry = circular_buffer_[tail % circular_buffer_size_];
+      if (entry.sequence.load(std::memory_order_acquire) == tail + 1u) {
+        consumer_(std::move(entry.message_body), entry.index_timestamp, LastIndexAndTimestamp());
+        entry.sequence.store(tail + circular_buffer_size_, std::memory_order_release);
+        ++tail;
+        spins = 0u;
+        if (!DROP_ON_OVERFLOW) {
+          // Need to notify message publishers that, in case they were waiting, a new slot is now available.
+          std::atomic_thread_fence(std::memory_order_seq_cst);
+          if (publishers_waiting_.load(std::memory_order_relaxed)) {
+            std::lock_guard<std::mutex> lock(mutex_);
+            publishers_condition_variable_.notify_all();
+          }
+        }
+      } else if (destructing_.load()) {
+        // Do not leave behind the messages the slots for which are allocated, but not yet committed.
+        if (tail == AllocatedHead()) {
+          return;
+        }
+        Backoff(spins);
+      } else if (BUSY_SPIN || ++spins < kMMQSpinIterationsBeforeSleeping) {
+        Pause();
+      } else {
+        std::unique_lock<std::mutex> lock(mutex_);
+        consumer_waiting_.store(true, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        consumer_condition_variable_.wait(lock, [this, &entry, tail] {
+          return entry.sequence.load(std::memory_order_acquire) == tail + 1u || destructing_.load();
+        });
+        consumer_waiting_.store(false, std::memory_order_relaxed);
+        spins = 0u;
+      }
+    }
+  }
+
+  // The instance of the consuming side of the FIFO buffer.
+  consumer_t& consumer_;
+
+  // The capacity of the circular buffer.
+  const size_t circular_buffer_size_;
+  std::vector<Entry> circular_buffer_;
+
+  // The position of the next message to publish, with `kClaimedBit` set while a publisher is assigning
+  // the index and the timestamp. Also serves as the seqlock sequence for `published_{index,us}_`.
+  alignas(kMMQCacheLineSize) std::atomic<uint64_t> head_{0u};
+  idxts_t last_idx_ts_ = idxts_t(0, std::chrono::microseconds(-1));  // Only accessed while the head is claimed.
+  std::atomic<uint64_t> published_index_{0u};
+  std::atomic<int64_t> published_us_{-1};
+
+  // The slow path, for the consumer to sleep when the buffer is empty, and for the publishers
+  // to sleep when it is full.
+  alignas(kMMQCacheLineSize) std::atomic_bool consumer_waiting_{false};
+  std::atomic<size_t> publishers_waiting_{0u};
+  std::atomic_bool destructing_{false};
+  std::mutex mutex_;
+  std::condition_variable consumer_condition_variable_;
+  std::condition_variable publishers_condition_variable_;
+
+  // The thread in which the consuming process is running.
+  std::thread consumer_thread_;
+};
+
+}  // namespace mmq
+}  // namespace current
+
+#endif  // BLOCKS_MMQ_LOCK_FREE_MMQ_H
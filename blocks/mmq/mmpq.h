@@ -26,12 +26,17 @@ SOFTWARE.
 #define BLOCKS_MMQ_MMPQ_H
 
 // MMPQ is an in-memory priority queue, with the external interface loosely resembling the one of the original MMQ.
+//
+// The entries are kept in a binary heap, ordered by their timestamps, and then by their indexes. The consumer thread
+// takes all the entries that are ready, i.e. not past the head, off the heap at once, and passes them on to the
+// consumer with the mutex released, so that the publishers are not blocked while the consumer is processing them.
 
+#include <algorithm>
 #include <chrono>
 #include <condition_variable>
 #include <mutex>
 #include <thread>
-#include <set>
+#include <vector>
 
 #include "../ss/ss.h"
 
@@ -52,7 +57,9 @@ class MMPQImpl {
   // by the instance of MMPQImpl. See "blocks/ss/ss.h" and its test for possible callee signatures.
   using consumer_t = CONSUMER;
 
-  MMPQImpl(consumer_t& consumer) : consumer_(consumer), consumer_thread_(&MMPQImpl::ConsumerThread, this) {
+  MMPQImpl(consumer_t& consumer) : consumer_(consumer) {
+    queue_.reserve(DEFAULT_BUFFER_SIZE);
+    consumer_thread_ = std::thread(&MMPQImpl::ConsumerThread, this);
     consumer_thread_created_ = true;
   }
 
@@ -80,8 +87,12 @@ class MMPQImpl {
     // Does not update `last_idx_ts_.us` at all. `UpdateHead()` must be called.
     // This is to ensure the regular `Publish`, coming through the interface defined in `Blocks/ss/pubsub.h`,
     // can publish into the future and utilize the full power of MMPQ.
-    queue_.emplace(std::forward<E>(entry), idxts_t(last_idx_ts_.index, us));
-    condition_variable_.notify_all();
+    queue_.emplace_back(std::forward<E>(entry), idxts_t(last_idx_ts_.index, us));
+    std::push_heap(queue_.begin(), queue_.end(), EntryComesLater());
+    // Only wake up the consumer if it has something to do, the entries published into the future have to wait.
+    if (us <= last_idx_ts_.us) {
+      condition_variable_.notify_one();
+    }
     return last_idx_ts_;
   }
 
@@ -95,7 +106,9 @@ class MMPQImpl {
       CURRENT_THROW(ss::InconsistentTimestampException(last_idx_ts_.us + std::chrono::microseconds(1), us));
     }
     last_idx_ts_.us = us;
-    condition_variable_.notify_all();
+    if (HasReadyEntries()) {
+      condition_variable_.notify_one();
+    }
   }
 
  private:
@@ -104,21 +117,37 @@ class MMPQImpl {
   void operator=(const MMPQImpl&) = delete;
   void operator=(MMPQImpl&&) = delete;
 
+  // Must be called from a locked section.
+  bool HasReadyEntries() const { return !queue_.empty() && queue_.front().index_timestamp.us <= last_idx_ts_.us; }
+
   void ConsumerThread() {
+    // The ready entries are moved here, to be passed to the consumer outside the locked section.
+    // The vector is reused, so that, once it has grown large enough, no allocations happen per batch.
+    std::vector<Entry> batch;
+    batch.reserve(DEFAULT_BUFFER_SIZE);
     while (true) {
-      std::unique_lock<std::mutex> lock(mutex_);
+      idxts_t last;
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+
+        condition_variable_.wait(lock, [this] { return HasReadyEntries() || destructing_; });
 
-      condition_variable_.wait(lock, [this] {
-        return (!queue_.empty() && queue_.begin()->index_timestamp.us <= last_idx_ts_.us) || destructing_;
-      });
+        if (destructing_) {
+          return;  // LCOV_EXCL_LINE
+        }
 
-      if (destructing_) {
-        return;  // LCOV_EXCL_LINE
+        do {
+          std::pop_heap(queue_.begin(), queue_.end(), EntryComesLater());
+          batch.push_back(std::move(queue_.back()));
+          queue_.pop_back();
+        } while (HasReadyEntries());
+        last = last_idx_ts_;
       }
 
-      auto it = queue_.begin();
-      consumer_(std::move(const_cast<Entry&>(*it).message_body), it->index_timestamp, last_idx_ts_);
-      queue_.erase(it);
+      for (Entry& e : batch) {
+        consumer_(std::move(e.message_body), e.index_timestamp, last);
+      }
+      batch.clear();
     }
   }
 
@@ -133,12 +162,24 @@ class MMPQImpl {
     message_t message_body;
     Entry() = default;
     Entry(Entry&&) = default;
+    Entry& operator=(Entry&&) = default;
     Entry(message_t&& message_body, idxts_t index_timestamp)
         : index_timestamp(index_timestamp), message_body(std::move(message_body)) {}
-    bool operator<(const Entry& rhs) const { return index_timestamp.us < rhs.index_timestamp.us; }
   };
 
-  std::set<Entry> queue_;
+  // The order of the heap. The entries published at the same timestamp are passed on in the order of publishing.
+  struct EntryComesLater {
+    bool operator()(const Entry& lhs, const Entry& rhs) const {
+      if (lhs.index_timestamp.us != rhs.index_timestamp.us) {
+        return lhs.index_timestamp.us > rhs.index_timestamp.us;
+      } else {
+        return lhs.index_timestamp.index > rhs.index_timestamp.index;
+      }
+    }
+  };
+
+  // The binary heap of the entries, with the earliest one at the front.
+  std::vector<Entry> queue_;
   idxts_t last_idx_ts_ = idxts_t(0, std::chrono::microseconds(-1));
   std::mutex mutex_;
   std::condition_variable condition_variable_;
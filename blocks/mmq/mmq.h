@@ -54,6 +54,8 @@ SOFTWARE.
 #include <type_traits>
 #include <vector>
 
+#include "lock_free_mmq.h"
+
 #include "../ss/ss.h"
 
 #include "../../bricks/time/chrono.h"
@@ -273,8 +275,26 @@ class MMQImpl {
   std::thread consumer_thread_;
 };
 
-template <typename MESSAGE, typename CONSUMER, size_t DEFAULT_BUFFER_SIZE = 1024, bool DROP_ON_OVERFLOW = false>
-using MMQ = ss::EntryPublisher<MMQImpl<MESSAGE, CONSUMER, DEFAULT_BUFFER_SIZE, DROP_ON_OVERFLOW>, MESSAGE>;
+// The `CONCURRENCY` template argument selects between the mutex-based `MMQImpl` above (the default),
+// and the ring from "lock_free_mmq.h", for many publishers or for a single one. The ring takes no mutex on the hot
+// path, although with many publishers they briefly claim its head in turn, see the comment in "lock_free_mmq.h".
+// `BUSY_SPIN` only applies to the lock-free ring, and makes its consumer thread never go to sleep.
+template <typename MESSAGE,
+          typename CONSUMER,
+          size_t DEFAULT_BUFFER_SIZE = 1024,
+          bool DROP_ON_OVERFLOW = false,
+          MMQConcurrency CONCURRENCY = MMQConcurrency::Mutex,
+          bool BUSY_SPIN = false>
+using MMQ = ss::EntryPublisher<
+    std::conditional_t<CONCURRENCY == MMQConcurrency::Mutex,
+                       MMQImpl<MESSAGE, CONSUMER, DEFAULT_BUFFER_SIZE, DROP_ON_OVERFLOW>,
+                       LockFreeMMQImpl<MESSAGE,
+                                       CONSUMER,
+                                       DEFAULT_BUFFER_SIZE,
+                                       DROP_ON_OVERFLOW,
+                                       CONCURRENCY == MMQConcurrency::LockFreeSPSC,
+                                       BUSY_SPIN>>,
+    MESSAGE>;
 
 }  // namespace mmq
 }  // namespace current
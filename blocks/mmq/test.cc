@@ -219,6 +219,85 @@ TEST(InMemoryMQ, WaitOnOverflowTest) {
   EXPECT_EQ(100u, std::set<std::string>(c.messages_.begin(), c.messages_.end()).size());
 }
 
+template <current::mmq::MMQConcurrency CONCURRENCY, bool BUSY_SPIN = false>
+void RunLockFreeDropOnOverflowTest() {
+  SuspendableConsumer c;
+  MMQ<std::string, SuspendableConsumer, 10, true, CONCURRENCY, BUSY_SPIN> mmq(c);
+  static_assert(current::ss::IsEntryPublisher<decltype(mmq), std::string>::value, "");
+
+  c.suspend_processing_ = true;
+  size_t messages_accepted = 0u;
+  for (size_t i = 0; i < 25; ++i) {
+    if (mmq.Publish(current::strings::Printf("M%02d", static_cast<int>(i))).index) {
+      ++messages_accepted;
+    }
+  }
+  EXPECT_EQ(10u, messages_accepted);
+
+  c.suspend_processing_ = false;
+  while (c.processed_messages_ != 10u) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(11u, mmq.Publish("Plus one").index);
+  while (c.processed_messages_ != 11u) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ(11u, c.total_messages_accepted_by_the_queue_);
+  EXPECT_EQ("M00,M01,M02,M03,M04,M05,M06,M07,M08,M09,Plus one", current::strings::Join(c.messages_, ','));
+}
+
+template <current::mmq::MMQConcurrency CONCURRENCY, bool BUSY_SPIN = false>
+void RunLockFreeWaitOnOverflowTest(size_t producers_count) {
+  SuspendableConsumer c;
+  c.SetProcessingDelayMillis(1u);
+  {
+    MMQ<std::string, SuspendableConsumer, 10, false, CONCURRENCY, BUSY_SPIN> mmq(c);
+    const auto producer = [&](char prefix, size_t count) {
+      for (size_t i = 0; i < count; ++i) {
+        mmq.Publish(current::strings::Printf("%c%02d", prefix, static_cast<int>(i)));
+      }
+    };
+    std::vector<std::thread> producers;
+    for (size_t i = 0; i < producers_count; ++i) {
+      producers.emplace_back(producer, static_cast<char>('a' + i), 100u / producers_count);
+    }
+    for (auto& p : producers) {
+      p.join();
+    }
+    EXPECT_GE(c.processed_messages_, 90u);
+    // The destructor of the lock-free MMQ waits for all the committed messages to be exported.
+  }
+  EXPECT_EQ(100u, c.processed_messages_);
+  EXPECT_EQ(100u, c.total_messages_accepted_by_the_queue_);
+  EXPECT_EQ(100u, std::set<std::string>(c.messages_.begin(), c.messages_.end()).size());
+}
+
+TEST(InMemoryMQ, LockFree) {
+  using current::mmq::MMQConcurrency;
+
+  current::time::ResetToZero();
+  RunLockFreeDropOnOverflowTest<MMQConcurrency::LockFreeMPSC>();
+  RunLockFreeDropOnOverflowTest<MMQConcurrency::LockFreeSPSC>();
+  RunLockFreeDropOnOverflowTest<MMQConcurrency::LockFreeMPSC, true>();
+
+  RunLockFreeWaitOnOverflowTest<MMQConcurrency::LockFreeMPSC>(10u);
+  RunLockFreeWaitOnOverflowTest<MMQConcurrency::LockFreeSPSC>(1u);
+  RunLockFreeWaitOnOverflowTest<MMQConcurrency::LockFreeSPSC, true>(1u);
+
+  {
+    SuspendableConsumer c;
+    MMQ<std::string, SuspendableConsumer, 1024, false, MMQConcurrency::LockFreeMPSC> mmq(c);
+    EXPECT_EQ(1u, mmq.Publish("one", std::chrono::microseconds(1)).index);
+    EXPECT_EQ(2u, mmq.Publish("three", std::chrono::microseconds(3)).index);
+    ASSERT_THROW(mmq.Publish("two", std::chrono::microseconds(2)), current::ss::InconsistentTimestampException);
+    EXPECT_EQ(3u, mmq.Publish("four", std::chrono::microseconds(4)).index);
+    while (c.processed_messages_ != 3u) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ("one,three,four", current::strings::Join(c.messages_, ','));
+  }
+}
+
 TEST(InMemoryMQ, TimeShouldNotGoBack) {
   current::time::ResetToZero();
 
@@ -413,3 +492,50 @@ TEST(InMemoryMQ, MMPQSupportsUpdateHead) {
   EXPECT_EQ("three @ 3, seven @ 7, ace @ 100, king @ 101, queen @ 102, jack @ 103, joker @ 1000",
             current::strings::Join(c.messages_by_timestamps_, ", "));
 }
+
+TEST(InMemoryMQ, MMPQDoesNotBlockPublishersWhileConsuming) {
+  current::time::ResetToZero();
+
+  struct ConsumerImpl {
+    std::vector<std::string> messages_by_indexes_;
+    std::atomic_size_t processed_messages_;
+    std::atomic_bool consumer_entered_;
+    std::atomic_bool suspend_processing_;
+    ConsumerImpl() : processed_messages_(0u), consumer_entered_(false), suspend_processing_(true) {}
+    EntryResponse operator()(const std::string& s, idxts_t idxts, idxts_t) {
+      consumer_entered_ = true;
+      while (suspend_processing_) {
+        std::this_thread::yield();
+      }
+      messages_by_indexes_.push_back("[" + current::ToString(idxts.index) + "] = " + s);
+      ++processed_messages_;
+      return EntryResponse::More;
+    }
+  };
+
+  using Consumer = current::ss::EntrySubscriber<ConsumerImpl, std::string>;
+
+  Consumer c;
+  MMPQ<std::string, Consumer> mmpq(c);
+
+  mmpq.Publish("one", std::chrono::microseconds(1));
+  mmpq.UpdateHead(std::chrono::microseconds(1));
+  while (!c.consumer_entered_) {
+    std::this_thread::yield();
+  }
+
+  // The consumer is stuck processing "one", yet publishing and updating the head are not blocked.
+  // The entries published at the same timestamp are all passed on, in the order they were published in.
+  mmpq.Publish("three", std::chrono::microseconds(3));
+  mmpq.Publish("two", std::chrono::microseconds(2));
+  mmpq.Publish("two again", std::chrono::microseconds(2));
+  mmpq.UpdateHead(std::chrono::microseconds(3));
+  EXPECT_EQ(0u, c.processed_messages_);
+
+  c.suspend_processing_ = false;
+  while (c.processed_messages_ != 4) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ("[1] = one, [3] = two, [4] = two again, [2] = three",
+            current::strings::Join(c.messages_by_indexes_, ", "));
+}
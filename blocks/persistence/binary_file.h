@@ -0,0 +1,776 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// A binary sibling of the file-based persister from `file.h`: same append-only single file, same semantics,
+// but with length-prefixed, CRC-checked records instead of JSON lines.
+//
+// The file begins with an eight-byte magic, followed by the records. Each record is a `uint32_t` payload size,
+// a `uint32_t` CRC32 of the payload, and the payload itself, the first byte of which is the type of the record:
+// * 'S': the JSON-serialized `ss::StreamSignature`, always the very first record,
+// * 'E': the `uint64_t` index and the `int64_t` timestamp, followed by the entry in `SaveIntoBinary()` format,
+// * 'H': the `int64_t` head timestamp; the trailing head record is rewritten in place on further head updates.
+//
+// At startup the file is scanned through a read-only memory map. The scan validates the CRCs, the indexes,
+// and the timestamps of all the records, without allocating memory per record and without parsing the entries.
+// Iterators read the records directly from a shared memory map of the file, which is re-created with room
+// to grow as the file is being appended to. Iterators never outlive the persister.
+
+#ifndef BLOCKS_PERSISTENCE_BINARY_FILE_H
+#define BLOCKS_PERSISTENCE_BINARY_FILE_H
+
+#include <atomic>
+#include <cstring>
+#include <fstream>
+#include <memory>
+#include <mutex>
+
+#ifndef CURRENT_WINDOWS
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+#endif  // CURRENT_WINDOWS
+
+#include "exceptions.h"
+#include "file.h"  // `MakeSureTheRightTypeIsSerialized`.
+
+#include "../ss/persister.h"
+#include "../ss/signature.h"
+
+#include "../../bricks/file/file.h"
+#include "../../bricks/strings/printf.h"
+#include "../../bricks/sync/locks.h"
+#include "../../bricks/sync/owned_borrowed.h"
+#include "../../bricks/time/chrono.h"
+#include "../../bricks/util/atomic_that_works.h"
+#include "../../bricks/util/crc32.h"
+#include "../../typesystem/schema/schema.h"
+#include "../../typesystem/serialization/binary.h"
+#include "../../typesystem/serialization/json.h"
+
+namespace current {
+namespace persistence {
+
+namespace impl {
+
+namespace constants {
+constexpr char kBinaryFileMagic[] = "C5T:BIN1";
+constexpr size_t kBinaryFileMagicSize = sizeof(kBinaryFileMagic) - 1u;
+constexpr char kBinaryRecordSignature = 'S';
+constexpr char kBinaryRecordEntry = 'E';
+constexpr char kBinaryRecordHead = 'H';
+constexpr size_t kBinaryEntryPayloadPrefixSize = sizeof(char) + sizeof(uint64_t) + sizeof(int64_t);
+constexpr size_t kBinaryHeadPayloadSize = sizeof(char) + sizeof(int64_t);
+}  // namespace constants
+
+struct BinaryRecordHeader {
+  uint32_t payload_size;
+  uint32_t payload_crc32;
+};
+static_assert(sizeof(BinaryRecordHeader) == 8, "");
+
+inline BinaryRecordHeader BinaryRecordHeaderAt(const char* record) {
+  BinaryRecordHeader header;
+  std::memcpy(&header, record, sizeof(header));
+  return header;
+}
+
+template <typename T>
+inline T BinaryPODAt(const char* data) {
+  T value;
+  std::memcpy(&value, data, sizeof(T));
+  return value;
+}
+
+template <typename T>
+inline void AppendBinaryPOD(std::string& output, T value) {
+  output.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+// Fills in the size and the CRC32 of the payload, which begins right after the header placeholder in `record`.
+inline void FrameBinaryRecord(std::string& record) {
+  BinaryRecordHeader header;
+  header.payload_size = static_cast<uint32_t>(record.length() - sizeof(BinaryRecordHeader));
+  header.payload_crc32 = CRC32(0u, record.data() + sizeof(BinaryRecordHeader), header.payload_size);
+  std::memcpy(&record[0], &header, sizeof(header));
+}
+
+// A read-only view of the first `Capacity()` bytes of a file. The capacity may exceed the size of the file:
+// only the bytes already written may be accessed, and the bytes appended later become visible as they are written.
+class ReadOnlyFileMapping final {
+ public:
+  ReadOnlyFileMapping(const std::string& filename, size_t capacity) {
+#ifndef CURRENT_WINDOWS
+    if (capacity) {
+      const int fd = ::open(filename.c_str(), O_RDONLY);
+      if (fd < 0) {
+        CURRENT_THROW(CannotReadFileException(filename));
+      }
+      void* data = ::mmap(nullptr, capacity, PROT_READ, MAP_SHARED, fd, 0);
+      ::close(fd);
+      if (data == MAP_FAILED) {
+        CURRENT_THROW(CannotReadFileException(filename));
+      }
+      data_ = static_cast<const char*>(data);
+      capacity_ = capacity;
+    }
+#else
+    // No `mmap()`, so just read the file, which is guaranteed to be at least `capacity` bytes long by now.
+    static_cast<void>(capacity);
+    contents_ = FileSystem::ReadFileAsString(filename);
+    data_ = contents_.data();
+    capacity_ = contents_.length();
+#endif  // CURRENT_WINDOWS
+  }
+
+  ~ReadOnlyFileMapping() {
+#ifndef CURRENT_WINDOWS
+    if (capacity_) {
+      ::munmap(const_cast<char*>(data_), capacity_);
+    }
+#endif  // CURRENT_WINDOWS
+  }
+
+  ReadOnlyFileMapping(const ReadOnlyFileMapping&) = delete;
+  ReadOnlyFileMapping& operator=(const ReadOnlyFileMapping&) = delete;
+
+  const char* Data() const { return data_; }
+  size_t Capacity() const { return capacity_; }
+
+ private:
+  const char* data_ = nullptr;
+  size_t capacity_ = 0u;
+#ifdef CURRENT_WINDOWS
+  std::string contents_;
+#endif  // CURRENT_WINDOWS
+};
+
+// A zero-copy view of a persisted entry. The `[data, data + size)` range holds the binary-serialized entry.
+struct BinaryEntryView {
+  idxts_t idx_ts;
+  const char* data;
+  size_t size;
+};
+
+// Walks the entry records of a mapped file, skipping the head records between them.
+class BinaryEntryRecordCursor final {
+ public:
+  BinaryEntryRecordCursor(std::shared_ptr<const ReadOnlyFileMapping> mapping, uint64_t offset)
+      : mapping_(std::move(mapping)), offset_(offset) {}
+
+  BinaryEntryView Current() {
+    SkipHeadRecords();
+    const char* record = mapping_->Data() + offset_;
+    const auto header = BinaryRecordHeaderAt(record);
+    const char* payload = record + sizeof(BinaryRecordHeader);
+    CURRENT_ASSERT(payload[0] == constants::kBinaryRecordEntry);
+    BinaryEntryView result;
+    result.idx_ts.index = BinaryPODAt<uint64_t>(payload + sizeof(char));
+    result.idx_ts.us = std::chrono::microseconds(BinaryPODAt<int64_t>(payload + sizeof(char) + sizeof(uint64_t)));
+    result.data = payload + constants::kBinaryEntryPayloadPrefixSize;
+    result.size = header.payload_size - constants::kBinaryEntryPayloadPrefixSize;
+    return result;
+  }
+
+  void Next() {
+    SkipHeadRecords();
+    offset_ += sizeof(BinaryRecordHeader) + BinaryRecordHeaderAt(mapping_->Data() + offset_).payload_size;
+  }
+
+ private:
+  void SkipHeadRecords() {
+    while (mapping_->Data()[offset_ + sizeof(BinaryRecordHeader)] == constants::kBinaryRecordHead) {
+      offset_ += sizeof(BinaryRecordHeader) + constants::kBinaryHeadPayloadSize;
+    }
+  }
+
+  std::shared_ptr<const ReadOnlyFileMapping> mapping_;
+  uint64_t offset_;
+};
+
+// The implementation of a persister based exclusively on appending binary records to one file.
+template <typename ENTRY>
+class BinaryFilePersister {
+ protected:
+  // { last_published_index + 1, last_published_us, current_head_us }, or { 0, -1us, -1us } for an empty persister.
+  struct end_t {
+    uint64_t next_index;
+    std::chrono::microseconds last_entry_us;
+    std::chrono::microseconds head;
+  };
+  static_assert(sizeof(std::chrono::microseconds) == 8, "");
+
+ private:
+  struct BinaryFilePersisterImpl final {
+    const std::string filename_;
+    std::ofstream file_appender_;
+    std::fstream head_rewriter_;
+
+    // `record_offset_.size() == end.next_index`, and `record_offset_[i]` is where the record for index `i` begins.
+    std::mutex& publish_mutex_ref_;  // Guards all the fields below, except `end_` and `mapping_`.
+    std::vector<uint64_t> record_offset_;
+    std::vector<std::chrono::microseconds> record_timestamp_;
+    uint64_t head_offset_;  // The offset of the trailing head record, or zero if the last record is not a head one.
+    uint64_t file_size_;
+    std::string record_buffer_;  // Reused across the calls to avoid allocations.
+
+    // Just `std::atomic<end_t> end_;` won't work in g++ until 5.1, ref.
+    // http://stackoverflow.com/questions/29824570/segfault-in-stdatomic-load/29824840#29824840
+    // std::atomic<end_t> end_;
+    current::atomic_that_works<end_t> end_;
+
+    mutable std::mutex mapping_mutex_;  // Guards `mapping_`.
+    mutable std::shared_ptr<const ReadOnlyFileMapping> mapping_;
+
+    BinaryFilePersisterImpl() = delete;
+    BinaryFilePersisterImpl(const BinaryFilePersisterImpl&) = delete;
+    BinaryFilePersisterImpl(BinaryFilePersisterImpl&&) = delete;
+    BinaryFilePersisterImpl& operator=(const BinaryFilePersisterImpl&) = delete;
+    BinaryFilePersisterImpl& operator=(BinaryFilePersisterImpl&&) = delete;
+
+    BinaryFilePersisterImpl(std::mutex& publish_mutex_ref,
+                            const ss::StreamNamespaceName& namespace_name,
+                            const std::string& filename)
+        : filename_(filename),
+          file_appender_(filename, std::ofstream::binary | std::ofstream::app | std::ofstream::ate),
+          head_rewriter_(filename, std::ofstream::binary | std::ofstream::in | std::ofstream::out),
+          publish_mutex_ref_(publish_mutex_ref),
+          head_offset_(0u),
+          file_size_(0u) {
+      if (file_appender_.bad() || head_rewriter_.bad()) {
+        CURRENT_THROW(PersistenceFileNotWritable(filename));
+      }
+      ValidateFileAndInitializeHead(namespace_name);
+    }
+
+    // Scan the file without parsing the entries. Used to initialize `end_` at startup.
+    void ValidateFileAndInitializeHead(const ss::StreamNamespaceName& namespace_name) {
+      reflection::StructSchema struct_schema;
+      struct_schema.AddType<ENTRY>();
+      const auto signature = JSON(ss::StreamSignature(namespace_name, struct_schema.GetSchemaInfo()));
+
+      uint64_t next_index = 0u;
+      auto last_entry_us = std::chrono::microseconds(-1);
+      auto head = std::chrono::microseconds(-1);
+
+      file_size_ = FileSystem::GetFileSize(filename_);
+      if (!file_size_) {
+        // A new file, begin it with the magic and the signature.
+        file_appender_.write(constants::kBinaryFileMagic, constants::kBinaryFileMagicSize);
+        file_size_ = constants::kBinaryFileMagicSize;
+        record_buffer_.assign(sizeof(BinaryRecordHeader), '\0');
+        record_buffer_.push_back(constants::kBinaryRecordSignature);
+        record_buffer_.append(signature);
+        AppendRecord();
+      } else {
+        const ReadOnlyFileMapping mapping(filename_, static_cast<size_t>(file_size_));
+        const char* data = mapping.Data();
+        if (file_size_ < constants::kBinaryFileMagicSize ||
+            std::memcmp(data, constants::kBinaryFileMagic, constants::kBinaryFileMagicSize)) {
+          CURRENT_THROW(MalformedEntryException("Not a binary stream file: `" + filename_ + "`."));
+        }
+        uint64_t offset = constants::kBinaryFileMagicSize;
+        while (offset < file_size_) {
+          if (file_size_ - offset < sizeof(BinaryRecordHeader)) {
+            CURRENT_THROW(MalformedEntryException(
+                strings::Printf("Truncated record header at offset %lld.", static_cast<long long>(offset))));
+          }
+          const auto header = BinaryRecordHeaderAt(data + offset);
+          if (!header.payload_size || file_size_ - offset - sizeof(BinaryRecordHeader) < header.payload_size) {
+            CURRENT_THROW(MalformedEntryException(
+                strings::Printf("Truncated record at offset %lld.", static_cast<long long>(offset))));
+          }
+          const char* payload = data + offset + sizeof(BinaryRecordHeader);
+          if (CRC32(0u, payload, header.payload_size) != header.payload_crc32) {
+            CURRENT_THROW(MalformedEntryException(
+                strings::Printf("CRC mismatch in the record at offset %lld.", static_cast<long long>(offset))));
+          }
+          const char type = payload[0];
+          if (offset == constants::kBinaryFileMagicSize && type != constants::kBinaryRecordSignature) {
+            CURRENT_THROW(InvalidStreamSignature(signature, ""));
+          }
+          if (type == constants::kBinaryRecordEntry) {
+            if (header.payload_size < constants::kBinaryEntryPayloadPrefixSize) {
+              CURRENT_THROW(MalformedEntryException(
+                  strings::Printf("Malformed entry record at offset %lld.", static_cast<long long>(offset))));
+            }
+            const auto index = BinaryPODAt<uint64_t>(payload + sizeof(char));
+            const auto us =
+                std::chrono::microseconds(BinaryPODAt<int64_t>(payload + sizeof(char) + sizeof(uint64_t)));
+            if (index != next_index) {
+              // Indexes must be strictly continuous.
+              CURRENT_THROW(ss::InconsistentIndexException(next_index, index));
+            }
+            if (!(us > head)) {
+              // Timestamps must strictly increase.
+              CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), us));
+            }
+            record_offset_.push_back(offset);
+            record_timestamp_.push_back(us);
+            ++next_index;
+            last_entry_us = head = us;
+            head_offset_ = 0u;
+          } else if (type == constants::kBinaryRecordHead) {
+            if (header.payload_size != constants::kBinaryHeadPayloadSize) {
+              CURRENT_THROW(MalformedEntryException(
+                  strings::Printf("Malformed head record at offset %lld.", static_cast<long long>(offset))));
+            }
+            const auto us = std::chrono::microseconds(BinaryPODAt<int64_t>(payload + sizeof(char)));
+            if (!(us > head)) {
+              CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), us));
+            }
+            head = us;
+            head_offset_ = offset;
+          } else if (type == constants::kBinaryRecordSignature) {
+            // The signature should be at the beginning of the file.
+            if (offset != constants::kBinaryFileMagicSize) {
+              CURRENT_THROW(InvalidSignatureLocation());
+            }
+            if (signature.compare(0, std::string::npos, payload + sizeof(char), header.payload_size - sizeof(char))) {
+              CURRENT_THROW(
+                  InvalidStreamSignature(signature, std::string(payload + sizeof(char), header.payload_size - 1u)));
+            }
+          } else {
+            CURRENT_THROW(MalformedEntryException(
+                strings::Printf("Unknown record type at offset %lld.", static_cast<long long>(offset))));
+          }
+          offset += sizeof(BinaryRecordHeader) + header.payload_size;
+        }
+      }
+      end_.store({next_index, last_entry_us, head});
+    }
+
+    // Appends the framed `record_buffer_` to the file. The caller should hold `publish_mutex_ref_`.
+    void AppendRecord() {
+      FrameBinaryRecord(record_buffer_);
+      file_appender_.write(record_buffer_.data(), static_cast<std::streamsize>(record_buffer_.length()));
+      file_appender_.flush();
+      file_size_ += record_buffer_.length();
+    }
+
+    // The caller should hold `publish_mutex_ref_`.
+    // The `serialized_entry` is the entry in the `SaveIntoBinary()` format.
+    void AppendEntryRecord(const idxts_t& idxts, const std::string& serialized_entry) {
+      CURRENT_ASSERT(record_offset_.size() == idxts.index);
+      CURRENT_ASSERT(record_timestamp_.size() == idxts.index);
+      record_buffer_.assign(sizeof(BinaryRecordHeader), '\0');
+      record_buffer_.push_back(constants::kBinaryRecordEntry);
+      AppendBinaryPOD(record_buffer_, static_cast<uint64_t>(idxts.index));
+      AppendBinaryPOD(record_buffer_, static_cast<int64_t>(idxts.us.count()));
+      record_buffer_.append(serialized_entry);
+      record_offset_.push_back(file_size_);
+      record_timestamp_.push_back(idxts.us);
+      AppendRecord();
+      head_offset_ = 0u;
+    }
+
+    // Returns a mapping of the file covering at least its first `size` bytes, re-mapping the file if necessary.
+    std::shared_ptr<const ReadOnlyFileMapping> MappingCovering(uint64_t size) const {
+      std::lock_guard<std::mutex> lock(mapping_mutex_);
+      if (!mapping_ || mapping_->Capacity() < size) {
+        // Leave room to grow, to not re-map the file on every new iteration over a stream being appended to.
+        const uint64_t capacity = std::max(size, static_cast<uint64_t>(mapping_ ? mapping_->Capacity() * 2u : 0u));
+        mapping_ = std::make_shared<ReadOnlyFileMapping>(filename_, static_cast<size_t>(capacity));
+      }
+      return mapping_;
+    }
+  };
+
+ public:
+  BinaryFilePersister() = delete;
+  BinaryFilePersister(const BinaryFilePersister&) = delete;
+  BinaryFilePersister(BinaryFilePersister&&) = delete;
+  BinaryFilePersister& operator=(const BinaryFilePersister&) = delete;
+  BinaryFilePersister& operator=(BinaryFilePersister&&) = delete;
+
+  BinaryFilePersister(std::mutex& publish_mutex_ref,
+                      const ss::StreamNamespaceName& namespace_name,
+                      const std::string& filename)
+      : file_persister_impl_(MakeOwned<BinaryFilePersisterImpl>(publish_mutex_ref, namespace_name, filename)) {}
+
+  class Iterator final {
+   public:
+    struct Entry {
+      idxts_t idx_ts;
+      ENTRY entry;
+    };
+
+    Iterator() = delete;
+    Iterator(const Iterator&) = delete;
+    Iterator& operator=(const Iterator&) = delete;
+
+    Iterator(Iterator&&) = default;
+    Iterator& operator=(Iterator&&) = default;
+
+    Iterator(Borrowed<BinaryFilePersisterImpl> file_persister_impl,
+             std::shared_ptr<const ReadOnlyFileMapping> mapping,
+             uint64_t i,
+             uint64_t offset)
+        : file_persister_impl_(std::move(file_persister_impl)), i_(i) {
+      if (mapping) {
+        cursor_ = std::make_unique<BinaryEntryRecordCursor>(std::move(mapping), offset);
+      }
+    }
+
+    // The zero-copy view of the current entry, valid for as long as this iterator is.
+    BinaryEntryView View() const {
+      const auto result = cursor_->Current();
+      if (result.idx_ts.index != i_) {
+        CURRENT_THROW(ss::InconsistentIndexException(i_, result.idx_ts.index));  // LCOV_EXCL_LINE
+      }
+      return result;
+    }
+
+    Entry operator*() const {
+      const auto view = View();
+      Entry result;
+      result.idx_ts = view.idx_ts;
+      LoadFromBinary(view.data, view.size, result.entry);
+      return result;
+    }
+
+    Iterator& operator++() {
+      // By convention, iterating over data, being an immutable operation, does not throw.
+      cursor_->Next();
+      ++i_;
+      return *this;
+    }
+    bool operator==(const Iterator& rhs) const { return i_ == rhs.i_; }
+    bool operator!=(const Iterator& rhs) const { return !operator==(rhs); }
+    operator bool() const { return file_persister_impl_; }
+
+   private:
+    const Borrowed<BinaryFilePersisterImpl> file_persister_impl_;
+    std::unique_ptr<BinaryEntryRecordCursor> cursor_;
+    uint64_t i_;
+  };
+
+  // Returns the entries in the same `idxts_t` JSON + TAB + entry JSON format as the text file persister does,
+  // as this is what the replicator and the HTTP subscribers expect.
+  class IteratorUnsafe final {
+   public:
+    IteratorUnsafe() = delete;
+    IteratorUnsafe(const IteratorUnsafe&) = delete;
+    IteratorUnsafe(IteratorUnsafe&&) = default;
+    IteratorUnsafe& operator=(const IteratorUnsafe&) = delete;
+    IteratorUnsafe& operator=(IteratorUnsafe&&) = default;
+
+    IteratorUnsafe(Borrowed<BinaryFilePersisterImpl> file_persister_impl,
+                   std::shared_ptr<const ReadOnlyFileMapping> mapping,
+                   uint64_t i,
+                   uint64_t offset)
+        : file_persister_impl_(std::move(file_persister_impl)), i_(i) {
+      if (mapping) {
+        cursor_ = std::make_unique<BinaryEntryRecordCursor>(std::move(mapping), offset);
+      }
+    }
+
+    std::string operator*() const {
+      const auto view = cursor_->Current();
+      CURRENT_ASSERT(view.idx_ts.index == i_);
+      return JSON(view.idx_ts) + '\t' + JSON(LoadFromBinary<ENTRY>(view.data, view.size));
+    }
+
+    IteratorUnsafe& operator++() {
+      cursor_->Next();
+      ++i_;
+      return *this;
+    }
+    bool operator==(const IteratorUnsafe& rhs) const { return i_ == rhs.i_; }
+    bool operator!=(const IteratorUnsafe& rhs) const { return !operator==(rhs); }
+    operator bool() const { return file_persister_impl_; }
+
+   private:
+    Borrowed<BinaryFilePersisterImpl> file_persister_impl_;
+    std::unique_ptr<BinaryEntryRecordCursor> cursor_;
+    uint64_t i_;
+  };
+
+  template <typename ITERATOR>
+  class IterableRangeImpl {
+   public:
+    IterableRangeImpl(Borrowed<BinaryFilePersisterImpl> file_persister_impl,
+                      uint64_t begin,
+                      uint64_t end,
+                      uint64_t begin_offset,
+                      uint64_t end_offset)
+        : file_persister_impl_(std::move(file_persister_impl)),
+          begin_(begin),
+          end_(end),
+          begin_offset_(begin_offset),
+          end_offset_(end_offset) {}
+
+    IterableRangeImpl(IterableRangeImpl&& rhs)
+        : file_persister_impl_(std::move(rhs.file_persister_impl_)),
+          begin_(rhs.begin_),
+          end_(rhs.end_),
+          begin_offset_(rhs.begin_offset_),
+          end_offset_(rhs.end_offset_) {}
+
+    ITERATOR begin() const {
+      // By convention, iterating over data, being an immutable operation, does not throw.
+      if (begin_ == end_) {
+        return ITERATOR(file_persister_impl_, nullptr, 0, 0);  // No need in mapping the file for a null iterator.
+      } else {
+        return ITERATOR(
+            file_persister_impl_, file_persister_impl_->MappingCovering(end_offset_), begin_, begin_offset_);
+      }
+    }
+    ITERATOR end() const {
+      // By convention, iterating over data, being an immutable operation, does not throw.
+      if (begin_ == end_) {
+        return ITERATOR(file_persister_impl_, nullptr, 0, 0);  // No need in mapping the file for a null iterator.
+      } else {
+        return ITERATOR(file_persister_impl_, nullptr, end_, 0);  // No need in mapping the file for `end`.
+      }
+    }
+
+    operator bool() const { return file_persister_impl_; }
+
+   private:
+    const Borrowed<BinaryFilePersisterImpl> file_persister_impl_;
+    const uint64_t begin_;
+    const uint64_t end_;
+    const uint64_t begin_offset_;
+    const uint64_t end_offset_;
+  };
+
+  // `TIMESTAMP` can be `std::chrono::microseconds` or `current::time::DefaultTimeArgument`.
+  template <current::locks::MutexLockStatus MLS, typename E, typename TIMESTAMP>
+  idxts_t PersisterPublishImpl(E&& entry, const TIMESTAMP provided_timestamp) {
+    // Serialize before taking the publish mutex, so that only the validation and the append happen under it.
+    // Explicit `MakeSureTheRightTypeIsSerialized` is essential, otherwise the `Variant`'s case
+    // would be serialized in an unwrapped way when passed directly.
+    thread_local std::string serialized_entry;
+    serialized_entry.clear();
+    SaveIntoBinary(serialized_entry,
+                   MakeSureTheRightTypeIsSerialized<ENTRY, decay_t<E>>::DoIt(std::forward<E>(entry)));
+
+    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+
+    end_t iterator = file_persister_impl_->end_.load();
+    const auto timestamp = current::time::TimestampAsMicroseconds(provided_timestamp);
+    if (!(timestamp > iterator.head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
+    }
+
+    iterator.last_entry_us = iterator.head = timestamp;
+    const auto idxts = idxts_t(iterator.next_index, iterator.last_entry_us);
+    file_persister_impl_->AppendEntryRecord(idxts, serialized_entry);
+    ++iterator.next_index;
+    file_persister_impl_->end_.store(iterator);
+
+    return idxts;
+  }
+
+  // The raw log line is in the `idxts_t` JSON + TAB + entry JSON format, and is stored in the binary one.
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PersisterPublishUnsafeImpl(const std::string& raw_log_line) {
+    // Parse and serialize before taking the publish mutex.
+    const auto tab_pos = raw_log_line.find('\t');
+    if (tab_pos == std::string::npos) {
+      CURRENT_THROW(MalformedEntryException(raw_log_line));
+    }
+    const idxts_t idxts = ParseJSON<idxts_t>(raw_log_line.c_str(), tab_pos);
+    std::string serialized_entry;
+    SaveIntoBinary(serialized_entry,
+                   ParseJSON<ENTRY>(raw_log_line.c_str() + tab_pos + 1u, raw_log_line.length() - tab_pos - 1u));
+
+    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+
+    end_t iterator = file_persister_impl_->end_.load();
+    if (idxts.index != iterator.next_index) {
+      CURRENT_THROW(UnsafePublishBadIndexTimestampException(iterator.next_index, idxts.index));
+    }
+    if (!(idxts.us > iterator.head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), idxts.us));
+    }
+
+    iterator.last_entry_us = iterator.head = idxts.us;
+    file_persister_impl_->AppendEntryRecord(idxts, serialized_entry);
+    ++iterator.next_index;
+    file_persister_impl_->end_.store(iterator);
+
+    return idxts;
+  }
+
+  template <current::locks::MutexLockStatus MLS, typename TIMESTAMP>
+  void PersisterUpdateHeadImpl(const TIMESTAMP provided_timestamp) {
+    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+
+    end_t iterator = file_persister_impl_->end_.load();
+    const auto timestamp = current::time::TimestampAsMicroseconds(provided_timestamp);
+    if (!(timestamp > iterator.head)) {
+      CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
+    }
+    iterator.head = timestamp;
+    auto& impl = *file_persister_impl_;
+    impl.record_buffer_.assign(sizeof(BinaryRecordHeader), '\0');
+    impl.record_buffer_.push_back(constants::kBinaryRecordHead);
+    AppendBinaryPOD(impl.record_buffer_, static_cast<int64_t>(timestamp.count()));
+    if (impl.head_offset_) {
+      FrameBinaryRecord(impl.record_buffer_);
+      impl.head_rewriter_.seekp(static_cast<std::streamoff>(impl.head_offset_), std::ios_base::beg);
+      impl.head_rewriter_.write(impl.record_buffer_.data(), static_cast<std::streamsize>(impl.record_buffer_.length()));
+      impl.head_rewriter_.flush();
+    } else {
+      impl.head_offset_ = impl.file_size_;
+      impl.AppendRecord();
+    }
+    impl.end_.store(iterator);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  bool PersisterEmptyImpl() const {
+    return !file_persister_impl_->end_.load().next_index;
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  uint64_t PersisterSizeImpl() const noexcept {
+    return file_persister_impl_->end_.load().next_index;
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  std::chrono::microseconds PersisterCurrentHeadImpl() const noexcept {
+    return file_persister_impl_->end_.load().head;
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PersisterLastPublishedIndexAndTimestampImpl() const {
+    const auto iterator = file_persister_impl_->end_.load();
+    if (iterator.next_index) {
+      return idxts_t(iterator.next_index - 1, iterator.last_entry_us);
+    } else {
+      CURRENT_THROW(NoEntriesPublishedYet());
+    }
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  head_optidxts_t PersisterHeadAndLastPublishedIndexAndTimestampImpl() const noexcept {
+    const auto iterator = file_persister_impl_->end_.load();
+    if (iterator.next_index) {
+      return head_optidxts_t(iterator.head, iterator.next_index - 1, iterator.last_entry_us);
+    } else {
+      return head_optidxts_t(iterator.head);
+    }
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  std::pair<uint64_t, uint64_t> PersisterIndexRangeByTimestampRangeImpl(std::chrono::microseconds from,
+                                                                        std::chrono::microseconds till) const {
+    std::pair<uint64_t, uint64_t> result{static_cast<uint64_t>(-1), static_cast<uint64_t>(-1)};
+    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+    const auto& record_timestamp = file_persister_impl_->record_timestamp_;
+    const auto begin_it = std::lower_bound(record_timestamp.begin(), record_timestamp.end(), from);
+    if (begin_it != record_timestamp.end()) {
+      result.first = std::distance(record_timestamp.begin(), begin_it);
+    }
+    if (till.count() > 0) {
+      const auto end_it = std::upper_bound(record_timestamp.begin(), record_timestamp.end(), till);
+      if (end_it != record_timestamp.end()) {
+        result.second = std::distance(record_timestamp.begin(), end_it);
+      }
+    }
+    return result;
+  }
+
+  using IterableRange = IterableRangeImpl<Iterator>;
+  using IterableRangeUnsafe = IterableRangeImpl<IteratorUnsafe>;
+
+  template <current::locks::MutexLockStatus MLS>
+  IterableRange PersisterIterate(uint64_t begin_index, uint64_t end_index) const {
+    return PersisterIterateImpl<MLS, IterableRange>(begin_index, end_index);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  IterableRangeUnsafe PersisterIterateUnsafe(uint64_t begin_index, uint64_t end_index) const {
+    return PersisterIterateImpl<MLS, IterableRangeUnsafe>(begin_index, end_index);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  IterableRange PersisterIterate(std::chrono::microseconds from, std::chrono::microseconds till) const {
+    return PersisterIterateImpl<MLS, IterableRange>(from, till);
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  IterableRangeUnsafe PersisterIterateUnsafe(std::chrono::microseconds from, std::chrono::microseconds till) const {
+    return PersisterIterateImpl<MLS, IterableRangeUnsafe>(from, till);
+  }
+
+ private:
+  template <current::locks::MutexLockStatus MLS, typename ITERABLE>
+  ITERABLE PersisterIterateImpl(uint64_t begin_index, uint64_t end_index) const {
+    // OK to only lock the mutex later, as `file_persister_impl_->end_` is an `atomic`.
+    const uint64_t current_size = file_persister_impl_->end_.load().next_index;
+    if (end_index == static_cast<uint64_t>(-1)) {
+      end_index = current_size;
+    }
+    if (end_index > current_size) {
+      CURRENT_THROW(InvalidIterableRangeException());
+    }
+    if (begin_index == end_index) {
+      return ITERABLE(file_persister_impl_, 0, 0, 0, 0);  // OK, even for an empty persister.
+    }
+    if (end_index < begin_index) {
+      CURRENT_THROW(InvalidIterableRangeException());
+    }
+
+    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+
+    // ">" is OK, as this call is multithreading-friendly, and more entries could have been added during this call.
+    CURRENT_ASSERT(file_persister_impl_->record_offset_.size() >= current_size);
+
+    return ITERABLE(file_persister_impl_,
+                    begin_index,
+                    end_index,
+                    file_persister_impl_->record_offset_[static_cast<size_t>(begin_index)],
+                    file_persister_impl_->file_size_);
+  }
+
+  template <current::locks::MutexLockStatus MLS, typename ITERABLE>
+  ITERABLE PersisterIterateImpl(std::chrono::microseconds from, std::chrono::microseconds till) const {
+    if (till.count() > 0 && till < from) {
+      CURRENT_THROW(InvalidIterableRangeException());
+    }
+
+    const auto index_range = PersisterIndexRangeByTimestampRangeImpl<MLS>(from, till);
+    if (index_range.first != static_cast<uint64_t>(-1)) {
+      return PersisterIterateImpl<MLS, ITERABLE>(index_range.first, index_range.second);
+    } else {  // No entries found in the requested range.
+      return ITERABLE(file_persister_impl_, 0, 0, 0, 0);
+    }
+  }
+
+ private:
+  Owned<BinaryFilePersisterImpl> file_persister_impl_;  // `Owned`, as iterators borrow it.
+};
+
+}  // namespace impl
+
+template <typename ENTRY>
+using BinaryFile = ss::EntryPersister<impl::BinaryFilePersister<ENTRY>, ENTRY>;
+
+}  // namespace persistence
+}  // namespace current
+
+#endif  // BLOCKS_PERSISTENCE_BINARY_FILE_H
@@ -27,13 +27,28 @@ SOFTWARE.
 // The file is replayed at startup to check its integriry and to extract the most recent index/timestamp.
 // Each iterator opens the same file again, to read its first N lines.
 // Iterators never outlive the persister.
+//
+// Optionally, with `SparseFileIndex`, only the offsets and timestamps of every Nth entry are kept in memory,
+// and are also persisted into a sidecar `<filename>.index` file. On restart, only the tail of the file past
+// the last persisted checkpoint is replayed, instead of the whole file.
+//
+// Optionally, with `FileDurability`, the entries are group-committed: accumulated in memory and appended
+// to the file in batches by a background thread, optionally followed by `fdatasync()`.
 
 #ifndef BLOCKS_PERSISTENCE_FILE_H
 #define BLOCKS_PERSISTENCE_FILE_H
 
+#include <algorithm>
 #include <atomic>
+#include <condition_variable>
 #include <fstream>
 #include <functional>
+#include <thread>
+
+#ifndef CURRENT_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // CURRENT_WINDOWS
 
 #ifdef CURRENT_BUILD_WITH_PARANOIC_RUNTIME_CHECKS
 #include <iostream>
@@ -54,6 +69,47 @@ SOFTWARE.
 namespace current {
 namespace persistence {
 
+// Passed as the last constructor argument of the `File` persister to enable the sparse index.
+struct SparseFileIndex {
+  uint64_t every_n_entries;
+  explicit SparseFileIndex(uint64_t every_n_entries = 1000u) : every_n_entries(every_n_entries) {
+    CURRENT_ASSERT(every_n_entries > 0u);
+  }
+};
+
+// Passed as the last constructor argument of the `File` persister to trade publishing latency for fewer syscalls.
+// * `FlushPerEntry`, the default, writes and flushes every entry as it is published.
+// * `GroupCommit` accumulates the entries in memory, and a background thread appends them to the file with a single
+//   `write()` once `max_entries_per_batch` entries are pending, or once `max_batch_delay` has passed.
+// * `FDataSyncPerBatch` also `fdatasync()`-s the file after each batch.
+// The iterators and the subscribers only see the entries already written into the file, and, with `strict`,
+// only the entries `fdatasync()`-ed to disk.
+struct FileDurability {
+  enum class Policy : int { FlushPerEntry = 0, GroupCommit = 1, FDataSyncPerBatch = 2 };
+  Policy policy = Policy::FlushPerEntry;
+  uint64_t max_entries_per_batch = 1000u;
+  std::chrono::microseconds max_batch_delay = std::chrono::milliseconds(1);
+  bool strict = false;
+
+  FileDurability() = default;
+  explicit FileDurability(Policy policy) : policy(policy) {}
+
+  FileDurability& SetMaxEntriesPerBatch(uint64_t value) {
+    CURRENT_ASSERT(value > 0u);
+    max_entries_per_batch = value;
+    return *this;
+  }
+  FileDurability& SetMaxBatchDelay(std::chrono::microseconds value) {
+    CURRENT_ASSERT(value.count() > 0);
+    max_batch_delay = value;
+    return *this;
+  }
+  FileDurability& SetStrict(bool value = true) {
+    strict = value;
+    return *this;
+  }
+};
+
 namespace impl {
 
 namespace constants {
@@ -61,6 +117,8 @@ constexpr char kDirectiveMarker = '#';
 constexpr char kSignatureDirective[] = "#signature";
 constexpr char kHeadDirective[] = "#head";
 constexpr char kHeadFormatString[] = "%020lld";
+constexpr char kSparseIndexFileSuffix[] = ".index";
+constexpr char kSparseIndexEveryNDirective[] = "#every_n";
 }  // namespace constants
 
 typedef int64_t head_value_t;
@@ -88,7 +146,7 @@ class IteratorOverFileOfPersistedEntries {
         if (tab_pos == std::string::npos) {
           CURRENT_THROW(MalformedEntryException(line_));
         }
-        const auto current = ParseJSON<idxts_t>(line_.substr(0, tab_pos));
+        const auto current = ParseJSON<idxts_t>(line_.c_str(), tab_pos);
         if (current.index != next_.index) {
           // Indexes must be strictly continuous.
           CURRENT_THROW(ss::InconsistentIndexException(next_.index, current.index));
@@ -150,17 +208,48 @@ class FilePersister {
     std::ofstream file_appender_;
     std::fstream head_rewriter_;
 
-    // `record_offset_.size() == end.next_index`,
-    // and `record_offset_[i]` is the record_offset_ in bytes where the line for index `i` begins.
+    // Only every `index_every_n_`-th entry is indexed, with `index_every_n_ == 1` unless `SparseFileIndex` is used.
+    // `record_offset_.size() == (end.next_index + index_every_n_ - 1) / index_every_n_`,
+    // and `record_offset_[i]` is the record_offset_ in bytes where the line for index `i * index_every_n_` begins.
     std::mutex& publish_mutex_ref_;  // Guards `record_offset_`, `head_offset_` and `record_timestamp_`.
+    const uint64_t index_every_n_;
     std::vector<std::streampos> record_offset_;
     std::streampos head_offset_;
     std::vector<std::chrono::microseconds> record_timestamp_;
 
+    // The sidecar index file, with one line per indexed entry. Only used with `SparseFileIndex`.
+    // The lines are kept in `pending_index_lines_`, guarded by the publish mutex, until the entries they point to
+    // are written into the file, so that the index never points past the data.
+    const std::string index_filename_;
+    std::ofstream index_appender_;
+    std::string pending_index_lines_;
+
+    // The reusable buffer the entry being published is serialized into. Guarded by the publish mutex.
+    std::string publish_buffer_;
+
     // Just `std::atomic<end_t> end_;` won't work in g++ until 5.1, ref.
     // http://stackoverflow.com/questions/29824570/segfault-in-stdatomic-load/29824840#29824840
     // std::atomic<end_t> end_;
+    // The `end_` is what the readers see, and only covers the entries written into the file (or synced to disk).
+    // The `pending_end_` is what the publishers see, guarded by the publish mutex. Unless the entries are
+    // group-committed, the two are the same.
     current::atomic_that_works<end_t> end_;
+    end_t pending_end_;
+
+    // Group commit. The lines not yet written into the file are kept in `pending_buffer_`, which begins at offset
+    // `pending_buffer_offset_` in the file. All guarded by the publish mutex.
+    const FileDurability durability_;
+    std::streampos pending_buffer_offset_;
+    std::string pending_buffer_;
+    uint64_t pending_entries_ = 0u;
+    bool destructing_ = false;
+    std::function<void()> on_batch_written_;
+    // Set while the flusher calls `on_batch_written_` outside the lock, for it to not be replaced or cleared meanwhile.
+    bool on_batch_written_running_ = false;
+    std::condition_variable on_batch_written_done_;
+    std::condition_variable flusher_condition_variable_;
+    int sync_fd_ = -1;
+    std::thread flusher_thread_;
 
     FilePersisterImpl() = delete;
     FilePersisterImpl(const FilePersisterImpl&) = delete;
@@ -170,41 +259,337 @@ class FilePersister {
 
     FilePersisterImpl(std::mutex& publish_mutex_ref,
                       const ss::StreamNamespaceName& namespace_name,
-                      const std::string& filename)
+                      const std::string& filename,
+                      uint64_t index_every_n = 1u,
+                      const std::string& index_filename = "",
+                      const FileDurability& durability = FileDurability())
         : filename_(filename),
           file_appender_(filename, std::ofstream::app | std::ofstream::ate),
           head_rewriter_(filename, std::ofstream::in | std::ofstream::out),
           publish_mutex_ref_(publish_mutex_ref),
-          head_offset_(0) {
+          index_every_n_(index_every_n),
+          head_offset_(0),
+          index_filename_(index_filename),
+          durability_(durability) {
       ValidateFileAndInitializeHead(namespace_name);
-      if (file_appender_.bad() || head_rewriter_.bad()) {
+      if (file_appender_.bad() || head_rewriter_.bad() || index_appender_.bad()) {
         CURRENT_THROW(PersistenceFileNotWritable(filename));
       }
+      pending_end_ = end_.load();
+      pending_buffer_offset_ = file_appender_.tellp();
+      if (durability_.policy != FileDurability::Policy::FlushPerEntry) {
+#ifndef CURRENT_WINDOWS
+        if (durability_.policy == FileDurability::Policy::FDataSyncPerBatch) {
+          sync_fd_ = ::open(filename_.c_str(), O_WRONLY);
+          if (sync_fd_ < 0) {
+            CURRENT_THROW(PersistenceFileNotWritable(filename));
+          }
+        }
+#endif  // CURRENT_WINDOWS
+        flusher_thread_ = std::thread([this]() { FlusherThread(); });
+      }
+    }
+
+    ~FilePersisterImpl() {
+      if (flusher_thread_.joinable()) {
+        {
+          std::unique_lock<std::mutex> lock(publish_mutex_ref_);
+          destructing_ = true;
+          ResetOnBatchWritten(lock, nullptr);  // Whoever is to be notified may be gone already.
+          flusher_condition_variable_.notify_one();
+        }
+        flusher_thread_.join();
+      }
+#ifndef CURRENT_WINDOWS
+      if (sync_fd_ >= 0) {
+        ::close(sync_fd_);
+      }
+#endif  // CURRENT_WINDOWS
+    }
+
+    // Replaces the callback once the flusher is not calling it. The caller should hold `publish_mutex_ref_`.
+    void ResetOnBatchWritten(std::unique_lock<std::mutex>& lock, std::function<void()> f) {
+      on_batch_written_done_.wait(lock, [this]() { return !on_batch_written_running_; });
+      on_batch_written_ = std::move(f);
+    }
+
+    bool GroupCommit() const { return durability_.policy != FileDurability::Policy::FlushPerEntry; }
+
+    // The offset in the file at which the next line will begin. The caller should hold `publish_mutex_ref_`.
+    std::streampos NextOffset() const {
+      return pending_buffer_offset_ + static_cast<std::streamoff>(pending_buffer_.size());
+    }
+
+    // Appends `size` bytes containing `entries` complete lines, and makes `end` the new end of the persister.
+    // Writes them into the file right away, unless the entries are group-committed.
+    // The caller should hold `publish_mutex_ref_`.
+    void Append(const char* data, size_t size, uint64_t entries, const end_t& end) {
+      if (!GroupCommit()) {
+        file_appender_.write(data, size).flush();
+        pending_buffer_offset_ += static_cast<std::streamoff>(size);
+        WriteIndexLines(pending_index_lines_);
+        end_.store(end);
+      } else {
+        // The flusher sleeps while there is nothing pending, so wake it up to start the batch.
+        const bool flusher_idle = !HasPendingChanges();
+        pending_buffer_.append(data, size);
+        pending_entries_ += entries;
+        if (flusher_idle || pending_entries_ >= durability_.max_entries_per_batch) {
+          flusher_condition_variable_.notify_one();
+        }
+      }
+      pending_end_ = end;
+    }
+
+    // Whether there are the lines or the `#head` update not yet visible to the readers, for group commit only.
+    // The caller should hold `publish_mutex_ref_`.
+    bool HasPendingChanges() const {
+      const end_t end = end_.load();
+      return !pending_buffer_.empty() || pending_end_.next_index != end.next_index || pending_end_.head != end.head;
+    }
+
+    // Appends the lines to the sidecar index file, and clears them. With group commit, only called by the flusher.
+    void WriteIndexLines(std::string& lines) {
+      if (!lines.empty()) {
+        index_appender_.write(lines.data(), lines.size()).flush();
+        lines.clear();
+      }
+    }
+
+    // Rewrites the value of the most recent `#head` directive in place, be it in the file or still pending.
+    // The caller should hold `publish_mutex_ref_`.
+    void RewriteHead(const std::string& head_str) {
+      if (head_offset_ >= pending_buffer_offset_) {
+        std::copy(head_str.begin(),
+                  head_str.end(),
+                  pending_buffer_.begin() + static_cast<std::streamoff>(head_offset_ - pending_buffer_offset_));
+      } else {
+        head_rewriter_.seekp(head_offset_, std::ios_base::beg);
+        head_rewriter_ << head_str << std::endl;
+      }
+    }
+
+    // The background thread writing the pending lines into the file, for group commit only.
+    void FlusherThread() {
+      std::unique_lock<std::mutex> lock(publish_mutex_ref_);
+      std::string index_lines;
+      while (true) {
+        // Sleep until there is something to write, and then give the batch up to `max_batch_delay` to fill up.
+        flusher_condition_variable_.wait(lock, [this]() { return destructing_ || HasPendingChanges(); });
+        flusher_condition_variable_.wait_for(lock, durability_.max_batch_delay, [this]() {
+          return destructing_ || pending_entries_ >= durability_.max_entries_per_batch;
+        });
+        const bool done = destructing_;
+        const end_t written = pending_end_;
+        const bool anything_to_write = !pending_buffer_.empty();
+        if (anything_to_write) {
+          // One `write()` for the whole batch. Done under the lock, as the `#head` may be rewritten in place.
+          file_appender_.write(pending_buffer_.data(), pending_buffer_.size()).flush();
+          pending_buffer_offset_ += static_cast<std::streamoff>(pending_buffer_.size());
+          pending_buffer_.clear();
+          pending_entries_ = 0u;
+          index_lines.swap(pending_index_lines_);
+        }
+        if (written.next_index != end_.load().next_index || written.head != end_.load().head) {
+          const bool sync = (durability_.policy == FileDurability::Policy::FDataSyncPerBatch);
+          if (!(sync && durability_.strict)) {
+            end_.store(written);
+          }
+          lock.unlock();
+          if (sync && anything_to_write) {
+#ifndef CURRENT_WINDOWS
+#ifdef CURRENT_APPLE
+            ::fsync(sync_fd_);
+#else
+            ::fdatasync(sync_fd_);
+#endif  // CURRENT_APPLE
+#endif  // CURRENT_WINDOWS
+          }
+          // The index lines only follow the data they point to, synced to disk if needed.
+          WriteIndexLines(index_lines);
+          if (sync && durability_.strict) {
+            end_.store(written);
+          }
+          lock.lock();
+          // Only call the callback still registered, and make whoever clears it wait until the call is over.
+          if (on_batch_written_) {
+            const std::function<void()> on_batch_written = on_batch_written_;
+            on_batch_written_running_ = true;
+            lock.unlock();
+            on_batch_written();
+            lock.lock();
+            on_batch_written_running_ = false;
+            on_batch_written_done_.notify_all();
+          }
+        }
+        if (done) {
+          return;
+        }
+      }
+    }
+
+    // Records the offset and the timestamp of the just appended entry, if this entry is to be indexed.
+    void IndexEntry(const idxts_t& idxts, std::streampos offset) {
+      if (!(idxts.index % index_every_n_)) {
+        CURRENT_ASSERT(record_offset_.size() == idxts.index / index_every_n_);
+        CURRENT_ASSERT(record_timestamp_.size() == idxts.index / index_every_n_);
+        record_offset_.push_back(offset);
+        record_timestamp_.push_back(idxts.us);
+        if (!index_filename_.empty()) {
+          pending_index_lines_.append(current::ToString(idxts.index))
+              .append(1u, ' ')
+              .append(current::ToString(static_cast<int64_t>(offset)))
+              .append(1u, ' ')
+              .append(current::ToString(idxts.us.count()))
+              .append(1u, '\n');
+        }
+      }
+    }
+
+    // The first step of finding the first entry the timestamp of which satisfies the monotonic `predicate`:
+    // binary-searching the indexed entries. Unless the index is dense, the not indexed entries preceding the found
+    // indexed one are then scanned by `ScanNotIndexedEntries()`, which reads the file and needs no lock.
+    struct IndexedEntriesLookup {
+      uint64_t result;              // The first indexed entry satisfying the predicate, or `size`.
+      uint64_t block_begin;         // The index of the indexed entry preceding `result`, known to not qualify.
+      std::streampos block_offset;  // The offset of this indexed entry in the file.
+      bool scan_needed;
+    };
+
+    // The caller should hold `publish_mutex_ref_`.
+    template <typename F>
+    IndexedEntriesLookup LookupIndexedEntries(uint64_t size, F&& predicate) const {
+      // With group commit, the entries past `size` may already be indexed, but not yet readable.
+      const size_t indexed =
+          std::min(record_timestamp_.size(), static_cast<size_t>((size + index_every_n_ - 1u) / index_every_n_));
+      const auto it = std::partition_point(record_timestamp_.begin(),
+                                           record_timestamp_.begin() + indexed,
+                                           [&predicate](std::chrono::microseconds t) { return !predicate(t); });
+      const uint64_t k = static_cast<uint64_t>(std::distance(record_timestamp_.begin(), it));
+      IndexedEntriesLookup lookup{std::min(k * index_every_n_, size), 0u, std::streampos(0), false};
+      if (k && index_every_n_ != 1u) {
+        lookup.block_begin = (k - 1u) * index_every_n_;
+        lookup.block_offset = record_offset_[static_cast<size_t>(k - 1u)];
+        lookup.scan_needed = true;
+      }
+      return lookup;
+    }
+
+    // Returns the index of the first entry the timestamp of which satisfies the monotonic `predicate`, or `size`,
+    // scanning the entries of the block found by `LookupIndexedEntries()`, which are all in the file already.
+    template <typename F>
+    uint64_t ScanNotIndexedEntries(const IndexedEntriesLookup& lookup, F&& predicate) const {
+      if (!lookup.scan_needed) {
+        return lookup.result;
+      }
+      std::ifstream fi(filename_);
+      IteratorOverFileOfPersistedEntries<ENTRY> cit(fi, lookup.block_offset, lookup.block_begin);
+      uint64_t found = lookup.result;
+      bool done = false;
+      while (!done && cit.ProcessNextEntry(
+                          [&](const idxts_t& current, const char*) {
+                            if (current.index + 1u >= lookup.result) {
+                              done = true;
+                            }
+                            if (current.index > lookup.block_begin && current.index < lookup.result &&
+                                predicate(current.us)) {
+                              found = current.index;
+                              done = true;
+                            }
+                          },
+                          [](const std::string&) {})) {
+        ;
+      }
+      return found;
+    }
+
+    // Loads the persisted sparse index into `record_offset_` and `record_timestamp_`, validating its last checkpoint
+    // against the file. Returns false, leaving no checkpoints loaded, if the index file is missing or malformed.
+    bool LoadSparseIndex(std::istream& fi, const std::string& signature) {
+      std::ifstream index_file(index_filename_);
+      std::string every_n_directive;
+      uint64_t every_n = 0u;
+      if (!(index_file >> every_n_directive >> every_n) ||
+          every_n_directive != constants::kSparseIndexEveryNDirective || every_n != index_every_n_) {
+        return false;
+      }
+      uint64_t index;
+      int64_t offset;
+      int64_t us;
+      while (index_file >> index >> offset >> us) {
+        if (index != record_offset_.size() * index_every_n_ ||
+            (!record_offset_.empty() && !(std::streampos(offset) > record_offset_.back()))) {
+          break;
+        }
+        record_offset_.push_back(std::streampos(offset));
+        record_timestamp_.push_back(std::chrono::microseconds(us));
+      }
+      bool valid = !record_offset_.empty();
+      if (valid) {
+        // The signature, if present, must match. The rest of the file before the last checkpoint is trusted.
+        std::string line;
+        if (std::getline(fi, line) &&
+            !line.compare(0, strlen(constants::kSignatureDirective), constants::kSignatureDirective)) {
+          auto offset = strlen(constants::kSignatureDirective);
+          while (std::isspace(line[offset])) {
+            ++offset;
+          }
+          if (line.compare(offset, std::string::npos, signature)) {
+            CURRENT_THROW(InvalidStreamSignature(signature, line.substr(offset)));
+          }
+        }
+        // The last checkpoint must point to the very entry it claims to point to.
+        fi.clear();
+        fi.seekg(record_offset_.back(), std::ios_base::beg);
+        const auto tab_pos = std::getline(fi, line) ? line.find('\t') : std::string::npos;
+        const auto expected = idxts_t((record_offset_.size() - 1u) * index_every_n_, record_timestamp_.back());
+        valid = tab_pos != std::string::npos && !line.compare(0, tab_pos, JSON(expected));
+        fi.clear();
+        fi.seekg(0, std::ios_base::beg);
+      }
+      if (!valid) {
+        record_offset_.clear();
+        record_timestamp_.clear();
+      }
+      return valid;
     }
 
     // Replay the file but ignore its contents. Used to initialize `end_` at startup.
+    // With the sparse index loaded, only the tail of the file, starting from the last checkpoint, is replayed.
     void ValidateFileAndInitializeHead(const ss::StreamNamespaceName& namespace_name) {
       std::ifstream fi(filename_);
       if (!fi.bad()) {
-        // Read through all the lines.
-        // Let `IteratorOverFileOfPersistedEntries` maintain its own `next_`, which later becomes `this->end_`.
-        // While reading the file, record the offset of each record and store it in `record_offset_`.
-        IteratorOverFileOfPersistedEntries<ENTRY> cit(fi, 0, 0);
-        const std::streampos offset_zero(0);
-        auto current_offset = offset_zero;
-        auto head = std::chrono::microseconds(-1);
         reflection::StructSchema struct_schema;
         struct_schema.AddType<ENTRY>();
         const auto signature = JSON(ss::StreamSignature(namespace_name, struct_schema.GetSchemaInfo()));
+        const std::streampos offset_zero(0);
+        auto current_offset = offset_zero;
+        uint64_t current_index = 0u;
+        size_t persisted_checkpoints = 0u;
+        if (!index_filename_.empty() && LoadSparseIndex(fi, signature)) {
+          // The last checkpoint is re-added as the tail is replayed.
+          persisted_checkpoints = record_offset_.size();
+          current_offset = record_offset_.back();
+          current_index = (persisted_checkpoints - 1u) * index_every_n_;
+          record_offset_.pop_back();
+          record_timestamp_.pop_back();
+        }
+        // Read through all the lines.
+        // Let `IteratorOverFileOfPersistedEntries` maintain its own `next_`, which later becomes `this->end_`.
+        // While reading the file, record the offset of every indexed record and store it in `record_offset_`.
+        IteratorOverFileOfPersistedEntries<ENTRY> cit(fi, current_offset, current_index);
+        auto head = std::chrono::microseconds(-1);
         while (cit.ProcessNextEntry(
             [&](const idxts_t& current, const char*) {
-              CURRENT_ASSERT(current.index == record_offset_.size());
-              CURRENT_ASSERT(current.index == record_timestamp_.size());
               if (!(current.us > head)) {
                 CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), current.us));
               }
-              record_offset_.push_back(current_offset);
-              record_timestamp_.push_back(current.us);
+              if (!(current.index % index_every_n_)) {
+                CURRENT_ASSERT(current.index / index_every_n_ == record_offset_.size());
+                CURRENT_ASSERT(current.index / index_every_n_ == record_timestamp_.size());
+                record_offset_.push_back(current_offset);
+                record_timestamp_.push_back(current.us);
+              }
               current_offset = fi.tellg();
               head = current.us;
               head_offset_ = 0;
@@ -249,6 +634,20 @@ class FilePersister {
         if (!current_offset) {
           file_appender_ << constants::kSignatureDirective << ' ' << signature << std::endl;
         }
+        if (!index_filename_.empty()) {
+          // Bring the index file up to date, rewriting it if it could not be used.
+          if (persisted_checkpoints) {
+            index_appender_.open(index_filename_, std::ofstream::app);
+          } else {
+            index_appender_.open(index_filename_, std::ofstream::trunc);
+            index_appender_ << constants::kSparseIndexEveryNDirective << ' ' << index_every_n_ << '\n';
+          }
+          for (size_t i = persisted_checkpoints; i < record_offset_.size(); ++i) {
+            index_appender_ << i * index_every_n_ << ' ' << static_cast<int64_t>(record_offset_[i]) << ' '
+                            << record_timestamp_[i].count() << '\n';
+          }
+          index_appender_.flush();
+        }
       } else {
         end_.store({0ull, std::chrono::microseconds(-1), std::chrono::microseconds(-1)});
       }
@@ -267,6 +666,43 @@ class FilePersister {
                 const std::string& filename)
       : file_persister_impl_(MakeOwned<FilePersisterImpl>(publish_mutex_ref, namespace_name, filename)) {}
 
+  FilePersister(std::mutex& publish_mutex_ref,
+                const ss::StreamNamespaceName& namespace_name,
+                const std::string& filename,
+                SparseFileIndex sparse_index)
+      : file_persister_impl_(MakeOwned<FilePersisterImpl>(publish_mutex_ref,
+                                                          namespace_name,
+                                                          filename,
+                                                          sparse_index.every_n_entries,
+                                                          filename + constants::kSparseIndexFileSuffix)) {}
+
+  FilePersister(std::mutex& publish_mutex_ref,
+                const ss::StreamNamespaceName& namespace_name,
+                const std::string& filename,
+                const FileDurability& durability)
+      : file_persister_impl_(
+            MakeOwned<FilePersisterImpl>(publish_mutex_ref, namespace_name, filename, 1u, "", durability)) {}
+
+  FilePersister(std::mutex& publish_mutex_ref,
+                const ss::StreamNamespaceName& namespace_name,
+                const std::string& filename,
+                SparseFileIndex sparse_index,
+                const FileDurability& durability)
+      : file_persister_impl_(MakeOwned<FilePersisterImpl>(publish_mutex_ref,
+                                                          namespace_name,
+                                                          filename,
+                                                          sparse_index.every_n_entries,
+                                                          filename + constants::kSparseIndexFileSuffix,
+                                                          durability)) {}
+
+  // With group commit, `f` is called from the background thread after each batch becomes visible to the readers.
+  // The stream uses it to wake up its subscribers.
+  // Once it returns, the previously set `f` is not being called, and will not be called again.
+  void SetOnBatchWritten(std::function<void()> f) {
+    std::unique_lock<std::mutex> lock(file_persister_impl_->publish_mutex_ref_);
+    file_persister_impl_->ResetOnBatchWritten(lock, std::move(f));
+  }
+
   class Iterator final {
    public:
     struct Entry {
@@ -345,8 +781,8 @@ class FilePersister {
                    const std::string& filename,
                    uint64_t i,
                    std::streampos offset,
-                   uint64_t)
-        : file_persister_impl_(std::move(file_persister_impl)), i_(i), current_offset_(offset) {
+                   uint64_t index_at_offset)
+        : file_persister_impl_(std::move(file_persister_impl)), i_(i), next_line_index_(index_at_offset) {
       if (!filename.empty()) {
         fi_ = std::make_unique<std::ifstream>(filename);
         CURRENT_ASSERT(!fi_->bad());
@@ -358,19 +794,20 @@ class FilePersister {
 
     // `operator*` relies on the fact each entry will be requested at most once.
     // The range-based for-loop works fine. -- D.K.
+    // The lines are read sequentially, skipping the directives, and the entries preceding the requested one,
+    // as the iteration may begin from the closest preceding indexed entry.
     std::string operator*() const {
       if (current_entry_.empty()) {
-        const auto offset = file_persister_impl_->record_offset_[static_cast<size_t>(i_)];
-        if (offset != current_offset_) {
-          fi_->seekg(offset, std::ios_base::beg);
-          current_offset_ = offset;
-        }
-        if (std::getline(*fi_, current_entry_)) {
-          CURRENT_ASSERT(current_entry_[0] != constants::kDirectiveMarker);
-        } else {
-          // End of file. Should never happen as long as the user only iterates over valid ranges.
-          CURRENT_THROW(current::Exception());  // LCOV_EXCL_LINE
+        while (next_line_index_ <= i_) {
+          if (!std::getline(*fi_, current_entry_)) {
+            // End of file. Should never happen as long as the user only iterates over valid ranges.
+            CURRENT_THROW(current::Exception());  // LCOV_EXCL_LINE
+          }
+          if (current_entry_[0] != constants::kDirectiveMarker) {
+            ++next_line_index_;
+          }
         }
+        CURRENT_ASSERT(next_line_index_ == i_ + 1);
       }
       return current_entry_;
     }
@@ -386,11 +823,10 @@ class FilePersister {
 
    private:
     Borrowed<FilePersisterImpl> file_persister_impl_;
-    bool valid_ = true;
     std::unique_ptr<std::ifstream> fi_;
     uint64_t i_;
+    mutable uint64_t next_line_index_;  // The index of the entry the next line read from `fi_` would contain.
     mutable std::string current_entry_;
-    mutable std::streampos current_offset_;
   };
 
   template <typename ITERATOR>
@@ -399,21 +835,28 @@ class FilePersister {
     IterableRangeImpl(Borrowed<FilePersisterImpl> file_persister_impl,
                       uint64_t begin,
                       uint64_t end,
-                      std::streampos begin_offset)
-        : file_persister_impl_(std::move(file_persister_impl)), begin_(begin), end_(end), begin_offset_(begin_offset) {}
+                      std::streampos begin_offset,
+                      uint64_t index_at_begin_offset)
+        : file_persister_impl_(std::move(file_persister_impl)),
+          begin_(begin),
+          end_(end),
+          begin_offset_(begin_offset),
+          index_at_begin_offset_(index_at_begin_offset) {}
 
     IterableRangeImpl(IterableRangeImpl&& rhs)
         : file_persister_impl_(std::move(rhs.file_persister_impl_)),
           begin_(rhs.begin_),
           end_(rhs.end_),
-          begin_offset_(rhs.begin_offset_) {}
+          begin_offset_(rhs.begin_offset_),
+          index_at_begin_offset_(rhs.index_at_begin_offset_) {}
 
     ITERATOR begin() const {
       // By convention, iterating over data, being an immutable operation, does not throw.
       if (begin_ == end_) {
         return ITERATOR(file_persister_impl_, "", 0, 0, 0);  // No need in accessing the file for a null iterator.
       } else {
-        return ITERATOR(file_persister_impl_, file_persister_impl_->filename_, begin_, begin_offset_, begin_);
+        return ITERATOR(
+            file_persister_impl_, file_persister_impl_->filename_, begin_, begin_offset_, index_at_begin_offset_);
       }
     }
     ITERATOR end() const {
@@ -433,14 +876,24 @@ class FilePersister {
     const uint64_t begin_;
     const uint64_t end_;
     const std::streampos begin_offset_;
+    const uint64_t index_at_begin_offset_;  // Not equal to `begin_` if `begin_` is not an indexed entry.
   };
 
   // `TIMESTAMP` can be `std::chrono::microseconds` or `current::time::DefaultTimeArgument`.
   template <current::locks::MutexLockStatus MLS, typename E, typename TIMESTAMP>
   idxts_t PersisterPublishImpl(E&& entry, const TIMESTAMP provided_timestamp) {
+    // The entry is serialized before the publish mutex is taken, which is shared with the subscribers of the stream.
+    // Only the validation of the timestamp and the append of the complete line happen under it.
+    // Explicit `MakeSureTheRightTypeIsSerialized` is essential, otherwise the `Variant`'s case
+    // would be serialized in an unwrapped way when passed directly.
+    thread_local std::string serialized_entry;
+    serialized_entry.clear();
+    AppendJSON(serialized_entry,
+               MakeSureTheRightTypeIsSerialized<ENTRY, decay_t<E>>::DoIt(std::forward<E>(entry)));
+
     current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
 
-    end_t iterator = file_persister_impl_->end_.load();
+    end_t iterator = file_persister_impl_->pending_end_;
     const auto timestamp = current::time::TimestampAsMicroseconds(provided_timestamp);
     if (!(timestamp > iterator.head)) {
 #ifdef CURRENT_BUILD_WITH_PARANOIC_RUNTIME_CHECKS
@@ -451,34 +904,95 @@ class FilePersister {
 
     iterator.last_entry_us = iterator.head = timestamp;
     const auto idxts = idxts_t(iterator.next_index, iterator.last_entry_us);
-    CURRENT_ASSERT(file_persister_impl_->record_offset_.size() == iterator.next_index);
-    CURRENT_ASSERT(file_persister_impl_->record_timestamp_.size() == iterator.next_index);
-    file_persister_impl_->record_offset_.push_back(file_persister_impl_->file_appender_.tellp());
-    file_persister_impl_->record_timestamp_.push_back(timestamp);
-
-    // Explicit `MakeSureTheRightTypeIsSerialized` is essential, otherwise the `Variant`'s case
-    // would be serialized in an unwrapped way when passed directly.
-    file_persister_impl_->file_appender_ << JSON(idxts) << '\t'
-                                         << JSON(MakeSureTheRightTypeIsSerialized<ENTRY, decay_t<E>>::DoIt(
-                                                std::forward<E>(entry)))
-                                         << std::endl;
+    const auto offset = file_persister_impl_->NextOffset();
+
+    std::string& buffer = file_persister_impl_->publish_buffer_;
+    buffer.clear();
+    AppendJSON(buffer, idxts);
+    buffer.push_back('\t');
+    buffer.append(serialized_entry);
+    buffer.push_back('\n');
+    file_persister_impl_->IndexEntry(idxts, offset);
     ++iterator.next_index;
     file_persister_impl_->head_offset_ = 0;
-    file_persister_impl_->end_.store(iterator);
+    file_persister_impl_->Append(buffer.data(), buffer.size(), 1u, iterator);
 
     return idxts;
   }
 
-  template <current::locks::MutexLockStatus MLS>
-  idxts_t PersisterPublishUnsafeImpl(const std::string& raw_log_line) {
+  // Publishes all the entries of `entries`, timestamped with `Now()`, and returns the index and timestamp of the last
+  // one, or `idxts_t()` if `entries` is empty. The entries are serialized before the publish mutex is taken, and are
+  // appended to the file with a single `write()`. If `published` is set, the index and timestamp of each entry, in
+  // order, are appended to it.
+  template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock, typename CONTAINER>
+  idxts_t PublishBatch(CONTAINER&& entries, std::vector<idxts_t>* published = nullptr) {
+    std::string serialized;
+    std::vector<size_t> serialized_end;
+    for (auto&& entry : entries) {
+      AppendJSON(serialized,
+                 MakeSureTheRightTypeIsSerialized<ENTRY, decay_t<decltype(entry)>>::DoIt(
+                     std::forward<decltype(entry)>(entry)));
+      serialized_end.push_back(serialized.size());
+    }
+    if (serialized_end.empty()) {
+      return idxts_t();
+    }
+
     current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
 
-    end_t iterator = file_persister_impl_->end_.load();
+    end_t iterator = file_persister_impl_->pending_end_;
+
+    // Validate all the timestamps before indexing any of the entries, so that the batch is published as a whole,
+    // or not at all, and the in-memory index always matches the file.
+    std::vector<std::chrono::microseconds> timestamps;
+    timestamps.reserve(serialized_end.size());
+    std::chrono::microseconds previous = iterator.head;
+    for (size_t i = 0; i < serialized_end.size(); ++i) {
+      const auto timestamp = current::time::Now();
+      if (!(timestamp > previous)) {
+        CURRENT_THROW(ss::InconsistentTimestampException(previous + std::chrono::microseconds(1), timestamp));
+      }
+      timestamps.push_back(timestamp);
+      previous = timestamp;
+    }
+
+    std::string& buffer = file_persister_impl_->publish_buffer_;
+    buffer.clear();
+    idxts_t idxts;
+    size_t serialized_begin = 0u;
+    for (size_t i = 0; i < serialized_end.size(); ++i) {
+      const size_t end = serialized_end[i];
+      iterator.last_entry_us = iterator.head = timestamps[i];
+      idxts = idxts_t(iterator.next_index, iterator.last_entry_us);
+      const auto offset = file_persister_impl_->NextOffset() + static_cast<std::streamoff>(buffer.size());
+      AppendJSON(buffer, idxts);
+      buffer.push_back('\t');
+      buffer.append(serialized, serialized_begin, end - serialized_begin);
+      buffer.push_back('\n');
+      serialized_begin = end;
+      file_persister_impl_->IndexEntry(idxts, offset);
+      ++iterator.next_index;
+      if (published) {
+        published->push_back(idxts);
+      }
+    }
+    file_persister_impl_->head_offset_ = 0;
+    file_persister_impl_->Append(buffer.data(), buffer.size(), serialized_end.size(), iterator);
+
+    return idxts;
+  }
+
+  template <current::locks::MutexLockStatus MLS>
+  idxts_t PersisterPublishUnsafeImpl(const std::string& raw_log_line) {
     const auto tab_pos = raw_log_line.find('\t');
     if (tab_pos == std::string::npos) {
       CURRENT_THROW(MalformedEntryException(raw_log_line));
     }
-    const idxts_t idxts = ParseJSON<idxts_t>(raw_log_line.substr(0, tab_pos));
+    const idxts_t idxts = ParseJSON<idxts_t>(raw_log_line.c_str(), tab_pos);
+
+    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+
+    end_t iterator = file_persister_impl_->pending_end_;
     if (idxts.index != iterator.next_index) {
       CURRENT_THROW(UnsafePublishBadIndexTimestampException(iterator.next_index, idxts.index));
     }
@@ -487,15 +1001,14 @@ class FilePersister {
     }
 
     iterator.last_entry_us = iterator.head = idxts.us;
-    CURRENT_ASSERT(file_persister_impl_->record_offset_.size() == idxts.index);
-    CURRENT_ASSERT(file_persister_impl_->record_timestamp_.size() == idxts.index);
-    file_persister_impl_->record_offset_.push_back(file_persister_impl_->file_appender_.tellp());
-    file_persister_impl_->record_timestamp_.push_back(idxts.us);
-
-    file_persister_impl_->file_appender_ << raw_log_line << std::endl;
+    const auto offset = file_persister_impl_->NextOffset();
+    std::string& buffer = file_persister_impl_->publish_buffer_;
+    buffer.assign(raw_log_line);
+    buffer.push_back('\n');
+    file_persister_impl_->IndexEntry(idxts, offset);
     ++iterator.next_index;
     file_persister_impl_->head_offset_ = 0;
-    file_persister_impl_->end_.store(iterator);
+    file_persister_impl_->Append(buffer.data(), buffer.size(), 1u, iterator);
 
     return idxts;
   }
@@ -504,7 +1017,7 @@ class FilePersister {
   void PersisterUpdateHeadImpl(const TIMESTAMP provided_timestamp) {
     current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
 
-    end_t iterator = file_persister_impl_->end_.load();
+    end_t iterator = file_persister_impl_->pending_end_;
     const auto timestamp = current::time::TimestampAsMicroseconds(provided_timestamp);
     if (!(timestamp > iterator.head)) {
       CURRENT_THROW(ss::InconsistentTimestampException(iterator.head + std::chrono::microseconds(1), timestamp));
@@ -512,16 +1025,24 @@ class FilePersister {
     iterator.head = timestamp;
     const auto head_str = Printf(constants::kHeadFormatString, static_cast<long long>(timestamp.count()));
     if (file_persister_impl_->head_offset_) {
-      auto& rewriter = file_persister_impl_->head_rewriter_;
-      rewriter.seekp(file_persister_impl_->head_offset_, std::ios_base::beg);
-      rewriter << head_str << std::endl;
+      file_persister_impl_->RewriteHead(head_str);
+      file_persister_impl_->pending_end_ = iterator;
+      if (!file_persister_impl_->GroupCommit()) {
+        file_persister_impl_->end_.store(iterator);
+      } else {
+        // Wake up the flusher, which may be sleeping with nothing else pending, to make the new head visible.
+        file_persister_impl_->flusher_condition_variable_.notify_one();
+      }
     } else {
-      auto& file_appender_ = file_persister_impl_->file_appender_;
-      file_appender_ << constants::kHeadDirective << ' ';
-      file_persister_impl_->head_offset_ = file_appender_.tellp();
-      file_appender_ << head_str << std::endl;
+      std::string& buffer = file_persister_impl_->publish_buffer_;
+      buffer.assign(constants::kHeadDirective);
+      buffer.push_back(' ');
+      file_persister_impl_->head_offset_ =
+          file_persister_impl_->NextOffset() + static_cast<std::streamoff>(buffer.size());
+      buffer.append(head_str);
+      buffer.push_back('\n');
+      file_persister_impl_->Append(buffer.data(), buffer.size(), 0u, iterator);
     }
-    file_persister_impl_->end_.store(iterator);
   }
 
   template <current::locks::MutexLockStatus MLS>
@@ -563,23 +1084,28 @@ class FilePersister {
   std::pair<uint64_t, uint64_t> PersisterIndexRangeByTimestampRangeImpl(std::chrono::microseconds from,
                                                                         std::chrono::microseconds till) const {
     std::pair<uint64_t, uint64_t> result{static_cast<uint64_t>(-1), static_cast<uint64_t>(-1)};
-    current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
-    const auto begin_it =
-        std::lower_bound(file_persister_impl_->record_timestamp_.begin(),
-                         file_persister_impl_->record_timestamp_.end(),
-                         from,
-                         [](std::chrono::microseconds entry_t, std::chrono::microseconds t) { return entry_t < t; });
-    if (begin_it != file_persister_impl_->record_timestamp_.end()) {
-      result.first = std::distance(file_persister_impl_->record_timestamp_.begin(), begin_it);
+    const auto begin_predicate = [from](std::chrono::microseconds t) { return !(t < from); };
+    const auto end_predicate = [till](std::chrono::microseconds t) { return till < t; };
+    // Only the in-memory index is searched under the lock, so that the publishers do not wait on the file reads.
+    uint64_t size;
+    typename FilePersisterImpl::IndexedEntriesLookup begin_lookup;
+    typename FilePersisterImpl::IndexedEntriesLookup end_lookup;
+    {
+      current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
+      size = file_persister_impl_->end_.load().next_index;
+      begin_lookup = file_persister_impl_->LookupIndexedEntries(size, begin_predicate);
+      if (till.count() > 0) {
+        end_lookup = file_persister_impl_->LookupIndexedEntries(size, end_predicate);
+      }
+    }
+    const uint64_t begin = file_persister_impl_->ScanNotIndexedEntries(begin_lookup, begin_predicate);
+    if (begin != size) {
+      result.first = begin;
     }
     if (till.count() > 0) {
-      const auto end_it =
-          std::upper_bound(file_persister_impl_->record_timestamp_.begin(),
-                           file_persister_impl_->record_timestamp_.end(),
-                           till,
-                           [](std::chrono::microseconds t, std::chrono::microseconds entry_t) { return t < entry_t; });
-      if (end_it != file_persister_impl_->record_timestamp_.end()) {
-        result.second = std::distance(file_persister_impl_->record_timestamp_.begin(), end_it);
+      const uint64_t end = file_persister_impl_->ScanNotIndexedEntries(end_lookup, end_predicate);
+      if (end != size) {
+        result.second = end;
       }
     }
     return result;
@@ -620,7 +1146,8 @@ class FilePersister {
       CURRENT_THROW(InvalidIterableRangeException());
     }
     if (begin_index == end_index) {
-      return ITERABLE(file_persister_impl_, 0, 0, 0);  // OK, even for an empty persister, where 0 is an invalid index.
+      // OK, even for an empty persister, where 0 is an invalid index.
+      return ITERABLE(file_persister_impl_, 0, 0, 0, 0);
     }
     if (end_index < begin_index) {
       CURRENT_THROW(InvalidIterableRangeException());
@@ -628,13 +1155,15 @@ class FilePersister {
 
     current::locks::SmartMutexLockGuard<MLS> lock(file_persister_impl_->publish_mutex_ref_);
 
-    // ">" is OK, as this call is multithreading-friendly, and more entries could have been added during this call.
-    CURRENT_ASSERT(file_persister_impl_->record_offset_.size() >= current_size);
+    // Begin from the closest indexed entry, which is `begin_index` itself unless the sparse index is used.
+    const uint64_t index_every_n = file_persister_impl_->index_every_n_;
+    CURRENT_ASSERT(file_persister_impl_->record_offset_.size() > begin_index / index_every_n);
 
     return ITERABLE(file_persister_impl_,
                     static_cast<size_t>(begin_index),
                     static_cast<size_t>(end_index),
-                    file_persister_impl_->record_offset_[static_cast<size_t>(begin_index)]);
+                    file_persister_impl_->record_offset_[static_cast<size_t>(begin_index / index_every_n)],
+                    begin_index / index_every_n * index_every_n);
   }
 
   template <current::locks::MutexLockStatus MLS, typename ITERABLE>
@@ -647,7 +1176,7 @@ class FilePersister {
     if (index_range.first != static_cast<uint64_t>(-1)) {
       return PersisterIterateImpl<MLS, ITERABLE>(index_range.first, index_range.second);
     } else {  // No entries found in the requested range.
-      return ITERABLE(file_persister_impl_, 0, 0, 0);
+      return ITERABLE(file_persister_impl_, 0, 0, 0, 0);
     }
   }
 
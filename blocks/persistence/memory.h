@@ -115,9 +115,16 @@ class MemoryPersister {
     IteratorUnsafe(Borrowed<Container> container, uint64_t i) : container_(std::move(container)), i_(i) {}
 
     std::string operator*() const {
-      std::lock_guard<std::mutex> lock(container_->memory_persister_container_mutex_);
-      const auto& entry = container_->entries_[static_cast<size_t>(i_)];
-      return JSON(idxts_t(i_, entry.first)) + '\t' + JSON(entry.second);
+      // The entries are only ever appended to the `std::deque`, which keeps the references to them valid,
+      // so the entry is serialized without holding the mutex.
+      const auto& entry = [this]() -> const typename Container::entry_t& {
+        std::lock_guard<std::mutex> lock(container_->memory_persister_container_mutex_);
+        return container_->entries_[static_cast<size_t>(i_)];
+      }();
+      std::string result = JSON(idxts_t(i_, entry.first));
+      result.push_back('\t');
+      AppendJSON(result, entry.second);
+      return result;
     }
     IteratorUnsafe& operator++() {
       ++i_;
@@ -168,13 +175,16 @@ class MemoryPersister {
 
   template <current::locks::MutexLockStatus MLS>
   idxts_t PersisterPublishUnsafeImpl(const std::string& raw_log_line) {
-    current::locks::SmartMutexLockGuard<MLS> lock(container_->memory_persister_container_mutex_);
-    const auto head = container_->head_;
+    // Parse before locking the mutex.
     const auto tab_pos = raw_log_line.find('\t');
     if (tab_pos == std::string::npos) {
       CURRENT_THROW(MalformedEntryException(raw_log_line));
     }
-    const auto idxts = ParseJSON<idxts_t>(raw_log_line.substr(0, tab_pos));
+    const auto idxts = ParseJSON<idxts_t>(raw_log_line.c_str(), tab_pos);
+    auto entry = ParseJSON<ENTRY>(raw_log_line.c_str() + tab_pos + 1u, raw_log_line.length() - tab_pos - 1u);
+
+    current::locks::SmartMutexLockGuard<MLS> lock(container_->memory_persister_container_mutex_);
+    const auto head = container_->head_;
     const auto expected_index = static_cast<uint64_t>(container_->entries_.size());
     if (idxts.index != expected_index) {
       CURRENT_THROW(UnsafePublishBadIndexTimestampException(expected_index, idxts.index));
@@ -182,7 +192,7 @@ class MemoryPersister {
     if (!(idxts.us > head)) {
       CURRENT_THROW(ss::InconsistentTimestampException(head + std::chrono::microseconds(1), idxts.us));
     }
-    container_->entries_.emplace_back(idxts.us, ParseJSON<ENTRY>(raw_log_line.substr(tab_pos + 1)));
+    container_->entries_.emplace_back(idxts.us, std::move(entry));
     container_->head_ = idxts.us;
     CURRENT_ASSERT(container_->head_ >= container_->entries_.back().first);
     return idxts;
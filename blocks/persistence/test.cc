@@ -31,6 +31,7 @@ SOFTWARE.
 
 #include "memory.h"
 #include "file.h"
+#include "binary_file.h"
 
 #include "../ss/ss.h"
 
@@ -38,6 +39,7 @@ SOFTWARE.
 #include "../../bricks/file/file.h"
 #include "../../bricks/strings/join.h"
 #include "../../bricks/strings/printf.h"
+#include "../../bricks/strings/split.h"
 
 #include "../../3rdparty/gtest/gtest-main-with-dflags.h"
 
@@ -675,6 +677,476 @@ TEST(PersistenceLayer, FileSignatureExceptions) {
   }
 }
 
+TEST(PersistenceLayer, FileWithSparseIndex) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::File<StorableString>;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const std::string index_file_name = persistence_file_name + ".index";
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+  const auto index_file_remover = current::FileSystem::ScopedRmFile(index_file_name);
+
+  const auto AllEntries = [](IMPL& impl, uint64_t begin, uint64_t end) {
+    std::vector<std::string> result;
+    for (const auto& e : impl.Iterate(begin, end)) {
+      result.push_back(Printf("%s/%d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.us.count())));
+    }
+    return Join(result, ',');
+  };
+  const auto AllEntriesUnsafe = [](IMPL& impl, uint64_t begin, uint64_t end) {
+    std::vector<std::string> result;
+    for (const auto& e : impl.IterateUnsafe(begin, end)) {
+      result.push_back(ParseJSON<StorableString>(e.substr(e.find('\t') + 1)).s);
+    }
+    return Join(result, ',');
+  };
+  const auto EntriesByTimestamp = [](IMPL& impl, int64_t from, int64_t till) {
+    std::vector<std::string> result;
+    for (const auto& e : impl.Iterate(std::chrono::microseconds(from), std::chrono::microseconds(till))) {
+      result.push_back(e.entry.s);
+    }
+    return Join(result, ',');
+  };
+
+  // Entries `0` .. `9`, published at 100us, 200us, ..., 1000us, with the head updated after each odd one.
+  const auto ConfirmContents = [&](IMPL& impl) {
+    EXPECT_EQ(10u, impl.Size());
+    EXPECT_EQ(1050, impl.CurrentHead().count());
+    EXPECT_EQ("0/100,1/200,2/300,3/400,4/500,5/600,6/700,7/800,8/900,9/1000", AllEntries(impl, 0, 10));
+    for (uint64_t begin = 0; begin <= 10; ++begin) {
+      for (uint64_t end = begin; end <= 10; ++end) {
+        std::vector<std::string> expected;
+        for (uint64_t i = begin; i < end; ++i) {
+          expected.push_back(current::ToString(i));
+        }
+        EXPECT_EQ(Join(expected, ','), AllEntriesUnsafe(impl, begin, end)) << begin << ' ' << end;
+      }
+    }
+    EXPECT_EQ("4,5,6", EntriesByTimestamp(impl, 450, 700));
+    EXPECT_EQ("4,5,6", EntriesByTimestamp(impl, 500, 750));
+    EXPECT_EQ("0", EntriesByTimestamp(impl, 0, 100));
+    EXPECT_EQ("7,8,9", EntriesByTimestamp(impl, 701, 0));
+    EXPECT_EQ("9", EntriesByTimestamp(impl, 1000, 2000));
+    EXPECT_EQ("", EntriesByTimestamp(impl, 1001, 0));
+  };
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(3));
+    for (int i = 0; i < 10; ++i) {
+      impl.Publish(StorableString(current::ToString(i)), std::chrono::microseconds((i + 1) * 100));
+      if (i % 2) {
+        impl.UpdateHead(std::chrono::microseconds((i + 1) * 100 + 50));
+      }
+    }
+    ConfirmContents(impl);
+  }
+
+  // Only every third entry is indexed.
+  const std::string index_contents = current::FileSystem::ReadFileAsString(index_file_name);
+  EXPECT_EQ(0u, index_contents.find("#every_n 3\n0 "));
+  EXPECT_EQ(5u, current::strings::Split(index_contents, '\n').size());
+
+  {
+    // Resume from the index.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(3));
+    ConfirmContents(impl);
+  }
+  EXPECT_EQ(index_contents, current::FileSystem::ReadFileAsString(index_file_name));
+
+  {
+    // Only the tail of the file, starting from the last indexed entry, is replayed on restart.
+    // Corrupt an entry before it, in a way that the full replay would not tolerate.
+    const std::string valid_contents = current::FileSystem::ReadFileAsString(persistence_file_name);
+    std::string contents = valid_contents;
+    contents[contents.find('\t', contents.find("{\"index\":1,"))] = ' ';
+    current::FileSystem::WriteStringToFile(contents, persistence_file_name.c_str());
+    std::mutex mutex;
+    {
+      IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(3));
+      EXPECT_EQ(10u, impl.Size());
+    }
+    ASSERT_THROW(IMPL(mutex, namespace_name, persistence_file_name), current::persistence::MalformedEntryException);
+    current::FileSystem::WriteStringToFile(valid_contents, persistence_file_name.c_str());
+  }
+
+  {
+    // The index file built for a different `N` is rebuilt.
+    std::mutex mutex;
+    {
+      IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(4));
+      ConfirmContents(impl);
+    }
+    EXPECT_EQ(0u, current::FileSystem::ReadFileAsString(index_file_name).find("#every_n 4\n0 "));
+    {
+      IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(3));
+      ConfirmContents(impl);
+    }
+    EXPECT_EQ(index_contents, current::FileSystem::ReadFileAsString(index_file_name));
+  }
+
+  {
+    // The index file pointing to the wrong place is ignored and rebuilt.
+    current::FileSystem::WriteStringToFile("#every_n 3\n0 1 100\n3 2 400\n", index_file_name.c_str());
+    std::mutex mutex;
+    {
+      IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(3));
+      ConfirmContents(impl);
+    }
+    EXPECT_EQ(index_contents, current::FileSystem::ReadFileAsString(index_file_name));
+  }
+
+  {
+    // The truncated index file is used up to the last valid entry, and then appended to.
+    current::FileSystem::WriteStringToFile(index_contents.substr(0, index_contents.length() - 5),
+                                           index_file_name.c_str());
+    std::mutex mutex;
+    {
+      IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(3));
+      ConfirmContents(impl);
+      impl.Publish(StorableString("10"), std::chrono::microseconds(1100));
+    }
+    IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(3));
+    EXPECT_EQ(11u, impl.Size());
+    EXPECT_EQ("8/900,9/1000,10/1100", AllEntries(impl, 8, 11));
+    EXPECT_EQ("10", EntriesByTimestamp(impl, 1001, 0));
+  }
+}
+
+TEST(PersistenceLayer, FileGroupCommit) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::File<StorableString>;
+  using current::persistence::FileDurability;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  const auto AllEntries = [](IMPL& impl) {
+    std::vector<std::string> result;
+    for (const auto& e : impl.Iterate()) {
+      result.push_back(Printf("%s/%d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.us.count())));
+    }
+    return Join(result, ',');
+  };
+  const auto WaitForSize = [](IMPL& impl, uint64_t size) {
+    while (impl.Size() != size) {
+      std::this_thread::yield();
+    }
+  };
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex,
+              namespace_name,
+              persistence_file_name,
+              FileDurability(FileDurability::Policy::GroupCommit)
+                  .SetMaxEntriesPerBatch(3u)
+                  .SetMaxBatchDelay(std::chrono::seconds(100)));
+
+    // The entries are only visible to the readers once the batch of three is written.
+    impl.Publish(StorableString("1"), std::chrono::microseconds(100));
+    EXPECT_EQ(2u, impl.Publish(StorableString("2"), std::chrono::microseconds(200)).index + 1u);
+    EXPECT_EQ(0u, impl.Size());
+    EXPECT_EQ(1u, current::strings::Split(current::FileSystem::ReadFileAsString(persistence_file_name), '\n').size());
+    impl.Publish(StorableString("3"), std::chrono::microseconds(300));
+    WaitForSize(impl, 3u);
+    EXPECT_EQ("1/100,2/200,3/300", AllEntries(impl));
+    EXPECT_EQ(300, impl.CurrentHead().count());
+
+    // The head is validated against what has been published, even if it is not written yet.
+    impl.UpdateHead(std::chrono::microseconds(400));
+    impl.UpdateHead(std::chrono::microseconds(500));
+    ASSERT_THROW(impl.Publish(StorableString("x"), std::chrono::microseconds(450)),
+                 current::ss::InconsistentTimestampException);
+    EXPECT_EQ(300, impl.CurrentHead().count());
+
+    // Three entries published as one batch. Serialized before the lock is taken, and appended as one buffer.
+    const std::vector<StorableString> batch({StorableString("4"), StorableString("5"), StorableString("6")});
+    current::time::SetNow(std::chrono::microseconds(600), std::chrono::microseconds(700));
+    std::vector<idxts_t> published;
+    EXPECT_EQ(5u, impl.PublishBatch(batch, &published).index);
+    WaitForSize(impl, 6u);
+    EXPECT_EQ("1/100,2/200,3/300,4/600,5/601,6/602", AllEntries(impl));
+    ASSERT_EQ(3u, published.size());
+    EXPECT_EQ(3u, published.front().index);
+    EXPECT_EQ(600, published.front().us.count());
+    EXPECT_EQ(5u, published.back().index);
+    EXPECT_EQ(602, published.back().us.count());
+
+    // The entries and the head left pending are written by the destructor.
+    impl.Publish(StorableString("7"), std::chrono::microseconds(700));
+    impl.UpdateHead(std::chrono::microseconds(800));
+    impl.UpdateHead(std::chrono::microseconds(900));
+    EXPECT_EQ(6u, impl.Size());
+  }
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ("1/100,2/200,3/300,4/600,5/601,6/602,7/700", AllEntries(impl));
+    EXPECT_EQ(900, impl.CurrentHead().count());
+    EXPECT_EQ(0u, impl.PublishBatch(std::vector<StorableString>()).index);
+    EXPECT_EQ(7u, impl.Size());
+  }
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex,
+              namespace_name,
+              persistence_file_name,
+              FileDurability(FileDurability::Policy::FDataSyncPerBatch)
+                  .SetMaxBatchDelay(std::chrono::milliseconds(1))
+                  .SetStrict());
+    impl.Publish(StorableString("8"), std::chrono::microseconds(1000));
+    impl.UpdateHead(std::chrono::microseconds(1100));
+    WaitForSize(impl, 8u);
+    while (impl.CurrentHead().count() != 1100) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ("1/100,2/200,3/300,4/600,5/601,6/602,7/700,8/1000", AllEntries(impl));
+  }
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(8u, impl.Size());
+    EXPECT_EQ(1100, impl.CurrentHead().count());
+  }
+}
+
+TEST(PersistenceLayer, FileBatchIsPublishedAsAWhole) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::File<StorableString>;
+  using current::persistence::FileDurability;
+  using current::persistence::SparseFileIndex;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const std::string index_file_name = persistence_file_name + ".index";
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+  const auto index_file_remover = current::FileSystem::ScopedRmFile(index_file_name);
+
+  const auto AllEntries = [](IMPL& impl) {
+    std::vector<std::string> result;
+    for (const auto& e : impl.Iterate()) {
+      result.push_back(Printf("%s/%d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.us.count())));
+    }
+    return Join(result, ',');
+  };
+  const auto IndexLines = [&index_file_name]() {
+    return current::strings::Split(current::FileSystem::ReadFileAsString(index_file_name), '\n').size();
+  };
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex,
+              namespace_name,
+              persistence_file_name,
+              SparseFileIndex(2),
+              FileDurability(FileDurability::Policy::GroupCommit)
+                  .SetMaxEntriesPerBatch(2u)
+                  .SetMaxBatchDelay(std::chrono::seconds(100)));
+
+    // The second entry of the batch gets the same timestamp as the first, indexed, one. Nothing is published.
+    current::time::SetNow(std::chrono::microseconds(100));
+    const std::vector<StorableString> batch({StorableString("x"), StorableString("y"), StorableString("z")});
+    ASSERT_THROW(impl.PublishBatch(batch), current::ss::InconsistentTimestampException);
+
+    // The index line for the entry not written into the file yet is not written into the index file either.
+    EXPECT_EQ(0u, impl.Publish(StorableString("0"), std::chrono::microseconds(200)).index);
+    EXPECT_EQ(1u, IndexLines());
+    EXPECT_EQ(1u, impl.Publish(StorableString("1"), std::chrono::microseconds(300)).index);
+    while (impl.Size() != 2u) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ(2u, IndexLines());
+
+    current::time::SetNow(std::chrono::microseconds(400), std::chrono::microseconds(500));
+    EXPECT_EQ(3u, impl.PublishBatch(std::vector<StorableString>({StorableString("2"), StorableString("3")})).index);
+    while (impl.Size() != 4u) {
+      std::this_thread::yield();
+    }
+    EXPECT_EQ("0/200,1/300,2/400,3/401", AllEntries(impl));
+    EXPECT_EQ(3u, IndexLines());
+  }
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, SparseFileIndex(2));
+    EXPECT_EQ("0/200,1/300,2/400,3/401", AllEntries(impl));
+  }
+}
+
+TEST(PersistenceLayer, BinaryFile) {
+  current::time::ResetToZero();
+
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::BinaryFile<StorableString>;
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(0u, impl.Size());
+    current::time::SetNow(std::chrono::microseconds(100));
+    impl.Publish(StorableString("foo"));
+    current::time::SetNow(std::chrono::microseconds(200));
+    impl.Publish(StorableString("bar"));
+    EXPECT_EQ(2u, impl.Size());
+    current::time::SetNow(std::chrono::microseconds(300));
+    impl.UpdateHead();
+    EXPECT_EQ(300, impl.CurrentHead().count());
+    current::time::SetNow(std::chrono::microseconds(500));
+    impl.Publish(StorableString("meh"));
+    current::time::SetNow(std::chrono::microseconds(550));
+    impl.UpdateHead();
+    current::time::SetNow(std::chrono::microseconds(600));
+    impl.UpdateHead();
+    EXPECT_EQ(600, impl.CurrentHead().count());
+
+    std::vector<std::string> all_three;
+    for (const auto& e : impl.Iterate()) {
+      all_three.push_back(Printf(
+          "%s %d %d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.index), static_cast<int>(e.idx_ts.us.count())));
+    }
+    EXPECT_EQ("foo 0 100,bar 1 200,meh 2 500", Join(all_three, ","));
+    std::vector<std::string> all_three_unsafe;
+    for (const auto& e : impl.IterateUnsafe()) {
+      all_three_unsafe.push_back(e);
+    }
+    EXPECT_EQ(
+        "{\"index\":0,\"us\":100}\t{\"s\":\"foo\"},"
+        "{\"index\":1,\"us\":200}\t{\"s\":\"bar\"},"
+        "{\"index\":2,\"us\":500}\t{\"s\":\"meh\"}",
+        Join(all_three_unsafe, ","));
+
+    // The zero-copy view exposes the binary representation of the entry, right from the mapped file.
+    const auto iterable = impl.Iterate(1, 2);
+    const auto iterator = iterable.begin();
+    const auto view = iterator.View();
+    EXPECT_EQ(1u, view.idx_ts.index);
+    EXPECT_EQ(200, view.idx_ts.us.count());
+    EXPECT_EQ("bar", current::LoadFromBinary<StorableString>(view.data, view.size).s);
+  }
+
+  {
+    // Confirm the data has been saved and can be replayed, including the in-place updated head.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(3u, impl.Size());
+    EXPECT_EQ(600, impl.CurrentHead().count());
+    EXPECT_EQ(500, impl.LastPublishedIndexAndTimestamp().us.count());
+
+    current::time::SetNow(std::chrono::microseconds(998));
+    impl.UpdateHead();
+    current::time::SetNow(std::chrono::microseconds(999));
+    // Called the way `Stream` calls it.
+    impl.template PersisterPublishUnsafeImpl<current::locks::MutexLockStatus::NeedToLock>(
+        "{\"index\":3,\"us\":999}\t{\"s\":\"blah\"}");
+    EXPECT_EQ(4u, impl.Size());
+
+    std::vector<std::string> last_two;
+    for (const auto& e : impl.Iterate(std::chrono::microseconds(500), std::chrono::microseconds(0))) {
+      last_two.push_back(Printf(
+          "%s %d %d", e.entry.s.c_str(), static_cast<int>(e.idx_ts.index), static_cast<int>(e.idx_ts.us.count())));
+    }
+    EXPECT_EQ("meh 2 500,blah 3 999", Join(last_two, ","));
+  }
+
+  {
+    // Confirm the appended entry is replayed as well.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    EXPECT_EQ(4u, impl.Size());
+    EXPECT_EQ(999, impl.CurrentHead().count());
+    std::vector<std::string> all_four_unsafe;
+    for (const auto& e : impl.IterateUnsafe()) {
+      all_four_unsafe.push_back(e);
+    }
+    EXPECT_EQ(
+        "{\"index\":0,\"us\":100}\t{\"s\":\"foo\"},"
+        "{\"index\":1,\"us\":200}\t{\"s\":\"bar\"},"
+        "{\"index\":2,\"us\":500}\t{\"s\":\"meh\"},"
+        "{\"index\":3,\"us\":999}\t{\"s\":\"blah\"}",
+        Join(all_four_unsafe, ","));
+  }
+}
+
+TEST(PersistenceLayer, BinaryFileExceptions) {
+  using namespace persistence_test;
+
+  using IMPL = current::persistence::BinaryFile<StorableString>;
+
+  static_assert(current::ss::IsPersister<IMPL>::value, "");
+  static_assert(current::ss::IsEntryPersister<IMPL, StorableString>::value, "");
+
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  {
+    current::time::ResetToZero();
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    ASSERT_THROW(impl.LastPublishedIndexAndTimestamp(), current::persistence::NoEntriesPublishedYet);
+    current::time::SetNow(std::chrono::microseconds(2));
+    impl.Publish(StorableString("foo"));
+    ASSERT_THROW(impl.Publish(StorableString("bar")), current::ss::InconsistentTimestampException);
+    ASSERT_THROW(impl.UpdateHead(), current::ss::InconsistentTimestampException);
+    ASSERT_THROW(impl.template PersisterPublishUnsafeImpl<current::locks::MutexLockStatus::NeedToLock>(
+                     "{\"index\":2,\"us\":3}\t{\"s\":\"bar\"}"),
+                 current::persistence::UnsafePublishBadIndexTimestampException);
+    ASSERT_THROW(impl.Iterate(1, 0), current::persistence::InvalidIterableRangeException);
+    ASSERT_THROW(impl.Iterate(100, 101), current::persistence::InvalidIterableRangeException);
+  }
+
+  const std::string valid_contents = current::FileSystem::ReadFileAsString(persistence_file_name);
+  std::mutex mutex;
+
+  // Another namespace or schema.
+  ASSERT_THROW(IMPL(mutex, current::ss::StreamNamespaceName("another", "entry_name"), persistence_file_name),
+               current::persistence::InvalidStreamSignature);
+  ASSERT_THROW(current::persistence::BinaryFile<std::string>(mutex, namespace_name, persistence_file_name),
+               current::persistence::InvalidStreamSignature);
+
+  {
+    // A flipped bit in the last record fails its CRC check.
+    std::string corrupted = valid_contents;
+    corrupted[corrupted.length() - 1] ^= 1;
+    current::FileSystem::WriteStringToFile(corrupted, persistence_file_name.c_str());
+    ASSERT_THROW(IMPL(mutex, namespace_name, persistence_file_name), current::persistence::MalformedEntryException);
+  }
+
+  {
+    // A truncated record.
+    current::FileSystem::WriteStringToFile(valid_contents.substr(0, valid_contents.length() - 1),
+                                           persistence_file_name.c_str());
+    ASSERT_THROW(IMPL(mutex, namespace_name, persistence_file_name), current::persistence::MalformedEntryException);
+  }
+
+  {
+    // Not a binary file at all.
+    current::FileSystem::WriteStringToFile("{\"index\":0,\"us\":1}\t{\"s\":\"foo\"}\n", persistence_file_name.c_str());
+    ASSERT_THROW(IMPL(mutex, namespace_name, persistence_file_name), current::persistence::MalformedEntryException);
+  }
+}
+
 TEST(PersistenceLayer, FileSafeVsUnsafeIterators) {
   using namespace persistence_test;
 
@@ -918,6 +1390,45 @@ TEST(PersistenceLayer, FileIteratorPerformanceTest) {
   }
 }
 
+TEST(PersistenceLayer, FileWithSparseIndexIteratorPerformanceTest) {
+  using namespace persistence_test;
+  using IMPL = current::persistence::File<StorableString>;
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+  const auto index_file_remover = current::FileSystem::ScopedRmFile(persistence_file_name + ".index");
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(7));
+    IteratorPerformanceTest(impl);
+  }
+  {
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name, current::persistence::SparseFileIndex(7));
+    IteratorPerformanceTest(impl, false);
+  }
+}
+
+TEST(PersistenceLayer, BinaryFileIteratorPerformanceTest) {
+  using namespace persistence_test;
+  using IMPL = current::persistence::BinaryFile<StorableString>;
+  const auto namespace_name = current::ss::StreamNamespaceName("namespace", "entry_name");
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_persistence_test_tmpdir, "data");
+  const auto file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+  {
+    // First, run the proper test.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    IteratorPerformanceTest(impl);
+  }
+  {
+    // Then, test file resume logic as well.
+    std::mutex mutex;
+    IMPL impl(mutex, namespace_name, persistence_file_name);
+    IteratorPerformanceTest(impl, false);
+  }
+}
+
 TEST(PersistenceLayer, FileIteratorCanNotOutliveFile) {
   using namespace persistence_test;
   using IMPL = current::persistence::File<std::string>;
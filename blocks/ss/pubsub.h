@@ -26,7 +26,10 @@ SOFTWARE.
 #ifndef BLOCKS_SS_PUBSUB_H
 #define BLOCKS_SS_PUBSUB_H
 
+#include <string>
 #include <type_traits>
+#include <utility>
+#include <vector>
 
 #include "../../port.h"
 
@@ -123,6 +126,56 @@ struct IsStreamPublisher {
 enum class EntryResponse { Done = 0, More = 1 };
 enum class TerminationResponse { Wait = 0, Terminate = 1 };
 
+// The consecutive entries passed at once to the subscribers declaring the batch signature,
+// `EntryResponse operator()(const EntriesBatch<ENTRY>& batch, idxts_t last)`.
+// With type filtering, the entries not passing the filter are not in the batch.
+// The entries are only valid for the duration of the call.
+template <typename ENTRY>
+class EntriesBatch final {
+ public:
+  struct Entry {
+    const idxts_t idx_ts;
+    const ENTRY& entry;
+  };
+
+  class Iterator final {
+   public:
+    using underlying_t = typename std::vector<std::pair<idxts_t, const ENTRY*>>::const_iterator;
+    explicit Iterator(underlying_t it) : it_(it) {}
+    Entry operator*() const { return Entry{it_->first, *it_->second}; }
+    Iterator& operator++() {
+      ++it_;
+      return *this;
+    }
+    bool operator==(const Iterator& rhs) const { return it_ == rhs.it_; }
+    bool operator!=(const Iterator& rhs) const { return !operator==(rhs); }
+
+   private:
+    underlying_t it_;
+  };
+
+  bool empty() const { return entries_.empty(); }
+  size_t size() const { return entries_.size(); }
+  Entry operator[](size_t i) const { return Entry{entries_[i].first, *entries_[i].second}; }
+  Entry front() const { return operator[](0u); }
+  Entry back() const { return operator[](entries_.size() - 1u); }
+  Iterator begin() const { return Iterator(entries_.begin()); }
+  Iterator end() const { return Iterator(entries_.end()); }
+
+  void clear() { entries_.clear(); }
+  void push_back(idxts_t idx_ts, const ENTRY& entry) { entries_.emplace_back(idx_ts, &entry); }
+
+ private:
+  std::vector<std::pair<idxts_t, const ENTRY*>> entries_;
+};
+
+// The consecutive raw log lines passed at once to the unchecked subscribers declaring the batch signature,
+// `EntryResponse operator()(const RawLogLinesBatch& batch, idxts_t last)`.
+struct RawLogLinesBatch final {
+  uint64_t begin_index = 0u;  // The index of `lines[0]`.
+  std::vector<std::string> lines;
+};
+
 struct GenericSubscriber {};
 
 template <typename ENTRY>
@@ -144,6 +197,18 @@ class EntrySubscriber : public GenericEntrySubscriber<ENTRY>, public IMPL {
   }
   EntryResponse operator()(std::chrono::microseconds ts) { return IMPL::operator()(ts); }
 
+  // The batch signatures are only exposed if `IMPL` declares them.
+  template <typename I = IMPL>
+  auto operator()(const EntriesBatch<ENTRY>& batch, idxts_t last)
+      -> decltype(std::declval<I&>()(batch, last), EntryResponse()) {
+    return I::operator()(batch, last);
+  }
+  template <typename I = IMPL>
+  auto operator()(const RawLogLinesBatch& batch, idxts_t last)
+      -> decltype(std::declval<I&>()(batch, last), EntryResponse()) {
+    return I::operator()(batch, last);
+  }
+
   // If a type-filtered subscriber hits the end which it doesn't see as the last entry does not pass the filter,
   // we need a way to ask that subscriber whether it wants to terminate or continue.
   EntryResponse EntryResponseIfNoMorePassTypeFilter() const { return IMPL::EntryResponseIfNoMorePassTypeFilter(); }
@@ -177,6 +242,27 @@ struct IsStreamSubscriber {
 
 namespace impl {
 
+template <typename F, typename B>
+auto AcceptsBatchImpl(int) -> decltype(std::declval<F&>()(std::declval<const B&>(), idxts_t()), std::true_type());
+template <typename F, typename B>
+std::false_type AcceptsBatchImpl(long);
+
+}  // namespace impl
+
+template <typename F, typename ENTRY>
+#ifndef CURRENT_FOR_CPP14
+inline
+#endif  // CURRENT_FOR_CPP14
+    constexpr bool accepts_entries_batch_v = decltype(impl::AcceptsBatchImpl<F, EntriesBatch<ENTRY>>(0))::value;
+
+template <typename F>
+#ifndef CURRENT_FOR_CPP14
+inline
+#endif  // CURRENT_FOR_CPP14
+    constexpr bool accepts_raw_log_lines_batch_v = decltype(impl::AcceptsBatchImpl<F, RawLogLinesBatch>(0))::value;
+
+namespace impl {
+
 template <typename TYPE_SUBSCRIBED_TO, typename STREAM_UNDERLYING_VARIANT>
 struct PassEntryToSubscriberIfTypeMatchesImpl {
   static_assert(TypeListContains<typename STREAM_UNDERLYING_VARIANT::typelist_t, TYPE_SUBSCRIBED_TO>::value,
@@ -198,6 +284,15 @@ struct PassEntryToSubscriberIfTypeMatchesImpl {
       }
     }
   }
+
+  template <typename E>
+  static bool Passes(const E& entry) {
+    return Exists<TYPE_SUBSCRIBED_TO>(entry);
+  }
+  template <typename E>
+  static const TYPE_SUBSCRIBED_TO& Filtered(const E& entry) {
+    return Value<TYPE_SUBSCRIBED_TO>(entry);
+  }
 };
 
 template <typename T>
@@ -207,6 +302,9 @@ struct PassEntryToSubscriberIfTypeMatchesImpl<T, T> {
     static_assert(IsEntrySubscriber<F, T>::value, "");
     return f(std::forward<E>(entry), current, last);
   }
+
+  static bool Passes(const T&) { return true; }
+  static const T& Filtered(const T& entry) { return entry; }
 };
 
 }  // namespace impl
@@ -217,6 +315,17 @@ EntryResponse PassEntryToSubscriberIfTypeMatches(F&& f, G&& fallback, E&& entry,
       std::forward<F>(f), std::forward<G>(fallback), std::forward<E>(entry), current, last);
 }
 
+// The per-batch counterparts of `PassEntryToSubscriberIfTypeMatches`, to filter the entries while forming the batch.
+template <typename TYPE_SUBSCRIBED_TO, typename STREAM_UNDERLYING_VARIANT, typename E>
+bool EntryPassesTypeFilter(const E& entry) {
+  return impl::PassEntryToSubscriberIfTypeMatchesImpl<TYPE_SUBSCRIBED_TO, STREAM_UNDERLYING_VARIANT>::Passes(entry);
+}
+
+template <typename TYPE_SUBSCRIBED_TO, typename STREAM_UNDERLYING_VARIANT, typename E>
+const TYPE_SUBSCRIBED_TO& TypeFilteredEntry(const E& entry) {
+  return impl::PassEntryToSubscriberIfTypeMatchesImpl<TYPE_SUBSCRIBED_TO, STREAM_UNDERLYING_VARIANT>::Filtered(entry);
+}
+
 }  // namespace ss
 }  // namespace current
 
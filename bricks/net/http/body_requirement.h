@@ -36,6 +36,11 @@ inline bool NeedContentLengthHeader(const std::string& method) {
   return method == "POST" || method == "PUT" || method == "PATCH";
 }
 
+// Per RFC 7231, section 4.2.2. The requests that are safe to retry if the connection was closed prematurely.
+inline bool IsIdempotentHTTPMethod(const std::string& method) {
+  return method == "GET" || method == "HEAD" || method == "PUT" || method == "DELETE" || method == "OPTIONS";
+}
+
 }  // namespace net
 }  // namespace current
 
@@ -50,6 +50,9 @@ constexpr char kContentLengthHeaderKey[] = "Content-Length";
 constexpr char kTransferEncodingHeaderKey[] = "Transfer-Encoding";
 constexpr char kTransferEncodingChunkedValue[] = "chunked";
 constexpr char kHTTPMethodOverrideHeaderKey[] = "X-HTTP-Method-Override";
+constexpr char kConnectionHeaderKey[] = "Connection";
+constexpr char kConnectionCloseValue[] = "close";
+constexpr char kConnectionKeepAliveValue[] = "keep-alive";
 
 // By default:
 // * HTTP responses that use `struct Response` will have the CORS header set.
@@ -65,6 +68,11 @@ constexpr size_t kMaxHTTPPayloadSizeInBytes = 1024 * 1024 * 16;
 constexpr size_t kMaxHTTPPayloadSizeInBytes = CURRENT_MAX_HTTP_PAYLOAD;
 #endif  // CURRENT_MAX_HTTP_PAYLOAD
 
+// The epoll-based HTTP server engine receives the requests up to these sizes on its own, without blocking.
+// Requests with larger headers or bodies are passed on to the worker threads to be read in the blocking mode.
+constexpr size_t kMaxHTTPPrebufferedHeaderSizeInBytes = 1024 * 64;
+constexpr size_t kMaxHTTPPrebufferedBodySizeInBytes = 1024 * 1024;
+
 }  // namespace constants
 }  // namespace net
 }  // namespace current
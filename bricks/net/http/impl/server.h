@@ -25,6 +25,9 @@ SOFTWARE.
 #ifndef BRICKS_NET_HTTP_IMPL_SERVER_H
 #define BRICKS_NET_HTTP_IMPL_SERVER_H
 
+#include <cstring>
+#include <functional>
+#include <iostream>
 #include <map>
 #include <memory>
 #include <sstream>
@@ -97,6 +100,16 @@ inline EventsJournal& HTTPDataJournal() { return current::Singleton<EventsJourna
 // HTTP response helpers. Used from both `GenericHTTPRequestData` and `GenericHTTPServerConnection`.
 struct HTTPResponder {
   typedef enum { ConnectionClose, ConnectionKeepAlive } ConnectionType;
+
+  // The connection to send the response into, along with whether it is to be kept alive after this response.
+  // Implicitly constructible from a bare `Connection&`, which is then closed after the response, as before.
+  struct Target final {
+    Connection& connection;
+    const ConnectionType connection_type;
+    Target(Connection& connection, ConnectionType connection_type = ConnectionClose)
+        : connection(connection), connection_type(connection_type) {}
+  };
+
   static void PrepareHTTPResponseHeader(std::ostream& os,
                                         ConnectionType connection_type,
                                         HTTPResponseCodeValue code = HTTPResponseCode.OK,
@@ -123,17 +136,17 @@ struct HTTPResponder {
 
   // The generic implementation.
   template <typename T>
-  static void SendHTTPResponseImpl(Connection& connection,
+  static void SendHTTPResponseImpl(Target target,
                                    const T& begin,
                                    const T& end,
                                    HTTPResponseCodeValue code,
                                    const http::Headers& headers,
                                    const std::string& content_type) {
     std::ostringstream os;
-    PrepareHTTPResponseHeader(os, ConnectionClose, code, headers, content_type);
+    PrepareHTTPResponseHeader(os, target.connection_type, code, headers, content_type);
     os << "Content-Length: " << (end - begin) << constants::kCRLF << constants::kCRLF;
-    connection.BlockingWrite(os.str(), true);
-    connection.BlockingWrite(begin, end, false);
+    target.connection.BlockingWrite(os.str(), true);
+    target.connection.BlockingWrite(begin, end, false);
   }
 
   // The actual implementations of sending the HTTP response.
@@ -143,7 +156,7 @@ struct HTTPResponder {
   // STL containers of chars and bytes, this does not yet cover std::string.
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& begin,
       const T& end,
       HTTPResponseCodeValue code,
@@ -154,7 +167,7 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& begin,
       const T& end,
       HTTPResponseCodeValue code,
@@ -165,7 +178,7 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& begin,
       const T& end,
       const std::string& content_type,
@@ -175,7 +188,7 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& begin,
       const T& end,
       const http::Headers& headers,
@@ -185,7 +198,7 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& begin,
       const T& end,
       HTTPResponseCodeValue code) {
@@ -194,7 +207,7 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& begin,
       const T& end) {
     SendHTTPResponseImpl(connection, begin, end, HTTPResponseCode.OK, http::Headers(), constants::kDefaultContentType);
@@ -203,7 +216,7 @@ struct HTTPResponder {
   // STL containers of chars and bytes.
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& obj,
       HTTPResponseCodeValue code,
       const std::string& content_type,
@@ -213,7 +226,7 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& obj,
       HTTPResponseCodeValue code,
       const http::Headers& headers,
@@ -223,7 +236,7 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& obj,
       const std::string& content_type,
       const http::Headers& headers) {
@@ -232,7 +245,7 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& obj,
       const http::Headers& headers,
       const std::string& content_type) {
@@ -241,20 +254,20 @@ struct HTTPResponder {
 
   template <typename T>
   static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       const T& obj,
       HTTPResponseCodeValue code) {
     SendHTTPResponseImpl(connection, obj.begin(), obj.end(), code, http::Headers(), constants::kDefaultContentType);
   }
 
   template <typename T>
-  static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse( Connection& connection,
+  static std::enable_if_t<sizeof(typename T::value_type) == 1> SendHTTPResponse(Target connection,
       const T& obj) {
     SendHTTPResponseImpl(connection, obj.begin(), obj.end(), HTTPResponseCode.OK, http::Headers(), constants::kDefaultContentType);
   }
 
   // Special case to handle std::string.
-  static void SendHTTPResponse(Connection& connection,
+  static void SendHTTPResponse(Target connection,
                                const std::string& string,
                                HTTPResponseCodeValue code,
                                const http::Headers& headers,
@@ -262,21 +275,21 @@ struct HTTPResponder {
     SendHTTPResponseImpl(connection, string.begin(), string.end(), code, headers, content_type);
   }
 
-  static void SendHTTPResponse(Connection& connection,
+  static void SendHTTPResponse(Target connection,
                                const std::string& string,
                                HTTPResponseCodeValue code,
                                const http::Headers& headers) {
     SendHTTPResponseImpl(connection, string.begin(), string.end(), code, headers, constants::kDefaultContentType);
   }
 
-  static void SendHTTPResponse(Connection& connection,
+  static void SendHTTPResponse(Target connection,
                                const std::string& string,
                                HTTPResponseCodeValue code,
                                const std::string& content_type) {
     SendHTTPResponseImpl(connection, string.begin(), string.end(), code, http::Headers(), content_type);
   }
 
-  static void SendHTTPResponse(Connection& connection, const std::string& string, HTTPResponseCodeValue code) {
+  static void SendHTTPResponse(Target connection, const std::string& string, HTTPResponseCodeValue code) {
     SendHTTPResponseImpl(connection,
                          string.begin(),
                          string.end(),
@@ -285,7 +298,7 @@ struct HTTPResponder {
                          constants::kDefaultContentType);
   }
 
-  static void SendHTTPResponse(Connection& connection, const std::string& string) {
+  static void SendHTTPResponse(Target connection, const std::string& string) {
     SendHTTPResponseImpl(connection,
                          string.begin(),
                          string.end(),
@@ -297,7 +310,7 @@ struct HTTPResponder {
   // Support `CURRENT_STRUCT`-s and `CURRENT_VARIANT`-s.
   template <class T>
   static std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(current::decay_t<T>)> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       T&& object,
       HTTPResponseCodeValue code,
       const http::Headers& headers,
@@ -309,7 +322,7 @@ struct HTTPResponder {
 
   template <class T>
   static std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(current::decay_t<T>)> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       T&& object,
       HTTPResponseCodeValue code,
       const http::Headers& headers) {
@@ -320,7 +333,7 @@ struct HTTPResponder {
 
   template <class T>
   static std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(current::decay_t<T>)> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       T&& object,
       HTTPResponseCodeValue code,
       const std::string& content_type) {
@@ -331,7 +344,7 @@ struct HTTPResponder {
 
   template <class T>
   static std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(current::decay_t<T>)> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       T&& object,
       HTTPResponseCodeValue code) {
     // TODO(dkorolev): We should probably make this not only correct but also efficient.
@@ -341,7 +354,7 @@ struct HTTPResponder {
 
   template <class T>
   static std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(current::decay_t<T>)> SendHTTPResponse(
-      Connection& connection,
+      Target connection,
       T&& object) {
     // TODO(dkorolev): We should probably make this not only correct but also efficient.
     const std::string s = JSON(std::forward<T>(object)) + '\n';
@@ -478,6 +491,11 @@ class GenericHTTPRequestData : public HELPER {
               raw_path_ = pieces[1];
               url_ = current::url::URL(raw_path_);
             }
+            // HTTP/1.1 connections are persistent by default, HTTP/1.0 ones only if explicitly asked to be.
+            // The version is the first token of a response's status line, and the third one of a request's line.
+            const bool is_response = (!pieces.empty() && !pieces[0].compare(0, 5, "HTTP/"));
+            const std::string* version = is_response ? &pieces[0] : (pieces.size() >= 3 ? &pieces[2] : nullptr);
+            keep_alive_requested_ = (version && *version != "HTTP/1.0");
             first_line_parsed = true;
           }
         } else if (receiving_body_in_chunks) {
@@ -499,6 +517,12 @@ class GenericHTTPRequestData : public HELPER {
             if (chunk_length == 0) {
               // Done with the body.
               HELPER::OnChunkedBodyDone(body_buffer_begin_, body_buffer_end_);
+              // Skip the blank line that terminates the chunked body, if it has already been received.
+              if (offset >= next_line_offset + constants::kCRLFLength &&
+                  !std::memcmp(&buffer_[next_line_offset], constants::kCRLF, constants::kCRLFLength)) {
+                next_line_offset += constants::kCRLFLength;
+              }
+              GiveBackReceivedDataPastTheRequest(c, next_line_offset, offset);
               return;
             } else {
               // A chunk of length `chunk_length` bytes starts right at next_line_offset.
@@ -563,6 +587,7 @@ class GenericHTTPRequestData : public HELPER {
             HELPER::OnHeader(key, value);
             if (HeaderNameEquals(key, constants::kContentLengthHeaderKey)) {
               body_length = static_cast<size_t>(atoi(value));
+              body_length_known_ = true;
               if (body_length > constants::kMaxHTTPPayloadSizeInBytes) {
                 HTTPResponder::SendHTTPResponse(c,
                                                 net::DefaultRequestEntityTooLargeMessage(),
@@ -571,11 +596,19 @@ class GenericHTTPRequestData : public HELPER {
                                                 net::constants::kDefaultHTMLContentType);
                 CURRENT_THROW(HTTPPayloadTooLarge());
               }
+            } else if (HeaderNameEquals(key, constants::kConnectionHeaderKey)) {
+              const std::string connection = current::strings::ToLower(value);
+              if (connection.find(constants::kConnectionCloseValue) != std::string::npos) {
+                keep_alive_requested_ = false;
+              } else if (connection.find(constants::kConnectionKeepAliveValue) != std::string::npos) {
+                keep_alive_requested_ = true;
+              }
             } else if (HeaderNameEquals(key, constants::kHTTPMethodOverrideHeaderKey)) {
               method_ = current::strings::ToUpper(value);
             } else if (HeaderNameEquals(key, constants::kTransferEncodingHeaderKey)) {
               if (HeaderNameEquals(value, constants::kTransferEncodingChunkedValue)) {
                 chunked_transfer_encoding = true;
+                body_length_known_ = true;
               }
             }
           }
@@ -602,6 +635,7 @@ class GenericHTTPRequestData : public HELPER {
               }
               body_buffer_begin_ = &buffer_[body_offset];
               body_buffer_end_ = body_buffer_begin_ + body_length;
+              GiveBackReceivedDataPastTheRequest(c, length_cap, offset);
               return;
             } else {
               if (NeedContentLengthHeader(method_)) {
@@ -612,6 +646,7 @@ class GenericHTTPRequestData : public HELPER {
                                                 net::constants::kDefaultHTMLContentType);
                 CURRENT_THROW(HTTPRequestBodyLengthNotProvided());
               }
+              GiveBackReceivedDataPastTheRequest(c, body_offset, offset);
               return;
             }
           } else {
@@ -640,6 +675,14 @@ class GenericHTTPRequestData : public HELPER {
   inline const current::url::URL& URL() const { return url_; }
   inline const std::string& RawPath() const { return raw_path_; }
 
+  // Whether the client wants the connection to be kept alive after the response, per the HTTP version and the
+  // `Connection` header. It is up to the server whether to honor it.
+  inline bool KeepAliveRequested() const { return keep_alive_requested_; }
+
+  // Whether the end of the message is known from `Content-Length` or from the chunked encoding, as opposed to
+  // the message body possibly extending until the connection is closed.
+  inline bool BodyLengthKnown() const { return body_length_known_; }
+
   // Note that `Body*()` methods assume that the body was fully read into memory.
   // If other means of reading the body, for example, event-based chunk parsing, is used,
   // then `Body()` will return empty string and all other `Body*()` methods will return nullptr.
@@ -669,6 +712,14 @@ class GenericHTTPRequestData : public HELPER {
   }
 
  private:
+  // The bytes read past the end of this request belong to the next, pipelined, one.
+  // Give them back to the connection, so that they are not lost if it is kept alive to serve more requests.
+  void GiveBackReceivedDataPastTheRequest(Connection& c, size_t request_end_offset, size_t offset) {
+    if (offset > request_end_offset) {
+      c.PrependReceivedData(std::string(&buffer_[request_end_offset], &buffer_[offset]));
+    }
+  }
+
   static char NormalizeHeaderChar(char c) { return c != '_' ? std::tolower(c) : '-'; }
   static bool HeaderNameEquals(const char* lhs, const char* rhs) {
     while (*lhs && *rhs) {
@@ -683,6 +734,8 @@ class GenericHTTPRequestData : public HELPER {
   std::string method_;
   current::url::URL url_;
   std::string raw_path_;
+  bool keep_alive_requested_ = false;
+  bool body_length_known_ = false;
 
   // HTTP parsing fields that have to be caried out of the parsing routine.
   std::vector<char> buffer_;                 // The buffer into which data has been read, except for chunked case.
@@ -718,7 +771,15 @@ class GenericHTTPServerConnection final : public HTTPResponder {
       const double buffer_growth_k = 1.95)
       : connection_(std::move(c)), message_(connection_, params, initial_buffer_size, buffer_growth_k) {}
   ~GenericHTTPServerConnection() {
-    if (!responded_) {
+    if (response_complete_ && keep_alive_ && message_.KeepAliveRequested()) {
+      // The response has been sent in full, and the connection is to be kept alive to serve more requests.
+      // Pass it on to the server, along with the data of the pipelined requests, if any, received so far.
+      try {
+        keep_alive_(std::move(connection_));
+      } catch (const Exception& e) {                                          // LCOV_EXCL_LINE
+        std::cerr << "Could not keep the connection alive: " << e.what() << std::endl;  // LCOV_EXCL_LINE
+      }
+    } else if (!responded_) {
       // If a user code throws an exception in a different thread, it will not be caught.
       // But, at least, capitalized "INTERNAL SERVER ERROR" will be returned.
       // It's also a good place for a breakpoint to tell the source of that exception.
@@ -750,8 +811,9 @@ class GenericHTTPServerConnection final : public HTTPResponder {
     if (responded_) {
       CURRENT_THROW(AttemptedToSendHTTPResponseMoreThanOnce());
     } else {
-      HTTPResponder::SendHTTPResponse(connection_, std::forward<ARGS>(args)...);
+      HTTPResponder::SendHTTPResponse(Target(connection_, ResponseConnectionType()), std::forward<ARGS>(args)...);
       responded_ = true;
+      response_complete_ = true;
     }
   }
 
@@ -760,7 +822,8 @@ class GenericHTTPServerConnection final : public HTTPResponder {
   struct ChunkedResponseSender final {
     // `struct Impl` is the logic wrapped into an `std::unique_ptr<>` to call the destructor only once.
     struct Impl final {
-      explicit Impl(Connection& connection) : connection_(connection) {}
+      Impl(Connection& connection, bool* response_complete)
+          : connection_(connection), response_complete_(response_complete) {}
 
       ~Impl() {
         if (!can_no_longer_write_) {
@@ -772,6 +835,9 @@ class GenericHTTPServerConnection final : public HTTPResponder {
             // Should send CRLF twice.
             connection_.BlockingWrite(constants::kCRLF, true);
             connection_.BlockingWrite(constants::kCRLF, false);
+            if (response_complete_) {
+              *response_complete_ = true;
+            }
           } catch (const SocketException& e) {                                          // LCOV_EXCL_LINE
             std::cerr << "Chunked response closure failed: " << e.what() << std::endl;  // LCOV_EXCL_LINE
           }                                                                             // LCOV_EXCL_LINE
@@ -837,6 +903,7 @@ class GenericHTTPServerConnection final : public HTTPResponder {
       }
 
       Connection& connection_;
+      bool* const response_complete_;
       bool can_no_longer_write_ = false;
       char data_cache_[CACHE_SIZE];
       uint64_t cache_size_ = 0;
@@ -848,7 +915,9 @@ class GenericHTTPServerConnection final : public HTTPResponder {
       void operator=(Impl&&) = delete;
     };
 
-    explicit ChunkedResponseSender(Connection& connection) : impl_(new Impl(connection)) {}
+    // If set, `*response_complete` is set to true once the terminating zero-length chunk has been sent.
+    explicit ChunkedResponseSender(Connection& connection, bool* response_complete = nullptr)
+        : impl_(new Impl(connection, response_complete)) {}
 
     template <typename T>
     inline ChunkedResponseSender& Send(T&& data, ChunkFlush flush = ChunkFlush::Flush) {
@@ -890,7 +959,7 @@ class GenericHTTPServerConnection final : public HTTPResponder {
       PrepareHTTPResponseHeader(os, ConnectionKeepAlive, code, headers, content_type);
       os << "Transfer-Encoding: chunked" << constants::kCRLF << constants::kCRLF;
       connection_.BlockingWrite(os.str(), true);
-      return ChunkedResponseSender<CACHE_SIZE>(connection_);
+      return ChunkedResponseSender<CACHE_SIZE>(connection_, &response_complete_);
     }
   }
 
@@ -910,8 +979,20 @@ class GenericHTTPServerConnection final : public HTTPResponder {
 
   Connection& RawConnection() { return connection_; }
 
+  // Used by the server engines that support persistent connections. If the client has asked for the connection to
+  // be kept alive, the response says so, and, once it has been sent in full, the connection is passed on to
+  // `keep_alive` from the destructor, to serve the next request. Responses sent via `RawConnection()` are not
+  // tracked, so after those the connection is closed, as it is when no `keep_alive` is set.
+  void SetKeepAliveHandler(std::function<void(Connection&&)> keep_alive) { keep_alive_ = std::move(keep_alive); }
+
  private:
+  HTTPResponder::ConnectionType ResponseConnectionType() const {
+    return (keep_alive_ && message_.KeepAliveRequested()) ? ConnectionKeepAlive : ConnectionClose;
+  }
+
   bool responded_ = false;
+  bool response_complete_ = false;
+  std::function<void(Connection&&)> keep_alive_;
   Connection connection_;
   GenericHTTPRequestData<HTTP_REQUEST_DATA> message_;
 
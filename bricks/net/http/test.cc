@@ -105,6 +105,31 @@ TEST(PosixHTTPServerTest, Smoke) {
   t.join();
 }
 
+TEST(PosixHTTPServerTest, KeepAliveIsTakenFromTheHTTPVersion) {
+  // The same parser reads both the requests and, in the HTTP client, the responses.
+  const auto keep_alive_requested = [](const std::string& message) {
+    auto reserved_port = current::net::ReserveLocalPort();
+    const int port = reserved_port;
+    std::thread t(
+        [&message](Socket s) {
+          Connection c(s.Accept());
+          c.BlockingWrite(message, false);
+        },
+        std::move(reserved_port));
+    Connection connection(ClientSocket("localhost", port));
+    const bool result = HTTPRequestData(connection).KeepAliveRequested();
+    t.join();
+    return result;
+  };
+  EXPECT_TRUE(keep_alive_requested("GET / HTTP/1.1\r\n\r\n"));
+  EXPECT_FALSE(keep_alive_requested("GET / HTTP/1.0\r\n\r\n"));
+  EXPECT_TRUE(keep_alive_requested("GET / HTTP/1.0\r\nConnection: keep-alive\r\n\r\n"));
+  EXPECT_TRUE(keep_alive_requested("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nOK"));
+  EXPECT_FALSE(keep_alive_requested("HTTP/1.1 200 OK\r\nConnection: close\r\nContent-Length: 2\r\n\r\nOK"));
+  EXPECT_FALSE(keep_alive_requested("HTTP/1.0 200 OK\r\nContent-Length: 2\r\n\r\nOK"));
+  EXPECT_FALSE(keep_alive_requested("HTTP/1.0 404 Not Found\r\nContent-Length: 2\r\n\r\nNo"));
+}
+
 TEST(PosixHTTPServerTest, SmokeWithTrailingSpaces) {
   auto reserved_port = current::net::ReserveLocalPort();
   const int port = reserved_port;
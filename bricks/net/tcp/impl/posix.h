@@ -66,6 +66,7 @@ typedef int SOCKET;
 
 #endif  // CURRENT_WINDOWS
 
+#include <algorithm>
 #include <iostream>
 #include <cstring>
 #include <string>
@@ -412,6 +413,25 @@ class Connection : public SocketHandle {
 
   const IPAndPort& RemoteIPAndPort() const { return remote_ip_and_port_; }
 
+  // Makes the next `BlockingRead()`-s return `data` first, before reading anything more from the socket.
+  // Used by the server engines that receive the beginning of the request on their own, and by the HTTP parser
+  // to give back the bytes of the pipelined requests it has read past the end of the current one.
+  void PrependReceivedData(std::string data) {
+    if (received_data_offset_ < received_data_.size()) {
+      data.append(received_data_, received_data_offset_, std::string::npos);
+    }
+    received_data_ = std::move(data);
+    received_data_offset_ = 0u;
+  }
+
+  // Returns and forgets the data prepended via `PrependReceivedData()` and not yet returned by `BlockingRead()`.
+  std::string TakeReceivedData() {
+    std::string result = received_data_.substr(std::min(received_data_offset_, received_data_.size()));
+    received_data_.clear();
+    received_data_offset_ = 0u;
+    return result;
+  }
+
   // By default, BlockingRead() will return as soon as some data has been read,
   // with the exception being multibyte records (sizeof(T) > 1), where it will keep reading
   // until the boundary of the records, or max_length of them, has been read.
@@ -429,6 +449,20 @@ class Connection : public SocketHandle {
       const uint8_t* end = (buffer + max_length);
       const int flags = ((policy == BlockingReadPolicy::ReturnASAP) ? 0 : MSG_WAITALL);
 
+      if (received_data_offset_ < received_data_.size()) {
+        const size_t n = std::min(max_length, received_data_.size() - received_data_offset_);
+        std::memcpy(ptr, received_data_.data() + received_data_offset_, n);
+        ptr += n;
+        received_data_offset_ += n;
+        if (received_data_offset_ == received_data_.size()) {
+          received_data_.clear();
+          received_data_offset_ = 0u;
+        }
+        if ((policy == BlockingReadPolicy::ReturnASAP) || (ptr == end)) {
+          return (ptr - buffer);
+        }
+      }
+
 #ifdef CURRENT_WINDOWS
       int wsa_last_error = 0;
 #endif
@@ -576,6 +610,10 @@ class Connection : public SocketHandle {
   const IPAndPort local_ip_and_port_;
   const IPAndPort remote_ip_and_port_;
 
+  // The data already received from the socket, to be returned by `BlockingRead()` first. See `PrependReceivedData()`.
+  std::string received_data_;
+  size_t received_data_offset_ = 0u;
+
   Connection() = delete;
   Connection(const Connection&) = delete;
   void operator=(const Connection&) = delete;
@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include <atomic>
 #include <condition_variable>
+#include <functional>
 #include <mutex>
 #include <unordered_set>
 
@@ -41,6 +42,11 @@ class WaitableTerminateSignal {
  public:
   explicit WaitableTerminateSignal() noexcept : stop_signal_(false) {}
 
+  // The signal can also be waited upon without a thread blocked on it: `on_event` is then called
+  // on every notification and on the termination signal, for the waiting party to be woken up its own way.
+  explicit WaitableTerminateSignal(std::function<void()> on_event) noexcept
+      : stop_signal_(false), on_event_(std::move(on_event)) {}
+
   // Can always check whether it is time to terminate. Thread-safe.
   operator bool() const noexcept { return stop_signal_; }
 
@@ -48,11 +54,19 @@ class WaitableTerminateSignal {
   void SignalExternalTermination() noexcept {
     stop_signal_ = true;
     condition_variable_.notify_all();
+    if (on_event_) {
+      on_event_();
+    }
   }
 
   // To be called by external users that the thread using this `WaitableTerminateSignal` could wait upon.
   // Thread-safe.
-  void NotifyOfExternalWaitableEvent() { condition_variable_.notify_all(); }
+  void NotifyOfExternalWaitableEvent() {
+    condition_variable_.notify_all();
+    if (on_event_) {
+      on_event_();
+    }
+  }
 
   // Waits until the provided method returns `true`, or until `SignalExternalTermination()` has been called.
   template <typename F>
@@ -76,6 +90,7 @@ class WaitableTerminateSignal {
 
   std::atomic_bool stop_signal_;
   std::condition_variable condition_variable_;
+  const std::function<void()> on_event_;
 };
 
 // Enables subscribing multiple `WaitableTerminateSignal`-s to be notified of new events at once.
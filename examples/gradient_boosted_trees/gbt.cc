@@ -41,6 +41,7 @@ DEFINE_uint32(trees, 2500, "The number of trees to train.");
 DEFINE_uint32(tree_depth, 5, "If nonzero, the maximum depth of each tree.");
 DEFINE_double(fraction_of_features_to_use_per_iteration, 0.4, "The fraction of features to use per tree.");
 DEFINE_int32(debug_iterations_frequency, 25, "If nonzero, debug output each N-th iteration.");
+DEFINE_uint32(threads, 0, "The number of threads to look for the best splits in, 0 to use all the cores.");
 DEFINE_bool(log_trees, false, "Set to true to log each tree in a pseudo-JSON (node.js-friendly) format.");
 
 // TODO(dkorolev): Rand seed?
@@ -170,7 +171,8 @@ int main(int argc, char** argv) {
                       dense_transposed_matrix,
                       input.weights,
                       input.feature_names,
-                      logging_ostream);
+                      logging_ostream,
+                      FLAGS_threads ? FLAGS_threads : std::max(std::thread::hardware_concurrency(), 1u));
   const double param_ff = FLAGS_fraction_of_features_to_use_per_iteration;
   CURRENT_ASSERT(param_ff > 0);
   CURRENT_ASSERT(param_ff <= 1);
@@ -202,9 +204,7 @@ int main(int argc, char** argv) {
         param_td);
     CURRENT_ASSERT(builder.TreesCount() == tree + 1);
 
-    for (size_t i = 0; i < N; ++i) {
-      output[i] += builder.Apply(ti, [&](size_t feature_index) { return dense_transposed_matrix[feature_index][i]; });
-    }
+    builder.ApplyToAllPoints(ti, output);
 
     if (FLAGS_debug_iterations_frequency && ((tree + 1) % FLAGS_debug_iterations_frequency) == 0) {
       const double area = ComputeAreaUnderPrecisionRecallCurve(output, input.labels, test_points);
@@ -0,0 +1,124 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef EXAMPLES_GRADIENT_BOOSTED_TREES_PARALLEL_FOR_H
+#define EXAMPLES_GRADIENT_BOOSTED_TREES_PARALLEL_FOR_H
+
+#include "../../current.h"
+
+// Runs `f(i)` for each `i` in `[0, n)` on a fixed set of threads, the calling one included, and returns when done.
+// The threads are started once, so that running many short jobs, such as one per tree node, is cheap.
+class ParallelFor {
+ public:
+  explicit ParallelFor(size_t threads) {
+    for (size_t i = 1; i < threads; ++i) {
+      workers_.emplace_back([this]() { WorkerThread(); });
+    }
+  }
+
+  ~ParallelFor() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      destructing_ = true;
+    }
+    job_ready_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  size_t Threads() const { return workers_.size() + 1u; }
+
+  template <typename F>
+  void operator()(size_t n, F&& f) {
+    if (workers_.empty() || n < 2u) {
+      for (size_t i = 0; i < n; ++i) {
+        f(i);
+      }
+      return;
+    }
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      job_context_ = &f;
+      job_function_ = [](void* context, size_t i) { (*static_cast<std::remove_reference_t<F>*>(context))(i); };
+      job_n_ = n;
+      next_index_ = 0u;
+      busy_workers_ = workers_.size();
+      ++generation_;
+    }
+    job_ready_.notify_all();
+    RunJob();
+    std::unique_lock<std::mutex> lock(mutex_);
+    job_done_.wait(lock, [this]() { return busy_workers_ == 0u; });
+  }
+
+ private:
+  void RunJob() {
+    for (size_t i = next_index_++; i < job_n_; i = next_index_++) {
+      job_function_(job_context_, i);
+    }
+  }
+
+  void WorkerThread() {
+    uint64_t seen_generation = 0u;
+    while (true) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        job_ready_.wait(lock, [this, seen_generation]() { return destructing_ || generation_ != seen_generation; });
+        if (destructing_) {
+          return;
+        }
+        seen_generation = generation_;
+      }
+      RunJob();
+      {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (--busy_workers_ == 0u) {
+          job_done_.notify_one();
+        }
+      }
+    }
+  }
+
+  std::vector<std::thread> workers_;
+  std::mutex mutex_;
+  std::condition_variable job_ready_;
+  std::condition_variable job_done_;
+  bool destructing_ = false;
+  uint64_t generation_ = 0u;
+  size_t busy_workers_ = 0u;
+
+  // The job being run: `job_function_(job_context_, i)` for each `i` in `[0, job_n_)`, the indexes claimed one by one.
+  void* job_context_ = nullptr;
+  void (*job_function_)(void*, size_t) = nullptr;
+  size_t job_n_ = 0u;
+  std::atomic<size_t> next_index_{0u};
+
+  ParallelFor(const ParallelFor&) = delete;
+  ParallelFor(ParallelFor&&) = delete;
+  ParallelFor& operator=(const ParallelFor&) = delete;
+  ParallelFor& operator=(ParallelFor&&) = delete;
+};
+
+#endif  // EXAMPLES_GRADIENT_BOOSTED_TREES_PARALLEL_FOR_H
@@ -37,6 +37,7 @@ SOFTWARE.
 
 #include "schema.h"
 #include "iterable_subset.h"
+#include "parallel_for.h"
 
 #define GBT_LARGE_EPSILON 0.001  // For relative improvements in standard deviation, which is computed in doubles.
 
@@ -60,6 +61,23 @@ class TreeBuilder {
   size_t* features_to_consider_begin_;
   size_t* features_to_consider_end_;
 
+  // Per-feature sums over the points of the node being split, one set per depth, so that the parent's ones are
+  // still around when its children are split. The "no" child gets its sums as the parent's minus the "yes" child's,
+  // and thus only the "yes" child makes a pass over the data.
+  struct FeatureStats {
+    int64_t sum_p1;
+    int64_t sum_p2;
+    uint64_t n;
+  };
+  struct LevelStats {
+    std::vector<FeatureStats> stats;  // `.size()` == m_, only the features to consider are valid.
+    bool ready = false;
+  };
+  std::deque<LevelStats> stats_per_depth_;
+  std::vector<uint64_t> point_in_node_;  // The bitset of the points of the node, set only while computing its sums.
+  ParallelFor parallel_for_;             // Computes the per-feature sums, one feature per job.
+  std::vector<size_t> points_to_apply_;  // The scratch space for `ApplyToAllPoints()`.
+
   // Output members: The tree(s) being built. The trees are stored in a single array of nodes or leaves.
   TreeEnsemble ensemble_;
 
@@ -86,7 +104,8 @@ class TreeBuilder {
               const std::vector<std::vector<bool>>& transposed_matrix,
               const Optional<std::vector<double>> weights,
               const Optional<std::vector<std::string>>& feature_names,
-              std::ostream* dump_ostream = nullptr)
+              std::ostream* dump_ostream = nullptr,
+              size_t threads = 1u)
       : n_(n),
         m_(transposed_matrix_adjacency_lists.size()),
         g_(transposed_matrix_adjacency_lists),
@@ -94,7 +113,9 @@ class TreeBuilder {
         weights_(weights),
         dump_ostream_(dump_ostream),
         feature_names_(feature_names),
-        points_to_consider_(n_) {
+        points_to_consider_(n_),
+        point_in_node_((n_ + 63u) / 64u, 0u),
+        parallel_for_(std::max(threads, static_cast<size_t>(1u))) {
     for (const auto& col : g_) {
       for (uint32_t point_index : col) {
         CURRENT_ASSERT(point_index < static_cast<uint32_t>(n_));
@@ -159,8 +180,90 @@ class TreeBuilder {
     return ensemble_.nodes[i].value;
   }
 
+  // Adds the value of the tree to `output[i]` for each of the `n_` points, same as `Apply()` would. The points are
+  // partitioned down the tree in one batch, so that each node reads its feature's column once, and not per point.
+  void ApplyToAllPoints(TreeIndex index, std::vector<int64_t>& output) {
+    CURRENT_ASSERT(output.size() == n_);
+    points_to_apply_.resize(n_);
+    for (size_t i = 0; i < n_; ++i) {
+      points_to_apply_[i] = i;
+    }
+    struct Span {
+      size_t node;
+      size_t* begin;
+      size_t* end;
+    };
+    std::vector<Span> stack;
+    stack.push_back(Span{static_cast<size_t>(index), &points_to_apply_[0], &points_to_apply_[0] + n_});
+    while (!stack.empty()) {
+      const Span span = stack.back();
+      stack.pop_back();
+      CURRENT_ASSERT(span.node < ensemble_.nodes.size());
+      const auto& node = ensemble_.nodes[span.node];
+      if (node.leaf) {
+        const int64_t value = static_cast<int64_t>(node.value);
+        for (size_t* it = span.begin; it != span.end; ++it) {
+          output[*it] += value;
+        }
+      } else {
+        const std::vector<bool>& matrix_row = matrix_[node.feature];
+        size_t* midpoint = std::partition(span.begin, span.end, [&](size_t point) { return matrix_row[point]; });
+        if (span.begin != midpoint) {
+          stack.push_back(Span{static_cast<size_t>(node.yes), span.begin, midpoint});
+        }
+        if (midpoint != span.end) {
+          stack.push_back(Span{static_cast<size_t>(node.no), midpoint, span.end});
+        }
+      }
+    }
+  }
+
  private:
-  TreeIndex BuildTreeRecursively(size_t depth) {
+  LevelStats& StatsAtDepth(size_t depth) {
+    while (stats_per_depth_.size() <= depth) {
+      stats_per_depth_.emplace_back();
+      stats_per_depth_.back().stats.resize(m_);
+    }
+    return stats_per_depth_[depth];
+  }
+
+  // Computes the per-feature sums over the points to consider, for the features to consider, in parallel.
+  void ComputeFeatureStats(LevelStats& level) {
+    for (size_t point : points_to_consider_) {
+      point_in_node_[point >> 6] |= (1ull << (point & 63u));
+    }
+    size_t const* features = features_to_consider_begin_;
+    parallel_for_(static_cast<size_t>(features_to_consider_end_ - features_to_consider_begin_), [&](size_t i) {
+      const size_t feature = features[i];
+      FeatureStats stats{0, 0, 0u};
+      for (const uint32_t point : g_[feature]) {
+        if (point_in_node_[point >> 6] & (1ull << (point & 63u))) {
+          const int64_t y = (*py_)[point];
+          stats.sum_p1 += y;
+          stats.sum_p2 += y * y;
+          ++stats.n;
+        }
+      }
+      level.stats[feature] = stats;
+    });
+    for (size_t point : points_to_consider_) {
+      point_in_node_[point >> 6] = 0u;
+    }
+    level.ready = true;
+  }
+
+  // Turns the sums of the "yes" child, kept in `level`, into the sums of its "no" sibling, in place.
+  void SubtractFeatureStatsFrom(const LevelStats& parent, LevelStats& level) {
+    for (size_t* feature_it = features_to_consider_begin_; feature_it != features_to_consider_end_; ++feature_it) {
+      const FeatureStats& total = parent.stats[*feature_it];
+      FeatureStats& stats = level.stats[*feature_it];
+      stats.sum_p1 = total.sum_p1 - stats.sum_p1;
+      stats.sum_p2 = total.sum_p2 - stats.sum_p2;
+      stats.n = total.n - stats.n;
+    }
+  }
+
+  TreeIndex BuildTreeRecursively(size_t depth, bool stats_from_sibling = false) {
     static const size_t indent_max_spaces = 1000u * 100u;
     static const std::string indent_placeholder(indent_max_spaces, ' ');
     const size_t indent_size = ((depth + 1) * 2);
@@ -174,6 +277,15 @@ class TreeBuilder {
     const size_t node_index = ensemble_.nodes.size();
     ensemble_.nodes.resize(ensemble_.nodes.size() + 1u);
 
+    // Only the nodes which may be split need the per-feature sums; the "yes" child tells its sibling if it has them.
+    LevelStats* level = nullptr;
+    if (depth < max_depth_) {
+      level = &StatsAtDepth(depth);
+      if (!stats_from_sibling) {
+        level->ready = false;
+      }
+    }
+
     // Sum and sum of squares of the values of the objective function per points considered.
     int64_t sum_p1 = 0;
     int64_t sum_p2 = 0;
@@ -234,20 +346,23 @@ class TreeBuilder {
 
       // Find the best features to split the tree by.
       // The best feature is the one that minimizes the sum of penalties in the left and right subtrees.
+      // No need to look for one beyond the maximum depth, as the node would become a leaf regardless.
       std::pair<double, size_t*> best_candidate(1.0 - GBT_LARGE_EPSILON, nullptr);
-      for (size_t* feature_it = features_to_consider_begin_; feature_it != features_to_consider_end_; ++feature_it) {
-        const size_t feature = *feature_it;
-        int64_t candidate_lhs_sum_p1 = 0;
-        int64_t candidate_lhs_sum_p2 = 0;
-        uint64_t candidate_lhs_n = 0;
-        for (const int32_t point : g_[feature]) {
-          if (points_to_consider_[point]) {
-            const int64_t y = (*py_)[point];
-            candidate_lhs_sum_p1 += y;
-            candidate_lhs_sum_p2 += y * y;
-            ++candidate_lhs_n;
-          }
+      if (level) {
+        if (stats_from_sibling) {
+          SubtractFeatureStatsFrom(stats_per_depth_[depth - 1u], *level);
+        } else {
+          ComputeFeatureStats(*level);
         }
+      }
+      for (size_t* feature_it = level ? features_to_consider_begin_ : features_to_consider_end_;
+           feature_it != features_to_consider_end_;
+           ++feature_it) {
+        const size_t feature = *feature_it;
+        const FeatureStats& stats = level->stats[feature];
+        const int64_t candidate_lhs_sum_p1 = stats.sum_p1;
+        const int64_t candidate_lhs_sum_p2 = stats.sum_p2;
+        const uint64_t candidate_lhs_n = stats.n;
         GBT_EXTRA_CHECK(CURRENT_ASSERT(candidate_lhs_n <= n_points));
         if (candidate_lhs_n > 0 && candidate_lhs_n < n_points) {
           // TODO(dkorolev): Better check by weight here; maybe even have weights as integers too, and carry them down.
@@ -335,7 +450,10 @@ class TreeBuilder {
               if (dump_ostream_) {
                 *dump_ostream_ << indent << "}, no: {\n";
               }
-              ensemble_.nodes[node_index].no = static_cast<size_t>(BuildTreeRecursively(depth + 1));
+              // The "yes" child has left its sums in place if it has computed them, and its subtree only goes deeper.
+              const bool sibling_stats_ready = (depth + 1 < max_depth_) && stats_per_depth_[depth + 1].ready;
+              ensemble_.nodes[node_index].no =
+                  static_cast<size_t>(BuildTreeRecursively(depth + 1, sibling_stats_ready));
               if (dump_ostream_) {
                 *dump_ostream_ << indent << "} },\n";
               }
@@ -27,8 +27,9 @@ SOFTWARE.
 // Karl's storage model contains of the following pieces:
 //
 // 1) The Stream `Stream` of all keepalives received. Persisted on disk, not stored in memory.
-//    Each "visualize production" request (be it JSON or SVG response) replays that stream over the desired
-//    period of time. Most commonly it's the past five minutes.
+//    Karl keeps the most recent keepalive per codename in memory, updated as keepalives arrive, so that
+//    the "visualize production" requests (be it JSON or SVG response) for the windows ending at the present
+//    moment, most commonly the past five minutes, do not replay the stream. Other windows still replay it.
 //
 // 2) The `Storage`, over a separate stream, to retain the information which may be required outside the
 //    "visualized" time window. Includes Karl's launch history, and per-service codename -> build::BuildInfo.
@@ -68,6 +69,7 @@ SOFTWARE.
 #include "../bricks/util/base64.h"
 
 #include "../blocks/http/api.h"
+#include "../blocks/mmq/mmq.h"
 
 #include "../utils/nginx/nginx.h"
 
@@ -259,6 +261,69 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
   using karl_nginx_manager_t::UpdateNginxIfNeeded;
   using karl_storage_t::storage_;
 
+  // The state of the fleet as of the most recent keepalive, to not replay `keepalives_stream_` on each request.
+  // Updated along with publishing each keepalive, under the same lock, and initialized from the persisted stream.
+  struct FleetState {
+    struct LatestKeepalive {
+      idxts_t idx_ts;
+      persisted_keepalive_t record;
+    };
+    // codename -> the most recent keepalive from this codename.
+    std::unordered_map<std::string, LatestKeepalive> latest_keepalive;
+    // service -> codename -> the timestamp of the most recent keepalive from this codename as this service.
+    std::map<std::string, std::map<std::string, std::chrono::microseconds>> codenames_per_service;
+    // location -> the timestamp and the codename of the most recent keepalive from this location.
+    std::map<ClaireServiceKey, std::pair<std::chrono::microseconds, std::string>> codename_per_location;
+    // The timestamp of the most recent keepalive overall; the windows ending after it are served from this state.
+    std::chrono::microseconds last_keepalive_us = std::chrono::microseconds(0);
+
+    void Apply(idxts_t idx_ts, persisted_keepalive_t&& record) {
+      const std::string codename = record.keepalive.codename;
+      codenames_per_service[record.keepalive.service][codename] = idx_ts.us;
+      codename_per_location[record.location] = std::make_pair(idx_ts.us, codename);
+      last_keepalive_us = idx_ts.us;
+      LatestKeepalive& latest = latest_keepalive[codename];
+      latest.idx_ts = idx_ts;
+      latest.record = std::move(record);
+    }
+  };
+
+  // A keepalive parsed and queued, to be persisted and responded to along with the others queued with it.
+  struct AcceptedKeepalive {
+    std::unique_ptr<Request> request;
+    std::chrono::microseconds now;
+    std::chrono::steady_clock::time_point queued_at;
+    ClaireServiceKey location;
+    claire_status_t keepalive;
+    Optional<std::chrono::microseconds> behind_this_by;
+  };
+
+  // Collects the queued keepalives into batches, persisting each batch once the queue is drained, or once it is full.
+  class KeepalivesBatcherImpl {
+   public:
+    explicit KeepalivesBatcherImpl(GenericKarl& karl) : karl_(karl) { batch_.reserve(kMaxKeepalivesPerBatch); }
+    ss::EntryResponse operator()(AcceptedKeepalive&& keepalive, idxts_t current, idxts_t last) {
+      batch_.push_back(std::move(keepalive));
+      if (current.index == last.index || batch_.size() >= kMaxKeepalivesPerBatch) {
+        karl_.PersistKeepalivesBatch(batch_);
+        batch_.clear();
+      }
+      return ss::EntryResponse::More;
+    }
+
+   private:
+    GenericKarl& karl_;
+    std::vector<AcceptedKeepalive> batch_;
+  };
+  using keepalives_batcher_t = current::ss::EntrySubscriber<KeepalivesBatcherImpl, AcceptedKeepalive>;
+
+  // The rendered fleet view, per response format and query, valid while `fleet_view_version_` stays the same.
+  struct CachedFleetView {
+    uint64_t version;
+    std::chrono::microseconds rendered_at;
+    Response response;
+  };
+
   struct PrivateConstructorSelector {};
   template <typename T>
   GenericKarl(T& storage_or_file,
@@ -277,12 +342,16 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
         notifiable_ref_(notifiable),
         fleet_view_renderer_ref_(renderer),
         keepalives_stream_(stream_t::CreateStream(parameters_.stream_persistence_file)),
+        fleet_state_(ReplayKeepalives(*keepalives_stream_)),
+        fleet_view_version_(0u),
         state_update_thread_running_(false),
         state_update_thread_force_wakeup_(false),
         state_update_thread_([this]() {
           state_update_thread_running_ = true;
           StateUpdateThread();
         }),
+        keepalives_batcher_(*this),
+        keepalives_queue_(keepalives_batcher_, kKeepalivesIngestionQueueSize),
         http_scope_(HTTP(current::net::BarePort(parameters_.keepalives_port))
                         .Register(parameters_.keepalives_url,
                                   URLPathArgs::CountMask::None | URLPathArgs::CountMask::One,
@@ -295,6 +364,10 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
                         .Register(parameters_.fleet_view_url + "status",
                                   URLPathArgs::CountMask::None,
                                   [this](Request r) { ServeKarlStatus(std::move(r)); }) +
+                    HTTP(current::net::BarePort(parameters_.fleet_view_port))
+                        .Register(parameters_.fleet_view_url + "ingestion",
+                                  URLPathArgs::CountMask::None,
+                                  [this](Request r) { ServeIngestionStatus(std::move(r)); }) +
                     HTTP(current::net::BarePort(parameters_.fleet_view_port))
                         .Register(parameters_.fleet_view_url + "build",
                                   URLPathArgs::CountMask::One,
@@ -414,6 +487,7 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
                   }
                 })
             .Wait();
+        ++fleet_view_version_;
       }
       UpdateNginxIfNeeded();
 #ifdef CURRENT_MOCK_TIME
@@ -480,6 +554,7 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
                 },
                 std::move(r))
             .Wait();  // NOTE(dkorolev): Could be `.Detach()`, but staying "safe" within Karl for now.
+        ++fleet_view_version_;
         {
           // Delete this `codename` from cache.
           std::lock_guard<std::mutex> lock(services_keepalive_cache_mutex_);
@@ -520,7 +595,7 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
 
           // If the received status can be parsed in detail, including the "runtime" variant, persist it.
           // If no, no big deal, keep the top-level one regardless.
-          const auto detailed_parsed_status = [&]() -> claire_status_t {
+          auto detailed_parsed_status = [&]() -> claire_status_t {
             Optional<claire_status_t> parsed_opt = TryParseJSON<claire_status_t>(json);
             if (!Exists(parsed_opt)) {  // Can't parse in Current format. Trying `Minimalistic`.
               parsed_opt = TryParseJSON<claire_status_t, JSONFormat::Minimalistic>(json);
@@ -543,131 +618,32 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
             }
           }();
 
-          const auto now = current::time::Now();
-
-          {
-            persisted_keepalive_t record;
-            record.location = location;
-            record.keepalive = detailed_parsed_status;
-            {
-              std::lock_guard<std::mutex> lock(latest_keepalive_index_mutex_);
-              latest_keepalive_index_plus_one_[parsed_status.codename] =
-                  keepalives_stream_->Publisher()->Publish(std::move(record)).index;
-            }
-          }
-
-          Optional<std::chrono::microseconds> optional_behind_this_by;
+          const auto queued_at = std::chrono::steady_clock::now();
+          AcceptedKeepalive accepted;
+          accepted.now = current::time::Now();
+          accepted.queued_at = queued_at;
+          accepted.location = location;
           if (Exists(parsed_status.last_successful_keepalive_ping_us)) {
-            optional_behind_this_by =
-                now - parsed_status.now - Value(parsed_status.last_successful_keepalive_ping_us) / 2;
+            accepted.behind_this_by =
+                accepted.now - parsed_status.now - Value(parsed_status.last_successful_keepalive_ping_us) / 2;
           }
-
-          auto& notifiable_ref = notifiable_ref_;
-          storage_
-              ->ReadWriteTransaction(
-                  [now, location, &parsed_status, &detailed_parsed_status, optional_behind_this_by, &notifiable_ref](
-                      MutableFields<storage_t> fields) -> Response {
-                    // OK to call from within a transaction.
-                    // The call is fast, and `storage_`'s transaction guarantees thread safety. -- D.K.
-                    notifiable_ref.OnKeepalive(now, location, parsed_status.codename, detailed_parsed_status);
-
-                    const auto& service = parsed_status.service;
-                    const auto& codename = parsed_status.codename;
-                    const auto& optional_build = parsed_status.build;
-                    const auto& optional_instance = parsed_status.cloud_instance_name;
-                    const auto& optional_av_group = parsed_status.cloud_availability_group;
-
-                    // Update per-server information in the `DB`.
-                    ServerInfo server;
-                    server.ip = location.ip;
-                    bool need_to_update_server_info = false;
-                    const ImmutableOptional<ServerInfo> current_server_info = fields.servers[location.ip];
-                    if (Exists(current_server_info)) {
-                      server = Value(current_server_info);
-                    }
-                    // Check the instance name.
-                    if (Exists(optional_instance)) {
-                      if (!Exists(server.cloud_instance_name) ||
-                          Value(server.cloud_instance_name) != Value(optional_instance)) {
-                        server.cloud_instance_name = Value(optional_instance);
-                        need_to_update_server_info = true;
-                      }
-                    }
-                    // Check the availability group.
-                    if (Exists(optional_av_group)) {
-                      if (!Exists(server.cloud_availability_group) ||
-                          Value(server.cloud_availability_group) != Value(optional_av_group)) {
-                        server.cloud_availability_group = Value(optional_av_group);
-                        need_to_update_server_info = true;
-                      }
-                    }
-                    // Check the time skew.
-                    if (Exists(optional_behind_this_by)) {
-                      const std::chrono::microseconds behind_this_by = Value(optional_behind_this_by);
-                      const auto time_skew_difference = server.behind_this_by - behind_this_by;
-                      if (static_cast<uint64_t>(std::abs(time_skew_difference.count())) >=
-                          kUpdateServerInfoThresholdByTimeSkewDifference) {
-                        server.behind_this_by = behind_this_by;
-                        need_to_update_server_info = true;
-                      }
-                    }
-                    if (need_to_update_server_info) {
-                      fields.servers.Add(server);
-                    }
-
-                    // Update the `DB` if the build information was not stored there yet.
-                    const ImmutableOptional<ClaireBuildInfo> current_claire_build_info = fields.builds[codename];
-                    if (Exists(optional_build) && (!Exists(current_claire_build_info) ||
-                                                   Value(current_claire_build_info).build != Value(optional_build))) {
-                      ClaireBuildInfo build;
-                      build.codename = codename;
-                      build.build = Value(optional_build);
-                      fields.builds.Add(build);
-                    }
-
-                    // Update the `DB` if "codename", "location", or "dependencies" differ.
-                    const ImmutableOptional<ClaireInfo> current_claire_info = fields.claires[codename];
-                    if ([&]() {
-                          if (!Exists(current_claire_info)) {
-                            return true;
-                          } else if (Value(current_claire_info).location != location) {
-                            return true;
-                          } else if (Value(current_claire_info).registered_state != ClaireRegisteredState::Active) {
-                            return true;
-                          } else {
-                            return false;
-                          }
-                        }()) {
-                      ClaireInfo claire;
-                      if (Exists(current_claire_info)) {
-                        // Do not overwrite `build` with `null`.
-                        claire = Value(current_claire_info);
-                      }
-
-                      claire.codename = codename;
-                      claire.service = service;
-                      claire.location = location;
-                      claire.reported_timestamp = now;
-                      claire.url_status_page_direct = location.StatusPageURL();
-                      claire.registered_state = ClaireRegisteredState::Active;
-
-                      fields.claires.Add(claire);
-                    }
-                    return Response("OK\n");
-                  },
-                  std::move(r))
-              .Wait();
+          accepted.keepalive = std::move(detailed_parsed_status);
+          accepted.request = std::make_unique<Request>(std::move(r));
+
+          // Blocks while the queue is full, which is the back-pressure for the services sending keepalives.
+          try {
+            keepalives_queue_.Publish(std::move(accepted));
+          } catch (const ss::InconsistentTimestampException&) {
+            // Not queued, so the request, still owned by `accepted`, responds with an error as it is destroyed.
+            return;
+          }
+          const auto queueing_wait =
+              std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - queued_at);
           {
-            std::lock_guard<std::mutex> lock(services_keepalive_cache_mutex_);
-            auto& placeholder = services_keepalive_time_cache_[parsed_status.codename];
-            if (placeholder.count() == 0) {
-              placeholder = now;
-              // Wake up state update thread only if the new codename has appeared in the cache.
-              state_update_thread_force_wakeup_ = true;
-              update_thread_condition_variable_.notify_one();
-            } else {
-              placeholder = now;
-            }
+            std::lock_guard<std::mutex> lock(ingestion_status_mutex_);
+            ++ingestion_status_.accepted;
+            ingestion_status_.total_queueing_wait += queueing_wait;
+            ingestion_status_.max_queueing_wait = std::max(ingestion_status_.max_queueing_wait, queueing_wait);
           }
         } else {
           r("Inconsistent URL/body parameters.\n", HTTPResponseCode.BadRequest);
@@ -682,6 +658,168 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
     }
   }
 
+  // Persists the batch of the accepted keepalives with one `PublishBatch()` and one storage transaction.
+  void PersistKeepalivesBatch(std::vector<AcceptedKeepalive>& batch) {
+    const auto respond = [&batch](const std::string& message, net::HTTPResponseCodeValue code) {
+      for (AcceptedKeepalive& accepted : batch) {
+        try {
+          (*accepted.request)(message, code);
+        } catch (const net::NetworkException&) {
+          // The service may have gone away, which is no reason to not respond to the rest of the batch.
+        }
+      }
+    };
+
+    try {
+      {
+        std::vector<persisted_keepalive_t> records(batch.size());
+        for (size_t i = 0; i < batch.size(); ++i) {
+          records[i].location = batch[i].location;
+          records[i].keepalive = batch[i].keepalive;
+        }
+        std::vector<idxts_t> published;
+        published.reserve(records.size());
+        std::lock_guard<std::mutex> lock(fleet_state_mutex_);
+        keepalives_stream_->Publisher()->PublishBatch(records, &published);
+        for (size_t i = 0; i < records.size(); ++i) {
+          fleet_state_.Apply(published[i], std::move(records[i]));
+        }
+      }
+      ++fleet_view_version_;
+
+      auto& notifiable_ref = notifiable_ref_;
+      const auto update_db = [&batch, &notifiable_ref](MutableFields<storage_t> fields) {
+        for (const AcceptedKeepalive& accepted : batch) {
+          const auto& location = accepted.location;
+          const auto& keepalive = accepted.keepalive;
+          // OK to call from within a transaction.
+          // The call is fast, and `storage_`'s transaction guarantees thread safety. -- D.K.
+          notifiable_ref.OnKeepalive(accepted.now, location, keepalive.codename, keepalive);
+
+          const auto& service = keepalive.service;
+          const auto& codename = keepalive.codename;
+          const auto& optional_build = keepalive.build;
+          const auto& optional_instance = keepalive.cloud_instance_name;
+          const auto& optional_av_group = keepalive.cloud_availability_group;
+
+          // Update per-server information in the `DB`.
+          ServerInfo server;
+          server.ip = location.ip;
+          bool need_to_update_server_info = false;
+          const ImmutableOptional<ServerInfo> current_server_info = fields.servers[location.ip];
+          if (Exists(current_server_info)) {
+            server = Value(current_server_info);
+          }
+          // Check the instance name.
+          if (Exists(optional_instance)) {
+            if (!Exists(server.cloud_instance_name) || Value(server.cloud_instance_name) != Value(optional_instance)) {
+              server.cloud_instance_name = Value(optional_instance);
+              need_to_update_server_info = true;
+            }
+          }
+          // Check the availability group.
+          if (Exists(optional_av_group)) {
+            if (!Exists(server.cloud_availability_group) ||
+                Value(server.cloud_availability_group) != Value(optional_av_group)) {
+              server.cloud_availability_group = Value(optional_av_group);
+              need_to_update_server_info = true;
+            }
+          }
+          // Check the time skew.
+          if (Exists(accepted.behind_this_by)) {
+            const std::chrono::microseconds behind_this_by = Value(accepted.behind_this_by);
+            const auto time_skew_difference = server.behind_this_by - behind_this_by;
+            if (static_cast<uint64_t>(std::abs(time_skew_difference.count())) >=
+                kUpdateServerInfoThresholdByTimeSkewDifference) {
+              server.behind_this_by = behind_this_by;
+              need_to_update_server_info = true;
+            }
+          }
+          if (need_to_update_server_info) {
+            fields.servers.Add(server);
+          }
+
+          // Update the `DB` if the build information was not stored there yet.
+          const ImmutableOptional<ClaireBuildInfo> current_claire_build_info = fields.builds[codename];
+          if (Exists(optional_build) && (!Exists(current_claire_build_info) ||
+                                         Value(current_claire_build_info).build != Value(optional_build))) {
+            ClaireBuildInfo build;
+            build.codename = codename;
+            build.build = Value(optional_build);
+            fields.builds.Add(build);
+          }
+
+          // Update the `DB` if "codename", "location", or "dependencies" differ.
+          const ImmutableOptional<ClaireInfo> current_claire_info = fields.claires[codename];
+          if ([&]() {
+                if (!Exists(current_claire_info)) {
+                  return true;
+                } else if (Value(current_claire_info).location != location) {
+                  return true;
+                } else if (Value(current_claire_info).registered_state != ClaireRegisteredState::Active) {
+                  return true;
+                } else {
+                  return false;
+                }
+              }()) {
+            ClaireInfo claire;
+            if (Exists(current_claire_info)) {
+              // Do not overwrite `build` with `null`.
+              claire = Value(current_claire_info);
+            }
+
+            claire.codename = codename;
+            claire.service = service;
+            claire.location = location;
+            claire.reported_timestamp = accepted.now;
+            claire.url_status_page_direct = location.StatusPageURL();
+            claire.registered_state = ClaireRegisteredState::Active;
+
+            fields.claires.Add(claire);
+          }
+        }
+      };
+      if (!WasCommitted(storage_->ReadWriteTransaction(update_db).Go())) {
+        respond("Karl registration error.\n", HTTPResponseCode.InternalServerError);
+        return;
+      }
+      ++fleet_view_version_;
+    } catch (const std::exception&) {
+      // Whatever has failed, from publishing the batch to committing it into the storage, fails the whole batch.
+      respond("Karl registration error.\n", HTTPResponseCode.InternalServerError);
+      return;
+    }
+
+    const auto latency = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() -
+                                                                                 batch.front().queued_at);
+    {
+      std::lock_guard<std::mutex> lock(ingestion_status_mutex_);
+      ingestion_status_.persisted += batch.size();
+      ++ingestion_status_.batches;
+      ingestion_status_.last_batch_size = batch.size();
+      ingestion_status_.max_batch_size = std::max(ingestion_status_.max_batch_size, ingestion_status_.last_batch_size);
+      ingestion_status_.last_batch_latency = latency;
+      ingestion_status_.max_batch_latency = std::max(ingestion_status_.max_batch_latency, latency);
+    }
+
+    respond("OK\n", HTTPResponseCode.OK);
+
+    {
+      std::lock_guard<std::mutex> lock(services_keepalive_cache_mutex_);
+      for (const AcceptedKeepalive& accepted : batch) {
+        auto& placeholder = services_keepalive_time_cache_[accepted.keepalive.codename];
+        if (placeholder.count() == 0) {
+          placeholder = accepted.now;
+          // Wake up state update thread only if the new codename has appeared in the cache.
+          state_update_thread_force_wakeup_ = true;
+          update_thread_condition_variable_.notify_one();
+        } else {
+          placeholder = accepted.now;
+        }
+      }
+    }
+  }
+
   void ServeFleetStatus(Request r) {
     const auto& qs = r.url.query;
     if (qs.has("schema")) {
@@ -713,6 +851,16 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
     }
   }
 
+  void ServeIngestionStatus(Request r) {
+    KarlKeepalivesIngestionStatus status;
+    {
+      std::lock_guard<std::mutex> lock(ingestion_status_mutex_);
+      status = ingestion_status_;
+    }
+    status.queue_capacity = kKeepalivesIngestionQueueSize;
+    r(status);
+  }
+
   void ServeBuild(Request r) {
     const auto codename = r.url_path_args[0];
     storage_
@@ -730,47 +878,41 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
         .Wait();  // NOTE(dkorolev): Could be `.Detach()`, but staying "safe" within Karl for now.
   }
 
+  static FleetState ReplayKeepalives(stream_t& stream) {
+    FleetState state;
+    for (const auto& e : stream.Data()->Iterate()) {
+      state.Apply(e.idx_ts, persisted_keepalive_t(e.entry));
+    }
+    return state;
+  }
+
   void ServeSnapshot(Request r) {
     const auto codename = r.url_path_args[0];
+    const bool nobuild = r.url.query.has("nobuild");
 
-    uint64_t& index_placeholder = [&]() {
-      std::lock_guard<std::mutex> lock(latest_keepalive_index_mutex_);
-      return std::ref(latest_keepalive_index_plus_one_[codename]);
-    }();
-
-    const auto& keepalives_data = keepalives_stream_->Data();
-
-    uint64_t index = index_placeholder;
-    if (!index) {
-      // If no latest keepalive index in cache, go through the whole log.
-      for (const auto& e : keepalives_data->Iterate()) {
-        if (e.entry.keepalive.codename == codename) {
-          index = e.idx_ts.index + 1;
-        }
-      }
-      if (index) {
-        std::lock_guard<std::mutex> lock(latest_keepalive_index_mutex_);
-        index_placeholder = std::max(index_placeholder, index);
+    const Optional<std::string> snapshot = [&]() -> Optional<std::string> {
+      std::lock_guard<std::mutex> lock(fleet_state_mutex_);
+      const auto cit = fleet_state_.latest_keepalive.find(codename);
+      if (cit == fleet_state_.latest_keepalive.end()) {
+        return nullptr;
       }
-    }
-
-    if (index) {
-      const auto e = *(keepalives_data->Iterate(index - 1).begin());
-      if (!r.url.query.has("nobuild")) {
-        r(JSON<JSONFormat::Minimalistic>(
-              SnapshotOfKeepalive<runtime_status_variant_t>(e.idx_ts.us - current::time::Now(), e.entry.keepalive)),
-          HTTPResponseCode.OK,
-          current::net::http::Headers(),
-          current::net::constants::kDefaultJSONContentType);
+      const auto& e = cit->second;
+      if (!nobuild) {
+        return JSON<JSONFormat::Minimalistic>(
+            SnapshotOfKeepalive<runtime_status_variant_t>(e.idx_ts.us - current::time::Now(), e.record.keepalive));
       } else {
-        auto tmp = e.entry.keepalive;
+        auto tmp = e.record.keepalive;
         tmp.build = nullptr;
-        r(JSON<JSONFormat::Minimalistic>(
-              SnapshotOfKeepalive<runtime_status_variant_t>(e.idx_ts.us - current::time::Now(), tmp)),
-          HTTPResponseCode.OK,
-          current::net::http::Headers(),
-          current::net::constants::kDefaultJSONContentType);
+        return JSON<JSONFormat::Minimalistic>(
+            SnapshotOfKeepalive<runtime_status_variant_t>(e.idx_ts.us - current::time::Now(), tmp));
       }
+    }();
+
+    if (Exists(snapshot)) {
+      r(Value(snapshot),
+        HTTPResponseCode.OK,
+        current::net::http::Headers(),
+        current::net::constants::kDefaultJSONContentType);
     } else {
       r(current_service_state::Error("No keepalives from '" + codename + "' have been received."),
         HTTPResponseCode.NotFound);
@@ -810,6 +952,49 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
       return now;
     }();
 
+    // To list only the services that are currently in `Active` state.
+    const bool active_only = r.url.query.has("active_only");
+
+    const auto response_format = [&r]() -> FleetViewResponseFormat {
+      if (r.url.query.has("full")) {
+        return FleetViewResponseFormat::JSONFull;
+      }
+      if (r.url.query.has("json")) {
+        return FleetViewResponseFormat::JSONMinimalistic;
+      }
+      if (r.url.query.has("html")) {
+        return FleetViewResponseFormat::HTMLFormat;
+      }
+      const char* kAcceptHeader = "Accept";
+      if (r.headers.Has(kAcceptHeader)) {
+        for (const auto& h : strings::Split(r.headers[kAcceptHeader].value, ',')) {
+          if (strings::Split(h, ';').front() == "text/html") {  // Allow "text/html; charset=...", etc.
+            return FleetViewResponseFormat::HTMLFormat;
+          }
+        }
+      }
+      return FleetViewResponseFormat::JSONMinimalistic;
+    }();
+
+    // Respond with the same view rendered recently, if no keepalives or state changes have arrived since.
+    const uint64_t version = fleet_view_version_;
+    const std::string cache_key =
+        current::ToString(static_cast<int>(response_format)) + JSON(r.url.AllQueryParameters());
+    const Optional<Response> cached_response = [&]() -> Optional<Response> {
+      std::lock_guard<std::mutex> lock(fleet_view_cache_mutex_);
+      const auto cit = fleet_view_cache_.find(cache_key);
+      if (cit != fleet_view_cache_.end() && cit->second.version == version && now >= cit->second.rendered_at &&
+          now - cit->second.rendered_at < kFleetViewCacheTTL) {
+        return cit->second.response;
+      } else {
+        return nullptr;
+      }
+    }();
+    if (Exists(cached_response)) {
+      r(Value(cached_response));
+      return;
+    }
+
     // Codenames to resolve to `ClaireServiceKey`-s later, in a `ReadOnlyTransaction`.
     std::unordered_set<std::string> codenames_to_resolve;
 
@@ -823,62 +1008,69 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
     std::map<std::string, std::set<std::string>> codenames_per_service;
     std::map<ClaireServiceKey, std::string> service_key_into_codename;
 
-    CURRENT_ASSERT(to >= from);
-    const auto& keepalives_data(keepalives_stream_->Data());
-    for (const auto& e : keepalives_data->Iterate(from, to)) {
-      const claire_status_t& keepalive = e.entry.keepalive;
-
+    const auto add_keepalive_to_report = [&](idxts_t idx_ts, const claire_status_t& keepalive) {
       codenames_to_resolve.insert(keepalive.codename);
-      service_key_into_codename[e.entry.location] = keepalive.codename;
-
-      codenames_per_service[keepalive.service].insert(keepalive.codename);
       // DIMA: More per-codename reporting fields go here; tailored to specific type, `.Call(populator)`, etc.
       ProtoReport report;
-      const std::string last_keepalive =
-          current::strings::TimeIntervalAsHumanReadableString(now - e.idx_ts.us) + " ago";
-      if ((now - e.idx_ts.us) < parameters_.service_timeout_interval) {
+      const std::string last_keepalive = current::strings::TimeIntervalAsHumanReadableString(now - idx_ts.us) + " ago";
+      if ((now - idx_ts.us) < parameters_.service_timeout_interval) {
         // Service is up.
         const auto projected_uptime_us =
-            (keepalive.now - keepalive.start_time_epoch_microseconds) + (now - e.idx_ts.us);
+            (keepalive.now - keepalive.start_time_epoch_microseconds) + (now - idx_ts.us);
         report.currently =
             current_service_state::up(keepalive.start_time_epoch_microseconds,
                                       last_keepalive,
-                                      e.idx_ts.us,
+                                      idx_ts.us,
                                       current::strings::TimeIntervalAsHumanReadableString(projected_uptime_us));
       } else {
         // Service is down.
         // TODO(dkorolev): Graceful shutdown case for `done`.
         report.currently = current_service_state::down(
-            keepalive.start_time_epoch_microseconds, last_keepalive, e.idx_ts.us, keepalive.uptime);
+            keepalive.start_time_epoch_microseconds, last_keepalive, idx_ts.us, keepalive.uptime);
       }
       report.dependencies = keepalive.dependencies;
       report.runtime = keepalive.runtime;
       report_for_codename[keepalive.codename] = report;
-    }
-
-    // To list only the services that are currently in `Active` state.
-    const bool active_only = r.url.query.has("active_only");
+    };
 
-    const auto response_format = [&r]() -> FleetViewResponseFormat {
-      if (r.url.query.has("full")) {
-        return FleetViewResponseFormat::JSONFull;
-      }
-      if (r.url.query.has("json")) {
-        return FleetViewResponseFormat::JSONMinimalistic;
+    CURRENT_ASSERT(to >= from);
+    const auto within_window = [from, to](std::chrono::microseconds us) { return us >= from && us < to; };
+    const bool built_from_fleet_state = [&]() {
+      std::lock_guard<std::mutex> lock(fleet_state_mutex_);
+      if (to <= fleet_state_.last_keepalive_us) {
+        return false;
       }
-      if (r.url.query.has("html")) {
-        return FleetViewResponseFormat::HTMLFormat;
+      // The window ends after the most recent keepalive, so the most recent keepalive from each codename
+      // is exactly the last one from it within the window, if it is within the window at all.
+      for (const auto& codename_and_keepalive : fleet_state_.latest_keepalive) {
+        const auto& latest = codename_and_keepalive.second;
+        if (within_window(latest.idx_ts.us)) {
+          add_keepalive_to_report(latest.idx_ts, latest.record.keepalive);
+        }
       }
-      const char* kAcceptHeader = "Accept";
-      if (r.headers.Has(kAcceptHeader)) {
-        for (const auto& h : strings::Split(r.headers[kAcceptHeader].value, ',')) {
-          if (strings::Split(h, ';').front() == "text/html") {  // Allow "text/html; charset=...", etc.
-            return FleetViewResponseFormat::HTMLFormat;
+      for (const auto& service_and_codenames : fleet_state_.codenames_per_service) {
+        for (const auto& codename_and_us : service_and_codenames.second) {
+          if (within_window(codename_and_us.second)) {
+            codenames_per_service[service_and_codenames.first].insert(codename_and_us.first);
           }
         }
       }
-      return FleetViewResponseFormat::JSONMinimalistic;
+      for (const auto& location_and_codename : fleet_state_.codename_per_location) {
+        if (within_window(location_and_codename.second.first)) {
+          service_key_into_codename[location_and_codename.first] = location_and_codename.second.second;
+        }
+      }
+      return true;
     }();
+    if (!built_from_fleet_state) {
+      const auto& keepalives_data(keepalives_stream_->Data());
+      for (const auto& e : keepalives_data->Iterate(from, to)) {
+        const claire_status_t& keepalive = e.entry.keepalive;
+        service_key_into_codename[e.entry.location] = keepalive.codename;
+        codenames_per_service[keepalive.service].insert(keepalive.codename);
+        add_keepalive_to_report(e.idx_ts, keepalive);
+      }
+    }
 
     const std::string public_url = actual_public_url_;
     storage_
@@ -980,7 +1172,16 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
               result.generation_time = current::time::Now() - now;
               return fleet_view_renderer_ref_.RenderResponse(response_format, parameters_, std::move(result));
             },
-            std::move(r))
+            [this, &r, &cache_key, version, now](Response response) {
+              {
+                std::lock_guard<std::mutex> lock(fleet_view_cache_mutex_);
+                if (fleet_view_cache_.size() >= kFleetViewCacheMaxEntries) {
+                  fleet_view_cache_.clear();
+                }
+                fleet_view_cache_[cache_key] = CachedFleetView{version, now, response};
+              }
+              r(std::move(response));
+            })
         .Wait();  // NOTE(dkorolev): Could be `.Detach()`, but staying "safe" within Karl for now.
   }
 
@@ -994,16 +1195,27 @@ class GenericKarl final : private KarlStorage<STORAGE_TYPE>,
   std::set<std::string> local_ips_;  // The list of local IPs used ti receive keepalives.
   mutable std::mutex local_ips_mutex_;
 
-  // codename -> stream index of the most recent keepalive from this codename.
-  std::mutex latest_keepalive_index_mutex_;
-  // Plus one to have `0` == "no keepalives", and avoid the corner case of record at index 0 being the one.
-  std::unordered_map<std::string, uint64_t> latest_keepalive_index_plus_one_;
-
   current::Owned<stream_t> keepalives_stream_;
+
+  // Also held while publishing into `keepalives_stream_`, to keep `fleet_state_` in sync with it.
+  std::mutex fleet_state_mutex_;
+  FleetState fleet_state_;
+
+  // Bumped on each keepalive and on each change to the storage, to invalidate the cached fleet views.
+  std::atomic<uint64_t> fleet_view_version_;
+  std::mutex fleet_view_cache_mutex_;
+  std::unordered_map<std::string, CachedFleetView> fleet_view_cache_;
+
   std::atomic_bool state_update_thread_running_;
   std::atomic_bool state_update_thread_force_wakeup_;
   std::condition_variable update_thread_condition_variable_;
   std::thread state_update_thread_;
+
+  mutable std::mutex ingestion_status_mutex_;
+  KarlKeepalivesIngestionStatus ingestion_status_;
+  keepalives_batcher_t keepalives_batcher_;
+  current::mmq::MMQ<AcceptedKeepalive, keepalives_batcher_t> keepalives_queue_;
+
   const HTTPRoutesScope http_scope_;
 };
 
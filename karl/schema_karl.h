@@ -170,6 +170,14 @@ CURRENT_STRUCT(ClaireBuildInfo) {
 
 const uint64_t kUpdateServerInfoThresholdByTimeSkewDifference = 50000;
 
+// The rendered fleet view is reused until the next keepalive or state change, but for no longer than this.
+constexpr static std::chrono::microseconds kFleetViewCacheTTL = std::chrono::microseconds(1000ll * 1000ll);
+constexpr static size_t kFleetViewCacheMaxEntries = 64;
+
+// The keepalives accepted, but not yet persisted, and the most keepalives to persist in one batch.
+constexpr static size_t kKeepalivesIngestionQueueSize = 4096;
+constexpr static size_t kMaxKeepalivesPerBatch = 1024;
+
 // Per-server status info.
 CURRENT_STRUCT(ServerInfo) {
   CURRENT_FIELD(ip, std::string);
@@ -364,6 +372,27 @@ CURRENT_STRUCT(KarlUpStatus) {
   CURRENT_CONSTRUCTOR(KarlUpStatus)(const KarlParameters& parameters) : parameters(parameters) {}
 };
 
+// The metrics of the keepalives ingestion, which persists the keepalives queued since the previous batch together.
+CURRENT_STRUCT(KarlKeepalivesIngestionStatus) {
+  CURRENT_FIELD(accepted, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(accepted, "The number of keepalives parsed and queued.");
+  CURRENT_FIELD(persisted, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(persisted, "The number of keepalives persisted and responded to.");
+  CURRENT_FIELD(queue_capacity, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(queue_capacity, "The number of keepalives that can be queued before accepting blocks.");
+  CURRENT_FIELD(batches, uint64_t, 0u);
+  CURRENT_FIELD_DESCRIPTION(batches, "The number of batches persisted, each with one publish and one transaction.");
+  CURRENT_FIELD(last_batch_size, uint64_t, 0u);
+  CURRENT_FIELD(max_batch_size, uint64_t, 0u);
+  CURRENT_FIELD(last_batch_latency, std::chrono::microseconds, std::chrono::microseconds(0));
+  CURRENT_FIELD_DESCRIPTION(last_batch_latency,
+                            "From the oldest keepalive of the last batch being queued to the batch persisted.");
+  CURRENT_FIELD(max_batch_latency, std::chrono::microseconds, std::chrono::microseconds(0));
+  CURRENT_FIELD(total_queueing_wait, std::chrono::microseconds, std::chrono::microseconds(0));
+  CURRENT_FIELD_DESCRIPTION(total_queueing_wait, "The time spent waiting to queue keepalives, due to the queue full.");
+  CURRENT_FIELD(max_queueing_wait, std::chrono::microseconds, std::chrono::microseconds(0));
+};
+
 CURRENT_STRUCT_T(SnapshotOfKeepalive) {
   CURRENT_FIELD(age, std::string);
   CURRENT_FIELD_DESCRIPTION(age, "How long ago was this snapshot saved, human-readable.");
@@ -874,6 +874,90 @@ TEST(Karl, ChangeDependenciesInClaire) {
   }
 }
 
+TEST(Karl, FleetStateIsRestoredFromPersistedKeepalives) {
+  current::time::ResetToZero();
+
+  const auto params = UnittestKarlParameters();
+  const auto stream_file_remover = current::FileSystem::ScopedRmFile(params.stream_persistence_file);
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(params.storage_persistence_file);
+  const current::karl::Locator karl_locator(Printf("http://localhost:%d/", FLAGS_karl_test_keepalives_port));
+
+  std::string codename;
+  {
+    const unittest_karl_t karl(params);
+    current::karl::Claire claire(karl_locator, "unittest", MimicPickPortForUnitTest());
+    // Register with no custom status filler and wait for the confirmation from Karl.
+    claire.Register(nullptr, true);
+    codename = claire.Codename();
+  }
+
+  // The restarted Karl knows the latest keepalive from `claire` without receiving any new ones.
+  const unittest_karl_t karl(params);
+  {
+    const auto response =
+        HTTP(GET(Printf("http://localhost:%d/snapshot/%s", FLAGS_karl_test_fleet_view_port, codename.c_str())));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_NE(std::string::npos, response.body.find(codename)) << response.body;
+  }
+  {
+    unittest_karl_status_t status;
+    const auto body = HTTP(GET(Printf("http://localhost:%d?full&from=0", FLAGS_karl_test_fleet_view_port))).body;
+    ASSERT_NO_THROW(status = ParseJSON<unittest_karl_status_t>(body)) << body;
+    ASSERT_TRUE(status.machines.count("127.0.0.1")) << JSON(status);
+    auto& per_ip_services = status.machines["127.0.0.1"].services;
+    ASSERT_EQ(1u, per_ip_services.size());
+    EXPECT_EQ("unittest", per_ip_services[codename].service);
+  }
+}
+
+TEST(Karl, KeepalivesAreIngestedInBatches) {
+  current::time::ResetToZero();
+
+  const auto params = UnittestKarlParameters();
+  const auto stream_file_remover = current::FileSystem::ScopedRmFile(params.stream_persistence_file);
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(params.storage_persistence_file);
+  const unittest_karl_t karl(params);
+  const current::karl::Locator karl_locator(Printf("http://localhost:%d/", FLAGS_karl_test_keepalives_port));
+
+  const size_t services = 10u;
+  const size_t keepalives_per_service = 5u;
+  std::vector<std::thread> threads;
+  for (size_t i = 0; i < services; ++i) {
+    threads.emplace_back([&karl_locator, i]() {
+      current::karl::ClaireStatus claire;
+      claire.service = "unittest";
+      claire.codename = "BATCH" + current::ToString(i);
+      claire.local_port = static_cast<uint16_t>(8000 + i);
+      for (size_t j = 0; j < keepalives_per_service; ++j) {
+        EXPECT_EQ(200, static_cast<int>(HTTP(POST(karl_locator.address_port_route, claire)).code));
+      }
+    });
+  }
+  for (auto& thread : threads) {
+    thread.join();
+  }
+
+  {
+    current::karl::KarlKeepalivesIngestionStatus ingestion;
+    const auto body = HTTP(GET(Printf("http://localhost:%d/ingestion", FLAGS_karl_test_fleet_view_port))).body;
+    ASSERT_NO_THROW(ingestion = ParseJSON<current::karl::KarlKeepalivesIngestionStatus>(body)) << body;
+    EXPECT_EQ(services * keepalives_per_service, ingestion.accepted);
+    EXPECT_EQ(services * keepalives_per_service, ingestion.persisted);
+    EXPECT_GE(ingestion.batches, 1u);
+    EXPECT_LE(ingestion.batches, services * keepalives_per_service);
+    EXPECT_GE(ingestion.max_batch_size, 1u);
+    EXPECT_EQ(current::karl::kKeepalivesIngestionQueueSize, ingestion.queue_capacity);
+  }
+
+  {
+    unittest_karl_status_t status;
+    const auto body = HTTP(GET(Printf("http://localhost:%d?full&from=0", FLAGS_karl_test_fleet_view_port))).body;
+    ASSERT_NO_THROW(status = ParseJSON<unittest_karl_status_t>(body)) << body;
+    ASSERT_TRUE(status.machines.count("127.0.0.1")) << JSON(status);
+    EXPECT_EQ(services, status.machines["127.0.0.1"].services.size());
+  }
+}
+
 TEST(Karl, ClaireNotifiesUserObject) {
   using namespace karl_unittest;
 
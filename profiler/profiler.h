@@ -26,6 +26,31 @@ SOFTWARE.
 // a `CURRENT_PROFILER_HTTP_ROUTE(http_scopes_variable, port, "/route")` macro to define an HTTP endpoint
 // exposing a full snapshot of how much time did each thread spend in each scope.
 // Scopes are hierarchical, represented in the output as a full call stack tree.
+//
+// The profiler is cheap enough to be kept enabled on the hot paths:
+// * Each thread owns its own trie of scopes. Entering and leaving a scope takes no locks and allocates nothing.
+//   The nodes of the trie are preallocated, `kMaxScopesPerThread` per thread, and the children of each node are
+//   the linked list of its siblings within this flat array. The scopes beyond this limit, or nested deeper than
+//   `kMaxScopeDepth`, are not tracked, and are reported as `scopes_not_tracked`.
+// * The time is measured in CPU ticks, via `rdtsc` where available, converted into microseconds at report time,
+//   with the rate calibrated against `std::chrono::steady_clock` since the profiler has started.
+// * The report is generated from a snapshot of each thread's trie, made consistent via a per-thread seqlock.
+//   The only mutex is the one protecting the list of threads, taken when a thread enters its first scope and when
+//   it exits, and by the reporter.
+// * Once a thread exits, its totals are merged into the ones of all the threads that have exited, reported as one
+//   more thread, and its state is reused by the next thread to enter a scope. The windowed reports only cover the
+//   threads that are still running.
+//
+// Besides the totals, each scope keeps the histogram of its durations, in power-of-two buckets of ticks, to report
+// the p50, p99, and max of it. Each thread also keeps the ring of its `kSamplesPerThread` most recent scope exits,
+// to report on the recent window of time only.
+//
+// The HTTP endpoint accepts:
+// * `?format=json` (the default), `?format=folded` for the collapsed stacks to feed into `flamegraph.pl`,
+//   or `?format=svg` for the call tree rendered by GraphViz, which requires `dot` to be installed.
+// * `?window=10` to only report the last ten seconds, from the samples. On the hot paths the ring of samples may
+//   cover less than the window requested; the time it does cover is reported as `window_covered`.
+// * `?reset` to only report what has happened since the reset, except the windowed reports are not affected.
 
 #ifndef CURRENT_PROFILER_H
 #define CURRENT_PROFILER_H
@@ -41,9 +66,26 @@ SOFTWARE.
 #error "No `CURRENT_PROFILER` in `CURRENT_COVERAGE_REPORT_MODE` please."
 #endif
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <sstream>
 #include <thread>
+#include <vector>
+
+#if defined(_MSC_VER) && (defined(_M_X64) || defined(_M_IX86))
+#include <intrin.h>
+#define CURRENT_PROFILER_HAS_RDTSC
+#elif defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#define CURRENT_PROFILER_HAS_RDTSC
+#endif
 
 #include "../blocks/http/api.h"
+#include "../bricks/dot/graphviz.h"
+#include "../bricks/strings/printf.h"
 #include "../bricks/time/chrono.h"
 #include "../bricks/util/singleton.h"
 
@@ -61,6 +103,9 @@ CURRENT_STRUCT(PerThreadReporting) {
   CURRENT_FIELD(us_per_entry, double);
   CURRENT_FIELD(absolute_best_possible_qps, double);
   CURRENT_FIELD(ratio_of_parent, double);
+  CURRENT_FIELD(p50_us, double);
+  CURRENT_FIELD(p99_us, double);
+  CURRENT_FIELD(max_us, double);
   CURRENT_FIELD(subscope, std::vector<PerThreadReporting>);
   CURRENT_FIELD(subscope_total_ratio_of_parent, double);
   bool operator<(const PerThreadReporting& rhs) const {
@@ -71,183 +116,776 @@ CURRENT_STRUCT(PerThreadReporting) {
 CURRENT_STRUCT(ProfilingReport) {
   CURRENT_FIELD(thread, std::vector<PerThreadReporting>);
   CURRENT_FIELD(profiling_overhead, std::chrono::microseconds);
-  CURRENT_FIELD(profiling_mutex_overhead, std::chrono::microseconds);
   CURRENT_FIELD(reporting_overhead, std::chrono::microseconds);
+  CURRENT_FIELD(scopes_not_tracked, uint64_t);
+  CURRENT_FIELD(window, Optional<std::chrono::microseconds>);
+  CURRENT_FIELD(window_covered, Optional<std::chrono::microseconds>);
 };
 
+// The per-thread limits, to keep the per-thread state preallocated.
+constexpr static uint32_t kMaxScopesPerThread = 256u;
+constexpr static uint32_t kMaxScopeDepth = 256u;
+constexpr static uint64_t kSamplesPerThread = 4096u;
+
+// The limit on the distinct call stacks kept for the threads that have exited, merged.
+constexpr static uint32_t kMaxScopesOfThreadsThatHaveExited = 4u * kMaxScopesPerThread;
+
+// The durations of scopes are counted in buckets of [2^i, 2^(i+1)) ticks, the last bucket being open-ended.
+constexpr static uint32_t kHistogramBuckets = 40u;
+
+// The number of attempts to take a consistent snapshot of a thread's trie before settling on an inconsistent one.
+constexpr static size_t kMaxSnapshotAttempts = 1000u;
+
+// The name under which the totals of the threads that have exited are reported.
+constexpr static char kRetiredThreadsName[] = "C++ threads that have exited";
+
+// CPU ticks, and their rate in microseconds, calibrated against the steady clock since the profiler has started.
+class Ticks final {
+ public:
+  Ticks() : ticks_started_(Now()), steady_started_(std::chrono::steady_clock::now()) {}
+
+  static uint64_t Now() {
+#ifdef CURRENT_PROFILER_HAS_RDTSC
+    return static_cast<uint64_t>(__rdtsc());
+#else
+    return static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count());
+#endif
+  }
+
+  double TicksPerMicrosecond() const {
+    const uint64_t ticks = Now() - ticks_started_;
+    const auto ns = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() -
+                                                                         steady_started_).count();
+    const double us = 1e-3 * static_cast<double>(ns);
+    return (ticks && us >= 1.0) ? (ticks / us) : 1.0;
+  }
+
+ private:
+  const uint64_t ticks_started_;
+  const std::chrono::steady_clock::time_point steady_started_;
+};
+
+inline uint32_t HistogramBucket(uint64_t ticks) {
+#if defined(__GNUC__) || defined(__clang__)
+  uint32_t bucket = ticks ? static_cast<uint32_t>(63 - __builtin_clzll(ticks)) : 0u;
+#else
+  uint32_t bucket = 0u;
+  while (ticks >>= 1) {
+    ++bucket;
+  }
+#endif
+  return std::min(bucket, kHistogramBuckets - 1u);
+}
+
+// The `q`-th quantile of the histogram, interpolated linearly within its bucket, and capped by the `max` known.
+inline double HistogramQuantile(const uint64_t* histogram, double q, uint64_t max) {
+  uint64_t total = 0u;
+  for (uint32_t i = 0u; i < kHistogramBuckets; ++i) {
+    total += histogram[i];
+  }
+  if (!total) {
+    return 0.0;
+  }
+  const double rank = q * total;
+  uint64_t seen = 0u;
+  for (uint32_t i = 0u; i < kHistogramBuckets; ++i) {
+    if (histogram[i] && seen + histogram[i] >= rank) {
+      const double lo = i ? static_cast<double>(1ull << i) : 0.0;
+      const double hi =
+          (i + 1u < kHistogramBuckets) ? static_cast<double>(1ull << (i + 1u)) : static_cast<double>(max);
+      return std::min(lo + (hi - lo) * (rank - seen) / histogram[i], static_cast<double>(max));
+    }
+    seen += histogram[i];
+  }
+  return static_cast<double>(max);  // LCOV_EXCL_LINE
+}
+
 struct Profiler {
   class StateMaintainer {
    private:
-    struct State {
-      struct PerThread {
-        struct Trie {
-          // `Now()` if within it, `0` if currently not there.
-          std::chrono::microseconds us_entered = std::chrono::microseconds(0);
-          // Total across all the times this scope was entered.
-          std::chrono::microseconds us_total = std::chrono::microseconds(0);
-          // The number of times this scope was entered.
-          uint64_t entries = 0;
-          // Sub-scopes within this scope, if any.
-          std::map<const char*, Trie> children;
-
-          std::chrono::microseconds ComputeTotalMicroseconds(std::chrono::microseconds now) const {
-            if (us_entered.count()) {
-              CURRENT_ASSERT(now >= us_entered);
-              return std::chrono::microseconds(us_total.count() + (now - us_entered).count());
-            } else {
-              return us_total;
-            }
+    constexpr static uint32_t kNoNode = static_cast<uint32_t>(-1);
+
+    // The node of the per-thread trie. Only ever written to by its thread, and read by the reporter.
+    struct Node {
+      std::atomic<const char*> scope{nullptr};
+      std::atomic<uint32_t> first_child{kNoNode};
+      std::atomic<uint32_t> next_sibling{kNoNode};
+      // The number of times this scope was entered.
+      std::atomic<uint64_t> entries{0u};
+      // Total across all the times this scope was left.
+      std::atomic<uint64_t> ticks_total{0u};
+      // The ticks when it was entered if within it, `0` if currently not there.
+      std::atomic<uint64_t> ticks_entered{0u};
+      // The longest time spent in this scope, and the histogram of the times spent in it.
+      std::atomic<uint64_t> ticks_max{0u};
+      std::atomic<uint64_t> histogram[kHistogramBuckets];
+
+      void Clear() {
+        scope.store(nullptr, std::memory_order_relaxed);
+        first_child.store(kNoNode, std::memory_order_relaxed);
+        next_sibling.store(kNoNode, std::memory_order_relaxed);
+        entries.store(0u, std::memory_order_relaxed);
+        ticks_total.store(0u, std::memory_order_relaxed);
+        ticks_entered.store(0u, std::memory_order_relaxed);
+        ticks_max.store(0u, std::memory_order_relaxed);
+        for (auto& bucket : histogram) {
+          bucket.store(0u, std::memory_order_relaxed);
+        }
+      }
+    };
+
+    // The copy of the node made by the reporter.
+    struct NodeSnapshot {
+      const char* scope;
+      uint32_t first_child;
+      uint32_t next_sibling;
+      uint64_t entries;
+      uint64_t ticks_total;
+      uint64_t ticks_entered;
+      uint64_t ticks_max;
+      uint64_t histogram[kHistogramBuckets];
+      // The ticks spent in this scope as of `now`, including the time since it was entered, if within it.
+      uint64_t TicksSpent(uint64_t now) const {
+        return ticks_total + ((ticks_entered && now > ticks_entered) ? (now - ticks_entered) : 0u);
+      }
+    };
+
+    // The scope exit recorded into the ring of the most recent ones.
+    struct Sample {
+      std::atomic<uint32_t> node{kNoNode};
+      std::atomic<uint64_t> ticks_left{0u};
+      std::atomic<uint64_t> ticks_spent{0u};
+    };
+
+    struct SampleSnapshot {
+      uint32_t node;
+      uint64_t ticks_left;
+      uint64_t ticks_spent;
+    };
+
+    struct PerThread {
+      std::thread::id thread_id;
+      // The seqlock: odd while the thread is updating its trie, even otherwise.
+      std::atomic<uint64_t> seq{0u};
+      // The nodes of the trie, with the root at index zero.
+      std::unique_ptr<Node[]> nodes;
+      std::atomic<uint32_t> nodes_used{1u};
+      std::atomic<uint64_t> scopes_not_tracked{0u};
+      // The ring of the most recent scope exits. The sample `i` is at `samples[i % kSamplesPerThread]`.
+      std::unique_ptr<Sample[]> samples;
+      std::atomic<uint64_t> samples_written{0u};
+      // The call stack, accessed by the thread only. Past `kMaxScopeDepth` only the `depth` is maintained.
+      uint32_t stack[kMaxScopeDepth];
+      uint32_t depth = 1u;
+      // The snapshot taken upon `?reset`, to be subtracted from the subsequent reports. Guarded by the mutex.
+      std::vector<NodeSnapshot> baseline;
+      uint64_t baseline_ticks = 0u;
+
+      explicit PerThread(std::thread::id thread_id)
+          : nodes(new Node[kMaxScopesPerThread]()), samples(new Sample[kSamplesPerThread]()) {
+        Start(thread_id);
+      }
+
+      // Starts over for the thread `id`, the state being either new or left by the thread that has exited.
+      // Only the nodes used need clearing, and the samples past `samples_written` are never read.
+      void Start(std::thread::id id) {
+        thread_id = id;
+        const uint32_t used = nodes_used.load(std::memory_order_relaxed);
+        for (uint32_t i = 0u; i < used; ++i) {
+          nodes[i].Clear();
+        }
+        nodes_used.store(1u, std::memory_order_relaxed);
+        scopes_not_tracked.store(0u, std::memory_order_relaxed);
+        samples_written.store(0u, std::memory_order_relaxed);
+        depth = 1u;
+        baseline.clear();
+        baseline_ticks = 0u;
+        nodes[0].scope.store("", std::memory_order_relaxed);
+        nodes[0].entries.store(1u, std::memory_order_relaxed);
+        nodes[0].ticks_entered.store(Ticks::Now(), std::memory_order_relaxed);
+        stack[0] = 0u;
+      }
+
+      void BeginUpdate() {
+        seq.store(seq.load(std::memory_order_relaxed) + 1u, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+      }
+      void EndUpdate() { seq.store(seq.load(std::memory_order_relaxed) + 1u, std::memory_order_release); }
+
+      static void Increment(std::atomic<uint64_t>& value, uint64_t delta = 1u) {
+        value.store(value.load(std::memory_order_relaxed) + delta, std::memory_order_relaxed);
+      }
+
+      uint32_t FindOrAddChild(uint32_t parent, const char* scope) {
+        if (parent == kNoNode) {
+          return kNoNode;
+        }
+        Node& p = nodes[parent];
+        for (uint32_t i = p.first_child.load(std::memory_order_relaxed); i != kNoNode;
+             i = nodes[i].next_sibling.load(std::memory_order_relaxed)) {
+          if (nodes[i].scope.load(std::memory_order_relaxed) == scope) {
+            return i;
           }
-          void RecursiveReset(std::chrono::microseconds now) {
-            us_total = std::chrono::microseconds(0);
-            if (us_entered.count()) {
-              us_entered = now;
-            }
-            entries = 1;
-            for (auto& e : children) {
-              e.second.RecursiveReset(now);
-            }
+        }
+        const uint32_t i = nodes_used.load(std::memory_order_relaxed);
+        if (i == kMaxScopesPerThread) {
+          return kNoNode;
+        }
+        Node& node = nodes[i];
+        node.scope.store(scope, std::memory_order_relaxed);
+        node.next_sibling.store(p.first_child.load(std::memory_order_relaxed), std::memory_order_relaxed);
+        p.first_child.store(i, std::memory_order_relaxed);
+        nodes_used.store(i + 1u, std::memory_order_relaxed);
+        return i;
+      }
+
+      void EnterScope(const char* scope, uint64_t now) {
+        BeginUpdate();
+        const uint32_t node = (depth < kMaxScopeDepth) ? FindOrAddChild(stack[depth - 1u], scope) : kNoNode;
+        if (node != kNoNode) {
+          nodes[node].ticks_entered.store(now, std::memory_order_relaxed);
+          Increment(nodes[node].entries);
+        } else {
+          Increment(scopes_not_tracked);
+        }
+        if (depth < kMaxScopeDepth) {
+          stack[depth] = node;
+        }
+        ++depth;
+        EndUpdate();
+      }
+
+      void LeaveScope(uint64_t now) {
+        CURRENT_ASSERT(depth > 1u);  // Should have at least the root trie node left in the stack.
+        BeginUpdate();
+        --depth;
+        const uint32_t node = (depth < kMaxScopeDepth) ? stack[depth] : kNoNode;
+        if (node != kNoNode) {
+          Node& n = nodes[node];
+          const uint64_t entered = n.ticks_entered.load(std::memory_order_relaxed);
+          const uint64_t spent = now > entered ? now - entered : 0u;
+          Increment(n.ticks_total, spent);
+          n.ticks_entered.store(0u, std::memory_order_relaxed);
+          if (spent > n.ticks_max.load(std::memory_order_relaxed)) {
+            n.ticks_max.store(spent, std::memory_order_relaxed);
           }
-        };
-        Trie trie;
-        std::stack<std::pair<const char*, Trie*> > stack;
-        PerThread() {
-          trie.us_entered = current::time::Now();
-          trie.entries = 1;
-          stack.push(std::make_pair("", &trie));
+          Increment(n.histogram[HistogramBucket(spent)]);
+          // The sample is written before the counter is bumped, see `CopySamples()`.
+          const uint64_t i = samples_written.load(std::memory_order_relaxed);
+          Sample& sample = samples[i % kSamplesPerThread];
+          sample.node.store(node, std::memory_order_relaxed);
+          sample.ticks_left.store(now, std::memory_order_relaxed);
+          sample.ticks_spent.store(spent, std::memory_order_relaxed);
+          samples_written.store(i + 1u, std::memory_order_release);
         }
-      };
-      std::unordered_map<std::thread::id, PerThread> per_thread;
-      std::chrono::microseconds total_spent_in_profiling = std::chrono::microseconds(0);
-      std::chrono::microseconds spent_in_reporting = std::chrono::microseconds(0);
-      std::chrono::microseconds spent_in_mutex_locking = std::chrono::microseconds(0);
-      void Reset() {
-        total_spent_in_profiling = std::chrono::microseconds(0);
-        spent_in_reporting = std::chrono::microseconds(0);
-        spent_in_mutex_locking = std::chrono::microseconds(0);
-        for (auto& e : per_thread) {
-          e.second.trie.RecursiveReset(current::time::Now());
+        EndUpdate();
+      }
+
+      // Copies the trie, retrying while the thread is updating it. Called by the reporter.
+      void Snapshot(std::vector<NodeSnapshot>& output, uint64_t& now) const {
+        for (size_t attempt = 0u; attempt < kMaxSnapshotAttempts; ++attempt) {
+          const uint64_t before = seq.load(std::memory_order_acquire);
+          if (before & 1u) {
+            std::this_thread::yield();
+            continue;
+          }
+          CopyNodes(output);
+          now = Ticks::Now();
+          std::atomic_thread_fence(std::memory_order_acquire);
+          if (seq.load(std::memory_order_relaxed) == before) {
+            return;
+          }
         }
+        // LCOV_EXCL_START
+        // The thread is too busy to be caught between its updates. Its snapshot may be off by a scope or so.
+        CopyNodes(output);
+        now = Ticks::Now();
+        // LCOV_EXCL_STOP
       }
-      ProfilingReport GenerateReport() const {
-        const std::chrono::microseconds now = current::time::Now();
-        ProfilingReport report;
-        report.profiling_overhead = total_spent_in_profiling - spent_in_reporting;
-        report.reporting_overhead = spent_in_reporting;
-        report.profiling_mutex_overhead = spent_in_mutex_locking;
-        std::vector<PerThreadReporting> thread;
-        thread.reserve(per_thread.size());
-        for (const auto& per_thread_element : per_thread) {
-          std::function<void(const PerThread::Trie& input,
-                             std::chrono::microseconds total_us,
-                             PerThreadReporting& output,
-                             const char* stack)>
-              recursive_fill;
-          recursive_fill = [now, &recursive_fill](const PerThread::Trie& input,
-                                                  std::chrono::microseconds total_us,
-                                                  PerThreadReporting& output,
-                                                  const char* stack) {
-            output.scope = stack;
-            output.entries = input.entries;
-            CURRENT_ASSERT(output.entries);
-            output.us = input.ComputeTotalMicroseconds(now);
-            output.us_per_entry = 1.0 * output.us.count() / output.entries;
-            output.absolute_best_possible_qps = output.us.count() ? (1e6 / output.us_per_entry) : 1e6;
-            output.ratio_of_parent = total_us.count() ? (1.0 * output.us.count() / total_us.count()) : 1.0;
-            output.subscope.reserve(input.children.size());
-            for (const auto& scope : input.children) {
-              output.subscope.resize(output.subscope.size() + 1);
-              recursive_fill(scope.second, output.us, output.subscope.back(), scope.first);
-            }
-            CURRENT_ASSERT(output.subscope.size() == input.children.size());
-            std::chrono::microseconds subscope_total = std::chrono::microseconds(0);
-            for (const auto& subscope : output.subscope) {
-              subscope_total += subscope.us;
+
+      void CopyNodes(std::vector<NodeSnapshot>& output) const {
+        const uint32_t n = nodes_used.load(std::memory_order_relaxed);
+        output.resize(n);
+        for (uint32_t i = 0u; i < n; ++i) {
+          const Node& node = nodes[i];
+          NodeSnapshot& copy = output[i];
+          copy.scope = node.scope.load(std::memory_order_relaxed);
+          copy.first_child = node.first_child.load(std::memory_order_relaxed);
+          copy.next_sibling = node.next_sibling.load(std::memory_order_relaxed);
+          copy.entries = node.entries.load(std::memory_order_relaxed);
+          copy.ticks_total = node.ticks_total.load(std::memory_order_relaxed);
+          copy.ticks_entered = node.ticks_entered.load(std::memory_order_relaxed);
+          copy.ticks_max = node.ticks_max.load(std::memory_order_relaxed);
+          for (uint32_t b = 0u; b < kHistogramBuckets; ++b) {
+            copy.histogram[b] = node.histogram[b].load(std::memory_order_relaxed);
+          }
+        }
+      }
+
+      // Copies the samples of the scopes left since `since_ticks`. Does not need the seqlock: the samples that
+      // might have been overwritten while being copied are dropped. Returns the ticks of the oldest sample kept.
+      uint64_t CopySamples(std::vector<SampleSnapshot>& output, uint64_t since_ticks) const {
+        output.clear();
+        const uint64_t end = samples_written.load(std::memory_order_acquire);
+        const uint64_t begin = end > kSamplesPerThread ? end - kSamplesPerThread : 0u;
+        for (uint64_t i = begin; i < end; ++i) {
+          const Sample& sample = samples[i % kSamplesPerThread];
+          output.push_back(SampleSnapshot{sample.node.load(std::memory_order_relaxed),
+                                          sample.ticks_left.load(std::memory_order_relaxed),
+                                          sample.ticks_spent.load(std::memory_order_relaxed)});
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const uint64_t written_meanwhile = samples_written.load(std::memory_order_relaxed);
+        // The samples `[begin, written_meanwhile - kSamplesPerThread]` could have been overwritten.
+        const uint64_t first_intact =
+            written_meanwhile >= kSamplesPerThread ? written_meanwhile - kSamplesPerThread + 1u : 0u;
+        const size_t drop = static_cast<size_t>(std::min(first_intact > begin ? first_intact - begin : 0u,
+                                                         static_cast<uint64_t>(output.size())));
+        output.erase(output.begin(), output.begin() + drop);
+        // Whether the ring covers all of the time requested, or only the time since its oldest sample.
+        const uint64_t oldest = (!output.empty() && (begin > 0u || drop)) ? output.front().ticks_left : 0u;
+        output.erase(std::remove_if(output.begin(),
+                                    output.end(),
+                                    [since_ticks](const SampleSnapshot& s) { return s.ticks_left < since_ticks; }),
+                     output.end());
+        return std::max(oldest, since_ticks);
+      }
+    };
+
+    // The totals of the threads that have exited, merged by their call stacks. The root is entered once per thread.
+    struct RetiredThreads {
+      std::vector<NodeSnapshot> nodes;
+      // Indexed as `nodes`: the part of them from before the most recent `?reset`, to be subtracted from the reports.
+      std::vector<NodeSnapshot> baseline;
+      uint64_t scopes_not_tracked = 0u;
+
+      RetiredThreads() { AddNode(""); }
+
+      uint32_t AddNode(const char* scope) {
+        NodeSnapshot node{scope, kNoNode, kNoNode, 0u, 0u, 0u, 0u, {0u}};
+        nodes.push_back(node);
+        baseline.push_back(node);
+        return static_cast<uint32_t>(nodes.size() - 1u);
+      }
+
+      static void Add(NodeSnapshot& into, const NodeSnapshot& from, uint64_t now) {
+        into.entries += from.entries;
+        into.ticks_total += from.TicksSpent(now);
+        into.ticks_max = std::max(into.ticks_max, from.ticks_max);
+        for (uint32_t b = 0u; b < kHistogramBuckets; ++b) {
+          into.histogram[b] += from.histogram[b];
+        }
+      }
+
+      // The number of times the scope `index` of the thread's trie and its subscopes were entered.
+      static uint64_t Entries(const std::vector<NodeSnapshot>& from, uint32_t index) {
+        uint64_t entries = from[index].entries;
+        for (uint32_t i = from[index].first_child; i != kNoNode; i = from[i].next_sibling) {
+          entries += Entries(from, i);
+        }
+        return entries;
+      }
+
+      // Merges the node `index` of the thread's trie and its subscopes into the node `into`.
+      // Past `kMaxScopesOfThreadsThatHaveExited` distinct call stacks, the scopes are counted as not tracked.
+      void Merge(
+          const PerThread& thread, const std::vector<NodeSnapshot>& from, uint64_t now, uint32_t index, uint32_t into) {
+        Add(nodes[into], from[index], now);
+        if (index < thread.baseline.size()) {
+          Add(baseline[into], thread.baseline[index], thread.baseline_ticks);
+        }
+        for (uint32_t i = from[index].first_child; i != kNoNode; i = from[i].next_sibling) {
+          uint32_t child = nodes[into].first_child;
+          while (child != kNoNode && nodes[child].scope != from[i].scope) {
+            child = nodes[child].next_sibling;
+          }
+          if (child == kNoNode) {
+            if (nodes.size() == kMaxScopesOfThreadsThatHaveExited) {
+              scopes_not_tracked += Entries(from, i);
+              continue;
             }
-            CURRENT_ASSERT(subscope_total <= output.us);
-            output.subscope_total_ratio_of_parent =
-                output.us.count() ? (1.0 * subscope_total.count() / output.us.count()) : 1.0;
-            std::sort(output.subscope.begin(), output.subscope.end());
-          };
-          thread.resize(thread.size() + 1);
-          std::ostringstream thread_id_as_string;
-          thread_id_as_string << "C++ thread with internal ID " << per_thread_element.first;
-          recursive_fill(per_thread_element.second.trie,
-                         per_thread_element.second.trie.ComputeTotalMicroseconds(now),
-                         thread.back(),
-                         thread_id_as_string.str().c_str());
+            child = AddNode(from[i].scope);
+            nodes[child].next_sibling = baseline[child].next_sibling = nodes[into].first_child;
+            nodes[into].first_child = baseline[into].first_child = child;
+          }
+          Merge(thread, from, now, i, child);
         }
-        CURRENT_ASSERT(thread.size() == per_thread.size());
-        report.thread = thread;
-        return report;
       }
     };
 
    public:
+    StateMaintainer() {
+      // Measure the cost of entering and leaving a scope once, to report the total overhead of profiling.
+      PerThread scratch(std::this_thread::get_id());
+      constexpr static uint64_t kCalibrationRuns = 1000u;
+      const auto begin = std::chrono::steady_clock::now();
+      for (uint64_t i = 0u; i < kCalibrationRuns; ++i) {
+        scratch.EnterScope("calibration", Ticks::Now());
+        scratch.LeaveScope(Ticks::Now());
+      }
+      const auto end = std::chrono::steady_clock::now();
+      ns_per_scope_ = static_cast<double>(std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count()) /
+                      kCalibrationRuns;
+    }
+
     void EnterScope(const char* scope) {
       CURRENT_ASSERT(scope);
       CURRENT_ASSERT(*scope);
-      Guarded([scope](std::chrono::microseconds now, State::PerThread& per_thread) {
-        CURRENT_ASSERT(now.count());
-        CURRENT_ASSERT(!per_thread.stack.empty());
-        State::PerThread::Trie& node = (*per_thread.stack.top().second).children[scope];
-        node.us_entered = now;
-        ++node.entries;
-        per_thread.stack.push(std::make_pair(scope, &node));
-      });
+      ThisThread().EnterScope(scope, Ticks::Now());
     }
 
     void LeaveScope(const char* scope) {
       CURRENT_ASSERT(scope);
       CURRENT_ASSERT(*scope);
-      Guarded([scope](std::chrono::microseconds now, State::PerThread& per_thread) {
-        CURRENT_ASSERT(now.count());
-        CURRENT_ASSERT(!per_thread.stack.empty());
-        CURRENT_ASSERT(scope == per_thread.stack.top().first);
-        State::PerThread::Trie& node = (*per_thread.stack.top().second);
-        CURRENT_ASSERT(node.us_entered <= now);
-        node.us_total += (now - node.us_entered);
-        node.us_entered = std::chrono::microseconds(0);
-        per_thread.stack.pop();
-        CURRENT_ASSERT(!per_thread.stack.empty());  // Should have at least the root trie node left in the stack.
-      });
+      static_cast<void>(scope);
+      ThisThread().LeaveScope(Ticks::Now());
     }
 
     void Report(Request request) {
-      Guarded([this, &request](std::chrono::microseconds unused_now, const State::PerThread& unused_per_thread_state) {
-        static_cast<void>(unused_now);
-        static_cast<void>(unused_per_thread_state);
-        if (request.url.query.has("reset")) {
-          state_.Reset();
-          request("The profiler has been reset.\n");
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (request.url.query.has("reset")) {
+        for (auto& per_thread : threads_) {
+          per_thread->Snapshot(per_thread->baseline, per_thread->baseline_ticks);
+        }
+        retired_.baseline = retired_.nodes;
+        spent_in_reporting_ = std::chrono::microseconds(0);
+        request("The profiler has been reset.\n");
+      } else {
+        const std::string format = request.url.query.get("format", "json");
+        if (format != "json" && format != "folded" && format != "svg") {
+          request("The `?format` parameter is invalid, legal values are `json`, `folded`, or `svg`.\n",
+                  HTTPResponseCode.BadRequest);
+          return;
+        }
+        std::chrono::microseconds window = std::chrono::microseconds(0);
+        if (request.url.query.has("window") && !ParseWindow(request.url.query["window"], window)) {
+          request("The `?window` parameter is invalid, it should be the positive number of seconds.\n",
+                  HTTPResponseCode.BadRequest);
+          return;
+        }
+        const std::chrono::microseconds pre_report = current::time::Now();
+        const ProfilingReport report = window.count() ? GenerateWindowedReport(window) : GenerateReport();
+        if (format == "folded") {
+          request(AsFoldedStacks(report), HTTPResponseCode.OK, net::http::Headers(), "text/plain");
+        } else if (format == "svg") {
+          request(AsGraph(report).AsSVG(), HTTPResponseCode.OK, net::http::Headers(), "image/svg+xml");
         } else {
-          const std::chrono::microseconds pre_report = current::time::Now();
-          request(state_.GenerateReport());
-          const std::chrono::microseconds post_report = current::time::Now();
-          state_.spent_in_reporting += (post_report - pre_report);
+          request(report);
         }
-      });
+        const std::chrono::microseconds post_report = current::time::Now();
+        spent_in_reporting_ += (post_report - pre_report);
+      }
+    }
+
+    // The number of per-thread states allocated, be it by the running threads or kept to be reused.
+    size_t ThreadStatesAllocated() const {
+      std::lock_guard<std::mutex> lock(mutex_);
+      return threads_.size() + free_threads_.size();
     }
 
    private:
-    template <typename F>
-    void Guarded(F&& f) {
-      const std::chrono::microseconds pre_mutex_lock = current::time::Now();
+    // The state of the current thread, registered with the profiler upon its first scope, retired upon its exit.
+    PerThread& ThisThread() {
+      struct Registration {
+        StateMaintainer* self = nullptr;
+        PerThread* per_thread = nullptr;
+        ~Registration() {
+          if (per_thread) {
+            self->RetireThread(*per_thread);
+          }
+        }
+      };
+      thread_local Registration registration;
+      if (!registration.per_thread) {
+        registration.self = this;
+        registration.per_thread = &RegisterThread();
+      }
+      return *registration.per_thread;
+    }
+
+    PerThread& RegisterThread() {
       std::lock_guard<std::mutex> lock(mutex_);
-      const std::chrono::microseconds post_mutex_lock = current::time::Now();
-      f(post_mutex_lock, state_.per_thread[std::this_thread::get_id()]);
-      const std::chrono::microseconds post_guarded_code = current::time::Now();
-      state_.total_spent_in_profiling += (post_guarded_code - pre_mutex_lock);
-      state_.spent_in_mutex_locking += (post_mutex_lock - pre_mutex_lock);
+      if (free_threads_.empty()) {
+        threads_.emplace_back(std::make_unique<PerThread>(std::this_thread::get_id()));
+      } else {
+        free_threads_.back()->Start(std::this_thread::get_id());
+        threads_.push_back(std::move(free_threads_.back()));
+        free_threads_.pop_back();
+      }
+      return *threads_.back();
     }
 
-    struct Scope {
-      Scope(const char*) {}
-      const char* scope;
-    };
+    // Merges the totals of the thread that is exiting into `retired_`, and keeps its state to be reused.
+    void RetireThread(PerThread& per_thread) {
+      std::lock_guard<std::mutex> lock(mutex_);
+      std::vector<NodeSnapshot> nodes;
+      uint64_t now;
+      per_thread.Snapshot(nodes, now);
+      retired_.Merge(per_thread, nodes, now, 0u, 0u);
+      retired_.scopes_not_tracked += per_thread.scopes_not_tracked.load(std::memory_order_relaxed);
+      const auto it = std::find_if(threads_.begin(), threads_.end(), [&per_thread](const auto& p) {
+        return p.get() == &per_thread;
+      });
+      CURRENT_ASSERT(it != threads_.end());
+      free_threads_.push_back(std::move(*it));
+      threads_.erase(it);
+    }
+
+    // Parses the `?window` in seconds, which must be positive and make sense as a number of microseconds.
+    static bool ParseWindow(const std::string& value, std::chrono::microseconds& window) {
+      std::istringstream is(value);
+      double seconds;
+      char garbage;
+      if (!(is >> seconds) || (is >> garbage) || !(seconds >= 1e-6 && seconds <= 1e12)) {
+        return false;
+      }
+      window = std::chrono::microseconds(static_cast<int64_t>(1e6 * seconds));
+      return true;
+    }
+
+    static std::string ThreadName(const PerThread& per_thread) {
+      std::ostringstream thread_id_as_string;
+      thread_id_as_string << "C++ thread with internal ID " << per_thread.thread_id;
+      return thread_id_as_string.str();
+    }
+
+    // Fills in the fields computed off the ones already set, and sorts the subscopes.
+    static void FillRatios(PerThreadReporting& output, std::chrono::microseconds parent_us) {
+      output.us_per_entry = output.entries ? (1.0 * output.us.count() / output.entries) : 0.0;
+      output.absolute_best_possible_qps = output.us_per_entry > 0 ? (1e6 / output.us_per_entry) : 1e6;
+      output.ratio_of_parent = parent_us.count() ? (1.0 * output.us.count() / parent_us.count()) : 1.0;
+      std::chrono::microseconds subscope_total = std::chrono::microseconds(0);
+      for (const auto& subscope : output.subscope) {
+        subscope_total += subscope.us;
+      }
+      output.subscope_total_ratio_of_parent =
+          output.us.count() ? (1.0 * subscope_total.count() / output.us.count()) : 1.0;
+      std::sort(output.subscope.begin(), output.subscope.end());
+    }
+
+    // Must be called from a locked section.
+    ProfilingReport GenerateReport() const {
+      const double ticks_per_us = ticks_.TicksPerMicrosecond();
+      const auto ToMicroseconds = [ticks_per_us](uint64_t ticks) {
+        return std::chrono::microseconds(static_cast<int64_t>(ticks / ticks_per_us));
+      };
+      ProfilingReport report;
+      report.scopes_not_tracked = 0u;
+      uint64_t total_entries = 0u;
+
+      // Adds the thread with the trie `nodes` as of `now`, less its `baseline` as of `baseline_ticks`.
+      const auto add_thread = [&](const std::vector<NodeSnapshot>& nodes,
+                                  uint64_t now,
+                                  const std::vector<NodeSnapshot>& baseline,
+                                  uint64_t baseline_ticks,
+                                  const std::string& name) {
+        std::function<void(uint32_t, std::chrono::microseconds, PerThreadReporting&, const char*)> recursive_fill;
+        recursive_fill = [&](uint32_t index,
+                             std::chrono::microseconds parent_us,
+                             PerThreadReporting& output,
+                             const char* scope) {
+          const NodeSnapshot& input = nodes[index];
+          uint64_t entries = input.entries;
+          uint64_t ticks = input.TicksSpent(now);
+          uint64_t histogram[kHistogramBuckets];
+          std::copy(input.histogram, input.histogram + kHistogramBuckets, histogram);
+          uint64_t ticks_max = input.ticks_max;
+          if (index < baseline.size()) {
+            // The root is entered once, when the thread starts.
+            entries -= index ? std::min(entries, baseline[index].entries) : 0u;
+            ticks -= std::min(ticks, baseline[index].TicksSpent(baseline_ticks));
+            for (uint32_t b = 0u; b < kHistogramBuckets; ++b) {
+              histogram[b] -= std::min(histogram[b], baseline[index].histogram[b]);
+            }
+            // The max since the reset is not known, the upper bound of the top bucket since the reset is.
+            uint32_t top = kHistogramBuckets;
+            while (top && !histogram[top - 1u]) {
+              --top;
+            }
+            if (top < kHistogramBuckets) {
+              ticks_max = top ? std::min(ticks_max, static_cast<uint64_t>(1u) << top) : 0u;
+            }
+          }
+          total_entries += entries;
+          output.scope = scope;
+          output.entries = entries;
+          output.us = ToMicroseconds(ticks);
+          output.p50_us = HistogramQuantile(histogram, 0.5, ticks_max) / ticks_per_us;
+          output.p99_us = HistogramQuantile(histogram, 0.99, ticks_max) / ticks_per_us;
+          output.max_us = ticks_max / ticks_per_us;
+          for (uint32_t i = input.first_child; i != kNoNode; i = nodes[i].next_sibling) {
+            output.subscope.resize(output.subscope.size() + 1);
+            recursive_fill(i, output.us, output.subscope.back(), nodes[i].scope);
+          }
+          FillRatios(output, parent_us);
+        };
+
+        report.thread.resize(report.thread.size() + 1);
+        recursive_fill(0u, std::chrono::microseconds(0), report.thread.back(), name.c_str());
+      };
+
+      std::vector<NodeSnapshot> nodes;
+      for (const auto& per_thread : threads_) {
+        uint64_t now;
+        per_thread->Snapshot(nodes, now);
+        report.scopes_not_tracked += per_thread->scopes_not_tracked.load(std::memory_order_relaxed);
+        add_thread(nodes, now, per_thread->baseline, per_thread->baseline_ticks, ThreadName(*per_thread));
+      }
+      report.scopes_not_tracked += retired_.scopes_not_tracked;
+      if (retired_.nodes[0].entries) {
+        add_thread(retired_.nodes, 0u, retired_.baseline, 0u, kRetiredThreadsName);
+      }
+      report.profiling_overhead =
+          std::chrono::microseconds(static_cast<int64_t>(total_entries * ns_per_scope_ * 1e-3));
+      report.reporting_overhead = spent_in_reporting_;
+      return report;
+    }
+
+    // Must be called from a locked section.
+    ProfilingReport GenerateWindowedReport(std::chrono::microseconds window) const {
+      const double ticks_per_us = ticks_.TicksPerMicrosecond();
+      const auto ToMicroseconds = [ticks_per_us](uint64_t ticks) {
+        return std::chrono::microseconds(static_cast<int64_t>(ticks / ticks_per_us));
+      };
+      ProfilingReport report;
+      report.scopes_not_tracked = 0u;
+      report.window = window;
+      std::chrono::microseconds window_covered = window;
+      uint64_t total_entries = 0u;
+      std::vector<NodeSnapshot> nodes;
+      std::vector<SampleSnapshot> samples;
+      for (const auto& per_thread : threads_) {
+        uint64_t now;
+        per_thread->Snapshot(nodes, now);
+        report.scopes_not_tracked += per_thread->scopes_not_tracked.load(std::memory_order_relaxed);
+        const uint64_t window_ticks = static_cast<uint64_t>(window.count() * ticks_per_us);
+        const uint64_t since = now > window_ticks ? now - window_ticks : 0u;
+        const uint64_t covered_since = per_thread->CopySamples(samples, since);
+        if (covered_since > since) {
+          window_covered = std::min(window_covered, ToMicroseconds(now - std::min(now, covered_since)));
+        }
+
+        // The times spent in each scope within the window, by node.
+        std::vector<std::vector<uint64_t>> spent(nodes.size());
+        for (const auto& sample : samples) {
+          if (sample.node < spent.size()) {
+            spent[sample.node].push_back(sample.ticks_spent);
+          }
+        }
+
+        // Returns `false` if neither this scope nor any of its subscopes has been left within the window.
+        std::function<bool(uint32_t, std::chrono::microseconds, PerThreadReporting&)> recursive_fill;
+        recursive_fill = [&](uint32_t index, std::chrono::microseconds parent_us, PerThreadReporting& output) {
+          std::vector<uint64_t>& durations = spent[index];
+          std::sort(durations.begin(), durations.end());
+          uint64_t ticks = 0u;
+          for (uint64_t d : durations) {
+            ticks += d;
+          }
+          const auto Quantile = [&durations, ticks_per_us](double q) {
+            return durations.empty() ? 0.0
+                                     : durations[std::min(static_cast<size_t>(q * durations.size()),
+                                                          durations.size() - 1u)] /
+                                           ticks_per_us;
+          };
+          output.scope = nodes[index].scope;
+          output.entries = durations.size();
+          output.us = ToMicroseconds(ticks);
+          output.p50_us = Quantile(0.5);
+          output.p99_us = Quantile(0.99);
+          output.max_us = durations.empty() ? 0.0 : durations.back() / ticks_per_us;
+          total_entries += durations.size();
+          for (uint32_t i = nodes[index].first_child; i != kNoNode; i = nodes[i].next_sibling) {
+            output.subscope.resize(output.subscope.size() + 1);
+            if (!recursive_fill(i, output.us, output.subscope.back())) {
+              output.subscope.pop_back();
+            }
+          }
+          FillRatios(output, parent_us);
+          return !durations.empty() || !output.subscope.empty();
+        };
+
+        report.thread.resize(report.thread.size() + 1);
+        PerThreadReporting& root = report.thread.back();
+        recursive_fill(0u, std::chrono::microseconds(0), root);
+        // The thread itself is "within" its root scope for the whole window.
+        root.scope = ThreadName(*per_thread);
+        root.entries = 1u;
+        root.us = ToMicroseconds(now - std::max(since, std::min(now, nodes[0].ticks_entered)));
+        root.p50_us = root.p99_us = root.max_us = 0.0;
+        for (auto& subscope : root.subscope) {
+          subscope.ratio_of_parent = root.us.count() ? (1.0 * subscope.us.count() / root.us.count()) : 1.0;
+        }
+        FillRatios(root, std::chrono::microseconds(0));
+      }
+      report.scopes_not_tracked += retired_.scopes_not_tracked;
+      report.profiling_overhead =
+          std::chrono::microseconds(static_cast<int64_t>(total_entries * ns_per_scope_ * 1e-3));
+      report.reporting_overhead = spent_in_reporting_;
+      report.window_covered = window_covered;
+      return report;
+    }
+
+    // The collapsed stacks, as in `thread;scope;subscope <microseconds>`, with the time spent in the scope itself.
+    static std::string AsFoldedStacks(const ProfilingReport& report) {
+      std::ostringstream os;
+      std::function<void(const PerThreadReporting&, const std::string&)> recursive_dump;
+      recursive_dump = [&os, &recursive_dump](const PerThreadReporting& node, const std::string& parent_stack) {
+        std::string name = node.scope;
+        std::replace(name.begin(), name.end(), ';', ':');
+        std::replace(name.begin(), name.end(), ' ', '_');
+        const std::string stack = parent_stack.empty() ? name : parent_stack + ';' + name;
+        std::chrono::microseconds self = node.us;
+        for (const auto& subscope : node.subscope) {
+          self -= subscope.us;
+          recursive_dump(subscope, stack);
+        }
+        if (self.count() > 0) {
+          os << stack << ' ' << self.count() << '\n';
+        }
+      };
+      for (const auto& thread : report.thread) {
+        recursive_dump(thread, "");
+      }
+      return os.str();
+    }
+
+    // The call tree, each scope labeled with its time and its share of the parent.
+    static graphviz::DiGraph AsGraph(const ProfilingReport& report) {
+      graphviz::DiGraph graph;
+      graph.RankDirLR();
+      std::function<graphviz::Node(const PerThreadReporting&)> recursive_add;
+      recursive_add = [&graph, &recursive_add](const PerThreadReporting& scope) {
+        graphviz::Node node(strings::Printf("%s\n%lld us, %.1lf%%\np50 %.1lf us, p99 %.1lf us, max %.1lf us",
+                                            scope.scope.c_str(),
+                                            static_cast<long long>(scope.us.count()),
+                                            100.0 * scope.ratio_of_parent,
+                                            scope.p50_us,
+                                            scope.p99_us,
+                                            scope.max_us));
+        node.Shape("box");
+        graph += node;
+        for (const auto& subscope : scope.subscope) {
+          graph += graphviz::Edge(node, recursive_add(subscope));
+        }
+        return node;
+      };
+      for (const auto& thread : report.thread) {
+        recursive_add(thread);
+      }
+      return graph;
+    }
+
+    const Ticks ticks_;
+    double ns_per_scope_ = 0.0;
 
-    std::mutex mutex_;
-    State state_;
+    // Guards the list of threads, and the reporting, never the scopes.
+    mutable std::mutex mutex_;
+    std::vector<std::unique_ptr<PerThread>> threads_;
+    // The states of the threads that have exited, to be reused by the new ones.
+    std::vector<std::unique_ptr<PerThread>> free_threads_;
+    RetiredThreads retired_;
+    std::chrono::microseconds spent_in_reporting_ = std::chrono::microseconds(0);
   };
 
   class ScopedStateMaintainer {
@@ -0,0 +1,606 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#define CURRENT_PROFILER
+
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../3rdparty/gtest/gtest-main.h"
+
+namespace profiler_test {
+
+using current::profiler::PerThreadReporting;
+using current::profiler::ProfilingReport;
+
+// Exposes the profiler on a port of its own, returns its URL.
+inline std::string ExposeProfiler(HTTPRoutesScope& scope) {
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  scope += HTTP(std::move(reserved_port)).Register("/profiler", current::profiler::Profiler::HTTPRoute);
+  return current::strings::Printf("http://localhost:%d/profiler", port);
+}
+
+inline std::string ThisThreadName() {
+  std::ostringstream os;
+  os << "C++ thread with internal ID " << std::this_thread::get_id();
+  return os.str();
+}
+
+// The most recent thread by this name, as the IDs of the threads that are gone may be reused.
+inline const PerThreadReporting* FindThread(const ProfilingReport& report, const std::string& name) {
+  for (auto it = report.thread.rbegin(); it != report.thread.rend(); ++it) {
+    if (it->scope == name) {
+      return &(*it);
+    }
+  }
+  return nullptr;
+}
+
+inline const PerThreadReporting* FindSubscope(const PerThreadReporting& parent, const std::string& name) {
+  for (const auto& subscope : parent.subscope) {
+    if (subscope.scope == name) {
+      return &subscope;
+    }
+  }
+  return nullptr;
+}
+
+// Runs `f` in a thread of its own, which then waits to be destroyed, as the profiler reports the threads that have
+// exited all together.
+class ParkedThread final {
+ public:
+  template <typename F>
+  explicit ParkedThread(F&& f)
+      : thread_([this, &f]() {
+          name_ = ThisThreadName();
+          f();
+          std::unique_lock<std::mutex> lock(mutex_);
+          ran_ = true;
+          condition_variable_.notify_all();
+          condition_variable_.wait(lock, [this]() { return exit_; });
+        }) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_variable_.wait(lock, [this]() { return ran_; });
+  }
+
+  ~ParkedThread() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      exit_ = true;
+      condition_variable_.notify_all();
+    }
+    thread_.join();
+  }
+
+  // The name of this thread in the reports.
+  const std::string& Name() const { return name_; }
+
+ private:
+  std::mutex mutex_;
+  std::condition_variable condition_variable_;
+  bool ran_ = false;
+  bool exit_ = false;
+  std::string name_;
+  std::thread thread_;
+};
+
+}  // namespace profiler_test
+
+TEST(Profiler, HistogramMath) {
+  using current::profiler::HistogramBucket;
+  using current::profiler::HistogramQuantile;
+  using current::profiler::kHistogramBuckets;
+
+  EXPECT_EQ(0u, HistogramBucket(0u));
+  EXPECT_EQ(0u, HistogramBucket(1u));
+  EXPECT_EQ(1u, HistogramBucket(2u));
+  EXPECT_EQ(1u, HistogramBucket(3u));
+  EXPECT_EQ(2u, HistogramBucket(4u));
+  EXPECT_EQ(9u, HistogramBucket(1023u));
+  EXPECT_EQ(10u, HistogramBucket(1024u));
+  EXPECT_EQ(kHistogramBuckets - 1u, HistogramBucket(1ull << (kHistogramBuckets - 1u)));
+  EXPECT_EQ(kHistogramBuckets - 1u, HistogramBucket(static_cast<uint64_t>(-1)));
+
+  uint64_t histogram[kHistogramBuckets] = {0u};
+  EXPECT_EQ(0.0, HistogramQuantile(histogram, 0.5, 0u));
+
+  // Four durations within [8, 16): the quantiles are interpolated linearly within the bucket.
+  histogram[3] = 4u;
+  EXPECT_EQ(12.0, HistogramQuantile(histogram, 0.5, 15u));
+  EXPECT_EQ(14.0, HistogramQuantile(histogram, 0.75, 15u));
+  // And capped by the max known.
+  EXPECT_EQ(10.0, HistogramQuantile(histogram, 0.5, 10u));
+
+  // One more duration within [1024, 2048) makes it the p99.
+  histogram[10] = 1u;
+  EXPECT_EQ(13.0, HistogramQuantile(histogram, 0.5, 2000u));
+  EXPECT_DOUBLE_EQ(1024.0 + 1024.0 * 0.95, HistogramQuantile(histogram, 0.99, 2000u));
+  EXPECT_EQ(2000.0, HistogramQuantile(histogram, 1.0, 2000u));
+
+  // The last bucket is open-ended, its upper bound is the max.
+  uint64_t open_ended[kHistogramBuckets] = {0u};
+  open_ended[kHistogramBuckets - 1u] = 2u;
+  const uint64_t lo = 1ull << (kHistogramBuckets - 1u);
+  EXPECT_EQ(lo + 50.0, HistogramQuantile(open_ended, 0.5, lo + 100u));
+}
+
+TEST(Profiler, NestedScopes) {
+  using namespace profiler_test;
+
+  HTTPRoutesScope scope;
+  const std::string url = ExposeProfiler(scope);
+
+  const ParkedThread thread([]() {
+    for (int i = 0; i < 3; ++i) {
+      CURRENT_PROFILER_SCOPE("outer");
+      {
+        CURRENT_PROFILER_SCOPE("inner");
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+      {
+        CURRENT_PROFILER_SCOPE("another inner");
+      }
+    }
+  });
+
+  const auto response = HTTP(GET(url));
+  EXPECT_EQ(200, static_cast<int>(response.code));
+  const auto report = ParseJSON<ProfilingReport>(response.body);
+  EXPECT_FALSE(Exists(report.window));
+  EXPECT_FALSE(Exists(report.window_covered));
+
+  const PerThreadReporting* root = FindThread(report, thread.Name());
+  ASSERT_TRUE(root);
+  ASSERT_EQ(1u, root->subscope.size());
+  const PerThreadReporting& outer = root->subscope[0];
+  EXPECT_EQ("outer", outer.scope);
+  EXPECT_EQ(3u, outer.entries);
+  ASSERT_EQ(2u, outer.subscope.size());
+  // The subscopes are sorted by the time spent in them.
+  const PerThreadReporting& inner = outer.subscope[0];
+  EXPECT_EQ("inner", inner.scope);
+  EXPECT_EQ("another inner", outer.subscope[1].scope);
+  EXPECT_EQ(3u, inner.entries);
+  EXPECT_EQ(3u, outer.subscope[1].entries);
+
+  EXPECT_GE(inner.us.count(), 6000);
+  EXPECT_LE(inner.us.count(), outer.us.count());
+  EXPECT_LE(outer.us.count(), root->us.count());
+  EXPECT_GT(inner.ratio_of_parent, 0.5);
+  EXPECT_LE(inner.ratio_of_parent, 1.0);
+  EXPECT_LE(outer.subscope_total_ratio_of_parent, 1.0);
+
+  // Each of the sleeps takes at least two milliseconds, and the histogram is precise within a factor of two.
+  EXPECT_GE(inner.p50_us, 1000.0);
+  EXPECT_GE(inner.max_us, 2000.0);
+  EXPECT_LE(inner.p50_us, inner.p99_us);
+  EXPECT_LE(inner.p99_us, inner.max_us);
+}
+
+TEST(Profiler, WindowedReport) {
+  using namespace profiler_test;
+  using current::profiler::kSamplesPerThread;
+
+  HTTPRoutesScope scope;
+  const std::string url = ExposeProfiler(scope);
+
+  const ParkedThread thread([]() {
+    for (int i = 0; i < 10; ++i) {
+      CURRENT_PROFILER_SCOPE("windowed");
+      std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+  });
+
+  {
+    const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url + "?window=10")).body);
+    ASSERT_TRUE(Exists(report.window));
+    EXPECT_EQ(10000000, Value(report.window).count());
+    // No thread has left more scopes than its ring of samples holds, so the whole window is covered.
+    ASSERT_TRUE(Exists(report.window_covered));
+    EXPECT_EQ(10000000, Value(report.window_covered).count());
+    const PerThreadReporting* root = FindThread(report, thread.Name());
+    ASSERT_TRUE(root);
+    ASSERT_EQ(1u, root->subscope.size());
+    const PerThreadReporting& windowed = root->subscope[0];
+    EXPECT_EQ("windowed", windowed.scope);
+    EXPECT_EQ(10u, windowed.entries);
+    EXPECT_GE(windowed.us.count(), 10000);
+    // The percentiles of the window are exact, taken off the samples.
+    EXPECT_GE(windowed.p50_us, 1000.0);
+    EXPECT_LE(windowed.p50_us, windowed.p99_us);
+    EXPECT_LE(windowed.p99_us, windowed.max_us);
+    EXPECT_LE(windowed.max_us, windowed.us.count() + 1.0);
+  }
+
+  // The window shorter than the time since the scopes were left does not report them.
+  std::this_thread::sleep_for(std::chrono::milliseconds(20));
+  {
+    const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url + "?window=0.01")).body);
+    EXPECT_EQ(10000, Value(report.window).count());
+    const PerThreadReporting* root = FindThread(report, thread.Name());
+    ASSERT_TRUE(root);
+    EXPECT_TRUE(root->subscope.empty());
+  }
+
+  // The thread that has left more scopes than its ring holds only covers part of the window.
+  const ParkedThread busy_thread([]() {
+    for (uint64_t i = 0u; i < kSamplesPerThread + 100u; ++i) {
+      CURRENT_PROFILER_SCOPE("frequent");
+    }
+  });
+  {
+    const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url + "?window=10")).body);
+    ASSERT_TRUE(Exists(report.window_covered));
+    EXPECT_LT(Value(report.window_covered).count(), 10000000);
+    const PerThreadReporting* root = FindThread(report, busy_thread.Name());
+    ASSERT_TRUE(root);
+    ASSERT_TRUE(FindSubscope(*root, "frequent"));
+    // Less the oldest sample, as the thread could be overwriting it while the ring was copied.
+    EXPECT_EQ(kSamplesPerThread - 1u, FindSubscope(*root, "frequent")->entries);
+  }
+  {
+    // The regular report is not limited by the ring.
+    const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url)).body);
+    const PerThreadReporting* root = FindThread(report, busy_thread.Name());
+    ASSERT_TRUE(root);
+    ASSERT_TRUE(FindSubscope(*root, "frequent"));
+    EXPECT_EQ(kSamplesPerThread + 100u, FindSubscope(*root, "frequent")->entries);
+  }
+}
+
+TEST(Profiler, SnapshotWhileThreadsAreRunning) {
+  using namespace profiler_test;
+
+  HTTPRoutesScope scope;
+  const std::string url = ExposeProfiler(scope);
+
+  constexpr static size_t kThreads = 4u;
+  std::atomic_bool done(false);
+  std::atomic_size_t started(0u);
+  std::vector<std::string> names(kThreads);
+  std::vector<std::thread> threads;
+  for (size_t t = 0u; t < kThreads; ++t) {
+    threads.emplace_back([&done, &started, &names, t]() {
+      names[t] = ThisThreadName();
+      ++started;
+      while (!done) {
+        CURRENT_PROFILER_SCOPE("busy");
+        CURRENT_PROFILER_SCOPE("busier");
+      }
+    });
+  }
+  while (started != kThreads) {
+    std::this_thread::yield();
+  }
+
+  // Each snapshot of a thread is consistent: a scope is never entered more times than its parent.
+  for (int i = 0; i < 20; ++i) {
+    const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url)).body);
+    for (const std::string& name : names) {
+      const PerThreadReporting* root = FindThread(report, name);
+      ASSERT_TRUE(root);
+      const PerThreadReporting* busy = FindSubscope(*root, "busy");
+      if (busy) {
+        const PerThreadReporting* busier = FindSubscope(*busy, "busier");
+        ASSERT_TRUE(busier);
+        EXPECT_LE(busier->entries, busy->entries);
+        EXPECT_GE(busier->entries + 1u, busy->entries);
+      }
+    }
+  }
+
+  done = true;
+  for (auto& thread : threads) {
+    thread.join();
+  }
+}
+
+TEST(Profiler, Reset) {
+  using namespace profiler_test;
+
+  HTTPRoutesScope scope;
+  const std::string url = ExposeProfiler(scope);
+
+  std::atomic_int stage(0);
+  std::string thread;
+  std::thread worker([&stage, &thread]() {
+    thread = ThisThreadName();
+    {
+      CURRENT_PROFILER_SCOPE("long");
+      std::this_thread::sleep_for(std::chrono::milliseconds(20));
+    }
+    for (int i = 0; i < 5; ++i) {
+      CURRENT_PROFILER_SCOPE("short");
+    }
+    stage = 1;
+    while (stage != 2) {
+      std::this_thread::yield();
+    }
+    for (int i = 0; i < 2; ++i) {
+      CURRENT_PROFILER_SCOPE("short");
+    }
+    // Stay running until reported on, as the profiler reports the threads that have exited all together.
+    stage = 3;
+    while (stage != 4) {
+      std::this_thread::yield();
+    }
+  });
+
+  while (stage != 1) {
+    std::this_thread::yield();
+  }
+  {
+    const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url)).body);
+    const PerThreadReporting* root = FindThread(report, thread);
+    ASSERT_TRUE(root);
+    ASSERT_TRUE(FindSubscope(*root, "short"));
+    EXPECT_EQ(5u, FindSubscope(*root, "short")->entries);
+    ASSERT_TRUE(FindSubscope(*root, "long"));
+    EXPECT_EQ(1u, FindSubscope(*root, "long")->entries);
+    EXPECT_GE(FindSubscope(*root, "long")->max_us, 20000.0);
+  }
+
+  EXPECT_EQ("The profiler has been reset.\n", HTTP(GET(url + "?reset")).body);
+  stage = 2;
+  while (stage != 3) {
+    std::this_thread::yield();
+  }
+
+  // Only what has happened since the reset is reported.
+  const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url)).body);
+  stage = 4;
+  worker.join();
+  const PerThreadReporting* root = FindThread(report, thread);
+  ASSERT_TRUE(root);
+  ASSERT_TRUE(FindSubscope(*root, "short"));
+  EXPECT_EQ(2u, FindSubscope(*root, "short")->entries);
+  ASSERT_TRUE(FindSubscope(*root, "long"));
+  const PerThreadReporting& long_scope = *FindSubscope(*root, "long");
+  EXPECT_EQ(0u, long_scope.entries);
+  EXPECT_EQ(0, long_scope.us.count());
+  EXPECT_EQ(0.0, long_scope.p50_us);
+  EXPECT_EQ(0.0, long_scope.max_us);
+  EXPECT_LT(root->us.count(), 20000);
+}
+
+TEST(Profiler, ScopesNotTracked) {
+  using namespace profiler_test;
+  using current::profiler::kMaxScopeDepth;
+  using current::profiler::kMaxScopesPerThread;
+
+  HTTPRoutesScope scope;
+  const std::string url = ExposeProfiler(scope);
+  const auto ScopesNotTracked = [&url]() {
+    return ParseJSON<ProfilingReport>(HTTP(GET(url)).body).scopes_not_tracked;
+  };
+
+  // The root of the per-thread trie is one of the `kMaxScopesPerThread` nodes.
+  constexpr static size_t kExtraScopes = 10u;
+  // The profiler keeps the pointers to the names of the scopes, so they must outlive it.
+  static std::vector<std::string> scopes;
+  for (size_t i = scopes.size(); i < kMaxScopesPerThread - 1u + kExtraScopes; ++i) {
+    scopes.push_back("scope " + current::ToString(i));
+  }
+  const uint64_t before = ScopesNotTracked();
+  const ParkedThread thread([]() {
+    for (const std::string& name : scopes) {
+      CURRENT_PROFILER_SCOPE(name.c_str());
+    }
+    // Entering the scope already tracked is fine.
+    CURRENT_PROFILER_SCOPE(scopes.front().c_str());
+  });
+  const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url)).body);
+  EXPECT_EQ(before + kExtraScopes, report.scopes_not_tracked);
+  const PerThreadReporting* root = FindThread(report, thread.Name());
+  ASSERT_TRUE(root);
+  EXPECT_EQ(kMaxScopesPerThread - 1u, root->subscope.size());
+  ASSERT_TRUE(FindSubscope(*root, scopes.front()));
+  EXPECT_EQ(2u, FindSubscope(*root, scopes.front())->entries);
+
+  // The root of the trie is at depth zero, so the scopes at depth `kMaxScopeDepth` and below are not tracked.
+  std::function<void(uint32_t)> recursive_scope;
+  recursive_scope = [&recursive_scope](uint32_t depth) {
+    CURRENT_PROFILER_SCOPE("deep");
+    if (depth + 1u < kMaxScopeDepth + kExtraScopes) {
+      recursive_scope(depth + 1u);
+    }
+  };
+  const uint64_t before_deep = ScopesNotTracked();
+  const ParkedThread deep_thread([&recursive_scope]() { recursive_scope(1u); });
+  const auto deep_report = ParseJSON<ProfilingReport>(HTTP(GET(url)).body);
+  EXPECT_EQ(before_deep + kExtraScopes, deep_report.scopes_not_tracked);
+  const PerThreadReporting* deep_root = FindThread(deep_report, deep_thread.Name());
+  ASSERT_TRUE(deep_root);
+  uint32_t depth = 0u;
+  for (const PerThreadReporting* node = deep_root; !node->subscope.empty(); node = &node->subscope.front()) {
+    EXPECT_EQ(1u, node->subscope.size());
+    EXPECT_EQ(1u, node->subscope.front().entries);
+    ++depth;
+  }
+  EXPECT_EQ(kMaxScopeDepth - 1u, depth);
+}
+
+TEST(Profiler, Formats) {
+  using namespace profiler_test;
+
+  HTTPRoutesScope scope;
+  const std::string url = ExposeProfiler(scope);
+
+  const ParkedThread parked_thread([]() {
+    CURRENT_PROFILER_SCOPE("folded outer");
+    {
+      CURRENT_PROFILER_SCOPE("folded;inner");
+      std::this_thread::sleep_for(std::chrono::milliseconds(2));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(2));
+  });
+  std::string thread = parked_thread.Name();
+  std::replace(thread.begin(), thread.end(), ' ', '_');
+
+  // The collapsed stacks, one line per scope with the time spent in the scope itself, for `flamegraph.pl`.
+  for (const char* query : {"?format=folded", "?format=folded&window=10"}) {
+    const auto response = HTTP(GET(url + query));
+    EXPECT_EQ(200, static_cast<int>(response.code)) << query;
+    EXPECT_EQ("text/plain", response.headers.Get("Content-Type")) << query;
+    std::map<std::string, int64_t> stacks;
+    std::istringstream is(response.body);
+    std::string stack;
+    int64_t us;
+    while (is >> stack >> us) {
+      stacks[stack] = us;
+    }
+    const std::string outer = thread + ";folded_outer";
+    ASSERT_TRUE(stacks.count(outer)) << query;
+    ASSERT_TRUE(stacks.count(outer + ";folded:inner")) << query;
+    EXPECT_GE(stacks[outer], 1000) << query;
+    EXPECT_GE(stacks[outer + ";folded:inner"], 2000) << query;
+  }
+
+  // The call tree rendered as SVG requires GraphViz.
+  if (!current::bricks::system::SystemCall("dot -V >/dev/null 2>&1")) {
+    const auto response = HTTP(GET(url + "?format=svg"));
+    EXPECT_EQ(200, static_cast<int>(response.code));
+    EXPECT_EQ("image/svg+xml", response.headers.Get("Content-Type"));
+    EXPECT_NE(std::string::npos, response.body.find("<svg"));
+    EXPECT_NE(std::string::npos, response.body.find("folded outer"));
+  }
+
+  EXPECT_EQ(200, static_cast<int>(HTTP(GET(url + "?format=json")).code));
+}
+
+TEST(Profiler, InvalidParameters) {
+  using namespace profiler_test;
+
+  HTTPRoutesScope scope;
+  const std::string url = ExposeProfiler(scope);
+
+  for (const char* query : {"?format=xml", "?format=", "?format=svg&window=-1"}) {
+    const auto response = HTTP(GET(url + query));
+    EXPECT_EQ(400, static_cast<int>(response.code)) << query;
+  }
+  EXPECT_EQ("The `?format` parameter is invalid, legal values are `json`, `folded`, or `svg`.\n",
+            HTTP(GET(url + "?format=xml")).body);
+
+  for (const char* query : {"?window=-1", "?window=0", "?window=", "?window=abc", "?window=10abc", "?window=nan",
+                                   "?window=inf", "?window=1e100", "?format=folded&window=-5"}) {
+    const auto response = HTTP(GET(url + query));
+    EXPECT_EQ(400, static_cast<int>(response.code)) << query;
+    EXPECT_EQ("The `?window` parameter is invalid, it should be the positive number of seconds.\n", response.body)
+        << query;
+  }
+
+  EXPECT_EQ(200, static_cast<int>(HTTP(GET(url + "?window=0.5")).code));
+  EXPECT_EQ(200, static_cast<int>(HTTP(GET(url + "?window=1e-3&format=folded")).code));
+}
+
+TEST(Profiler, ThreadsThatHaveExited) {
+  using namespace profiler_test;
+  using current::profiler::kRetiredThreadsName;
+
+  HTTPRoutesScope scope;
+  const std::string url = ExposeProfiler(scope);
+  const auto& profiler = current::Singleton<current::profiler::Profiler::StateMaintainer>();
+
+  // The totals of the threads that have exited, merged into one, for the scope `name`.
+  const auto ExitedEntries = [&url](const std::string& name) -> uint64_t {
+    const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url)).body);
+    const PerThreadReporting* root = FindThread(report, kRetiredThreadsName);
+    const PerThreadReporting* subscope = root ? FindSubscope(*root, name) : nullptr;
+    return subscope ? subscope->entries : 0u;
+  };
+
+  constexpr static size_t kThreadsAtOnce = 4u;
+  const auto RunThreads = []() {
+    std::vector<std::thread> threads;
+    for (size_t t = 0u; t < kThreadsAtOnce; ++t) {
+      threads.emplace_back([]() {
+        CURRENT_PROFILER_SCOPE("exited");
+        CURRENT_PROFILER_SCOPE("exited inner");
+      });
+    }
+    for (auto& thread : threads) {
+      thread.join();
+    }
+  };
+
+  const uint64_t before = ExitedEntries("exited");
+  RunThreads();
+  const size_t allocated = profiler.ThreadStatesAllocated();
+
+  // The states of the threads that have exited are reused, and their totals are kept.
+  constexpr static size_t kRuns = 50u;
+  for (size_t i = 0u; i < kRuns; ++i) {
+    RunThreads();
+  }
+  EXPECT_EQ(allocated, profiler.ThreadStatesAllocated());
+  EXPECT_EQ(before + (kRuns + 1u) * kThreadsAtOnce, ExitedEntries("exited"));
+  {
+    const auto report = ParseJSON<ProfilingReport>(HTTP(GET(url)).body);
+    for (const auto& thread : report.thread) {
+      EXPECT_FALSE(FindSubscope(thread, "exited") && thread.scope != kRetiredThreadsName) << thread.scope;
+    }
+    const PerThreadReporting* root = FindThread(report, kRetiredThreadsName);
+    ASSERT_TRUE(root);
+    ASSERT_TRUE(FindSubscope(*root, "exited"));
+    const PerThreadReporting& exited = *FindSubscope(*root, "exited");
+    ASSERT_EQ(1u, exited.subscope.size());
+    EXPECT_EQ("exited inner", exited.subscope[0].scope);
+    EXPECT_EQ(exited.entries, exited.subscope[0].entries);
+  }
+
+  // The thread that exits after the reset only adds what it has done since the reset.
+  std::atomic_int stage(0);
+  std::thread worker([&stage]() {
+    for (int i = 0; i < 3; ++i) {
+      CURRENT_PROFILER_SCOPE("exited after reset");
+    }
+    stage = 1;
+    while (stage != 2) {
+      std::this_thread::yield();
+    }
+    for (int i = 0; i < 2; ++i) {
+      CURRENT_PROFILER_SCOPE("exited after reset");
+    }
+  });
+  while (stage != 1) {
+    std::this_thread::yield();
+  }
+  EXPECT_EQ("The profiler has been reset.\n", HTTP(GET(url + "?reset")).body);
+  stage = 2;
+  worker.join();
+  EXPECT_EQ(0u, ExitedEntries("exited"));
+  EXPECT_EQ(2u, ExitedEntries("exited after reset"));
+  RunThreads();
+  EXPECT_EQ(kThreadsAtOnce, ExitedEntries("exited"));
+}
@@ -139,6 +139,28 @@ struct FieldCounter {
   enum { value = sizeof(typename T::CURRENT_STORAGE_FIELD_COUNT_STRUCT) / sizeof(CountFieldsImplementationType) };
 };
 
+// Passes the state of all the fields to `f` as the events that, applied to the empty fields, would recreate it.
+namespace impl {
+template <typename FIELDS, int I>
+struct DumpFieldsAsEventsImpl {
+  template <typename F>
+  static void Run(const FIELDS& fields, F& f) {
+    DumpFieldsAsEventsImpl<FIELDS, I - 1>::Run(fields, f);
+    fields(ImmutableFieldByIndex<I - 1>(), [&f](const auto& field) { field.DumpAsEvents(f); });
+  }
+};
+template <typename FIELDS>
+struct DumpFieldsAsEventsImpl<FIELDS, 0> {
+  template <typename F>
+  static void Run(const FIELDS&, F&) {}
+};
+}  // namespace impl
+
+template <typename FIELDS, typename F>
+void DumpFieldsAsEvents(const FIELDS& fields, F&& f) {
+  impl::DumpFieldsAsEventsImpl<FIELDS, FieldCounter<FIELDS>::value>::Run(fields, f);
+}
+
 // Helper class to get the corresponding persisted types for each of the storage fields.
 #ifdef CURRENT_STORAGE_PATCH_SUPPORT
 template <typename UPDATE_EVENT, typename DELETE_EVENT, typename PATCH_EVENT_OR_VOID>
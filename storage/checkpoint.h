@@ -0,0 +1,306 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Storage checkpoints: the state of all the storage fields, written into a file, as of some entry of its stream.
+// Restarting from a checkpoint only requires replaying the stream entries that follow it.
+//
+// A checkpoint file contains:
+// * The JSON-serialized `idxts_t` of the last stream entry reflected in the checkpoint, on the first line,
+// * One JSON-serialized mutation per line, which, applied to the empty fields, recreate their state, and
+// * The "#<number of mutations>" line, the last one, which tells the checkpoint was written in full.
+// The checkpoints are named "checkpoint.<zero-padded index>", and are written under a temporary name first.
+
+#ifndef CURRENT_STORAGE_CHECKPOINT_H
+#define CURRENT_STORAGE_CHECKPOINT_H
+
+#include "../port.h"
+
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifndef CURRENT_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif  // CURRENT_WINDOWS
+
+#include "base.h"
+#include "exceptions.h"
+
+#include "../blocks/ss/idx_ts.h"
+#include "../bricks/file/file.h"
+#include "../bricks/strings/printf.h"
+#include "../typesystem/optional.h"
+#include "../typesystem/serialization/json.h"
+
+namespace current {
+namespace storage {
+
+CURRENT_STRUCT(StorageCheckpointInfo) {
+  CURRENT_FIELD(file_name, std::string);
+  CURRENT_FIELD(index, uint64_t);  // The index of the last stream entry reflected in the checkpoint.
+  CURRENT_FIELD(us, std::chrono::microseconds);
+  CURRENT_FIELD(mutations, uint64_t);
+};
+
+CURRENT_STRUCT(StorageCheckpointsList) {
+  CURRENT_FIELD(checkpoints, std::vector<std::string>);  // The full file names, the most recent one first.
+};
+
+template <typename FIELDS, typename FIELDS_VARIANT>
+class StorageCheckpoints final {
+ public:
+  constexpr static const char* kFileNamePrefix = "checkpoint.";
+  constexpr static const char* kTmpFileNameSuffix = ".tmp";
+  constexpr static char kFooterMarker = '#';
+  constexpr static size_t kCheckpointsToKeep = 3u;
+
+  explicit StorageCheckpoints(std::string dir) : dir_(std::move(dir)) {}
+
+  const std::string& Dir() const { return dir_; }
+
+  // The checkpoint serialized in memory, to write it without holding the lock that guards the fields.
+  struct SerializedCheckpoint final {
+    idxts_t last_applied;
+    std::string mutations;  // One JSON-serialized mutation per line.
+    uint64_t count = 0u;
+  };
+
+  static SerializedCheckpoint Serialize(const FIELDS& fields, idxts_t last_applied) {
+    SerializedCheckpoint result;
+    result.last_applied = last_applied;
+    DumpFieldsAsEvents(fields, [&result](const auto& event) {
+      result.mutations += JSON(FIELDS_VARIANT(event));
+      result.mutations += '\n';
+      ++result.count;
+    });
+    return result;
+  }
+
+  // Whether the checkpoint as of the stream entry with this index has been written already.
+  bool Has(uint64_t index) const { return std::ifstream(FileName(index)).good(); }
+
+  // Writes the checkpoint of `fields`, which reflect the stream up to and including `last_applied`,
+  // unless there is one as of this stream entry already.
+  // Removes the oldest checkpoints, keeping the `kCheckpointsToKeep` most recent ones.
+  Optional<StorageCheckpointInfo> Save(const FIELDS& fields, idxts_t last_applied) const {
+    return Write(last_applied, [&fields](std::ofstream& fo) {
+      uint64_t mutations = 0u;
+      DumpFieldsAsEvents(fields, [&fo, &mutations](const auto& event) {
+        fo << JSON(FIELDS_VARIANT(event)) << '\n';
+        ++mutations;
+      });
+      return mutations;
+    });
+  }
+
+  // Same as above, for the checkpoint serialized beforehand.
+  Optional<StorageCheckpointInfo> Save(const SerializedCheckpoint& checkpoint) const {
+    return Write(checkpoint.last_applied, [&checkpoint](std::ofstream& fo) {
+      fo << checkpoint.mutations;
+      return checkpoint.count;
+    });
+  }
+
+  // Applies the most recent checkpoint written in full, and accepted by `accept(idxts)`, to `fields`,
+  // which must be empty. Returns the `idxts_t` of the last stream entry it reflects, or nothing if there is none.
+  template <typename F>
+  Optional<idxts_t> LoadNewest(FIELDS& fields, F&& accept) const {
+    for (const std::string& file_name : ListNewestFirst()) {
+      const Optional<idxts_t> idxts = IsWrittenInFull(file_name);
+      if (Exists(idxts) && accept(Value(idxts))) {
+        std::ifstream fi(file_name);
+        std::string line;
+        std::getline(fi, line);
+        while (std::getline(fi, line) && (line.empty() || line[0] != kFooterMarker)) {
+          try {
+            ParseJSON<FIELDS_VARIANT>(line).Call(fields);
+          } catch (const serialization::json::TypeSystemParseJSONException&) {
+            // The footer matches, so the file has been tampered with. The fields are partially loaded by now.
+            CURRENT_THROW(StorageCheckpointCorruptedException(file_name));
+          }
+        }
+        return idxts;
+      }
+    }
+    return nullptr;
+  }
+
+  // The full names of the checkpoint files, the most recent one first.
+  std::vector<std::string> ListNewestFirst() const {
+    std::vector<std::string> result;
+    if (FileSystem::IsDir(dir_)) {
+      const std::string prefix = kFileNamePrefix;
+      const std::string suffix = kTmpFileNameSuffix;
+      FileSystem::ScanDir(dir_, [&](const FileSystem::ScanDirItemInfo& item) {
+        if (item.basename.compare(0, prefix.length(), prefix) == 0 &&
+            !(item.basename.length() >= suffix.length() &&
+              item.basename.compare(item.basename.length() - suffix.length(), suffix.length(), suffix) == 0)) {
+          result.push_back(item.pathname);
+        }
+      });
+    }
+    std::sort(result.rbegin(), result.rend());
+    return result;
+  }
+
+ private:
+  std::string FileName(uint64_t index) const {
+    return FileSystem::JoinPath(dir_,
+                                kFileNamePrefix + strings::Printf("%020llu", static_cast<unsigned long long>(index)));
+  }
+
+  // Writes the header, the mutations via `write_mutations(fo)`, which returns their number, and the footer
+  // into a temporary file, and renames it into place once it is on disk.
+  template <typename F>
+  Optional<StorageCheckpointInfo> Write(idxts_t last_applied, F&& write_mutations) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    StorageCheckpointInfo info;
+    info.file_name = FileName(last_applied.index);
+    if (std::ifstream(info.file_name).good()) {
+      return nullptr;
+    }
+    info.index = last_applied.index;
+    info.us = last_applied.us;
+    const std::string tmp_file_name = info.file_name + kTmpFileNameSuffix;
+    {
+      std::ofstream fo(tmp_file_name);
+      if (!fo) {
+        CURRENT_THROW(StorageCheckpointException("Cannot write the checkpoint: `" + tmp_file_name + "`."));
+      }
+      fo << JSON(last_applied) << '\n';
+      info.mutations = write_mutations(fo);
+      fo << kFooterMarker << info.mutations << '\n';
+      if (!fo.flush()) {
+        CURRENT_THROW(StorageCheckpointException("Cannot write the checkpoint: `" + tmp_file_name + "`."));
+      }
+    }
+    // The checkpoint must be on disk before it replaces anything, and the rename must be on disk before
+    // the older checkpoints are removed.
+    if (!SyncToDisk(tmp_file_name)) {
+      CURRENT_THROW(StorageCheckpointException("Cannot sync the checkpoint: `" + tmp_file_name + "`."));
+    }
+    FileSystem::RenameFile(tmp_file_name, info.file_name);
+    if (!SyncToDisk(dir_)) {
+      CURRENT_THROW(StorageCheckpointException("Cannot sync the checkpoints directory: `" + dir_ + "`."));
+    }
+    const std::vector<std::string> checkpoints = ListNewestFirst();
+    for (size_t i = kCheckpointsToKeep; i < checkpoints.size(); ++i) {
+      FileSystem::RmFile(checkpoints[i], FileSystem::RmFileParameters::Silent);
+    }
+    return info;
+  }
+
+  // `fsync()`-s the file or the directory. A no-op on Windows.
+  static bool SyncToDisk(const std::string& path) {
+#ifndef CURRENT_WINDOWS
+    const int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+      return false;
+    }
+    const bool ok = !::fsync(fd);
+    ::close(fd);
+    return ok;
+#else
+    static_cast<void>(path);
+    return true;
+#endif  // CURRENT_WINDOWS
+  }
+
+  // Returns the `idxts_t` from the header of the checkpoint if it has the expected number of mutations.
+  static Optional<idxts_t> IsWrittenInFull(const std::string& file_name) {
+    std::ifstream fi(file_name);
+    std::string line;
+    if (!std::getline(fi, line)) {
+      return nullptr;
+    }
+    const Optional<idxts_t> idxts = TryParseJSON<idxts_t>(line);
+    if (!Exists(idxts)) {
+      return nullptr;
+    }
+    uint64_t mutations = 0u;
+    while (std::getline(fi, line)) {
+      if (!line.empty() && line[0] == kFooterMarker) {
+        if (line.substr(1) == current::ToString(mutations) && !std::getline(fi, line)) {
+          return idxts;
+        }
+        return nullptr;
+      }
+      ++mutations;
+    }
+    return nullptr;
+  }
+
+  const std::string dir_;
+  mutable std::mutex mutex_;
+};
+
+// Calls `f` every `period` from a dedicated thread, until destructed.
+class PeriodicCheckpoints final {
+ public:
+  PeriodicCheckpoints(std::chrono::milliseconds period, std::function<void()> f)
+      : period_(period), f_(std::move(f)), thread_([this]() { Thread(); }) {}
+
+  ~PeriodicCheckpoints() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      destructing_ = true;
+      condition_variable_.notify_all();
+    }
+    thread_.join();
+  }
+
+ private:
+  void Thread() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (!condition_variable_.wait_for(lock, period_, [this]() { return destructing_; })) {
+      lock.unlock();
+      try {
+        f_();
+      } catch (const std::exception& e) {
+        std::cerr << "Storage checkpoint failed: " << e.what() << std::endl;
+      }
+      lock.lock();
+    }
+  }
+
+  const std::chrono::milliseconds period_;
+  const std::function<void()> f_;
+  std::mutex mutex_;
+  std::condition_variable condition_variable_;
+  bool destructing_ = false;
+  std::thread thread_;
+};
+
+}  // namespace storage
+}  // namespace current
+
+#endif  // CURRENT_STORAGE_CHECKPOINT_H
@@ -151,6 +151,27 @@ class GenericManyToMany {
   }
   void operator()(const DELETE_EVENT& e) { DoEraseWithLastModified(e.us, std::make_pair(e.key.first, e.key.second)); }
 
+  // Passes the state of the container to `f` as the events that would recreate it, the last modification
+  // timestamps of the deleted entries included. For the storage checkpoints.
+  // The deletions go first, so that they are no-ops when the events are applied to an empty container.
+  template <typename F>
+  void DumpAsEvents(F&& f) const {
+    for (const auto& lm : last_modified_) {
+      if (map_.find(lm.first) == map_.end()) {
+        DELETE_EVENT e;
+        e.us = lm.second;
+        e.key = lm.first;
+        f(e);
+      }
+    }
+    for (const auto& lm : last_modified_) {
+      const auto iterator = map_.find(lm.first);
+      if (iterator != map_.end()) {
+        f(UPDATE_EVENT(lm.second, *iterator->second));
+      }
+    }
+  }
+
   template <typename OUTER_MAP>
   struct OuterAccessor final {
     using OUTER_KEY = typename OUTER_MAP::key_type;
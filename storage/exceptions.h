@@ -72,6 +72,15 @@ struct ReadWriteTransactionInFollowerStorageException : StorageException {
   using StorageException::StorageException;
 };
 
+struct StorageCheckpointException : StorageException {
+  using StorageException::StorageException;
+};
+
+struct StorageCheckpointCorruptedException : StorageCheckpointException {
+  explicit StorageCheckpointCorruptedException(const std::string& filename)
+      : StorageCheckpointException("Corrupted storage checkpoint: `" + filename + "`.") {}
+};
+
 struct StorageInGracefulShutdownException : InGracefulShutdownException {
   using InGracefulShutdownException::InGracefulShutdownException;
 };
@@ -0,0 +1,200 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_STORAGE_PERSISTER_PARALLEL_REPLAY_H
+#define CURRENT_STORAGE_PERSISTER_PARALLEL_REPLAY_H
+
+#include "../../port.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "../../blocks/persistence/exceptions.h"
+#include "../../blocks/ss/exceptions.h"
+#include "../../blocks/ss/idx_ts.h"
+#include "../../typesystem/serialization/json.h"
+
+namespace current {
+namespace storage {
+namespace persister {
+
+// Replays the raw log lines of a stream, "<idxts_t JSON>\t<entry JSON>", parsing them on several threads.
+// The parsed entries are passed to `f(const ENTRY&, idxts_t)` strictly in order, on the calling thread.
+//
+// The lines are read and the entries are applied on the calling thread, while the worker threads parse
+// the chunks of lines in between. At most `kMaxChunksInFlightPerThread` chunks per thread are read ahead.
+template <typename ENTRY>
+class ParallelReplay final {
+ public:
+  constexpr static size_t kLinesPerChunk = 256u;
+  constexpr static size_t kMaxChunksInFlightPerThread = 4u;
+
+  explicit ParallelReplay(size_t threads)
+      : max_chunks_in_flight_(std::max(threads, size_t(1)) * kMaxChunksInFlightPerThread) {
+    for (size_t i = 0u; i < std::max(threads, size_t(1)); ++i) {
+      threads_.emplace_back([this]() { WorkerThread(); });
+    }
+  }
+
+  ~ParallelReplay() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      destructing_ = true;
+      condition_variable_.notify_all();
+    }
+    for (auto& thread : threads_) {
+      thread.join();
+    }
+  }
+
+  // Returns the index of the entry following the last one replayed.
+  template <typename RAW_LINES, typename F>
+  uint64_t Run(RAW_LINES&& raw_lines, uint64_t begin_index, F&& f) {
+    next_index_ = begin_index;
+    std::vector<std::string> lines;
+    lines.reserve(kLinesPerChunk);
+    for (auto&& line : raw_lines) {
+      lines.push_back(std::forward<decltype(line)>(line));
+      if (lines.size() == kLinesPerChunk) {
+        Submit(std::move(lines), f);
+        lines.clear();
+        lines.reserve(kLinesPerChunk);
+      }
+    }
+    if (!lines.empty()) {
+      Submit(std::move(lines), f);
+    }
+    while (ApplyFrontChunk(f)) {
+    }
+    return next_index_;
+  }
+
+ private:
+  struct Chunk final {
+    std::vector<std::string> lines;
+    std::vector<std::pair<idxts_t, ENTRY>> entries;
+    std::exception_ptr error;
+    bool parsed = false;
+  };
+
+  static void ParseChunk(Chunk& chunk) {
+    try {
+      chunk.entries.reserve(chunk.lines.size());
+      for (const std::string& line : chunk.lines) {
+        const size_t tab_pos = line.find('\t');
+        if (tab_pos == std::string::npos) {
+          CURRENT_THROW(persistence::MalformedEntryException(line));
+        }
+        chunk.entries.emplace_back(ParseJSON<idxts_t>(line.c_str(), tab_pos),
+                                   ParseJSON<ENTRY>(line.c_str() + tab_pos + 1));
+      }
+    } catch (...) {
+      chunk.error = std::current_exception();
+    }
+    chunk.lines.clear();
+  }
+
+  void WorkerThread() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      condition_variable_.wait(lock, [this]() { return destructing_ || chunks_parse_begin_ < chunks_.size(); });
+      if (destructing_) {
+        return;
+      }
+      Chunk& chunk = chunks_[chunks_parse_begin_++];
+      lock.unlock();
+      ParseChunk(chunk);
+      lock.lock();
+      chunk.parsed = true;
+      condition_variable_.notify_all();
+    }
+  }
+
+  template <typename F>
+  void Submit(std::vector<std::string>&& lines, F& f) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (chunks_.size() < max_chunks_in_flight_) {
+        chunks_.emplace_back();
+        chunks_.back().lines = std::move(lines);
+        condition_variable_.notify_all();
+        return;
+      }
+    }
+    ApplyFrontChunk(f);
+    Submit(std::move(lines), f);
+  }
+
+  // Waits until the oldest chunk is parsed, and applies it. Returns false if there are no chunks in flight.
+  template <typename F>
+  bool ApplyFrontChunk(F& f) {
+    Chunk chunk;
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      if (chunks_.empty()) {
+        return false;
+      }
+      condition_variable_.wait(lock, [this]() { return chunks_.front().parsed; });
+      chunk = std::move(chunks_.front());
+      chunks_.pop_front();
+      --chunks_parse_begin_;
+    }
+    // The entries parsed before the one that failed to parse, if any, are applied, as the sequential replay would.
+    for (const auto& e : chunk.entries) {
+      if (e.first.index != next_index_) {
+        CURRENT_THROW(ss::InconsistentIndexException(next_index_, e.first.index));
+      }
+      f(e.second, e.first);
+      ++next_index_;
+    }
+    if (chunk.error) {
+      std::rethrow_exception(chunk.error);
+    }
+    return true;
+  }
+
+  const size_t max_chunks_in_flight_;
+  std::vector<std::thread> threads_;
+
+  std::mutex mutex_;
+  std::condition_variable condition_variable_;
+  std::deque<Chunk> chunks_;       // Guarded by `mutex_`. Only the front one is ever removed, once parsed.
+  size_t chunks_parse_begin_ = 0u;  // Guarded by `mutex_`. The index in `chunks_` of the next chunk to parse.
+  bool destructing_ = false;        // Guarded by `mutex_`.
+
+  uint64_t next_index_ = 0u;  // Only accessed from the calling thread.
+};
+
+}  // namespace persister
+}  // namespace storage
+}  // namespace current
+
+#endif  // CURRENT_STORAGE_PERSISTER_PARALLEL_REPLAY_H
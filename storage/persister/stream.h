@@ -27,6 +27,7 @@ SOFTWARE.
 #define CURRENT_STORAGE_PERSISTER_STREAM_H
 
 #include "common.h"
+#include "parallel_replay.h"
 #include "../base.h"
 #include "../exceptions.h"
 #include "../transaction.h"
@@ -47,19 +48,25 @@ class StreamStreamPersisterImpl final {
       std::conditional_t<std::is_same_v<STREAM_RECORD_TYPE, NoCustomPersisterParam>, transaction_t, STREAM_RECORD_TYPE>;
   using stream_t = stream::Stream<stream_entry_t, UNDERLYING_PERSISTER>;
   using fields_update_function_t = std::function<void(const variant_t&)>;
+  using transaction_applied_function_t = std::function<void(const transaction_t&, idxts_t)>;
+  // Restores the fields from the most recent checkpoint the stream has the last entry of, as told by the argument.
+  // Returns the `idxts_t` of that entry, or nothing if the stream is to be replayed from the very beginning.
+  using checkpoint_loader_function_t = std::function<Optional<idxts_t>(std::function<bool(idxts_t)>)>;
 
   struct StreamSubscriberImpl {
     using EntryResponse = current::ss::EntryResponse;
     using TerminationResponse = current::ss::TerminationResponse;
-    using replay_function_t = std::function<void(const transaction_t&, std::chrono::microseconds)>;
+    using batch_t = current::ss::EntriesBatch<transaction_t>;
+    using replay_function_t = std::function<void(const batch_t&)>;
     replay_function_t replay_f_;
     uint64_t next_replay_index_ = 0u;
 
     StreamSubscriberImpl(replay_function_t f) : replay_f_(f) {}
 
-    EntryResponse operator()(const transaction_t& transaction, idxts_t current, idxts_t) {
-      replay_f_(transaction, current.us);
-      next_replay_index_ = current.index + 1u;
+    // The transactions are replayed in batches, to lock the publishing mutex once per batch.
+    EntryResponse operator()(const batch_t& batch, idxts_t) {
+      replay_f_(batch);
+      next_replay_index_ = batch.back().idx_ts.index + 1u;
       return EntryResponse::More;
     }
 
@@ -73,30 +80,41 @@ class StreamStreamPersisterImpl final {
   struct Master {};
   struct Following {};
 
-  StreamStreamPersisterImpl(Master, fields_update_function_t f, Borrowed<stream_t> stream)
+  StreamStreamPersisterImpl(Master,
+                            fields_update_function_t f,
+                            Borrowed<stream_t> stream,
+                            checkpoint_loader_function_t load_checkpoint = nullptr)
       : fields_update_f_(f),
         stream_publishing_mutex_ref_(stream->Impl()->publishing_mutex),
         stream_(std::move(stream)),
         publisher_used_(stream_->BecomeFollowingStream()) {
-    subscriber_instance_ = std::make_unique<StreamSubscriber>(
-        [this](const transaction_t& transaction, std::chrono::microseconds timestamp) {
-          std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
-          ApplyMutationsFromLockedSectionOrConstructor(transaction, timestamp);
-        });
+    subscriber_instance_ = std::make_unique<StreamSubscriber>([this](const typename StreamSubscriber::batch_t& batch) {
+      std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
+      for (const auto& e : batch) {
+        ApplyMutationsFromLockedSectionOrConstructor(e.entry, e.idx_ts);
+      }
+    });
     std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
-    SyncReplayStreamFromLockedSectionOrConstructor(0u);
+    SyncReplayStreamFromLockedSectionOrConstructor(LoadCheckpointFromLockedSectionOrConstructor(load_checkpoint));
   }
 
-  StreamStreamPersisterImpl(Following, fields_update_function_t f, Borrowed<stream_t> stream)
+  StreamStreamPersisterImpl(Following,
+                            fields_update_function_t f,
+                            Borrowed<stream_t> stream,
+                            checkpoint_loader_function_t load_checkpoint = nullptr)
       : fields_update_f_(f),
         stream_publishing_mutex_ref_(stream->Impl()->publishing_mutex),
         stream_(std::move(stream)) {
-    subscriber_instance_ = std::make_unique<StreamSubscriber>(
-        [this](const transaction_t& transaction, std::chrono::microseconds timestamp) {
-          std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
-          ApplyMutationsFromLockedSectionOrConstructor(transaction, timestamp);
-        });
+    subscriber_instance_ = std::make_unique<StreamSubscriber>([this](const typename StreamSubscriber::batch_t& batch) {
+      std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
+      for (const auto& e : batch) {
+        ApplyMutationsFromLockedSectionOrConstructor(e.entry, e.idx_ts);
+      }
+    });
     std::lock_guard<std::mutex> lock(stream_publishing_mutex_ref_);
+    // Replay what is already in the stream right away, as the master does, to make use of the parallel replay.
+    subscriber_instance_->next_replay_index_ =
+        SyncReplayStreamFromLockedSectionOrConstructor(LoadCheckpointFromLockedSectionOrConstructor(load_checkpoint));
     SubscribeToStreamFromLockedSection();
   }
 
@@ -114,9 +132,12 @@ class StreamStreamPersisterImpl final {
   template <current::locks::MutexLockStatus MLS>
   std::chrono::microseconds LastAppliedTimestampPersister() const {
     locks::SmartMutexLockGuard<MLS> master_follower_change_lock(master_follower_change_mutex_);
-    return last_applied_timestamp_;
+    return Exists(last_applied_) ? Value(last_applied_).us : std::chrono::microseconds(-1);
   }
 
+  // The stream entry the fields reflect the state as of, unless nothing has been applied to them yet.
+  Optional<idxts_t> LastAppliedIndexAndTimestampFromLockedSection() const { return last_applied_; }
+
   void PersistJournalFromLockedSection(MutationJournal& journal) {
     const std::chrono::microseconds timestamp = current::time::Now();
     CURRENT_ASSERT(Exists(publisher_used_));
@@ -131,9 +152,18 @@ class StreamStreamPersisterImpl final {
         transaction.mutations.emplace_back(BypassVariantTypeCheck(), std::move(entry));
       }
       std::swap(transaction.meta, journal.transaction_meta);
-      Value(publisher_used_)
-          ->template Publish<current::locks::MutexLockStatus::AlreadyLocked>(std::move(transaction), timestamp);
-      SetLastAppliedTimestampFromLockedSection(timestamp);
+      if (!on_transaction_applied_f_) {
+        SetLastAppliedFromLockedSection(
+            Value(publisher_used_)
+                ->template Publish<current::locks::MutexLockStatus::AlreadyLocked>(std::move(transaction), timestamp));
+      } else {
+        const idxts_t idxts =
+            Value(publisher_used_)
+                ->template Publish<current::locks::MutexLockStatus::AlreadyLocked>(
+                    static_cast<const transaction_t&>(transaction), timestamp);
+        SetLastAppliedFromLockedSection(idxts);
+        on_transaction_applied_f_(transaction, idxts);
+      }
     }
     journal.Clear();
   }
@@ -145,6 +175,10 @@ class StreamStreamPersisterImpl final {
                                      [this](Request r) { (*Borrowed<stream_t>(stream_))(std::move(r)); });
   }
 
+  // The function to call on each transaction applied to the fields, be it committed, replayed, or followed.
+  // Must be set with the publishing mutex of the stream locked; is called with it locked too.
+  void SetOnTransactionAppliedFromLockedSection(transaction_applied_function_t f) { on_transaction_applied_f_ = f; }
+
   Borrowed<stream_t> BorrowStream() const { return stream_; }
   const WeakBorrowed<stream_t>& Stream() const { return stream_; }
   WeakBorrowed<stream_t>& Stream() { return stream_; }
@@ -176,24 +210,70 @@ class StreamStreamPersisterImpl final {
   // TODO(dkorolev): `BecomeFollowingStorage` maybe?
 
  private:
+  // Invariant: `stream_publishing_mutex_ref_` is locked, or the call is taking place from the constructor.
+  // Returns the index of the stream entry to replay from.
+  uint64_t LoadCheckpointFromLockedSectionOrConstructor(const checkpoint_loader_function_t& load_checkpoint) {
+    if (!load_checkpoint) {
+      return 0u;
+    }
+    const auto& data = *stream_->Data();
+    const Optional<idxts_t> checkpoint = load_checkpoint([&data](idxts_t idxts) {
+      // The checkpoint must have been made from this very stream, or from its prefix.
+      if (idxts.index >= data.template Size<current::locks::MutexLockStatus::AlreadyLocked>()) {
+        return false;
+      }
+      for (const auto& e : data.template Iterate<current::locks::MutexLockStatus::AlreadyLocked>(idxts.index,
+                                                                                                 idxts.index + 1u)) {
+        return e.idx_ts.us == idxts.us;
+      }
+      return false;
+    });
+    if (!Exists(checkpoint)) {
+      return 0u;
+    }
+    SetLastAppliedFromLockedSection(Value(checkpoint));
+    return Value(checkpoint).index + 1u;
+  }
+
+  // The streams kept as JSON in a file are replayed with the parsing spread across several threads,
+  // as long as there are enough entries to replay for it to pay off.
+  constexpr static bool kStreamIsParsedOnReplay =
+      std::is_same_v<UNDERLYING_PERSISTER<stream_entry_t>, current::persistence::File<stream_entry_t>>;
+  constexpr static uint64_t kMinEntriesForParallelReplay = 10000u;
+  constexpr static size_t kMaxParallelReplayThreads = 8u;
+
   // Invariant: both `subscriber_creator_destructor_mutex_` and `stream_publishing_mutex_ref_` are locked,
   // or the call is taking place from the constructor.
-  void SyncReplayStreamFromLockedSectionOrConstructor(uint64_t from_idx) {
-    for (const auto& stream_record :
-         stream_->Data()->template Iterate<current::locks::MutexLockStatus::AlreadyLocked>(from_idx)) {
-      if (Exists<transaction_t>(stream_record.entry)) {
-        const transaction_t& transaction = Value<transaction_t>(stream_record.entry);
-        ApplyMutationsFromLockedSectionOrConstructor(transaction, stream_record.idx_ts.us);
+  // Returns the index of the stream entry following the last one replayed.
+  uint64_t SyncReplayStreamFromLockedSectionOrConstructor(uint64_t from_idx) {
+    const auto apply = [this](const stream_entry_t& entry, idxts_t idxts) {
+      if (Exists<transaction_t>(entry)) {
+        ApplyMutationsFromLockedSectionOrConstructor(Value<transaction_t>(entry), idxts);
+      }
+    };
+    const auto& data = *stream_->Data();
+    const uint64_t size = data.template Size<current::locks::MutexLockStatus::AlreadyLocked>();
+    const size_t threads = std::min(size_t(std::thread::hardware_concurrency()), kMaxParallelReplayThreads);
+    if (kStreamIsParsedOnReplay && threads > 1u && from_idx + kMinEntriesForParallelReplay <= size) {
+      return ParallelReplay<stream_entry_t>(threads).Run(
+          data.template IterateUnsafe<current::locks::MutexLockStatus::AlreadyLocked>(from_idx, size), from_idx, apply);
+    } else {
+      for (const auto& stream_record :
+           data.template Iterate<current::locks::MutexLockStatus::AlreadyLocked>(from_idx, size)) {
+        apply(stream_record.entry, stream_record.idx_ts);
       }
+      return size;
     }
   }
 
-  void ApplyMutationsFromLockedSectionOrConstructor(const transaction_t& transaction,
-                                                    std::chrono::microseconds timestamp) {
+  void ApplyMutationsFromLockedSectionOrConstructor(const transaction_t& transaction, idxts_t idxts) {
     for (const auto& mutation : transaction.mutations) {
       fields_update_f_(mutation);
     }
-    SetLastAppliedTimestampFromLockedSection(timestamp);
+    SetLastAppliedFromLockedSection(idxts);
+    if (on_transaction_applied_f_) {
+      on_transaction_applied_f_(transaction, idxts);
+    }
   }
 
  private:
@@ -208,13 +288,14 @@ class StreamStreamPersisterImpl final {
   // Important: The publishing mutex of the respective stream must be unlocked!
   void TerminateStreamSubscriptionFromLockedSection() { subscriber_scope_ = nullptr; }
 
-  void SetLastAppliedTimestampFromLockedSection(std::chrono::microseconds timestamp) {
-    CURRENT_ASSERT(timestamp > last_applied_timestamp_);
-    last_applied_timestamp_ = timestamp;
+  void SetLastAppliedFromLockedSection(idxts_t idxts) {
+    CURRENT_ASSERT(!Exists(last_applied_) || idxts.us > Value(last_applied_).us);
+    last_applied_ = idxts;
   }
 
  private:
   fields_update_function_t fields_update_f_;
+  transaction_applied_function_t on_transaction_applied_f_;  // Guarded by the publishing mutex of the stream.
 
   std::mutex& stream_publishing_mutex_ref_;  // == `stream_->Impl()->publishing_mutex`.
   Borrowed<stream_t> stream_;
@@ -224,7 +305,7 @@ class StreamStreamPersisterImpl final {
   std::unique_ptr<StreamSubscriber> subscriber_instance_;
   current::stream::SubscriberScope subscriber_scope_;
 
-  std::chrono::microseconds last_applied_timestamp_ = std::chrono::microseconds(-1);  // Replayed or from the master.
+  Optional<idxts_t> last_applied_;  // Replayed, restored from a checkpoint, or from the master.
 
   HTTPRoutesScope handlers_scope_;
 };
@@ -0,0 +1,239 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// `StorageSnapshots` enables read-only transactions that do not lock the publishing mutex of the storage.
+//
+// It keeps two extra copies, "replicas", of the storage fields, and applies the committed transactions to them
+// from a dedicated thread, in the "left-right" fashion. The readers use the active replica. The new transactions
+// are applied to the other one, once the readers that may have started on it before the last flip are gone,
+// after which the two are flipped. The replica that has just become inactive catches up on the next round.
+//
+// Thus, the readers never wait for the writers, and the writers never wait for the readers. The price is the
+// memory for the two replicas, and the snapshot lagging behind the storage by the transactions not yet applied.
+// The snapshot is always consistent: it reflects the storage as of some committed transaction.
+
+#ifndef CURRENT_STORAGE_SNAPSHOT_H
+#define CURRENT_STORAGE_SNAPSHOT_H
+
+#include "../port.h"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include "base.h"
+
+#include "../blocks/ss/idx_ts.h"
+
+namespace current {
+namespace storage {
+
+// The read-only copy of the storage fields, as of the transaction with the index `NextIndex() - 1` in the stream.
+template <typename FIELDS>
+struct SnapshotFields final : FIELDS {
+  // The timestamp of the last transaction reflected in this snapshot.
+  std::chrono::microseconds LastAppliedTimestamp() const { return last_applied_timestamp_; }
+  // The number of the stream entries reflected in this snapshot.
+  uint64_t NextIndex() const { return next_index_; }
+
+  std::chrono::microseconds last_applied_timestamp_ = std::chrono::microseconds(-1);
+  uint64_t next_index_ = 0u;
+};
+
+template <typename FIELDS, typename TRANSACTION>
+class StorageSnapshots final {
+ public:
+  using fields_t = SnapshotFields<FIELDS>;
+  using transaction_t = TRANSACTION;
+
+  // Keeps the replica it is reading from intact while in scope.
+  class ReadScope final {
+   public:
+    ReadScope(const StorageSnapshots& self) : self_(self) {
+      while (true) {
+        index_ = self_.active_.load();
+        ++self_.replicas_[index_].readers;
+        if (self_.active_.load() == index_) {
+          break;
+        }
+        self_.replicas_[index_].ReleaseReader();
+      }
+    }
+    ~ReadScope() { self_.replicas_[index_].ReleaseReader(); }
+
+    const fields_t& Fields() const { return self_.replicas_[index_].fields; }
+
+   private:
+    ReadScope(const ReadScope&) = delete;
+    ReadScope& operator=(const ReadScope&) = delete;
+
+    const StorageSnapshots& self_;
+    size_t index_;
+  };
+
+  StorageSnapshots() : applier_thread_(&StorageSnapshots::ApplierThread, this) {}
+
+  ~StorageSnapshots() {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      destructing_ = true;
+      condition_variable_.notify_all();
+    }
+    applier_thread_.join();
+  }
+
+  // Brings both replicas to the state of `fields`, which reflect the stream up to and including `last_applied`.
+  // Only valid before the snapshot is read from.
+  void Initialize(const FIELDS& fields, idxts_t last_applied) {
+    for (auto& replica : replicas_) {
+      DumpFieldsAsEvents(fields, [&replica](const auto& event) { static_cast<FIELDS&>(replica.fields)(event); });
+      replica.fields.last_applied_timestamp_ = last_applied.us;
+      replica.fields.next_index_ = last_applied.index + 1u;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    next_index_ = last_applied.index + 1u;
+    applied_index_ = next_index_;
+  }
+
+  // Queues the transaction that has been applied to the storage to be applied to the snapshot. THREAD-SAFE.
+  // The transactions the snapshot has already seen, by their index in the stream, are ignored.
+  void Apply(const transaction_t& transaction, idxts_t idxts) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (idxts.index >= next_index_) {
+      incoming_.push_back(Pending{idxts, transaction});
+      next_index_ = idxts.index + 1u;
+      condition_variable_.notify_all();
+    }
+  }
+
+  // Waits until the snapshot reflects all the transactions passed in so far. For the tests mostly.
+  void WaitUntilUpToDate() const {
+    std::unique_lock<std::mutex> lock(mutex_);
+    condition_variable_.wait(lock, [this]() { return applied_index_ == next_index_; });
+  }
+
+ private:
+  struct Pending final {
+    idxts_t idxts;
+    transaction_t transaction;
+  };
+
+  struct Replica final {
+    fields_t fields;
+    mutable std::atomic_size_t readers{0u};
+
+    // The applier thread sleeps until the readers of the replica are gone, which may take a while, for instance,
+    // when dumping a checkpoint. The last reader to leave wakes it up.
+    mutable std::atomic_bool applier_waiting{false};
+    mutable std::mutex readers_mutex;
+    mutable std::condition_variable readers_gone;
+
+    void ReleaseReader() const {
+      if (--readers == 0u && applier_waiting.load()) {
+        std::lock_guard<std::mutex> lock(readers_mutex);
+        readers_gone.notify_one();
+      }
+    }
+
+    void WaitUntilNoReaders() {
+      if (readers.load()) {
+        std::unique_lock<std::mutex> lock(readers_mutex);
+        applier_waiting.store(true);
+        readers_gone.wait(lock, [this]() { return !readers.load(); });
+        applier_waiting.store(false);
+      }
+    }
+  };
+
+  static void ApplyToReplica(fields_t& fields, const transaction_t& transaction, idxts_t idxts) {
+    for (const auto& mutation : transaction.mutations) {
+      mutation.Call(static_cast<FIELDS&>(fields));
+    }
+    fields.last_applied_timestamp_ = idxts.us;
+    fields.next_index_ = idxts.index + 1u;
+  }
+
+  // Applies the transactions from `log_` not yet applied to the replica. No one may be reading from it.
+  void CatchUp(fields_t& fields) {
+    for (const Pending& pending : log_) {
+      if (pending.idxts.index >= fields.next_index_) {
+        ApplyToReplica(fields, pending.transaction, pending.idxts);
+      }
+    }
+  }
+
+  void ApplierThread() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      condition_variable_.wait(lock, [this]() { return destructing_ || !incoming_.empty(); });
+      if (destructing_) {
+        return;
+      }
+      for (Pending& pending : incoming_) {
+        log_.push_back(std::move(pending));
+      }
+      incoming_.clear();
+      const uint64_t next_index = next_index_;
+      lock.unlock();
+
+      const size_t inactive = 1u - active_.load();
+      Replica& replica = replicas_[inactive];
+      // Only the readers that have started before the previous flip may still be here.
+      replica.WaitUntilNoReaders();
+      CatchUp(replica.fields);
+      active_.store(inactive);
+      // The log is only needed until both replicas have caught up.
+      const uint64_t both_next_index = replicas_[1u - inactive].fields.next_index_;
+      while (!log_.empty() && log_.front().idxts.index < both_next_index) {
+        log_.pop_front();
+      }
+
+      lock.lock();
+      applied_index_ = next_index;
+      condition_variable_.notify_all();
+    }
+  }
+
+  Replica replicas_[2];
+  std::atomic_size_t active_{0u};
+
+  mutable std::mutex mutex_;
+  mutable std::condition_variable condition_variable_;
+  std::vector<Pending> incoming_;  // Guarded by `mutex_`.
+  uint64_t next_index_ = 0u;       // Guarded by `mutex_`: the index of the transaction to queue next.
+  uint64_t applied_index_ = 0u;    // Guarded by `mutex_`: the `next_index_` the active replica is up to date with.
+  bool destructing_ = false;       // Guarded by `mutex_`.
+
+  std::deque<Pending> log_;  // Only accessed from the applier thread.
+  std::thread applier_thread_;
+};
+
+}  // namespace storage
+}  // namespace current
+
+#endif  // CURRENT_STORAGE_SNAPSHOT_H
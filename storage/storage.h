@@ -46,6 +46,8 @@ SOFTWARE.
 #include <atomic>
 
 #include "base.h"
+#include "checkpoint.h"
+#include "snapshot.h"
 #include "transaction.h"
 #include "transaction_policy.h"
 #include "transaction_result.h"
@@ -303,12 +305,21 @@ class StorageImpl {
   using fields_variant_t = Variant<fields_type_list_t>;
   using persister_t = PERSISTER<fields_variant_t, CUSTOM_PERSISTER_PARAM>;
   using stream_t = typename persister_t::stream_t;
+  using snapshots_t = StorageSnapshots<FIELDS, Transaction<fields_variant_t>>;
+  using checkpoints_t = StorageCheckpoints<FIELDS, fields_variant_t>;
 
  private:
   FIELDS fields_;
+  // Set by `EnableSnapshotReads()`. Declared before the persister to outlive it, as the persister feeds it.
+  std::unique_ptr<snapshots_t> snapshots_;
+  std::atomic<const snapshots_t*> snapshots_enabled_{nullptr};
+  std::unique_ptr<checkpoints_t> checkpoints_;  // Set iff the storage has been created with the checkpoints.
   Optional<Owned<stream_t>> owned_stream_;  // Valid iff the Storage has been constructed to keep its own stream.
   persister_t persister_;
   TRANSACTION_POLICY<persister_t> transaction_policy_;
+  // Declared last to be destructed first, as they make checkpoints of the above.
+  std::unique_ptr<PeriodicCheckpoints> periodic_checkpoints_;
+  HTTPRoutesScope checkpoints_http_scope_;
 
  public:
   using fields_by_ref_t = FIELDS&;
@@ -318,20 +329,47 @@ class StorageImpl {
 
   template <typename... ARGS>
   static Owned<StorageImpl> CreateMasterStorage(ARGS&&... args) {
-    return MakeOwned<StorageImpl>(typename persister_t::Master(), CreateStreamAsWell(), std::forward<ARGS>(args)...);
+    return MakeOwned<StorageImpl>(
+        typename persister_t::Master(), CreateStreamAsWell(), std::string(), std::forward<ARGS>(args)...);
   }
 
   template <typename... ARGS>
   static Owned<StorageImpl> CreateFollowingStorage(ARGS&&... args) {
-    return MakeOwned<StorageImpl>(typename persister_t::Following(), CreateStreamAsWell(), std::forward<ARGS>(args)...);
+    return MakeOwned<StorageImpl>(
+        typename persister_t::Following(), CreateStreamAsWell(), std::string(), std::forward<ARGS>(args)...);
   }
 
   static Owned<StorageImpl> CreateMasterStorageAtopExistingStream(Borrowed<stream_t> stream) {
-    return MakeOwned<StorageImpl>(typename persister_t::Master(), UseExistingStream(), stream);
+    return MakeOwned<StorageImpl>(typename persister_t::Master(), UseExistingStream(), std::string(), stream);
   }
 
   static Owned<StorageImpl> CreateFollowingStorageAtopExistingStream(Borrowed<stream_t> stream) {
-    return MakeOwned<StorageImpl>(typename persister_t::Following(), UseExistingStream(), stream);
+    return MakeOwned<StorageImpl>(typename persister_t::Following(), UseExistingStream(), std::string(), stream);
+  }
+
+  // The storages keeping their checkpoints in `checkpoints_dir` start from the most recent one,
+  // only replaying the stream entries following it.
+  template <typename... ARGS>
+  static Owned<StorageImpl> CreateMasterStorageWithCheckpoints(const std::string& checkpoints_dir, ARGS&&... args) {
+    return MakeOwned<StorageImpl>(
+        typename persister_t::Master(), CreateStreamAsWell(), checkpoints_dir, std::forward<ARGS>(args)...);
+  }
+
+  template <typename... ARGS>
+  static Owned<StorageImpl> CreateFollowingStorageWithCheckpoints(const std::string& checkpoints_dir,
+                                                                  ARGS&&... args) {
+    return MakeOwned<StorageImpl>(
+        typename persister_t::Following(), CreateStreamAsWell(), checkpoints_dir, std::forward<ARGS>(args)...);
+  }
+
+  static Owned<StorageImpl> CreateMasterStorageAtopExistingStreamWithCheckpoints(const std::string& checkpoints_dir,
+                                                                                 Borrowed<stream_t> stream) {
+    return MakeOwned<StorageImpl>(typename persister_t::Master(), UseExistingStream(), checkpoints_dir, stream);
+  }
+
+  static Owned<StorageImpl> CreateFollowingStorageAtopExistingStreamWithCheckpoints(
+      const std::string& checkpoints_dir, Borrowed<stream_t> stream) {
+    return MakeOwned<StorageImpl>(typename persister_t::Following(), UseExistingStream(), checkpoints_dir, stream);
   }
 
  private:
@@ -341,18 +379,33 @@ class StorageImpl {
   struct UseExistingStream {};
 
   template <typename CONSTRUCTION_TYPE>
-  StorageImpl(CONSTRUCTION_TYPE, UseExistingStream, Borrowed<stream_t> stream)
-      : persister_(
-            CONSTRUCTION_TYPE(), [this](const fields_variant_t& entry) { entry.Call(fields_); }, stream),
+  StorageImpl(CONSTRUCTION_TYPE, UseExistingStream, const std::string& checkpoints_dir, Borrowed<stream_t> stream)
+      : checkpoints_(checkpoints_dir.empty() ? nullptr : std::make_unique<checkpoints_t>(checkpoints_dir)),
+        persister_(
+            CONSTRUCTION_TYPE(),
+            [this](const fields_variant_t& entry) { entry.Call(fields_); },
+            stream,
+            CheckpointLoader()),
         transaction_policy_(persister_, fields_.current_storage_mutation_journal_) {}
 
   template <typename CONSTRUCTION_TYPE, typename... ARGS>
-  StorageImpl(CONSTRUCTION_TYPE, CreateStreamAsWell, ARGS&&... args)
-      : owned_stream_(std::move(stream_t::CreateStream(std::forward<ARGS>(args)...))),
+  StorageImpl(CONSTRUCTION_TYPE, CreateStreamAsWell, const std::string& checkpoints_dir, ARGS&&... args)
+      : checkpoints_(checkpoints_dir.empty() ? nullptr : std::make_unique<checkpoints_t>(checkpoints_dir)),
+        owned_stream_(std::move(stream_t::CreateStream(std::forward<ARGS>(args)...))),
         persister_(
-            CONSTRUCTION_TYPE(), [this](const fields_variant_t& entry) { entry.Call(fields_); }, Value(owned_stream_)),
+            CONSTRUCTION_TYPE(),
+            [this](const fields_variant_t& entry) { entry.Call(fields_); },
+            Value(owned_stream_),
+            CheckpointLoader()),
         transaction_policy_(persister_, fields_.current_storage_mutation_journal_) {}
 
+  typename persister_t::checkpoint_loader_function_t CheckpointLoader() {
+    if (!checkpoints_) {
+      return nullptr;
+    }
+    return [this](std::function<bool(idxts_t)> accept) { return checkpoints_->LoadNewest(fields_, accept); };
+  }
+
  public:
   template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock>
   bool IsMasterStorage() {
@@ -418,6 +471,127 @@ class StorageImpl {
         [&f1, this]() { return f1(static_cast<const FIELDS&>(fields_)); }, std::forward<F2>(f2));
   }
 
+  // Makes `SnapshotReadOnlyTransaction()` run against the snapshot of the storage, maintained from now on.
+  // The snapshot costs two extra copies of the fields, which are initialized from the fields as they are now.
+  void EnableSnapshotReads() {
+    std::lock_guard<std::mutex> lock(persister_.Stream()->Impl()->publishing_mutex);
+    if (!snapshots_) {
+      snapshots_ = std::make_unique<snapshots_t>();
+      const Optional<idxts_t> last_applied = persister_.LastAppliedIndexAndTimestampFromLockedSection();
+      if (Exists(last_applied)) {
+        snapshots_->Initialize(fields_, Value(last_applied));
+      }
+      persister_.SetOnTransactionAppliedFromLockedSection(
+          [this](const transaction_t& transaction, idxts_t idxts) { snapshots_->Apply(transaction, idxts); });
+      snapshots_enabled_ = snapshots_.get();
+    }
+  }
+
+  // Read-only transactions that do not lock the publishing mutex, and thus neither wait for nor delay the writers.
+  // They see the storage as of some recently committed transaction, which may not yet include the most recent ones.
+  // Without `EnableSnapshotReads()` called, these are the regular `ReadOnlyTransaction()`-s.
+  template <typename F>
+  ::current::Future<::current::storage::TransactionResult<f_result_t<F>>, ::current::StrictFuture::Strict>
+  SnapshotReadOnlyTransaction(F&& f) const {
+    const snapshots_t* snapshots = snapshots_enabled_;
+    if (!snapshots) {
+      return ReadOnlyTransaction(std::forward<F>(f));
+    }
+    const typename snapshots_t::ReadScope scope(*snapshots);
+    return transaction_policy_.TransactionFromSnapshot(
+        [&f, &scope]() { return f(static_cast<const FIELDS&>(scope.Fields())); });
+  }
+
+  template <typename F1, typename F2>
+  ::current::Future<::current::storage::TransactionResult<void>, ::current::StrictFuture::Strict>
+  SnapshotReadOnlyTransaction(F1&& f1, F2&& f2) const {
+    const snapshots_t* snapshots = snapshots_enabled_;
+    if (!snapshots) {
+      return ReadOnlyTransaction(std::forward<F1>(f1), std::forward<F2>(f2));
+    }
+    const typename snapshots_t::ReadScope scope(*snapshots);
+    return transaction_policy_.TransactionFromSnapshot(
+        [&f1, &scope]() { return f1(static_cast<const FIELDS&>(scope.Fields())); }, std::forward<F2>(f2));
+  }
+
+  // The timestamp of the last transaction the snapshot reflects, or -1 if there is no snapshot yet.
+  std::chrono::microseconds SnapshotLastAppliedTimestamp() const {
+    const snapshots_t* snapshots = snapshots_enabled_;
+    if (!snapshots) {
+      return std::chrono::microseconds(-1);
+    }
+    const typename snapshots_t::ReadScope scope(*snapshots);
+    return scope.Fields().LastAppliedTimestamp();
+  }
+
+  // Waits until the snapshot reflects all the transactions applied to the storage so far.
+  void WaitForSnapshotToCatchUp() const {
+    const snapshots_t* snapshots = snapshots_enabled_;
+    if (snapshots) {
+      snapshots->WaitUntilUpToDate();
+    }
+  }
+
+  // Writes the checkpoint of the storage, unless it has not changed since the previous one.
+  // Does not lock the publishing mutex if the snapshot reads are enabled, as the snapshot is dumped then.
+  // Otherwise, only holds it while serializing the fields into memory.
+  Optional<StorageCheckpointInfo> SaveCheckpoint() {
+    if (!checkpoints_) {
+      CURRENT_THROW(StorageCheckpointException("The storage has not been created with the checkpoints."));
+    }
+    const snapshots_t* snapshots = snapshots_enabled_;
+    if (snapshots) {
+      const typename snapshots_t::ReadScope scope(*snapshots);
+      if (!scope.Fields().NextIndex()) {
+        return nullptr;
+      }
+      return checkpoints_->Save(scope.Fields(),
+                                idxts_t(scope.Fields().NextIndex() - 1u, scope.Fields().LastAppliedTimestamp()));
+    } else {
+      // Only serialize the fields under the publishing mutex, and write them to disk once it is released.
+      typename checkpoints_t::SerializedCheckpoint checkpoint;
+      {
+        std::lock_guard<std::mutex> lock(persister_.Stream()->Impl()->publishing_mutex);
+        const Optional<idxts_t> last_applied = persister_.LastAppliedIndexAndTimestampFromLockedSection();
+        if (!Exists(last_applied) || checkpoints_->Has(Value(last_applied).index)) {
+          return nullptr;
+        }
+        checkpoint = checkpoints_t::Serialize(fields_, Value(last_applied));
+      }
+      return checkpoints_->Save(checkpoint);
+    }
+  }
+
+  void EnablePeriodicCheckpoints(std::chrono::milliseconds period) {
+    periodic_checkpoints_ = nullptr;
+    periodic_checkpoints_ = std::make_unique<PeriodicCheckpoints>(period, [this]() { SaveCheckpoint(); });
+  }
+
+  // POST-ing to the `route` makes a checkpoint, GET-ting it lists the checkpoints.
+  void ExposeCheckpointsViaHTTP(uint16_t port, const std::string& route) {
+    checkpoints_http_scope_ += HTTP(current::net::BarePort(port)).Register(route, [this](Request r) {
+      if (r.method == "POST") {
+        const Optional<StorageCheckpointInfo> info = SaveCheckpoint();
+        if (Exists(info)) {
+          r(Value(info));
+        } else {
+          r("Nothing to checkpoint.\n");
+        }
+      } else if (r.method == "GET") {
+        StorageCheckpointsList list;
+        if (checkpoints_) {
+          list.checkpoints = checkpoints_->ListNewestFirst();
+        }
+        r(list);
+      } else {
+        r(current::net::DefaultMethodNotAllowedMessage(),
+          HTTPResponseCode.MethodNotAllowed,
+          net::http::Headers(),
+          net::constants::kDefaultHTMLContentType);
+      }
+    });
+  }
+
   void ExposeRawLogViaHTTP(int port, const std::string& route) { persister_.ExposeRawLogViaHTTP(port, route); }
 
   Borrowed<stream_t> BorrowUnderlyingStream() const { return persister_.BorrowStream(); }
@@ -487,6 +661,7 @@ class NullStoragePersisterImpl {
   void PersistJournal(MutationJournal& journal) { journal.Clear(); }
 
   // No-ops to make everything compile.
+  using checkpoint_loader_function_t = std::function<Optional<idxts_t>(std::function<bool(idxts_t)>)>;
   struct stream_t {
     struct impl_t {};
     struct entry_t {};
@@ -1718,6 +1718,337 @@ TEST(TransactionalStorage, WorkWithUnderlyingStream) {
       collected);
 }
 
+TEST(TransactionalStorage, ParallelReplay) {
+  using namespace transactional_storage_test;
+  using current::storage::persister::ParallelReplay;
+
+  std::vector<std::string> lines;
+  for (int32_t i = 0; i < 10000; ++i) {
+    lines.push_back(JSON(idxts_t(i, std::chrono::microseconds(i + 1))) + '\t' + JSON(Record(current::ToString(i), i)));
+  }
+
+  {
+    int64_t sum = 0;
+    uint64_t expected_index = 0u;
+    EXPECT_EQ(10000u, ParallelReplay<Record>(4u).Run(lines, 0u, [&](const Record& record, idxts_t idxts) {
+      EXPECT_EQ(expected_index, idxts.index);
+      EXPECT_EQ(current::ToString(expected_index), record.lhs);
+      ++expected_index;
+      sum += record.rhs;
+    }));
+    EXPECT_EQ(49995000, sum);
+  }
+
+  {
+    // The entries are passed on in order up until the one that could not be parsed.
+    lines[5000] = "malformed";
+    uint64_t next_index = 0u;
+    ASSERT_THROW(ParallelReplay<Record>(4u).Run(lines, 0u, [&](const Record&, idxts_t) { ++next_index; }),
+                 current::persistence::MalformedEntryException);
+    EXPECT_EQ(5000u, next_index);
+  }
+
+  {
+    // The indexes must be continuous.
+    lines.resize(5000u);
+    ASSERT_THROW(ParallelReplay<Record>(4u).Run(lines, 1u, [](const Record&, idxts_t) {}),
+                 current::ss::InconsistentIndexException);
+  }
+}
+
+TEST(TransactionalStorage, ReplayLargeLog) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using storage_t = TestStorage<StreamStreamPersister>;
+  using stream_t = typename storage_t::stream_t;
+
+  const std::string storage_file_name =
+      current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "storage_large_log");
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(storage_file_name);
+
+  // Enough transactions for the parallel replay to kick in on a multicore machine.
+  const int32_t kTransactions = 12345;
+  {
+    current::Owned<storage_t> storage = storage_t::CreateMasterStorage(storage_file_name);
+    for (int32_t i = 0; i < kTransactions; ++i) {
+      current::time::SetNow(std::chrono::microseconds(i + 1));
+      storage
+          ->ReadWriteTransaction([i](MutableFields<storage_t> fields) {
+            fields.d.Add(Record{current::ToString(i % 1000), i});
+            if (i % 10 == 9) {
+              fields.d.Erase(current::ToString(i % 1000 - 1));
+            }
+          })
+          .Go();
+    }
+  }
+
+  const auto verify = [kTransactions](ImmutableFields<storage_t> fields) {
+    EXPECT_EQ(900u, fields.d.Size());
+    for (int32_t i = kTransactions - 1000; i < kTransactions; ++i) {
+      if (i % 10 != 8) {
+        EXPECT_EQ(i, Value(fields.d[current::ToString(i % 1000)]).rhs);
+      } else {
+        EXPECT_FALSE(Exists(fields.d[current::ToString(i % 1000)]));
+      }
+    }
+  };
+
+  {
+    current::Owned<storage_t> storage = storage_t::CreateMasterStorage(storage_file_name);
+    EXPECT_EQ(kTransactions, storage->LastAppliedTimestamp().count());
+    storage->ReadOnlyTransaction(verify).Go();
+  }
+
+  {
+    auto stream = stream_t::CreateStream(storage_file_name);
+    const auto publisher = stream->BecomeFollowingStream();
+    current::Owned<storage_t> storage = storage_t::CreateFollowingStorageAtopExistingStream(stream);
+    EXPECT_EQ(kTransactions, storage->LastAppliedTimestamp().count());
+    storage->ReadOnlyTransaction(verify).Go();
+  }
+}
+
+TEST(TransactionalStorage, Checkpoints) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using storage_t = TestStorage<StreamStreamPersister>;
+  using stream_t = typename storage_t::stream_t;
+
+  const std::string storage_file_name =
+      current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "storage_with_checkpoints");
+  const auto storage_file_remover = current::FileSystem::ScopedRmFile(storage_file_name);
+  const std::string checkpoints_dir =
+      current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "checkpoints");
+  current::FileSystem::RmDir(
+      checkpoints_dir, current::FileSystem::RmDirParameters::Silent, current::FileSystem::RmDirRecursive::Yes);
+  current::FileSystem::MkDir(checkpoints_dir);
+
+  std::string checkpoint_file_name;
+  {
+    auto storage = storage_t::CreateMasterStorageWithCheckpoints(checkpoints_dir, storage_file_name);
+    EXPECT_FALSE(Exists(storage->SaveCheckpoint()));  // Nothing to checkpoint yet.
+
+    current::time::SetNow(std::chrono::microseconds(100));
+    storage->ReadWriteTransaction([](MutableFields<storage_t> fields) {
+      fields.d.Add(Record{"a", 1});
+      fields.d.Add(Record{"b", 2});
+      fields.d.Add(Record{"c", 3});
+      fields.umany_to_umany.Add(Cell{1, "one", 1});
+    }).Go();
+    current::time::SetNow(std::chrono::microseconds(200));
+    storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Erase("b"); }).Go();
+
+    const auto info = storage->SaveCheckpoint();
+    ASSERT_TRUE(Exists(info));
+    EXPECT_EQ(1u, Value(info).index);
+    EXPECT_EQ(200, Value(info).us.count());
+    EXPECT_EQ(4u, Value(info).mutations);  // Two records, one cell, and the deleted record.
+    checkpoint_file_name = Value(info).file_name;
+    EXPECT_FALSE(Exists(storage->SaveCheckpoint()));  // Nothing new to checkpoint.
+
+    current::time::SetNow(std::chrono::microseconds(300));
+    storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Add(Record{"d", 4}); }).Go();
+  }
+
+  // Tamper with the checkpoint to tell it is used instead of the stream entries it reflects.
+  {
+    std::string contents = current::FileSystem::ReadFileAsString(checkpoint_file_name);
+    const size_t pos = contents.find("\"lhs\":\"a\"");
+    ASSERT_NE(std::string::npos, pos);
+    contents[pos + 7] = 'x';
+    current::FileSystem::WriteStringToFile(contents, checkpoint_file_name.c_str());
+  }
+
+  const auto verify = [](ImmutableFields<storage_t> fields) {
+    EXPECT_FALSE(Exists(fields.d["a"]));
+    EXPECT_EQ(1, Value(fields.d["x"]).rhs);
+    EXPECT_FALSE(Exists(fields.d["b"]));
+    EXPECT_EQ(200, Value(fields.d.LastModified("b")).count());
+    EXPECT_EQ(3, Value(fields.d["c"]).rhs);
+    EXPECT_EQ(4, Value(fields.d["d"]).rhs);
+    EXPECT_EQ(300, Value(fields.d.LastModified("d")).count());
+    EXPECT_EQ(1u, fields.umany_to_umany.Size());
+  };
+
+  {
+    auto storage = storage_t::CreateMasterStorageWithCheckpoints(checkpoints_dir, storage_file_name);
+    EXPECT_EQ(300, storage->LastAppliedTimestamp().count());
+    storage->ReadOnlyTransaction(verify).Go();
+
+    // The snapshot of the storage, if enabled, is what is checkpointed.
+    storage->EnableSnapshotReads();
+    storage->SnapshotReadOnlyTransaction(verify).Go();
+    const auto info = storage->SaveCheckpoint();
+    ASSERT_TRUE(Exists(info));
+    EXPECT_EQ(2u, Value(info).index);
+    size_t checkpoints = 0u;
+    current::FileSystem::ScanDir(checkpoints_dir, [&checkpoints](const auto&) { ++checkpoints; });
+    EXPECT_EQ(2u, checkpoints);
+  }
+
+  {
+    auto stream = stream_t::CreateStream(storage_file_name);
+    const auto publisher = stream->BecomeFollowingStream();
+    auto storage = storage_t::CreateFollowingStorageAtopExistingStreamWithCheckpoints(checkpoints_dir, stream);
+    EXPECT_EQ(300, storage->LastAppliedTimestamp().count());
+    storage->ReadOnlyTransaction(verify).Go();
+  }
+
+  // The checkpoints made from other streams are ignored.
+  {
+    const std::string other_storage_file_name =
+        current::FileSystem::JoinPath(FLAGS_transactional_storage_test_tmpdir, "other_storage");
+    const auto other_storage_file_remover = current::FileSystem::ScopedRmFile(other_storage_file_name);
+    auto storage = storage_t::CreateMasterStorageWithCheckpoints(checkpoints_dir, other_storage_file_name);
+    EXPECT_EQ(-1, storage->LastAppliedTimestamp().count());
+    EXPECT_EQ(0u, Value(storage->ReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                              return fields.d.Size();
+                            }).Go()));
+  }
+
+  // The checkpoints can be made periodically, and via HTTP. Only the most recent three are kept.
+  {
+    auto reserved_port = current::net::ReserveLocalPort();
+    const int port = reserved_port;
+    auto& http_server = HTTP(std::move(reserved_port));
+    static_cast<void>(http_server);
+
+    auto storage = storage_t::CreateMasterStorageWithCheckpoints(checkpoints_dir, storage_file_name);
+    storage->ExposeCheckpointsViaHTTP(port, "/checkpoints");
+    const std::string url = current::strings::Printf("http://localhost:%d/checkpoints", port);
+
+    EXPECT_EQ("Nothing to checkpoint.\n", HTTP(POST(url, "")).body);
+    current::time::SetNow(std::chrono::microseconds(400));
+    storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Add(Record{"e", 5}); }).Go();
+    const auto info = ParseJSON<current::storage::StorageCheckpointInfo>(HTTP(POST(url, "")).body);
+    EXPECT_EQ(3u, info.index);
+    EXPECT_EQ(3u, ParseJSON<current::storage::StorageCheckpointsList>(HTTP(GET(url)).body).checkpoints.size());
+
+    storage->EnablePeriodicCheckpoints(std::chrono::milliseconds(1));
+    current::time::SetNow(std::chrono::microseconds(500));
+    storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Add(Record{"f", 6}); }).Go();
+    std::string newest;
+    while (newest.find(current::strings::Printf("checkpoint.%020d", 4)) == std::string::npos) {
+      std::this_thread::yield();
+      newest = ParseJSON<current::storage::StorageCheckpointsList>(HTTP(GET(url)).body).checkpoints.front();
+    }
+    EXPECT_EQ(3u, ParseJSON<current::storage::StorageCheckpointsList>(HTTP(GET(url)).body).checkpoints.size());
+  }
+
+  // The checkpoint written in full that can not be parsed is reported as corrupted.
+  {
+    const std::string newest =
+        current::FileSystem::JoinPath(checkpoints_dir, current::strings::Printf("checkpoint.%020d", 4));
+    std::string contents = current::FileSystem::ReadFileAsString(newest);
+    const size_t pos = contents.find('\n');
+    ASSERT_NE(std::string::npos, pos);
+    contents[pos + 1] = '?';
+    current::FileSystem::WriteStringToFile(contents, newest.c_str());
+    ASSERT_THROW(storage_t::CreateMasterStorageWithCheckpoints(checkpoints_dir, storage_file_name),
+                 current::storage::StorageCheckpointCorruptedException);
+  }
+
+  current::FileSystem::RmDir(
+      checkpoints_dir, current::FileSystem::RmDirParameters::Silent, current::FileSystem::RmDirRecursive::Yes);
+}
+
+TEST(TransactionalStorage, SnapshotReadOnlyTransactions) {
+  current::time::ResetToZero();
+
+  using namespace transactional_storage_test;
+  using storage_t = TestStorage<StreamInMemoryStreamPersister>;
+
+  auto storage = storage_t::CreateMasterStorage();
+
+  // Without the snapshot enabled, the snapshot read-only transactions are the regular ones.
+  current::time::SetNow(std::chrono::microseconds(100));
+  storage->ReadWriteTransaction([](MutableFields<storage_t> fields) { fields.d.Add(Record{"0", 0}); }).Go();
+  EXPECT_EQ(1u, Value(storage->SnapshotReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                 return fields.d.Size();
+                               }).Go()));
+  EXPECT_EQ(-1, storage->SnapshotLastAppliedTimestamp().count());
+
+  // The snapshot is brought up to date with the transactions committed before it was enabled.
+  storage->EnableSnapshotReads();
+  EXPECT_EQ(1u, Value(storage->SnapshotReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+                                 return fields.d.Size();
+                               }).Go()));
+  EXPECT_EQ(100, storage->SnapshotLastAppliedTimestamp().count());
+
+  // The snapshot read-only transactions run concurrently with the writer, and always see a consistent state.
+  const size_t kTotalRecords = 1000u;
+  std::thread writer([&storage, kTotalRecords]() {
+    for (size_t i = 1u; i < kTotalRecords; ++i) {
+      current::time::SetNow(std::chrono::microseconds(100 * (i + 1)));
+      storage
+          ->ReadWriteTransaction([i](MutableFields<storage_t> fields) {
+            fields.d.Add(Record{current::ToString(i), static_cast<int32_t>(i)});
+          })
+          .Go();
+    }
+  });
+  size_t previous_size = 0u;
+  while (previous_size < kTotalRecords) {
+    const size_t size = Value(storage->SnapshotReadOnlyTransaction([](ImmutableFields<storage_t> fields) {
+      for (size_t i = 0u; i < fields.d.Size(); ++i) {
+        EXPECT_TRUE(Exists(fields.d[current::ToString(i)]));
+      }
+      EXPECT_FALSE(Exists(fields.d[current::ToString(fields.d.Size())]));
+      return fields.d.Size();
+    }).Go());
+    EXPECT_GE(size, previous_size);
+    previous_size = size;
+  }
+  writer.join();
+
+  storage->WaitForSnapshotToCatchUp();
+  EXPECT_EQ(storage->LastAppliedTimestamp().count(), storage->SnapshotLastAppliedTimestamp().count());
+  EXPECT_EQ(100 * static_cast<int64_t>(kTotalRecords), storage->SnapshotLastAppliedTimestamp().count());
+
+  // The two-step form is supported as well.
+  std::string last;
+  storage
+      ->SnapshotReadOnlyTransaction(
+          [kTotalRecords](ImmutableFields<storage_t> fields) {
+            return Value(fields.d[current::ToString(kTotalRecords - 1u)]).rhs;
+          },
+          [&last](int32_t rhs) { last = current::ToString(rhs); })
+      .Go();
+  EXPECT_EQ("999", last);
+
+  // A long-running snapshot reader only delays the snapshot until it is done, and then the snapshot catches up.
+  std::atomic_bool reader_started(false);
+  std::atomic_bool reader_may_finish(false);
+  std::thread reader([&]() {
+    storage
+        ->SnapshotReadOnlyTransaction([&](ImmutableFields<storage_t>) {
+          reader_started = true;
+          while (!reader_may_finish) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+          }
+        })
+        .Go();
+  });
+  while (!reader_started) {
+    std::this_thread::yield();
+  }
+  for (size_t i = 0u; i < 2u; ++i) {
+    current::time::SetNow(std::chrono::microseconds(100 * (kTotalRecords + i + 1u)));
+    storage
+        ->ReadWriteTransaction(
+            [i](MutableFields<storage_t> fields) { fields.d.Add(Record{"extra" + current::ToString(i), 0}); })
+        .Go();
+  }
+  std::this_thread::sleep_for(std::chrono::milliseconds(10));
+  reader_may_finish = true;
+  reader.join();
+  storage->WaitForSnapshotToCatchUp();
+  EXPECT_EQ(100 * static_cast<int64_t>(kTotalRecords + 2u), storage->SnapshotLastAppliedTimestamp().count());
+}
+
 TEST(TransactionalStorage, GracefulShutdown) {
   current::time::ResetToZero();
 
@@ -103,8 +103,14 @@ class Synchronous final {
   // Read-only transaction returning non-void type.
   template <typename F, class = std::enable_if_t<!std::is_void<f_result_t<F>>::value>>
   Future<TransactionResult<f_result_t<F>>, StrictFuture::Strict> TransactionFromLockedSection(F&& f) const {
-    using result_t = f_result_t<F>;
     journal_.AssertEmpty();
+    return TransactionFromSnapshot(std::forward<F>(f));
+  }
+
+  // Read-only transaction returning non-void type, run against a snapshot, with the publishing mutex not locked.
+  template <typename F, class = std::enable_if_t<!std::is_void<f_result_t<F>>::value>>
+  Future<TransactionResult<f_result_t<F>>, StrictFuture::Strict> TransactionFromSnapshot(F&& f) const {
+    using result_t = f_result_t<F>;
     std::promise<TransactionResult<result_t>> promise;
     if (destructing_) {
       promise.set_exception(std::make_exception_ptr(StorageInGracefulShutdownException()));  // LCOV_EXCL_LINE
@@ -179,6 +185,12 @@ class Synchronous final {
   template <typename F, class = std::enable_if_t<std::is_void<f_result_t<F>>::value>>
   Future<TransactionResult<void>, StrictFuture::Strict> TransactionFromLockedSection(F&& f) const {
     journal_.AssertEmpty();
+    return TransactionFromSnapshot(std::forward<F>(f));
+  }
+
+  // Read-only transaction returning void type, run against a snapshot, with the publishing mutex not locked.
+  template <typename F, class = std::enable_if_t<std::is_void<f_result_t<F>>::value>>
+  Future<TransactionResult<void>, StrictFuture::Strict> TransactionFromSnapshot(F&& f) const {
     std::promise<TransactionResult<void>> promise;
     if (destructing_) {
       promise.set_exception(std::make_exception_ptr(StorageInGracefulShutdownException()));
@@ -253,8 +265,14 @@ class Synchronous final {
   // Read-only two-step transaction.
   template <typename F1, typename F2, class = std::enable_if_t<!std::is_void<f_result_t<F1>>::value>>
   Future<TransactionResult<void>, StrictFuture::Strict> TransactionFromLockedSection(F1&& f1, F2&& f2) const {
-    using result_t = f_result_t<F1>;
     journal_.AssertEmpty();
+    return TransactionFromSnapshot(std::forward<F1>(f1), std::forward<F2>(f2));
+  }
+
+  // Read-only two-step transaction, run against a snapshot, with the publishing mutex not locked.
+  template <typename F1, typename F2, class = std::enable_if_t<!std::is_void<f_result_t<F1>>::value>>
+  Future<TransactionResult<void>, StrictFuture::Strict> TransactionFromSnapshot(F1&& f1, F2&& f2) const {
+    using result_t = f_result_t<F1>;
     std::promise<TransactionResult<void>> promise;
     if (destructing_) {
       promise.set_exception(std::make_exception_ptr(StorageInGracefulShutdownException()));  // LCOV_EXCL_LINE
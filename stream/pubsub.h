@@ -292,24 +292,28 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
         if (to_timestamp_.count() && current.us > to_timestamp_) {
           return ss::EntryResponse::Done;
         }
-        const std::string entry_json = [this, &current, &entry]() {
-          if (params_.entries_only) {
-            return JSON<J>(entry) + '\n';
-          } else {
-            return JSON<J>(current) + '\t' + JSON<J>(entry) + '\n';
-          }
-        }();
-        current_response_size_ += entry_json.length();
+        // The line is serialized once per stream, not once per subscriber, as long as it is in the shared cache.
+        const std::shared_ptr<const std::string> entry_json =
+            impl_->serialized_entries.template Get<J>(current.index, params_.entries_only, [this, &current, &entry]() {
+              if (params_.entries_only) {
+                return JSON<J>(entry) + '\n';
+              } else {
+                return JSON<J>(current) + '\t' + JSON<J>(entry) + '\n';
+              }
+            });
+        current_response_size_ += entry_json->length();
         try {
           if (params_.array) {
             if (!output_started_) {
-              http_response_("[\n");
+              http_response_("[\n", current::net::ChunkFlush::NoFlush);
               output_started_ = true;
             } else {
-              http_response_(",\n");
+              http_response_(",\n", current::net::ChunkFlush::NoFlush);
             }
           }
-          http_response_(std::move(entry_json));
+          http_response_(
+              *entry_json,
+              current.index == last.index ? current::net::ChunkFlush::Flush : current::net::ChunkFlush::NoFlush);
         } catch (const current::net::NetworkException&) {  // LCOV_EXCL_LINE
           return ss::EntryResponse::Done;                  // LCOV_EXCL_LINE
         }
@@ -331,11 +335,16 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
       }
       return ss::EntryResponse::More;
     }();
-    if (result == ss::EntryResponse::Done && params_.array) {
-      if (!output_started_) {
-        http_response_("[]\n");
+    if (result == ss::EntryResponse::Done) {
+      if (params_.array) {
+        if (!output_started_) {
+          http_response_("[]\n");
+        } else {
+          http_response_("]\n");
+        }
       } else {
-        http_response_("]\n");
+        // flush cached response data.
+        http_response_("", current::net::ChunkFlush::Flush);
       }
     }
     return result;
@@ -350,7 +359,10 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
       // Obtain current timestamp only when it's necessary by parsing the `raw_log_line`.
       const auto GetCurrentUs = [&current_us, &raw_log_line]() -> std::chrono::microseconds {
         if (!current_us.count()) {
-          current_us = ParseJSON<ts_only_t>(raw_log_line.substr(0, raw_log_line.find('\t'))).us;
+          const size_t tab_pos = raw_log_line.find('\t');
+          current_us =
+              ParseJSON<ts_only_t>(raw_log_line.c_str(), tab_pos != std::string::npos ? tab_pos : raw_log_line.length())
+                  .us;
         }
         return current_us;
       };
@@ -374,14 +386,19 @@ class PubSubHTTPEndpointImpl : public AbstractSubscriberObject {
         if (to_timestamp_.count() && GetCurrentUs() > to_timestamp_) {
           return ss::EntryResponse::Done;
         }
-        const std::string response_data = [this, &raw_log_line]() {
+        // The raw line is sent as is, never parsed and re-serialized.
+        const size_t offset = [this, &raw_log_line]() -> size_t {
           if (!params_.entries_only) {
-            return raw_log_line;
+            return 0u;
           } else {
             const auto tab_pos = raw_log_line.find('\t');
-            return tab_pos != std::string::npos ? raw_log_line.substr(tab_pos + 1) : raw_log_line;
+            return tab_pos != std::string::npos ? tab_pos + 1u : 0u;
           }
-        }() + '\n';
+        }();
+        std::string response_data;
+        response_data.reserve(raw_log_line.length() - offset + 1u);
+        response_data.append(raw_log_line, offset, std::string::npos);
+        response_data += '\n';
         current_response_size_ += response_data.length();
         try {
           if (params_.array) {
@@ -27,6 +27,7 @@ SOFTWARE.
 #ifndef CURRENT_STREAM_REPLICATOR_H
 #define CURRENT_STREAM_REPLICATOR_H
 
+#include <cstring>
 #include <functional>
 #include <string>
 #include <thread>
@@ -141,7 +142,8 @@ class SubscribableRemoteStream final {
         }
         // The leftover, previously incomplete record (full line) is now complete,
         // process it and begin processing this chunk from offset `begin_pos`.
-        PassEntryToSubscriber(carried_over_data_ + chunk.substr(0u, begin_pos));
+        carried_over_data_.append(chunk, 0u, begin_pos);
+        PassEntryToSubscriber(carried_over_data_.data(), carried_over_data_.length());
         carried_over_data_.clear();
       }
 
@@ -158,10 +160,11 @@ class SubscribableRemoteStream final {
           ++end_pos;
         }
         if (end_pos == chunk_size) {
-          carried_over_data_ = chunk.substr(begin_pos);
+          carried_over_data_.assign(chunk, begin_pos, std::string::npos);
           break;
         }
-        PassEntryToSubscriber(chunk.substr(begin_pos, end_pos - begin_pos));  // NOTE(dkorolev): Can be `Chunk`.
+        // The complete lines are passed on as views into the chunk, with no copying.
+        PassEntryToSubscriber(chunk.data() + begin_pos, end_pos - begin_pos);
         begin_pos = end_pos + 1u;
       }
     }
@@ -172,33 +175,40 @@ class SubscribableRemoteStream final {
     uint64_t next_expected_index_;
     std::chrono::microseconds from_us_;
     const idxts_t unused_idxts_;
+    // The incomplete last line of the chunk, to be completed by the next one. Its capacity is reused.
     std::string carried_over_data_;
+    // The buffer for the raw lines passed on in `RM::Unchecked` mode, as `const std::string&`. Its capacity is reused.
+    std::string raw_log_line_;
 
    private:
     template <ReplicationMode MODE = RM>
-    std::enable_if_t<MODE == ReplicationMode::Checked> PassEntryToSubscriber(const std::string& raw_log_line) {
-      const auto split = current::strings::Split(raw_log_line, '\t');
-      if (split.empty()) {
+    std::enable_if_t<MODE == ReplicationMode::Checked> PassEntryToSubscriber(const char* line, size_t length) {
+      // Parse the parts of the line before and after the tab in place, without creating substrings.
+      const char* tab = static_cast<const char*>(::memchr(line, '\t', length));
+      const bool has_entry = (tab != nullptr);
+      const size_t tab_pos = has_entry ? static_cast<size_t>(tab - line) : length;
+      const size_t entry_pos = has_entry ? tab_pos + 1u : length;
+      if (!length || (has_entry && ::memchr(line + entry_pos, '\t', length - entry_pos))) {
         CURRENT_THROW(RemoteStreamMalformedChunkException());
       }
       try {
-        const auto tsoptidx = ParseJSON<ts_optidx_t>(split[0]);
+        const auto tsoptidx = ParseJSON<ts_optidx_t>(line, tab_pos);
         if (from_us_.count() > 0 && tsoptidx.us < from_us_) {
           CURRENT_THROW(RemoteStreamMalformedChunkException());
         }
         if (Exists(tsoptidx.index)) {
           const auto idxts = idxts_t(Value(tsoptidx.index), tsoptidx.us);
-          if (split.size() != 2u || idxts.index != next_expected_index_) {
+          if (!has_entry || idxts.index != next_expected_index_) {
             CURRENT_THROW(RemoteStreamMalformedChunkException());
           }
-          auto entry = ParseJSON<TYPE_SUBSCRIBED_TO>(split[1]);
+          auto entry = ParseJSON<TYPE_SUBSCRIBED_TO>(line + entry_pos, length - entry_pos);
           if (subscriber_(std::move(entry), idxts, unused_idxts_) == ss::EntryResponse::Done) {
             CURRENT_THROW(StreamTerminatedBySubscriber());
           }
           ++next_expected_index_;
           from_us_ = std::chrono::microseconds(0);
         } else {
-          if (split.size() != 1u) {
+          if (has_entry) {
             CURRENT_THROW(RemoteStreamMalformedChunkException());
           }
           if (subscriber_(tsoptidx.us) == ss::EntryResponse::Done) {
@@ -212,10 +222,11 @@ class SubscribableRemoteStream final {
     }
 
     template <ReplicationMode MODE = RM>
-    std::enable_if_t<MODE == ReplicationMode::Unchecked> PassEntryToSubscriber(const std::string& raw_log_line) {
-      const auto tab_pos = raw_log_line.find('\t');
-      if (tab_pos != std::string::npos) {
-        if (subscriber_(raw_log_line, next_expected_index_, unused_idxts_) == ss::EntryResponse::Done) {
+    std::enable_if_t<MODE == ReplicationMode::Unchecked> PassEntryToSubscriber(const char* line, size_t length) {
+      // The raw lines are passed on as is, to be published via `PublishUnsafe()`, with no parsing.
+      if (::memchr(line, '\t', length)) {
+        raw_log_line_.assign(line, length);
+        if (subscriber_(raw_log_line_, next_expected_index_, unused_idxts_) == ss::EntryResponse::Done) {
           CURRENT_THROW(StreamTerminatedBySubscriber());
         }
         // NOTE(dkorolev) & NOTE(grixa): In `RM::Unchecked` mode
@@ -224,7 +235,7 @@ class SubscribableRemoteStream final {
         from_us_ = std::chrono::microseconds(0);
       } else {
         try {
-          const auto ts = ParseJSON<ts_only_t>(raw_log_line);
+          const auto ts = ParseJSON<ts_only_t>(line, length);
           if (subscriber_(ts.us) == ss::EntryResponse::Done) {
             CURRENT_THROW(StreamTerminatedBySubscriber());
           }
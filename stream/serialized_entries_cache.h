@@ -0,0 +1,104 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// `SerializedEntriesCache` keeps the recently serialized stream entries, so that the HTTP subscribers to the same
+// stream, following it in the same JSON format, serialize each entry once, not once per subscriber.
+//
+// The cache is a ring of `kSerializedEntriesCacheSize` slots, with the entry of index `i` stored in the slot
+// `i % kSerializedEntriesCacheSize`. Each slot is keyed by the index, by the JSON format, and by whether the line
+// is the full one, with the index and the timestamp, or just the entry. A miss overwrites the slot.
+//
+// The cached lines are `std::shared_ptr<const std::string>`-s, so that the subscriber sending the line does not
+// hold the lock of the slot, and the slot can be overwritten meanwhile.
+
+#ifndef CURRENT_STREAM_SERIALIZED_ENTRIES_CACHE_H
+#define CURRENT_STREAM_SERIALIZED_ENTRIES_CACHE_H
+
+#include "../port.h"
+
+#include <memory>
+#include <mutex>
+#include <string>
+#include <typeinfo>
+#include <vector>
+
+namespace current {
+namespace stream {
+
+constexpr static size_t kSerializedEntriesCacheSize = 4096u;
+
+class SerializedEntriesCache final {
+ public:
+  explicit SerializedEntriesCache(size_t size = kSerializedEntriesCacheSize) : slots_(size ? size : 1u) {}
+
+  // Returns the line for the entry of `index` in the format `J`, calling `serialize()` if it is not in the cache.
+  template <class J, typename F>
+  std::shared_ptr<const std::string> Get(uint64_t index, bool entries_only, F&& serialize) {
+    const size_t i = static_cast<size_t>(index % slots_.size());
+    Slot& slot = slots_[i];
+    std::mutex& mutex = mutexes_[i % kMutexes];
+    const std::type_info& format = typeid(J);
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (slot.line && slot.index == index && slot.entries_only == entries_only && *slot.format == format) {
+        return slot.line;
+      }
+    }
+    // Serialize outside the lock: if several subscribers miss at once, they would do the work that is to be done
+    // once, but would not wait for one another.
+    auto line = std::make_shared<const std::string>(serialize());
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      slot.index = index;
+      slot.format = &format;
+      slot.entries_only = entries_only;
+      slot.line = line;
+    }
+    return line;
+  }
+
+ private:
+  // The slots are locked in stripes, as a mutex per slot would make the cache several times larger.
+  constexpr static size_t kMutexes = 64u;
+
+  struct Slot final {
+    uint64_t index = 0u;
+    const std::type_info* format = nullptr;
+    bool entries_only = false;
+    std::shared_ptr<const std::string> line;
+  };
+
+  std::vector<Slot> slots_;
+  std::mutex mutexes_[kMutexes];
+
+  SerializedEntriesCache(const SerializedEntriesCache&) = delete;
+  SerializedEntriesCache(SerializedEntriesCache&&) = delete;
+  void operator=(const SerializedEntriesCache&) = delete;
+  void operator=(SerializedEntriesCache&&) = delete;
+};
+
+}  // namespace stream
+}  // namespace current
+
+#endif  // CURRENT_STREAM_SERIALIZED_ENTRIES_CACHE_H
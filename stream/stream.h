@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include "../port.h"
 
+#include <deque>
 #include <functional>
 #include <iostream>
 #include <map>
@@ -263,19 +264,36 @@ class Stream final {
     return RecreatePublisher();
   }
 
+  // Makes the subscriptions that follow, HTTP ones included, run as tasks on the `executor` instead of each on
+  // its own thread. The `executor` must outlive this stream. Passing `nullptr` restores the thread per subscription.
+  void SetSubscriberExecutor(SubscriberExecutor* executor) { impl_->subscriber_executor = executor; }
+
+  // The maximum number of entries passed at once to the subscribers declaring the batch signature.
+  constexpr static uint64_t kMaxEntriesPerSubscriberBatch = 1000u;
+
   // TODO(dkorolev): Master-follower flip between two streams belongs in Stream first, then in Storage.
   template <typename TYPE_SUBSCRIBED_TO, typename F, SubscriptionMode SM>
-  class SubscriberThreadInstance final : public current::stream::SubscriberScope::SubscriberThread {
+  class SubscriberThreadInstance final : public current::stream::SubscriberScope::SubscriberThread,
+                                         public SubscriberExecutor::Task {
    private:
     bool this_is_valid_;
     std::function<void()> done_callback_;
+    SubscriberExecutor* const executor_;
     current::WaitableTerminateSignal terminate_signal_;
     bool terminate_sent_;
     BorrowedWithCallback<impl_t> impl_;
     F& subscriber_;
     const uint64_t begin_idx_;
     const std::chrono::microseconds from_us_;
+    std::chrono::microseconds head_;
+    uint64_t index_;
     std::thread thread_;
+    // With the executor, the task is registered to be notified of the stream events throughout its lifetime.
+    std::unique_ptr<current::WaitableTerminateSignalBulkNotifier::Scope> notifier_scope_;
+    // Reused across the batches passed to the subscribers declaring the batch signature.
+    ss::EntriesBatch<TYPE_SUBSCRIBED_TO> batch_;
+    std::deque<entry_t> batch_entries_;
+    ss::RawLogLinesBatch raw_batch_;
 
     SubscriberThreadInstance() = delete;
     SubscriberThreadInstance(const SubscriberThreadInstance&) = delete;
@@ -291,7 +309,8 @@ class Stream final {
                              std::function<void()> done_callback)
         : this_is_valid_(false),
           done_callback_(done_callback),
-          terminate_signal_(),
+          executor_(impl->subscriber_executor),
+          terminate_signal_(executor_ ? std::function<void()>([this]() { executor_->Notify(*this); }) : nullptr),
           terminate_sent_(false),
           impl_(std::move(impl),
                 [this]() {
@@ -302,7 +321,15 @@ class Stream final {
           subscriber_(subscriber),
           begin_idx_(begin_idx),
           from_us_(from_us),
-          thread_(&SubscriberThreadInstance::Thread, this) {
+          head_(from_us - std::chrono::microseconds(1)),
+          index_(begin_idx) {
+      if (executor_) {
+        notifier_scope_ =
+            std::make_unique<current::WaitableTerminateSignalBulkNotifier::Scope>(impl_->notifier, terminate_signal_);
+        executor_->Start(*this);
+      } else {
+        thread_ = std::thread(&SubscriberThreadInstance::Thread, this);
+      }
       // Must guard against the constructor of `BorrowedWithCallback<impl_t> impl_` throwing.
       // NOTE(dkorolev): This is obsolete now, but keeping the logic for now, to keep it safe. -- D.K.
       this_is_valid_ = true;
@@ -310,13 +337,18 @@ class Stream final {
 
     ~SubscriberThreadInstance() {
       if (this_is_valid_) {
-        // The constructor has completed successfully. The thread has started, and `impl_` is valid.
-        CURRENT_ASSERT(thread_.joinable());
+        // The constructor has completed successfully. The thread or the task has started, and `impl_` is valid.
         if (!subscriber_thread_done_) {
           std::lock_guard<std::mutex> lock(impl_->publishing_mutex);
           terminate_signal_.SignalExternalTermination();
         }
-        thread_.join();
+        if (executor_) {
+          executor_->WaitUntilDone(*this);
+          notifier_scope_ = nullptr;
+        } else {
+          CURRENT_ASSERT(thread_.joinable());
+          thread_.join();
+        }
       } else {
         // The constructor has not completed successfully. The thread was not started, and `impl_` is garbage.
         if (done_callback_) {
@@ -328,7 +360,20 @@ class Stream final {
     void Thread() {
       // Keep the subscriber thread exception-safe. By construction, it's guaranteed to live
       // strictly within the scope of existence of `impl_t` contained in `impl_`.
-      ThreadImpl(begin_idx_);
+      ThreadImpl();
+      MarkDone();
+    }
+
+    // The step of the task run by the executor.
+    SubscriberStepResult Step(uint64_t max_entries) override {
+      const SubscriberStepResult result = SubscriberStep(max_entries);
+      if (result == SubscriberStepResult::Done) {
+        MarkDone();
+      }
+      return result;
+    }
+
+    void MarkDone() {
       subscriber_thread_done_ = true;
       std::lock_guard<std::mutex> lock(impl_->http_subscriptions_mutex);
       if (done_callback_) {
@@ -336,24 +381,68 @@ class Stream final {
       }
     }
 
+    // Returns `true` if the termination has been signaled, and the subscriber has agreed to terminate.
+    bool TerminateIfSignaled() {
+      if (!terminate_sent_ && terminate_signal_) {
+        terminate_sent_ = true;
+        return subscriber_.Terminate() != ss::TerminationResponse::Wait;
+      }
+      return false;
+    }
+
+    // Passes the entries `[index, end)` to the subscriber. The `last` is the snapshot of the last published entry
+    // taken along with `end`, so that the publishing mutex is not locked for each entry passed.
+    // The subscribers declaring the batch signature are passed up to `kMaxEntriesPerSubscriberBatch` entries at once.
     template <SubscriptionMode MODE = SM>
     std::enable_if_t<MODE == SubscriptionMode::Checked, ss::EntryResponse> PassEntriesToSubscriber(const impl_t& impl,
                                                                                                    uint64_t index,
-                                                                                                   uint64_t size) {
-      for (const auto& e : impl.persister.Iterate(index, size)) {
-        if (!terminate_sent_ && terminate_signal_) {
-          terminate_sent_ = true;
-          if (subscriber_.Terminate() != ss::TerminationResponse::Wait) {
-            return ss::EntryResponse::Done;
+                                                                                                   uint64_t end,
+                                                                                                   idxts_t last) {
+      if constexpr (ss::accepts_entries_batch_v<F, TYPE_SUBSCRIBED_TO>) {
+        batch_.clear();
+        batch_entries_.clear();
+        uint64_t batch_begin = index;
+        for (auto&& e : impl.persister.Iterate(index, end)) {
+          const bool passes = ss::EntryPassesTypeFilter<TYPE_SUBSCRIBED_TO, entry_t>(e.entry);
+          if (passes) {
+            if constexpr (std::is_reference_v<decltype(e.entry)>) {
+              batch_.push_back(e.idx_ts, ss::TypeFilteredEntry<TYPE_SUBSCRIBED_TO, entry_t>(e.entry));
+            } else {
+              // The persister has materialized the entry, it should live until the batch is passed on.
+              batch_entries_.push_back(std::move(e.entry));
+              batch_.push_back(e.idx_ts, ss::TypeFilteredEntry<TYPE_SUBSCRIBED_TO, entry_t>(batch_entries_.back()));
+            }
+          }
+          ++index;
+          if (index == end || index - batch_begin == kMaxEntriesPerSubscriberBatch) {
+            if (TerminateIfSignaled()) {
+              return ss::EntryResponse::Done;
+            }
+            if (!batch_.empty() && subscriber_(batch_, last) == ss::EntryResponse::Done) {
+              return ss::EntryResponse::Done;
+            }
+            if (!passes && index == last.index + 1u &&
+                subscriber_.EntryResponseIfNoMorePassTypeFilter() == ss::EntryResponse::Done) {
+              return ss::EntryResponse::Done;
+            }
+            batch_.clear();
+            batch_entries_.clear();
+            batch_begin = index;
           }
         }
-        if (current::ss::PassEntryToSubscriberIfTypeMatches<TYPE_SUBSCRIBED_TO, entry_t>(
-                subscriber_,
-                [this]() -> ss::EntryResponse { return subscriber_.EntryResponseIfNoMorePassTypeFilter(); },
-                e.entry,
-                e.idx_ts,
-                impl.persister.LastPublishedIndexAndTimestamp()) == ss::EntryResponse::Done) {
-          return ss::EntryResponse::Done;
+      } else {
+        for (const auto& e : impl.persister.Iterate(index, end)) {
+          if (TerminateIfSignaled()) {
+            return ss::EntryResponse::Done;
+          }
+          if (current::ss::PassEntryToSubscriberIfTypeMatches<TYPE_SUBSCRIBED_TO, entry_t>(
+                  subscriber_,
+                  [this]() -> ss::EntryResponse { return subscriber_.EntryResponseIfNoMorePassTypeFilter(); },
+                  e.entry,
+                  e.idx_ts,
+                  last) == ss::EntryResponse::Done) {
+            return ss::EntryResponse::Done;
+          }
         }
       }
       return ss::EntryResponse::More;
@@ -362,54 +451,80 @@ class Stream final {
     template <SubscriptionMode MODE = SM>
     std::enable_if_t<MODE == SubscriptionMode::Unchecked, ss::EntryResponse> PassEntriesToSubscriber(const impl_t& impl,
                                                                                                      uint64_t index,
-                                                                                                     uint64_t size) {
-      for (const auto& e : impl.persister.IterateUnsafe(index, size)) {
-        if (!terminate_sent_ && terminate_signal_) {
-          terminate_sent_ = true;
-          if (subscriber_.Terminate() != ss::TerminationResponse::Wait) {
-            return ss::EntryResponse::Done;
+                                                                                                     uint64_t end,
+                                                                                                     idxts_t last) {
+      if constexpr (ss::accepts_raw_log_lines_batch_v<F>) {
+        raw_batch_.begin_index = index;
+        raw_batch_.lines.clear();
+        for (auto&& line : impl.persister.IterateUnsafe(index, end)) {
+          raw_batch_.lines.push_back(std::move(line));
+          ++index;
+          if (index == end || raw_batch_.lines.size() == kMaxEntriesPerSubscriberBatch) {
+            if (TerminateIfSignaled()) {
+              return ss::EntryResponse::Done;
+            }
+            if (subscriber_(raw_batch_, last) == ss::EntryResponse::Done) {
+              return ss::EntryResponse::Done;
+            }
+            raw_batch_.begin_index = index;
+            raw_batch_.lines.clear();
           }
         }
-        if (subscriber_(e, index++, impl.persister.LastPublishedIndexAndTimestamp()) == ss::EntryResponse::Done) {
-          return ss::EntryResponse::Done;
+      } else {
+        for (const auto& e : impl.persister.IterateUnsafe(index, end)) {
+          if (TerminateIfSignaled()) {
+            return ss::EntryResponse::Done;
+          }
+          if (subscriber_(e, index++, last) == ss::EntryResponse::Done) {
+            return ss::EntryResponse::Done;
+          }
         }
       }
       return ss::EntryResponse::More;
     }
 
-    void ThreadImpl(uint64_t begin_idx) {
-      auto head = from_us_ - std::chrono::microseconds(1);
-      uint64_t index = begin_idx;
-      uint64_t size = 0;
-      while (true) {
-        if (!terminate_sent_ && terminate_signal_) {
-          terminate_sent_ = true;
-          if (subscriber_.Terminate() != ss::TerminationResponse::Wait) {
-            return;
-          }
-        }
-        const auto head_idx = impl_->persister.HeadAndLastPublishedIndexAndTimestamp();
-        size = Exists(head_idx.idxts) ? Value(head_idx.idxts).index + 1 : 0;
-        if (head_idx.head > head) {
-          if (size > index) {
-            if (PassEntriesToSubscriber(*impl_, index, size) == ss::EntryResponse::Done) {
-              return;
-            }
-            index = size;
-            head = Value(head_idx.idxts).us;
+    // Passes up to `max_entries` entries, or the head, to the subscriber. Returns `Idle` if there is nothing new.
+    SubscriberStepResult SubscriberStep(uint64_t max_entries) {
+      if (TerminateIfSignaled()) {
+        return SubscriberStepResult::Done;
+      }
+      const auto head_idx = impl_->persister.HeadAndLastPublishedIndexAndTimestamp();
+      const uint64_t size = Exists(head_idx.idxts) ? Value(head_idx.idxts).index + 1 : 0;
+      if (head_idx.head > head_) {
+        if (size > index_) {
+          const uint64_t end = size - index_ > max_entries ? index_ + max_entries : size;
+          if (PassEntriesToSubscriber(*impl_, index_, end, Value(head_idx.idxts)) == ss::EntryResponse::Done) {
+            return SubscriberStepResult::Done;
           }
-          if (size >= begin_idx && head_idx.head > head && subscriber_(head_idx.head) == ss::EntryResponse::Done) {
-            return;
+          index_ = end;
+          if (end < size) {
+            return SubscriberStepResult::MoreWork;
           }
-          head = head_idx.head;
-        } else {
+          head_ = Value(head_idx.idxts).us;
+        }
+        if (size >= begin_idx_ && head_idx.head > head_ && subscriber_(head_idx.head) == ss::EntryResponse::Done) {
+          return SubscriberStepResult::Done;
+        }
+        head_ = head_idx.head;
+        return SubscriberStepResult::MoreWork;
+      } else {
+        return SubscriberStepResult::Idle;
+      }
+    }
+
+    void ThreadImpl() {
+      while (true) {
+        const SubscriberStepResult result = SubscriberStep(static_cast<uint64_t>(-1));
+        if (result == SubscriberStepResult::Done) {
+          return;
+        } else if (result == SubscriberStepResult::Idle) {
           std::unique_lock<std::mutex> lock(impl_->publishing_mutex);
           current::WaitableTerminateSignalBulkNotifier::Scope scope(impl_->notifier, terminate_signal_);
-          terminate_signal_.WaitUntil(lock, [this, &index, &begin_idx, &head]() {
+          terminate_signal_.WaitUntil(lock, [this]() {
             return terminate_signal_ ||
-                   impl_->persister.template Size<current::locks::MutexLockStatus::AlreadyLocked>() > index ||
-                   (index > begin_idx &&
-                    impl_->persister.template CurrentHead<current::locks::MutexLockStatus::AlreadyLocked>() > head);
+                   impl_->persister.template Size<current::locks::MutexLockStatus::AlreadyLocked>() > index_ ||
+                   (index_ > begin_idx_ &&
+                    impl_->persister.template CurrentHead<current::locks::MutexLockStatus::AlreadyLocked>() > head_);
           });
         }
       }
@@ -583,11 +698,16 @@ class Stream final {
         // Note: Called from a locked section of `borrowed_impl->http_subscriptions_mutex`.
         borrowed_impl->http_subscriptions[subscription_id].second = nullptr;
       };
+      // The unchecked subscriptions save on parsing the entries, which is moot for the in-memory persister: its
+      // "raw" lines are serialized on the fly, once per subscriber. The checked path serializes the entries
+      // via the shared `serialized_entries` cache instead, once per stream.
+      const bool checked =
+          request_params.checked || std::is_same_v<persistence_layer_t, current::persistence::Memory<entry_t>>;
       current::stream::SubscriberScope http_chunked_subscriber_scope =
-          request_params.checked ? static_cast<current::stream::SubscriberScope>(
-                                       Subscribe(*http_chunked_subscriber, begin_idx, from_timestamp, done_callback))
-                                 : static_cast<current::stream::SubscriberScope>(SubscribeUnchecked(
-                                       *http_chunked_subscriber, begin_idx, from_timestamp, done_callback));
+          checked ? static_cast<current::stream::SubscriberScope>(
+                        Subscribe(*http_chunked_subscriber, begin_idx, from_timestamp, done_callback))
+                  : static_cast<current::stream::SubscriberScope>(
+                        SubscribeUnchecked(*http_chunked_subscriber, begin_idx, from_timestamp, done_callback));
 
       {
         std::lock_guard<std::mutex> lock(borrowed_impl->http_subscriptions_mutex);
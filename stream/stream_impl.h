@@ -27,6 +27,7 @@ SOFTWARE.
 
 #include "../port.h"
 
+#include <atomic>
 #include <map>
 #include <thread>
 #include <type_traits>
@@ -38,6 +39,9 @@ SOFTWARE.
 #include "../blocks/persistence/file.h"
 #include "../blocks/ss/pubsub.h"
 
+#include "serialized_entries_cache.h"
+#include "subscriber_executor.h"
+
 namespace current {
 namespace stream {
 
@@ -107,9 +111,11 @@ struct StreamImpl {
   using persistence_layer_t = PERSISTENCE_LAYER<entry_t>;
 
   // Publishing-related mutex and notifier are mutable to wait on them from the subscriber thread.
+  // The notifier is declared before the persister, as the persister may notify it from its own thread until it is
+  // destroyed, see `NotifyOfBatchesWrittenBy()`.
   mutable std::mutex publishing_mutex;
-  persistence_layer_t persister;
   mutable current::WaitableTerminateSignalBulkNotifier notifier;
+  persistence_layer_t persister;
 
   // The HTTP-subscription-related logic is `mutable` because subscribing to a stream is `const` by convention.
   using http_subscriptions_t =
@@ -117,8 +123,25 @@ struct StreamImpl {
   mutable std::mutex http_subscriptions_mutex;
   mutable http_subscriptions_t http_subscriptions;
 
+  // The entries recently serialized for the HTTP subscribers, shared by all of them.
+  mutable SerializedEntriesCache serialized_entries;
+
+  // When set, the subscriptions made, HTTP ones included, run on this executor instead of on their own threads.
+  std::atomic<SubscriberExecutor*> subscriber_executor{nullptr};
+
   template <typename... ARGS>
-  StreamImpl(ARGS&&... args) : persister(publishing_mutex, std::forward<ARGS>(args)...) {}
+  StreamImpl(ARGS&&... args) : persister(publishing_mutex, std::forward<ARGS>(args)...) {
+    NotifyOfBatchesWrittenBy(persister, 0);
+  }
+
+ private:
+  // The persisters writing the entries in the background, such as `File` with group commit, tell when they do.
+  template <typename P>
+  auto NotifyOfBatchesWrittenBy(P& p, int) -> decltype(p.SetOnBatchWritten(nullptr), void()) {
+    p.SetOnBatchWritten([this]() { notifier.NotifyAllOfExternalWaitableEvent(); });
+  }
+  template <typename P>
+  void NotifyOfBatchesWrittenBy(P&, long) {}
 };
 
 template <typename ENTRY, template <typename> class PERSISTENCE_LAYER>
@@ -149,6 +172,14 @@ class StreamPublisherImpl {
     return result;
   }
 
+  // Only available with the persisters supporting it, such as `File`.
+  template <current::locks::MutexLockStatus MLS = current::locks::MutexLockStatus::NeedToLock, typename CONTAINER>
+  idxts_t PublishBatch(CONTAINER&& entries, std::vector<idxts_t>* published = nullptr) {
+    const auto result = data_->persister.template PublishBatch<MLS>(std::forward<CONTAINER>(entries), published);
+    data_->notifier.NotifyAllOfExternalWaitableEvent();
+    return result;
+  }
+
   template <current::locks::MutexLockStatus MLS, typename TIMESTAMP>
   void PublisherUpdateHeadImpl(TIMESTAMP&& timestamp) {
     data_->persister.template PersisterUpdateHeadImpl<MLS>(std::forward<TIMESTAMP>(timestamp));
@@ -0,0 +1,166 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// `SubscriberExecutor` runs stream subscriptions as cooperative tasks on a fixed pool of worker threads,
+// instead of dedicating an OS thread to each `Subscribe()`. Used via `stream->SetSubscriberExecutor(&executor)`.
+//
+// A task is run in steps, each passing at most `max_entries_per_step` entries to its subscriber. A task that has
+// more to do is put to the back of the queue, so that a subscriber catching up on a long stream does not starve
+// the others. A task that is out of entries is parked until the stream notifies it of a new entry, of a new head,
+// or of termination, via the very `WaitableTerminateSignalBulkNotifier` the subscriber threads wait upon.
+//
+// NOTE: A subscriber that blocks, for instance on a slow HTTP client, blocks one worker thread while it does.
+// NOTE: The executor must outlive the streams using it. Its destructor waits for all the subscriptions to end.
+
+#ifndef CURRENT_STREAM_SUBSCRIBER_EXECUTOR_H
+#define CURRENT_STREAM_SUBSCRIBER_EXECUTOR_H
+
+#include "../port.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace current {
+namespace stream {
+
+enum class SubscriberStepResult : int { MoreWork, Idle, Done };
+
+class SubscriberExecutor final {
+ public:
+  class Task {
+   public:
+    virtual ~Task() = default;
+    // Passes up to `max_entries` entries to the subscriber, never waiting for new ones.
+    virtual SubscriberStepResult Step(uint64_t max_entries) = 0;
+
+   private:
+    friend class SubscriberExecutor;
+    enum class State : int { Idle, Queued, Running, RunningAndNotified, Done };
+    State state_ = State::Idle;  // Guarded by the mutex of the executor.
+  };
+
+  // Zero `worker_threads` stands for `std::thread::hardware_concurrency()`.
+  explicit SubscriberExecutor(size_t worker_threads = 0u, uint64_t max_entries_per_step = 1000u)
+      : max_entries_per_step_(std::max(max_entries_per_step, static_cast<uint64_t>(1u))) {
+    if (!worker_threads) {
+      worker_threads = std::max(static_cast<size_t>(std::thread::hardware_concurrency()), static_cast<size_t>(1u));
+    }
+    for (size_t i = 0; i < worker_threads; ++i) {
+      workers_.emplace_back([this]() { WorkerThread(); });
+    }
+  }
+
+  ~SubscriberExecutor() {
+    {
+      std::unique_lock<std::mutex> lock(mutex_);
+      task_done_condition_variable_.wait(lock, [this]() { return !active_tasks_; });
+      stopping_ = true;
+      condition_variable_.notify_all();
+    }
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  size_t WorkerThreads() const { return workers_.size(); }
+
+  size_t ActiveTasks() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return active_tasks_;
+  }
+
+  // Starts running the task. The task must stay alive until `WaitUntilDone()` has returned for it.
+  void Start(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    ++active_tasks_;
+    task.state_ = Task::State::Queued;
+    ready_.push_back(&task);
+    condition_variable_.notify_one();
+  }
+
+  // Wakes up the parked task, or, if it is running now, makes sure it runs one more step. THREAD-SAFE.
+  void Notify(Task& task) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (task.state_ == Task::State::Idle) {
+      task.state_ = Task::State::Queued;
+      ready_.push_back(&task);
+      condition_variable_.notify_one();
+    } else if (task.state_ == Task::State::Running) {
+      task.state_ = Task::State::RunningAndNotified;
+    }
+  }
+
+  // Waits until the task has returned `SubscriberStepResult::Done` from its step. The task should be told
+  // to terminate beforehand, otherwise this call waits for as long as the subscriber keeps accepting entries.
+  void WaitUntilDone(Task& task) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    task_done_condition_variable_.wait(lock, [&task]() { return task.state_ == Task::State::Done; });
+  }
+
+ private:
+  void WorkerThread() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (true) {
+      condition_variable_.wait(lock, [this]() { return stopping_ || !ready_.empty(); });
+      if (ready_.empty()) {
+        return;
+      }
+      Task* task = ready_.front();
+      ready_.pop_front();
+      task->state_ = Task::State::Running;
+      lock.unlock();
+      const SubscriberStepResult result = task->Step(max_entries_per_step_);
+      lock.lock();
+      if (result == SubscriberStepResult::Done) {
+        // The task may be destroyed as soon as the lock is released, it must not be touched from here on.
+        task->state_ = Task::State::Done;
+        --active_tasks_;
+        task_done_condition_variable_.notify_all();
+      } else if (result == SubscriberStepResult::MoreWork || task->state_ == Task::State::RunningAndNotified) {
+        task->state_ = Task::State::Queued;
+        ready_.push_back(task);
+      } else {
+        task->state_ = Task::State::Idle;
+      }
+    }
+  }
+
+  const uint64_t max_entries_per_step_;
+  mutable std::mutex mutex_;
+  std::condition_variable condition_variable_;
+  std::condition_variable task_done_condition_variable_;
+  std::deque<Task*> ready_;
+  size_t active_tasks_ = 0u;
+  bool stopping_ = false;
+  std::vector<std::thread> workers_;
+};
+
+}  // namespace stream
+}  // namespace current
+
+#endif  // CURRENT_STREAM_SUBSCRIBER_EXECUTOR_H
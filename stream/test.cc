@@ -419,6 +419,64 @@ TEST(Stream, SubscribeProcessedThreeEntriesBecauseWeWaitInTheScope) {
   EXPECT_EQ("10,11,12", d_unchecked.results_);
 }
 
+TEST(Stream, SubscribersShareTheExecutor) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+
+  // Two worker threads, passing at most three entries to a subscriber at once, serve all the subscriptions.
+  current::stream::SubscriberExecutor executor(2u, 3u);
+  EXPECT_EQ(2u, executor.WorkerThreads());
+
+  auto stream = current::stream::Stream<Record>::CreateStream();
+  stream->SetSubscriberExecutor(&executor);
+  current::time::SetNow(std::chrono::microseconds(1));
+  for (int i = 1; i <= 5; ++i) {
+    stream->Publisher()->Publish(Record(i), std::chrono::microseconds(i * 10));
+  }
+
+  constexpr size_t kSubscribers = 20u;
+  std::vector<Data> data(kSubscribers);
+  std::vector<std::unique_ptr<StreamTestProcessor>> processors;
+  Data terminated_data;
+  StreamTestProcessor terminated_processor(terminated_data, true);
+  {
+    std::vector<current::stream::SubscriberScope> scopes;
+    for (size_t i = 0; i < kSubscribers; ++i) {
+      processors.push_back(std::make_unique<StreamTestProcessor>(data[i], false));
+      processors.back()->SetMax(10u);
+      scopes.push_back(stream->Subscribe(*processors.back()));
+    }
+    current::stream::SubscriberScope terminated_scope = stream->SubscribeUnchecked(terminated_processor);
+    EXPECT_EQ(kSubscribers + 1u, executor.ActiveTasks());
+
+    for (int i = 6; i <= 10; ++i) {
+      stream->Publisher()->Publish(Record(i), std::chrono::microseconds(i * 10));
+    }
+
+    // Each subscriber is done after ten entries.
+    for (const auto& scope : scopes) {
+      while (scope) {
+        std::this_thread::yield();
+      }
+    }
+    EXPECT_EQ(1u, executor.ActiveTasks());
+
+    // The subscriber waiting for more entries is terminated as its scope is left.
+    while (terminated_data.seen_ < 10u) {
+      std::this_thread::yield();
+    }
+    EXPECT_TRUE(terminated_scope);
+  }
+  EXPECT_EQ(0u, executor.ActiveTasks());
+
+  for (size_t i = 0; i < kSubscribers; ++i) {
+    EXPECT_EQ(10u, data[i].seen_);
+    EXPECT_EQ("1,2,3,4,5,6,7,8,9,10", data[i].results_);
+  }
+  EXPECT_EQ("1,2,3,4,5,6,7,8,9,10,TERMINATE", terminated_data.results_);
+}
+
 namespace stream_unittest {
 
 // Collector class for `SubscribeToStreamViaHTTP` test.
@@ -1025,6 +1083,60 @@ TEST(Stream, PersistsToFile) {
   EXPECT_EQ(stream_golden_data, current::FileSystem::ReadFileAsString(persistence_file_name));
 }
 
+TEST(Stream, GroupCommitsToFile) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+  using current::persistence::FileDurability;
+
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_stream_test_tmpdir, "data");
+  const auto persistence_file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  auto persisted = current::stream::Stream<Record, current::persistence::File>::CreateStream(
+      persistence_file_name, FileDurability(FileDurability::Policy::GroupCommit));
+
+  current::time::SetNow(std::chrono::microseconds(100), std::chrono::microseconds(200));
+  EXPECT_EQ(2u, persisted->Publisher()->PublishBatch(std::vector<Record>({Record(1), Record(2), Record(3)})).index);
+
+  // The subscriber is woken up once the batch is written into the file.
+  Data d;
+  {
+    StreamTestProcessor p(d, false, true);
+    p.SetMax(3u);
+    persisted->Subscribe(p);
+    EXPECT_EQ(3u, d.seen_);
+  }
+  const std::vector<std::string> expected_values{"[0:100,2:102] 1", "[1:101,2:102] 2", "[2:102,2:102] 3"};
+  EXPECT_TRUE(CompareValuesMixedWithTerminate(d.results_, expected_values, StreamTestProcessor::kTerminateStr))
+      << Join(expected_values, ',') << " != " << d.results_;
+}
+
+TEST(Stream, DestroyedWhileGroupCommitIsInFlight) {
+  using namespace stream_unittest;
+  using current::persistence::FileDurability;
+
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_stream_test_tmpdir, "data");
+
+  // The stream is destroyed shortly after the batch is published, while the flusher is yet to write it, or is writing
+  // it, or is about to notify the stream of it having been written. The batch is still written in full.
+  for (int i = 0; i < 100; ++i) {
+    const auto persistence_file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+    const FileDurability durability =
+        FileDurability((i & 1) ? FileDurability::Policy::FDataSyncPerBatch : FileDurability::Policy::GroupCommit)
+            .SetMaxBatchDelay(std::chrono::microseconds(10));
+    current::time::ResetToZero();
+    {
+      auto persisted =
+          current::stream::Stream<Record, current::persistence::File>::CreateStream(persistence_file_name, durability);
+      current::time::SetNow(std::chrono::microseconds(100), std::chrono::microseconds(200));
+      persisted->Publisher()->PublishBatch(std::vector<Record>({Record(1), Record(2), Record(3)}));
+      std::this_thread::sleep_for(std::chrono::microseconds((i / 2) * 5));
+    }
+    auto reopened = current::stream::Stream<Record, current::persistence::File>::CreateStream(persistence_file_name);
+    EXPECT_EQ(3u, reopened->Data()->Size());
+  }
+}
+
 TEST(Stream, ParsesFromFile) {
   current::time::ResetToZero();
 
@@ -1365,6 +1477,22 @@ TEST(Stream, ParseArbitrarilySplitChunks) {
   }
 
   EXPECT_EQ(stream_golden_data, current::FileSystem::ReadFileAsString(persistence_file_name));
+
+  // The unchecked replication passes the very same raw lines on, with no parsing.
+  const std::string unchecked_persistence_file_name =
+      current::FileSystem::JoinPath(FLAGS_stream_test_tmpdir, "data_unchecked");
+  const auto unchecked_persistence_file_remover = current::FileSystem::ScopedRmFile(unchecked_persistence_file_name);
+  auto unchecked_replicated_stream = stream_t::CreateStream(unchecked_persistence_file_name);
+  auto unchecked_replicator = RemoteStreamReplicator(unchecked_replicated_stream);
+
+  {
+    const auto subscriber_scope = remote_stream.SubscribeUnchecked(unchecked_replicator);
+    while (unchecked_replicated_stream->Data()->Size() < 3u) {
+      std::this_thread::yield();
+    }
+  }
+
+  EXPECT_EQ(stream_golden_data, current::FileSystem::ReadFileAsString(unchecked_persistence_file_name));
 }
 
 TEST(Stream, MasterFollowerFlip) {
@@ -1928,6 +2056,121 @@ TEST(Stream, SubscribeWithFilterByType) {
   }
 }
 
+TEST(Stream, SubscribeWithBatchSignature) {
+  current::time::ResetToZero();
+
+  using namespace stream_unittest;
+  using current::ss::EntriesBatch;
+  using current::ss::RawLogLinesBatch;
+
+  struct BatchCollectorImpl {
+    BatchCollectorImpl() = delete;
+    BatchCollectorImpl(const BatchCollectorImpl&) = delete;
+    BatchCollectorImpl(BatchCollectorImpl&&) = delete;
+
+    explicit BatchCollectorImpl(size_t expected_count) : expected_count_(expected_count) {}
+
+    EntryResponse operator()(const EntriesBatch<Variant<Record, AnotherRecord>>& batch, idxts_t last) {
+      for (const auto& e : batch) {
+        sum_ += Exists<Record>(e.entry) ? Value<Record>(e.entry).x : Value<AnotherRecord>(e.entry).y;
+      }
+      return Collected(batch.front().idx_ts.index, batch.size(), last);
+    }
+
+    EntryResponse operator()(const EntriesBatch<Record>& batch, idxts_t last) {
+      for (const auto& e : batch) {
+        sum_ += e.entry.x;
+      }
+      return Collected(batch.front().idx_ts.index, batch.size(), last);
+    }
+
+    EntryResponse operator()(const RawLogLinesBatch& batch, idxts_t last) {
+      for (const auto& line : batch.lines) {
+        const auto tab_pos = line.find('\t');
+        CURRENT_ASSERT(tab_pos != std::string::npos);
+        sum_ += ParseJSON<idxts_t>(line.substr(0, tab_pos)).us.count();
+      }
+      return Collected(batch.begin_index, batch.lines.size(), last);
+    }
+
+    EntryResponse operator()(std::chrono::microseconds) const { return EntryResponse::More; }
+
+    TerminationResponse Terminate() const { return TerminationResponse::Wait; }
+
+    static EntryResponse EntryResponseIfNoMorePassTypeFilter() { return EntryResponse::Done; }
+
+    EntryResponse Collected(uint64_t begin_index, size_t size, idxts_t last) {
+      batches_.push_back(current::ToString(begin_index) + ':' + current::ToString(size));
+      last_index_ = last.index;
+      count_ += size;
+      return count_ == expected_count_ ? EntryResponse::Done : EntryResponse::More;
+    }
+
+    std::vector<std::string> batches_;
+    size_t count_ = 0u;
+    int64_t sum_ = 0;
+    uint64_t last_index_ = 0u;
+    const size_t expected_count_;
+  };
+
+  const std::string persistence_file_name = current::FileSystem::JoinPath(FLAGS_stream_test_tmpdir, "data");
+  const auto persistence_file_remover = current::FileSystem::ScopedRmFile(persistence_file_name);
+
+  auto stream = current::stream::Stream<Variant<Record, AnotherRecord>>::CreateStream();
+  auto persisted =
+      current::stream::Stream<Variant<Record, AnotherRecord>, current::persistence::File>::CreateStream(
+          persistence_file_name);
+  for (int i = 1; i <= 2500; ++i) {
+    current::time::SetNow(std::chrono::microseconds(i));
+    if (i & 1) {
+      stream->Publisher()->Publish(Record(i));
+      persisted->Publisher()->Publish(Record(i));
+    } else {
+      stream->Publisher()->Publish(AnotherRecord(i));
+      persisted->Publisher()->Publish(AnotherRecord(i));
+    }
+  }
+
+  {
+    using Collector = current::ss::StreamSubscriber<BatchCollectorImpl, Variant<Record, AnotherRecord>>;
+    static_assert(current::ss::accepts_entries_batch_v<Collector, Variant<Record, AnotherRecord>>, "");
+    static_assert(current::ss::accepts_raw_log_lines_batch_v<Collector>, "");
+    static_assert(!current::ss::accepts_entries_batch_v<StreamTestProcessor, Record>, "");
+
+    // The entries are passed in batches of up to a thousand.
+    Collector c(2500u);
+    stream->Subscribe(c);
+    EXPECT_EQ("0:1000 1000:1000 2000:500", Join(c.batches_, ' '));
+    EXPECT_EQ(2500 * 2501 / 2, c.sum_);
+    EXPECT_EQ(2499u, c.last_index_);
+
+    // With the `File` persister, the entries of the batch are parsed from the file.
+    Collector c_persisted(2500u);
+    persisted->Subscribe(c_persisted);
+    EXPECT_EQ("0:1000 1000:1000 2000:500", Join(c_persisted.batches_, ' '));
+    EXPECT_EQ(2500 * 2501 / 2, c_persisted.sum_);
+
+    Collector c_unchecked(2500u);
+    stream->SubscribeUnchecked(c_unchecked);
+    EXPECT_EQ("0:1000 1000:1000 2000:500", Join(c_unchecked.batches_, ' '));
+    EXPECT_EQ(2500 * 2501 / 2, c_unchecked.sum_);
+  }
+
+  {
+    // Type filtering happens as the batches are formed, and the last entry not passing the filter ends the batches.
+    using Collector = current::ss::StreamSubscriber<BatchCollectorImpl, Record>;
+    Collector c(2500u);
+    stream->Subscribe<Record>(c);
+    EXPECT_EQ("0:500 1000:500 2000:250", Join(c.batches_, ' '));
+    EXPECT_EQ(1250 * 1250, c.sum_);
+
+    Collector c_persisted(2500u);
+    persisted->Subscribe<Record>(c_persisted);
+    EXPECT_EQ("0:500 1000:500 2000:250", Join(c_persisted.batches_, ' '));
+    EXPECT_EQ(1250 * 1250, c_persisted.sum_);
+  }
+}
+
 TEST(Stream, ReleaseAndAcquirePublisher) {
   current::time::ResetToZero();
 
@@ -2126,3 +2369,53 @@ TEST(Stream, SubscribingToJustTailDoesTheJob) {
   EXPECT_EQ(40, result[1].x);
   EXPECT_EQ(50, result[2].x);
 }
+
+TEST(Stream, HTTPSubscribersShareSerializedEntries) {
+  using namespace stream_unittest;
+
+  {
+    // The cache serializes each entry once per format, and re-serializes the entries evicted from the ring.
+    current::stream::SerializedEntriesCache cache(4u);
+    int calls = 0;
+    const auto serialize = [&calls]() {
+      ++calls;
+      return current::ToString(calls);
+    };
+    EXPECT_EQ("1", *cache.Get<JSONFormat::Current>(0u, false, serialize));
+    EXPECT_EQ("1", *cache.Get<JSONFormat::Current>(0u, false, serialize));
+    EXPECT_EQ("2", *cache.Get<JSONFormat::Minimalistic>(1u, false, serialize));
+    EXPECT_EQ("2", *cache.Get<JSONFormat::Minimalistic>(1u, false, serialize));
+    EXPECT_EQ("3", *cache.Get<JSONFormat::Minimalistic>(1u, true, serialize));
+    EXPECT_EQ(3, calls);
+    EXPECT_EQ("4", *cache.Get<JSONFormat::Current>(4u, false, serialize));
+    EXPECT_EQ("5", *cache.Get<JSONFormat::Current>(0u, false, serialize));
+    EXPECT_EQ(5, calls);
+  }
+
+  auto reserved_port = current::net::ReserveLocalPort();
+  const int port = reserved_port;
+  auto& http_server = HTTP(std::move(reserved_port));
+  static_cast<void>(http_server);
+
+  auto exposed_stream = current::stream::Stream<Record>::CreateStream();
+  const std::string base_url = Printf("http://localhost:%d/shared", port);
+  const auto scope = HTTP(port).Register("/shared", *exposed_stream);
+
+  for (int i = 0; i < 5; ++i) {
+    exposed_stream->Publisher()->Publish(Record(i), std::chrono::microseconds(i + 1));
+  }
+
+  // The subscribers in the same format are served the same bytes, and the formats do not mix.
+  const std::string golden = HTTP(GET(base_url + "?nowait")).body;
+  EXPECT_EQ(
+      "{\"index\":0,\"us\":1}\t{\"x\":0}\n"
+      "{\"index\":1,\"us\":2}\t{\"x\":1}\n"
+      "{\"index\":2,\"us\":3}\t{\"x\":2}\n"
+      "{\"index\":3,\"us\":4}\t{\"x\":3}\n"
+      "{\"index\":4,\"us\":5}\t{\"x\":4}\n",
+      golden);
+  EXPECT_EQ(golden, HTTP(GET(base_url + "?nowait&checked")).body);
+  EXPECT_EQ("{\"x\":3}\n{\"x\":4}\n", HTTP(GET(base_url + "?nowait&i=3&entries_only")).body);
+  EXPECT_EQ("[\n{\"x\":3}\n,\n{\"x\":4}\n]\n", HTTP(GET(base_url + "?nowait&i=3&array")).body);
+  EXPECT_EQ(golden, HTTP(GET(base_url + "?nowait")).body);
+}
@@ -203,6 +203,12 @@ struct RecursiveTypeTraverser {
     return CalculateTypeID(result);
   }
 
+  // An `InlineVariant` has the same type ID as the respective `Variant`.
+  template <typename NAME, typename... TS>
+  TypeID operator()(TypeSelector<InlineVariantImpl<NAME, TypeListImpl<TS...>>>) {
+    return operator()(TypeSelector<VariantImpl<NAME, TypeListImpl<TS...>>>());
+  }
+
   template <typename T>
   std::enable_if_t<IS_CURRENT_STRUCT(T), TypeID> operator()(TypeSelector<T>) {
     ReflectedType_Struct result;
@@ -471,6 +477,11 @@ struct ReflectorImpl {
     return ReflectedType(std::move(result));
   }
 
+  template <typename NAME, typename... TS>
+  ReflectedType operator()(TypeSelector<InlineVariantImpl<NAME, TypeListImpl<TS...>>>) {
+    return operator()(TypeSelector<VariantImpl<NAME, TypeListImpl<TS...>>>());
+  }
+
   template <typename T>
   std::enable_if_t<IS_CURRENT_STRUCT(T), ReflectedType> operator()(TypeSelector<T>) {
     ReflectedType_Struct s;
@@ -0,0 +1,316 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// The compact binary format for Current types.
+//
+// * Integers, floating point numbers, `bool`-s, and `std::chrono::*` types are stored as is, in the host byte order.
+//   No byte swapping is done, so the blobs are only portable across the hosts of the same endianness.
+// * String and container lengths, as well as `Variant` case indexes, are varint-encoded (LEB128).
+// * `CURRENT_STRUCT`-s are stored as their fields in the order of declaration, base class fields first, no names.
+// * `Optional`-s are stored as a presence byte followed by the value, if any.
+//
+// The format carries no field names, and thus no schema. `BinarySerialize()` and `BinaryParse()` prepend and
+// validate a header with the `TypeID` of the top-level type, so that a blob is never parsed into the wrong type.
+// `SaveIntoBinary()` and `LoadFromBinary()` operate on the raw, header-less, representation, for the users
+// who keep the schema elsewhere, e.g., once per file.
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
+
+#include <algorithm>
+#include <cstring>
+#include <istream>
+#include <ostream>
+#include <string>
+
+#include "exceptions.h"
+
+#include "../serialization.h"
+
+#include "../../struct.h"
+#include "../../optional.h"
+#include "../../helpers.h"
+#include "../../reflection/reflection.h"
+
+#include "../../../bricks/strings/chunk.h"
+
+namespace current {
+namespace serialization {
+namespace binary {
+
+// The first byte of the header of each `BinarySerialize()`-d blob, followed by the 64-bit `TypeID`.
+constexpr uint8_t kBinaryFormatVersion = 1u;
+constexpr size_t kBinaryHeaderSize = sizeof(uint8_t) + sizeof(uint64_t);
+
+// The most memory to allocate ahead of reading the data from a stream, the length of which is not known upfront.
+constexpr size_t kBinaryMaxStreamPreallocationBytes = 1u << 20;
+
+// Appends the binary representation to an `std::string`, which can be reused across calls to avoid allocations.
+class BinarySerializer final {
+ public:
+  explicit BinarySerializer(std::string& output) : output_(output) {}
+
+  void Write(const void* data, size_t size) { output_.append(reinterpret_cast<const char*>(data), size); }
+
+  template <typename T>
+  void WritePOD(T value) {
+    Write(&value, sizeof(T));
+  }
+
+  void WriteVarInt(uint64_t value) {
+    char buffer[10];
+    size_t size = 0u;
+    while (value >= 0x80u) {
+      buffer[size++] = static_cast<char>((value & 0x7fu) | 0x80u);
+      value >>= 7;
+    }
+    buffer[size++] = static_cast<char>(value);
+    output_.append(buffer, size);
+  }
+
+ private:
+  std::string& output_;
+};
+
+// Reads from a contiguous block of memory, without copying it.
+class BinaryMemorySource final {
+ public:
+  BinaryMemorySource(const char* begin, size_t size) : current_(begin), end_(begin + size) {}
+
+  void Read(void* destination, size_t size) {
+    EnsureAvailable(size);
+    std::memcpy(destination, current_, size);
+    current_ += size;
+  }
+
+  void ReadString(std::string& destination, size_t size) {
+    EnsureAvailable(size);
+    destination.assign(current_, size);
+    current_ += size;
+  }
+
+  size_t BytesLeft() const { return static_cast<size_t>(end_ - current_); }
+  size_t PreallocationLimitBytes() const { return BytesLeft(); }
+
+ private:
+  void EnsureAvailable(size_t size) const {
+    if (static_cast<size_t>(end_ - current_) < size) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Unexpected end of binary input."));
+    }
+  }
+
+  const char* current_;
+  const char* const end_;
+};
+
+// Reads from an `std::istream`, consuming exactly as many bytes as the object occupies.
+class BinaryStreamSource final {
+ public:
+  explicit BinaryStreamSource(std::istream& is) : is_(is) {}
+
+  void Read(void* destination, size_t size) {
+    is_.read(reinterpret_cast<char*>(destination), static_cast<std::streamsize>(size));
+    if (static_cast<size_t>(is_.gcount()) != size) {
+      CURRENT_THROW(BinaryLoadFromStreamException("Unexpected end of binary stream."));
+    }
+  }
+
+  void ReadString(std::string& destination, size_t size) {
+    destination.clear();
+    while (destination.length() < size) {
+      const size_t offset = destination.length();
+      const size_t chunk = std::min(size - offset, kBinaryMaxStreamPreallocationBytes);
+      destination.resize(offset + chunk);
+      Read(&destination[offset], chunk);
+    }
+  }
+
+  size_t PreallocationLimitBytes() const { return kBinaryMaxStreamPreallocationBytes; }
+
+ private:
+  std::istream& is_;
+};
+
+template <class SOURCE>
+class BinaryDeserializer final {
+ public:
+  template <typename... ARGS>
+  explicit BinaryDeserializer(ARGS&&... args) : source_(std::forward<ARGS>(args)...) {}
+
+  void Read(void* destination, size_t size) { source_.Read(destination, size); }
+
+  template <typename T>
+  T ReadPOD() {
+    T value;
+    Read(&value, sizeof(T));
+    return value;
+  }
+
+  uint64_t ReadVarInt() {
+    uint64_t result = 0u;
+    for (int shift = 0; shift < 64; shift += 7) {
+      uint8_t byte;
+      Read(&byte, 1u);
+      result |= static_cast<uint64_t>(byte & 0x7fu) << shift;
+      if (!(byte & 0x80u)) {
+        return result;
+      }
+    }
+    CURRENT_THROW(BinaryMalformedDataException("Varint is too long."));
+  }
+
+  void ReadString(std::string& destination, size_t size) { source_.ReadString(destination, size); }
+
+  // The number of elements it is safe to allocate ahead of reading `size` of them. The sizes in the input are not
+  // trusted beyond what the input left can hold, so that a corrupt blob does not result in a huge allocation.
+  template <typename T>
+  size_t ElementsToPreallocate(uint64_t size) const {
+    return static_cast<size_t>(std::min<uint64_t>(size, source_.PreallocationLimitBytes() / sizeof(T)));
+  }
+
+  SOURCE& Source() { return source_; }
+
+ private:
+  SOURCE source_;
+};
+
+template <typename T>
+inline void SaveIntoBinary(std::string& output, const T& source) {
+  BinarySerializer binary_serializer(output);
+  Serialize(binary_serializer, source);
+}
+
+template <typename T>
+inline void SaveIntoBinary(std::ostream& os, const T& source) {
+  std::string output;
+  SaveIntoBinary(output, source);
+  os.write(output.data(), static_cast<std::streamsize>(output.length()));
+}
+
+template <typename T>
+inline void LoadFromBinary(std::istream& is, T& destination) {
+  BinaryDeserializer<BinaryStreamSource> binary_deserializer(is);
+  Deserialize(binary_deserializer, destination);
+  CheckIntegrity(destination);
+}
+
+template <typename T>
+inline T LoadFromBinary(std::istream& is) {
+  T result;
+  LoadFromBinary(is, result);
+  return result;
+}
+
+// Parses the header-less representation, which must span the whole `[data, data + size)` range.
+template <typename T>
+inline void LoadFromBinary(const char* data, size_t size, T& destination) {
+  BinaryDeserializer<BinaryMemorySource> binary_deserializer(data, size);
+  Deserialize(binary_deserializer, destination);
+  if (binary_deserializer.Source().BytesLeft()) {
+    CURRENT_THROW(BinaryMalformedDataException("Trailing bytes after the binary object."));
+  }
+  CheckIntegrity(destination);
+}
+
+template <typename T>
+inline T LoadFromBinary(const char* data, size_t size) {
+  T result;
+  LoadFromBinary(data, size, result);
+  return result;
+}
+
+template <typename T>
+reflection::TypeID BinarySchemaTypeID() {
+  static const reflection::TypeID type_id = reflection::CurrentTypeID<T>();
+  return type_id;
+}
+
+template <typename T>
+inline void BinarySerialize(const T& source, std::string& output) {
+  BinarySerializer binary_serializer(output);
+  binary_serializer.WritePOD(kBinaryFormatVersion);
+  binary_serializer.WritePOD(static_cast<uint64_t>(BinarySchemaTypeID<T>()));
+  Serialize(binary_serializer, source);
+}
+
+template <typename T>
+inline std::string BinarySerialize(const T& source) {
+  std::string output;
+  BinarySerialize(source, output);
+  return output;
+}
+
+template <typename T>
+inline void BinaryParse(const char* data, size_t size, T& destination) {
+  if (size < kBinaryHeaderSize) {
+    CURRENT_THROW(BinaryLoadFromStreamException("Binary input is shorter than its header."));
+  }
+  if (static_cast<uint8_t>(data[0]) != kBinaryFormatVersion) {
+    CURRENT_THROW(BinarySchemaMismatchException("Unsupported binary format version."));
+  }
+  uint64_t type_id;
+  std::memcpy(&type_id, data + sizeof(uint8_t), sizeof(uint64_t));
+  if (static_cast<reflection::TypeID>(type_id) != BinarySchemaTypeID<T>()) {
+    CURRENT_THROW(BinarySchemaMismatchException("Binary input was serialized from a different type."));
+  }
+  try {
+    LoadFromBinary(data + kBinaryHeaderSize, size - kBinaryHeaderSize, destination);
+  } catch (UninitializedVariant) {
+    CURRENT_THROW(BinaryUninitializedVariantObjectException());
+  }
+}
+
+template <typename T>
+inline T BinaryParse(const char* data, size_t size) {
+  T result;
+  BinaryParse(data, size, result);
+  return result;
+}
+
+template <typename T>
+inline T BinaryParse(const std::string& source) {
+  return BinaryParse<T>(source.data(), source.length());
+}
+
+template <typename T>
+inline T BinaryParse(const strings::Chunk& source) {
+  return BinaryParse<T>(source.c_str(), source.length());
+}
+
+}  // namespace binary
+}  // namespace serialization
+
+// Keep top-level symbols both in `current::` and in global namespace.
+using serialization::binary::BinaryParse;
+using serialization::binary::BinarySerialize;
+using serialization::binary::LoadFromBinary;
+using serialization::binary::SaveIntoBinary;
+}  // namespace current
+
+using current::BinaryParse;
+using current::BinarySerialize;
+using current::LoadFromBinary;
+using current::SaveIntoBinary;
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_BINARY_H
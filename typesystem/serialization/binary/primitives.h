@@ -0,0 +1,108 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
+
+#include <chrono>
+#include <string>
+#include <type_traits>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+// Integers, `char`, `float`, and `double` are stored as is.
+template <typename T>
+struct SerializeImpl<binary::BinarySerializer,
+                     T,
+                     std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, T value) { binary_serializer.WritePOD(value); }
+};
+
+template <class SOURCE, typename T>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>,
+                       T,
+                       std::enable_if_t<std::is_arithmetic_v<T> && !std::is_same_v<T, bool>>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer, T& destination) {
+    binary_deserializer.Read(&destination, sizeof(T));
+  }
+};
+
+// `bool` is stored as a single byte, which must be zero or one.
+template <>
+struct SerializeImpl<binary::BinarySerializer, bool> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, bool value) {
+    binary_serializer.WritePOD(static_cast<uint8_t>(value ? 1u : 0u));
+  }
+};
+
+template <class SOURCE>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, bool> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer, bool& destination) {
+    const uint8_t value = binary_deserializer.template ReadPOD<uint8_t>();
+    if (value > 1u) {
+      CURRENT_THROW(BinaryMalformedDataException("Expected `bool` as zero or one."));
+    }
+    destination = (value != 0u);
+  }
+};
+
+// `std::string` is stored as its varint-encoded length followed by the bytes.
+template <>
+struct SerializeImpl<binary::BinarySerializer, std::string> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const std::string& value) {
+    binary_serializer.WriteVarInt(value.length());
+    binary_serializer.Write(value.data(), value.length());
+  }
+};
+
+template <class SOURCE>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, std::string> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer, std::string& destination) {
+    binary_deserializer.ReadString(destination, static_cast<size_t>(binary_deserializer.ReadVarInt()));
+  }
+};
+
+// `std::chrono::milliseconds` and `std::chrono::microseconds` are stored as 64-bit signed integers.
+template <typename R, typename P>
+struct SerializeImpl<binary::BinarySerializer, std::chrono::duration<R, P>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, std::chrono::duration<R, P> value) {
+    binary_serializer.WritePOD(static_cast<int64_t>(value.count()));
+  }
+};
+
+template <class SOURCE, typename R, typename P>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, std::chrono::duration<R, P>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer,
+                            std::chrono::duration<R, P>& destination) {
+    destination = std::chrono::duration<R, P>(static_cast<R>(binary_deserializer.template ReadPOD<int64_t>()));
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_PRIMITIVES_H
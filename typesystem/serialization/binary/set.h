@@ -0,0 +1,62 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_SET_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_SET_H
+
+#include <set>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+template <typename T, class EQ, class ALLOCATOR>
+struct SerializeImpl<binary::BinarySerializer, std::set<T, EQ, ALLOCATOR>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const std::set<T, EQ, ALLOCATOR>& value) {
+    binary_serializer.WriteVarInt(value.size());
+    for (const auto& element : value) {
+      Serialize(binary_serializer, element);
+    }
+  }
+};
+
+template <class SOURCE, typename T, class EQ, class ALLOCATOR>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, std::set<T, EQ, ALLOCATOR>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer,
+                            std::set<T, EQ, ALLOCATOR>& destination) {
+    destination.clear();
+    const size_t size = static_cast<size_t>(binary_deserializer.ReadVarInt());
+    for (size_t i = 0; i < size; ++i) {
+      T element;
+      Deserialize(binary_deserializer, element);
+      destination.insert(destination.end(), std::move(element));
+    }
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_SET_H
@@ -0,0 +1,112 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_STRUCT_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_STRUCT_H
+
+#include <type_traits>
+
+#include "binary.h"
+
+#include "../../reflection/reflection.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+class BinaryStructFieldsSerializer {
+ public:
+  explicit BinaryStructFieldsSerializer(BinarySerializer& binary_serializer) : binary_serializer_(binary_serializer) {}
+
+  template <typename U>
+  void operator()(const char*, const U& source) const {
+    Serialize(binary_serializer_, source);
+  }
+
+ private:
+  BinarySerializer& binary_serializer_;
+};
+
+template <class SOURCE>
+class BinaryStructFieldsDeserializer {
+ public:
+  explicit BinaryStructFieldsDeserializer(BinaryDeserializer<SOURCE>& binary_deserializer)
+      : binary_deserializer_(binary_deserializer) {}
+
+  template <typename U>
+  void operator()(const char*, U& destination) const {
+    Deserialize(binary_deserializer_, destination);
+  }
+
+ private:
+  BinaryDeserializer<SOURCE>& binary_deserializer_;
+};
+}  // namespace binary
+
+template <>
+struct SerializeImpl<binary::BinarySerializer, CurrentStruct> {
+  static void DoSerialize(binary::BinarySerializer&, const CurrentStruct&) {}
+};
+
+template <typename T>
+struct SerializeImpl<binary::BinarySerializer,
+                     T,
+                     std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same_v<T, CurrentStruct>>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const T& value) {
+    using decayed_t = current::decay_t<T>;
+    using super_t = current::reflection::SuperType<decayed_t>;
+
+    if (!std::is_same_v<super_t, CurrentStruct>) {
+      Serialize(binary_serializer, static_cast<const super_t&>(value));
+    }
+    current::reflection::VisitAllFields<decayed_t, current::reflection::FieldNameAndImmutableValue>::WithObject(
+        value, binary::BinaryStructFieldsSerializer(binary_serializer));
+  }
+};
+
+template <class SOURCE>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, CurrentStruct> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>&, CurrentStruct&) {}
+};
+
+template <class SOURCE, typename T>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>,
+                       T,
+                       std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same_v<T, CurrentStruct>>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer, T& destination) {
+    using decayed_t = current::decay_t<T>;
+    using super_t = current::reflection::SuperType<decayed_t>;
+
+    if (!std::is_same_v<super_t, CurrentStruct>) {
+      Deserialize(binary_deserializer, static_cast<super_t&>(destination));
+    }
+    current::reflection::VisitAllFields<decayed_t, current::reflection::FieldNameAndMutableValue>::WithObject(
+        destination, binary::BinaryStructFieldsDeserializer<SOURCE>(binary_deserializer));
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_STRUCT_H
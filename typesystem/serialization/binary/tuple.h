@@ -0,0 +1,79 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_TUPLE_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_TUPLE_H
+
+#include <tuple>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+template <class TUPLE, int I, int N>
+struct SerializeBinaryTupleImpl {
+  static void DoIt(binary::BinarySerializer& binary_serializer, const TUPLE& value) {
+    Serialize(binary_serializer, std::get<I>(value));
+    SerializeBinaryTupleImpl<TUPLE, I + 1, N>::DoIt(binary_serializer, value);
+  }
+};
+
+template <class TUPLE, int N>
+struct SerializeBinaryTupleImpl<TUPLE, N, N> {
+  static void DoIt(binary::BinarySerializer&, const TUPLE&) {}
+};
+
+template <typename... TS>
+struct SerializeImpl<binary::BinarySerializer, std::tuple<TS...>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const std::tuple<TS...>& value) {
+    SerializeBinaryTupleImpl<std::tuple<TS...>, 0, sizeof...(TS)>::DoIt(binary_serializer, value);
+  }
+};
+
+template <class SOURCE, class TUPLE, int I, int N>
+struct DeserializeBinaryTupleImpl {
+  static void DoIt(binary::BinaryDeserializer<SOURCE>& binary_deserializer, TUPLE& destination) {
+    Deserialize(binary_deserializer, std::get<I>(destination));
+    DeserializeBinaryTupleImpl<SOURCE, TUPLE, I + 1, N>::DoIt(binary_deserializer, destination);
+  }
+};
+
+template <class SOURCE, class TUPLE, int N>
+struct DeserializeBinaryTupleImpl<SOURCE, TUPLE, N, N> {
+  static void DoIt(binary::BinaryDeserializer<SOURCE>&, TUPLE&) {}
+};
+
+template <class SOURCE, typename... TS>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, std::tuple<TS...>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer,
+                            std::tuple<TS...>& destination) {
+    DeserializeBinaryTupleImpl<SOURCE, std::tuple<TS...>, 0, sizeof...(TS)>::DoIt(binary_deserializer, destination);
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_TUPLE_H
@@ -0,0 +1,67 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_UNORDERED_MAP_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_UNORDERED_MAP_H
+
+#include <unordered_map>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+template <typename TK, typename TV, class HASH, class EQ, class ALLOCATOR>
+struct SerializeImpl<binary::BinarySerializer, std::unordered_map<TK, TV, HASH, EQ, ALLOCATOR>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer,
+                          const std::unordered_map<TK, TV, HASH, EQ, ALLOCATOR>& value) {
+    binary_serializer.WriteVarInt(value.size());
+    for (const auto& element : value) {
+      Serialize(binary_serializer, element.first);
+      Serialize(binary_serializer, element.second);
+    }
+  }
+};
+
+template <class SOURCE, typename TK, typename TV, class HASH, class EQ, class ALLOCATOR>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, std::unordered_map<TK, TV, HASH, EQ, ALLOCATOR>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer,
+                            std::unordered_map<TK, TV, HASH, EQ, ALLOCATOR>& destination) {
+    destination.clear();
+    const uint64_t size = binary_deserializer.ReadVarInt();
+    destination.reserve(binary_deserializer.template ElementsToPreallocate<std::pair<TK, TV>>(size));
+    for (uint64_t i = 0; i < size; ++i) {
+      TK k;
+      TV v;
+      Deserialize(binary_deserializer, k);
+      Deserialize(binary_deserializer, v);
+      destination.emplace(std::move(k), std::move(v));
+    }
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_UNORDERED_MAP_H
@@ -0,0 +1,133 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+// Binary format for `Variant` objects:
+// * A varint, which is zero for an uninitialized `Variant`, and one plus the index of the case in the type list
+//   otherwise.
+// * The serialized case object, if any.
+//
+// Since the case index depends on the order of types in the `Variant`, so does the `TypeID` of the `Variant`,
+// and thus the header of the `BinarySerialize()`-d blob protects against parsing it into a reordered `Variant`.
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
+
+#include <array>
+#include <type_traits>
+
+#include "binary.h"
+
+#include "../../variant.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+
+template <typename T, typename TYPELIST>
+struct BinaryVariantCaseIndex;
+
+template <typename T, typename... TS>
+struct BinaryVariantCaseIndex<T, TypeListImpl<T, TS...>> {
+  constexpr static uint64_t value = 0u;
+};
+
+template <typename T, typename X, typename... TS>
+struct BinaryVariantCaseIndex<T, TypeListImpl<X, TS...>> {
+  constexpr static uint64_t value = 1u + BinaryVariantCaseIndex<T, TypeListImpl<TS...>>::value;
+};
+
+template <typename VARIANT>
+class BinaryVariantSerializer {
+ public:
+  explicit BinaryVariantSerializer(BinarySerializer& binary_serializer) : binary_serializer_(binary_serializer) {}
+
+  template <typename X>
+  void operator()(const X& object) {
+    binary_serializer_.WriteVarInt(1u + BinaryVariantCaseIndex<X, typename VARIANT::typelist_t>::value);
+    Serialize(binary_serializer_, object);
+  }
+
+ private:
+  BinarySerializer& binary_serializer_;
+};
+
+template <class SOURCE, typename TYPELIST>
+struct BinaryVariantDeserializers;
+
+// A jump table, indexed by the case index, to construct and deserialize the right case of the `Variant`.
+template <class SOURCE, typename... TS>
+struct BinaryVariantDeserializers<SOURCE, TypeListImpl<TS...>> {
+  using deserializer_t = void (*)(BinaryDeserializer<SOURCE>&, IHasUncheckedMoveFromUniquePtr&);
+
+  template <typename X>
+  static void DeserializeCase(BinaryDeserializer<SOURCE>& binary_deserializer,
+                              IHasUncheckedMoveFromUniquePtr& destination) {
+    auto result = std::make_unique<X>();
+    Deserialize(binary_deserializer, *result);
+    destination.UncheckedMoveFromUniquePtr(std::move(result));
+  }
+
+  static void DoLoadVariant(BinaryDeserializer<SOURCE>& binary_deserializer,
+                            IHasUncheckedMoveFromUniquePtr& destination,
+                            uint64_t case_index) {
+    static const std::array<deserializer_t, sizeof...(TS)> deserializers = {{&DeserializeCase<TS>...}};
+    if (case_index < sizeof...(TS)) {
+      deserializers[static_cast<size_t>(case_index)](binary_deserializer, destination);
+    } else {
+      CURRENT_THROW(BinaryMalformedDataException("Variant case index is out of range."));
+    }
+  }
+};
+
+}  // namespace binary
+
+template <typename T>
+struct SerializeImpl<binary::BinarySerializer, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const T& value) {
+    if (Exists(value)) {
+      binary::BinaryVariantSerializer<T> impl(binary_serializer);
+      value.Call(impl);
+    } else {
+      binary_serializer.WriteVarInt(0u);
+    }
+  }
+};
+
+template <class SOURCE, typename T>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, T, std::enable_if_t<IS_CURRENT_VARIANT(T)>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer, T& value) {
+    const uint64_t index_plus_one = binary_deserializer.ReadVarInt();
+    if (!index_plus_one) {
+      CURRENT_THROW(BinaryUninitializedVariantObjectException());
+    }
+    binary::BinaryVariantDeserializers<SOURCE, typename T::typelist_t>::DoLoadVariant(
+        binary_deserializer, value, index_plus_one - 1u);
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VARIANT_H
@@ -0,0 +1,111 @@
+/*******************************************************************************
+The MIT License (MIT)
+
+Copyright (c) 2026 Dmitry "Dima" Korolev <dmitry.korolev@gmail.com>
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in all
+copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN THE
+SOFTWARE.
+*******************************************************************************/
+
+#ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VECTOR_H
+#define CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VECTOR_H
+
+#include <type_traits>
+#include <vector>
+
+#include "binary.h"
+
+namespace current {
+namespace serialization {
+
+namespace binary {
+// Vectors of numbers are written and read as a single block of memory, not element by element.
+template <typename T>
+struct IsBinaryBlockCopyable {
+  constexpr static bool value = std::is_arithmetic_v<T> && !std::is_same_v<T, bool>;
+};
+}  // namespace binary
+
+template <typename T, typename TA>
+struct SerializeImpl<binary::BinarySerializer, std::vector<T, TA>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const std::vector<T, TA>& value) {
+    binary_serializer.WriteVarInt(value.size());
+    if constexpr (binary::IsBinaryBlockCopyable<T>::value) {
+      binary_serializer.Write(value.data(), sizeof(T) * value.size());
+    } else {
+      for (const auto& element : value) {
+        Serialize(binary_serializer, element);
+      }
+    }
+  }
+};
+
+template <typename TA>
+struct SerializeImpl<binary::BinarySerializer, std::vector<bool, TA>> {
+  static void DoSerialize(binary::BinarySerializer& binary_serializer, const std::vector<bool, TA>& value) {
+    binary_serializer.WriteVarInt(value.size());
+    for (const auto&& element : value) {
+      const bool tmp = element;
+      Serialize(binary_serializer, tmp);
+    }
+  }
+};
+
+template <class SOURCE, typename T, typename TA>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, std::vector<T, TA>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer,
+                            std::vector<T, TA>& destination) {
+    const uint64_t size = binary_deserializer.ReadVarInt();
+    destination.clear();
+    if constexpr (binary::IsBinaryBlockCopyable<T>::value) {
+      // Grow the vector as the input is read, so that the input running out stops an oversized vector early.
+      while (destination.size() < size) {
+        const size_t offset = destination.size();
+        const size_t chunk = std::max<size_t>(binary_deserializer.template ElementsToPreallocate<T>(size - offset), 1u);
+        destination.resize(offset + chunk);
+        binary_deserializer.Read(destination.data() + offset, sizeof(T) * chunk);
+      }
+    } else {
+      destination.reserve(binary_deserializer.template ElementsToPreallocate<T>(size));
+      for (uint64_t i = 0; i < size; ++i) {
+        destination.emplace_back();
+        Deserialize(binary_deserializer, destination.back());
+      }
+    }
+  }
+};
+
+template <class SOURCE, typename TA>
+struct DeserializeImpl<binary::BinaryDeserializer<SOURCE>, std::vector<bool, TA>> {
+  static void DoDeserialize(binary::BinaryDeserializer<SOURCE>& binary_deserializer,
+                            std::vector<bool, TA>& destination) {
+    const uint64_t size = binary_deserializer.ReadVarInt();
+    destination.clear();
+    destination.reserve(binary_deserializer.template ElementsToPreallocate<uint8_t>(size));
+    for (uint64_t i = 0; i < size; ++i) {
+      bool tmp;
+      Deserialize(binary_deserializer, tmp);
+      destination.push_back(tmp);
+    }
+  }
+};
+
+}  // namespace serialization
+}  // namespace current
+
+#endif  // CURRENT_TYPE_SYSTEM_SERIALIZATION_BINARY_VECTOR_H
@@ -35,12 +35,11 @@ namespace serialization {
 template <class JSON_FORMAT, typename T, size_t N>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::array<T, N>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const std::array<T, N>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.StartArray();
     for (const auto& element : value) {
-      rapidjson::Value element_to_push;
-      json_stringifier.Inner(&element_to_push, element);
-      json_stringifier.Current().PushBack(std::move(element_to_push.Move()), json_stringifier.Allocator());
+      json_stringifier.Inner(element);
     }
+    json_stringifier.EndArray();
   }
 };
 
@@ -26,6 +26,9 @@ SOFTWARE.
 #ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_JSON_H
 #define CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_JSON_H
 
+#include <cstring>
+#include <string>
+
 #include "exceptions.h"
 #include "rapidjson.h"
 
@@ -119,64 +122,130 @@ struct IsJSONSerializableImpl<false, false, false, T> {
   constexpr static bool value = false;
 };
 
-// For RapidJSON value assignments, specifically strings (use `SetString`, not `SetValue`) and `std::chrono::*`.
+// The output stream for `rapidjson::Writer<>`, appending the JSON directly to an `std::string`.
+class JSONStringOutputStream final {
+ public:
+  using Ch = char;
+  explicit JSONStringOutputStream(std::string& output) : output_(output) {}
+  void Put(char c) { output_.push_back(c); }
+  void Flush() {}
+
+ private:
+  std::string& output_;
+};
+
+using json_writer_t = rapidjson::Writer<JSONStringOutputStream>;
+
+// For scalar values, specifically strings and `std::chrono::*`. The choice of the number-writing method
+// follows what `rapidjson::Document::Accept()` would do, so that the output is byte-for-byte the same.
 template <typename T>
 struct JSONValueAssignerImpl {
-  static void AssignValue(rapidjson::Value& destination, current::copy_free<T> value) { destination = value; }
+  static void AssignValue(json_writer_t& writer, current::copy_free<T> value) {
+    if constexpr (std::is_same_v<T, bool>) {
+      writer.Bool(value);
+    } else if constexpr (std::is_floating_point_v<T>) {
+      writer.Double(static_cast<double>(value));
+    } else if constexpr (std::is_signed_v<T>) {
+      writer.Int64(static_cast<int64_t>(value));
+    } else {
+      writer.Uint64(static_cast<uint64_t>(value));
+    }
+  }
 };
 
+// The streaming JSON serializer. Walks the object and emits JSON directly into the output string,
+// with no intermediate DOM. The output can be an existing `std::string`, which is then appended to.
+//
+// Absent values (`Variant`-s or `Optional`-s in certain formats) are supported by deferring the key:
+// the key of an object member is only written out along with the first token of its value,
+// and is dropped if the value turns out to be absent.
 template <class JSON_FORMAT>
 class JSONStringifier final {
  public:
-  JSONStringifier() {
-    // Can't assign in the initializer list, `current_` is the field before `document_`.
-    // And I've confirmed keeping `document_` first results in performance degradation. -- D.K.
-    current_ = &document_;
-  }
-
-  rapidjson::Value& Current() { return *current_; }
-  rapidjson::Document::AllocatorType& Allocator() { return document_.GetAllocator(); }
+  JSONStringifier() : output_stream_(owned_output_), writer_(output_stream_) {}
+  explicit JSONStringifier(std::string& output) : output_stream_(output), writer_(output_stream_) {}
 
   template <typename T>
   void operator=(T&& x) {
-    JSONValueAssignerImpl<current::decay_t<T>>::AssignValue(*current_, std::forward<T>(x));
+    WritePendingKey();
+    JSONValueAssignerImpl<current::decay_t<T>>::AssignValue(writer_, std::forward<T>(x));
+  }
+
+  void SetNull() {
+    WritePendingKey();
+    writer_.Null();
+  }
+
+  void SetString(const char* s, size_t length) {
+    WritePendingKey();
+    writer_.String(s, static_cast<rapidjson::SizeType>(length));
+  }
+
+  void StartObject() {
+    WritePendingKey();
+    writer_.StartObject();
+  }
+  void EndObject() { writer_.EndObject(); }
+
+  void StartArray() {
+    WritePendingKey();
+    writer_.StartArray();
+  }
+  void EndArray() { writer_.EndArray(); }
+
+  // The key of the next member of the current object. The key must outlive the serialization of its value.
+  void Key(const char* key) { Key(key, strlen(key)); }
+  void Key(const std::string& key) { Key(key.c_str(), key.length()); }
+  void Key(const char* key, size_t length) {
+    pending_key_ = key;
+    pending_key_length_ = length;
   }
 
   // Serialize another object, in an inner scope. The object is guaranteed to result in a valid value.
+  // Absent values become `null`-s, the same way they would in an array.
   template <typename T>
-  void Inner(rapidjson::Value* inner_value, T&& x) {
-    std::swap(current_, inner_value);
+  void Inner(T&& x) {
     Serialize(*this, std::forward<T>(x));
-    std::swap(current_, inner_value);
+    if (absent_) {
+      absent_ = false;
+      SetNull();
+    }
   }
 
-  // Serialize another object, in an inner scope. The object may end up a no-op, which should be ignored.
+  // Serialize another object as the member of the current object under `key`.
+  // The object may end up a no-op, which should be ignored, along with its key.
   // Example: A `Variant` or `Optional` in the `Minimalistic` format.
-  void MarkAsAbsentValue() { current_ = nullptr; }
+  void MarkAsAbsentValue() { absent_ = true; }
   template <typename T>
-  bool MaybeInner(rapidjson::Value* inner_value, T&& x) {
-    rapidjson::Value* previous = current_;
-    current_ = inner_value;
+  bool MaybeInner(const char* key, T&& x) {
+    Key(key);
     Serialize(*this, std::forward<T>(x));
-    if (current_) {
-      current_ = previous;
+    if (!absent_) {
       return true;
     } else {
-      current_ = previous;
+      absent_ = false;
+      pending_key_ = nullptr;
       return false;
     }
   }
 
-  std::string ResultingJSON() const {
-    rapidjson::StringBuffer string_buffer;
-    rapidjson::Writer<rapidjson::StringBuffer> writer(string_buffer);
-    document_.Accept(writer);
-    return string_buffer.GetString();
-  }
+  // Only meaningful when the stringifier owns its output, i.e. was constructed with no arguments.
+  std::string ResultingJSON() { return std::move(owned_output_); }
 
  private:
-  rapidjson::Value* current_;
-  rapidjson::Document document_;
+  void WritePendingKey() {
+    if (pending_key_) {
+      writer_.Key(pending_key_, static_cast<rapidjson::SizeType>(pending_key_length_));
+      pending_key_ = nullptr;
+    }
+  }
+
+  std::string owned_output_;
+  JSONStringOutputStream output_stream_;
+  json_writer_t writer_;
+  const char* pending_key_ = nullptr;
+  size_t pending_key_length_ = 0u;
+  bool absent_ = false;
 };
 
 enum class JSONVariantStyle : int { Current, Simple, NewtonsoftFSharp };
@@ -241,9 +310,13 @@ struct JSONPatchMode<JSONPatcher<J>> {
 template <class JSON_FORMAT>
 class JSONParser final {
  public:
-  explicit JSONParser(const char* json) {
-    if (document_.Parse(json).HasParseError()) {
-      CURRENT_THROW(InvalidJSONException(json));
+  explicit JSONParser(const char* json) : JSONParser(json, std::strlen(json)) {}
+
+  // Parses in situ: the input is copied once into `buffer_`, and the strings of the DOM point into it,
+  // so no per-string allocations are made. Also, `json` does not have to be null-terminated.
+  JSONParser(const char* json, size_t length) : buffer_(json, length) {
+    if (document_.ParseInsitu(&buffer_[0]).HasParseError()) {
+      CURRENT_THROW(InvalidJSONException(std::string(json, length)));
     }
     current_ = &document_;
   }
@@ -320,6 +393,7 @@ class JSONParser final {
  private:
   rapidjson::Value* current_;
   std::vector<CharPtrOrInt> path_;
+  std::string buffer_;  // Must outlive `document_`, as the in-situ parsed strings point into it.
   rapidjson::Document document_;
 };
 
@@ -329,13 +403,26 @@ void ParseJSONViaRapidJSON(const char* json, T& destination) {
   Deserialize(json_parser, destination);
 }
 
+template <class J, typename T>
+void ParseJSONViaRapidJSON(const char* json, size_t length, T& destination) {
+  JSONParser<J> json_parser(json, length);
+  Deserialize(json_parser, destination);
+}
+
 template <class J = JSONFormat::Current, typename T>
 inline std::string JSON(const T& source) {
   JSONStringifier<J> json_stringifier;
-  Serialize(json_stringifier, source);
+  json_stringifier.Inner(source);
   return json_stringifier.ResultingJSON();
 }
 
+// Appends the JSON of `source` to `output`, with no temporary strings. Useful for reusable buffers.
+template <class J = JSONFormat::Current, typename T>
+inline void AppendJSON(std::string& output, const T& source) {
+  JSONStringifier<J> json_stringifier(output);
+  json_stringifier.Inner(source);
+}
+
 template <class J = JSONFormat::Current>
 inline std::string JSON(const char* special_case_bare_c_string) {
   return JSON<J>(std::string(special_case_bare_c_string));
@@ -351,9 +438,21 @@ inline void ParseJSON(const char* source, T& destination) {
   }
 }
 
+// Parses the `[source, source + length)` range, which does not have to be null-terminated.
+// Use it to parse a part of a line, i.e. before or after the tab, without creating a substring.
+template <typename T, class J = JSONFormat::Current>
+inline void ParseJSON(const char* source, size_t length, T& destination) {
+  try {
+    ParseJSONViaRapidJSON<J>(source, length, destination);
+    CheckIntegrity(destination);
+  } catch (UninitializedVariant) {
+    CURRENT_THROW(JSONUninitializedVariantObjectException());
+  }
+}
+
 template <typename T, class J = JSONFormat::Current>
 inline void ParseJSON(const std::string& source, T& destination) {
-  ParseJSON(source.c_str(), destination);
+  ParseJSON<T, J>(source.c_str(), source.length(), destination);
 }
 
 template <typename T, class J = JSONFormat::Current>
@@ -389,9 +488,16 @@ inline T ParseJSON(const char* source) {
   return result;
 }
 
+template <typename T, class J = JSONFormat::Current>
+inline T ParseJSON(const char* source, size_t length) {
+  T result;
+  ParseJSON<T, J>(source, length, result);
+  return result;
+}
+
 template <typename T, class J = JSONFormat::Current>
 inline T ParseJSON(const std::string& source) {
-  return ParseJSON<T, J>(source.c_str());
+  return ParseJSON<T, J>(source.c_str(), source.length());
 }
 
 template <typename T, class J = JSONFormat::Current>
@@ -424,6 +530,7 @@ inline Optional<T> TryParseJSON(const strings::Chunk& source) {
 }  // namespace serialization
 
 // Keep top-level symbols both in `current::` and in global namespace.
+using serialization::json::AppendJSON;
 using serialization::json::InvalidJSONException;
 using serialization::json::JSON;
 using serialization::json::JSONFormat;
@@ -435,6 +542,7 @@ using serialization::json::TryParseJSON;
 using serialization::json::TypeSystemParseJSONException;
 }  // namespace current
 
+using current::AppendJSON;
 using current::InvalidJSONException;
 using current::JSON;
 using current::JSONFormat;
@@ -37,18 +37,14 @@ namespace serialization {
 template <class JSON_FORMAT, typename TK, typename TV, typename TC, typename TA>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::map<TK, TV, TC, TA>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const std::map<TK, TV, TC, TA>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.StartArray();
     for (const auto& element : value) {
-      rapidjson::Value key_value_as_array;
-      key_value_as_array.SetArray();
-      rapidjson::Value populated_key;
-      rapidjson::Value populated_value;
-      json_stringifier.Inner(&populated_key, element.first);
-      json_stringifier.Inner(&populated_value, element.second);
-      key_value_as_array.PushBack(std::move(populated_key.Move()), json_stringifier.Allocator());
-      key_value_as_array.PushBack(std::move(populated_value.Move()), json_stringifier.Allocator());
-      json_stringifier.Current().PushBack(std::move(key_value_as_array.Move()), json_stringifier.Allocator());
+      json_stringifier.StartArray();
+      json_stringifier.Inner(element.first);
+      json_stringifier.Inner(element.second);
+      json_stringifier.EndArray();
     }
+    json_stringifier.EndArray();
   }
 };
 
@@ -56,13 +52,12 @@ template <class JSON_FORMAT, typename TV, typename TC, typename TA>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::map<std::string, TV, TC, TA>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier,
                           const std::map<std::string, TV, TC, TA>& value) {
-    json_stringifier.Current().SetObject();
+    json_stringifier.StartObject();
     for (const auto& element : value) {
-      rapidjson::Value populated_value;
-      json_stringifier.Inner(&populated_value, element.second);
-      json_stringifier.Current().AddMember(
-          rapidjson::StringRef(element.first), std::move(populated_value.Move()), json_stringifier.Allocator());
+      json_stringifier.Key(element.first);
+      json_stringifier.Inner(element.second);
     }
+    json_stringifier.EndObject();
   }
 };
 
@@ -38,12 +38,11 @@ template <class JSON_FORMAT, typename T, class EQ, class ALLOCATOR>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::set<T, EQ, ALLOCATOR>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier,
                           const std::set<T, EQ, ALLOCATOR>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.StartArray();
     for (const auto& element : value) {
-      rapidjson::Value element_to_push;
-      json_stringifier.Inner(&element_to_push, element);
-      json_stringifier.Current().PushBack(std::move(element_to_push.Move()), json_stringifier.Allocator());
+      json_stringifier.Inner(element);
     }
+    json_stringifier.EndArray();
   }
 };
 
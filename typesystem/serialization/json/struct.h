@@ -26,6 +26,7 @@ SOFTWARE.
 #ifndef CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_STRUCT_H
 #define CURRENT_TYPE_SYSTEM_SERIALIZATION_JSON_STRUCT_H
 
+#include <cstring>
 #include <type_traits>
 
 #include "json.h"
@@ -42,15 +43,9 @@ class JSONStructFieldsSerializer {
   explicit JSONStructFieldsSerializer(json::JSONStringifier<JSON_FORMAT>& json_stringifier)
       : json_stringifier_(json_stringifier) {}
 
-  // IMPORTANT: Must take name as `const char* name`, as `const std::string& name`
-  // would fail memory-allocation-wise due to over-smartness of RapidJSON.
   template <typename U>
   void operator()(const char* name, const U& source) const {
-    rapidjson::Value placeholder;
-    if (json_stringifier_.MaybeInner(&placeholder, source)) {
-      json_stringifier_.Current().AddMember(
-          rapidjson::StringRef(name), std::move(placeholder.Move()), json_stringifier_.Allocator());
-    }
+    json_stringifier_.MaybeInner(name, source);
   }
 
  private:
@@ -82,9 +77,10 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>,
                      T,
                      std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same_v<T, CurrentStruct>>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const T& value) {
-    json_stringifier.Current().SetObject();
+    json_stringifier.StartObject();
     json::JSONStructFieldsSerializer<JSON_FORMAT> visitor(json_stringifier);
     json::SerializeStructImpl<JSON_FORMAT, T>::SerializeStruct(visitor, value);
+    json_stringifier.EndObject();
   }
 };
 
@@ -99,14 +95,23 @@ struct DeserializeImpl<json::JSONParser<JSON_FORMAT>,
                        std::enable_if_t<IS_CURRENT_STRUCT(T) && !std::is_same_v<T, CurrentStruct>>> {
   class DeserializeSingleField {
    public:
-    explicit DeserializeSingleField(json::JSONParser<JSON_FORMAT>& json_parser) : json_parser_(json_parser) {}
+    explicit DeserializeSingleField(json::JSONParser<JSON_FORMAT>& json_parser)
+        : json_parser_(json_parser), next_member_(json_parser.Current().MemberBegin()) {}
 
     // IMPORTANT: Must take `name` as `const char* name`, since `const std::string& name`
     // would fail memory-allocation-wise due to over-smartness of RapidJSON.
+    // The fields are usually in the very order they were serialized in, so the member right after the previously
+    // matched one is tried first, and the lookup by name is the fallback.
     template <typename U>
-    void operator()(const char* name, U& value) const {
-      if (json_parser_.Current().HasMember(name)) {
-        json_parser_.Inner(&json_parser_.Current()[name], value, ".", name);
+    void operator()(const char* name, U& value) {
+      rapidjson::Value& object = json_parser_.Current();
+      const size_t name_length = std::strlen(name);
+      if (!(next_member_ != object.MemberEnd() && next_member_->name.GetStringLength() == name_length &&
+            !std::memcmp(next_member_->name.GetString(), name, name_length))) {
+        next_member_ = object.FindMember(rapidjson::StringRef(name, name_length));
+      }
+      if (next_member_ != object.MemberEnd()) {
+        json_parser_.Inner(&(next_member_++)->value, value, ".", name);
       } else {
         json_parser_.Inner(nullptr, value, ".", name);
       }
@@ -114,6 +119,7 @@ struct DeserializeImpl<json::JSONParser<JSON_FORMAT>,
 
    private:
     json::JSONParser<JSON_FORMAT>& json_parser_;
+    rapidjson::Value::MemberIterator next_member_;
   };
 
   static void DoDeserialize(json::JSONParser<JSON_FORMAT>& json_parser, T& destination) {
@@ -124,8 +130,9 @@ struct DeserializeImpl<json::JSONParser<JSON_FORMAT>,
       if (!std::is_same_v<super_t, CurrentStruct>) {
         Deserialize(json_parser, static_cast<super_t&>(destination));
       }
+      DeserializeSingleField visitor(json_parser);
       current::reflection::VisitAllFields<decayed_t, current::reflection::FieldNameAndMutableValue>::WithObject(
-          destination, DeserializeSingleField(json_parser));
+          destination, visitor);
     } else if (!json::JSONPatchMode<JSON_FORMAT>::value || (json_parser && !json_parser.Current().IsObject())) {
       CURRENT_THROW(JSONSchemaException("object", json_parser));  // LCOV_EXCL_LINE
     }
@@ -36,9 +36,7 @@ namespace serialization {
 template <class JSON_FORMAT, class TUPLE, int I, int N>
 struct SerializeTupleImpl {
   static void DoIt(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const TUPLE& value) {
-    rapidjson::Value element_to_push;
-    json_stringifier.Inner(&element_to_push, std::get<I>(value));
-    json_stringifier.Current().PushBack(std::move(element_to_push.Move()), json_stringifier.Allocator());
+    json_stringifier.Inner(std::get<I>(value));
     SerializeTupleImpl<JSON_FORMAT, TUPLE, I + 1, N>::DoIt(json_stringifier, value);
   }
 };
@@ -51,8 +49,9 @@ struct SerializeTupleImpl<JSON_FORMAT, TUPLE, N, N> {
 template <class JSON_FORMAT, typename... TS>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::tuple<TS...>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const std::tuple<TS...>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.StartArray();
     SerializeTupleImpl<JSON_FORMAT, std::tuple<TS...>, 0, sizeof...(TS)>::DoIt(json_stringifier, value);
+    json_stringifier.EndArray();
   }
 };
 
@@ -38,7 +38,8 @@ namespace serialization {
 template <class JSON_FORMAT>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, reflection::TypeID> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, reflection::TypeID value) {
-    json_stringifier.Current().SetString("T" + current::ToString(value), json_stringifier.Allocator());
+    const std::string serialized_type_id = "T" + current::ToString(value);
+    json_stringifier.SetString(serialized_type_id.c_str(), serialized_type_id.length());
   }
 };
 
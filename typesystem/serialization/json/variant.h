@@ -60,29 +60,21 @@ class JSONVariantSerializer<json::JSONVariantStyle::Current, JSON_FORMAT> {
 
   template <typename X>
   std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(X)> operator()(const X& object) {
-    rapidjson::Value serialized_object;
-    json_stringifier_.Inner(&serialized_object, object);
-
     using namespace ::current::reflection;
-    rapidjson::Value serialized_type_id;
-    json_stringifier_.Inner(&serialized_type_id, Value<ReflectedTypeBase>(Reflector().ReflectType<X>()).type_id);
-
-    json_stringifier_.Current().SetObject();
-
-    json_stringifier_.Current().AddMember(
-        rapidjson::StringRef(reflection::CurrentTypeName<X, reflection::NameFormat::Z>()),
-        std::move(serialized_object.Move()),
-        json_stringifier_.Allocator());
+    const char* case_name = reflection::CurrentTypeName<X, reflection::NameFormat::Z>();
 
+    json_stringifier_.StartObject();
+    json_stringifier_.Key(case_name);
+    json_stringifier_.Inner(object);
     if (json::JSONVariantTypeIDInEmptyKey<JSON_FORMAT>::value) {
-      json_stringifier_.Current().AddMember("", std::move(serialized_type_id.Move()), json_stringifier_.Allocator());
+      json_stringifier_.Key("", 0u);
+      json_stringifier_.Inner(Value<ReflectedTypeBase>(Reflector().ReflectType<X>()).type_id);
     }
     if (json::JSONVariantTypeNameInDollarKey<JSON_FORMAT>::value) {
-      json_stringifier_.Current().AddMember(
-          "$",
-          rapidjson::StringRef(reflection::CurrentTypeName<X, reflection::NameFormat::Z>()),
-          json_stringifier_.Allocator());
+      json_stringifier_.Key("$", 1u);
+      json_stringifier_.SetString(case_name, strlen(case_name));
     }
+    json_stringifier_.EndObject();
   }
 
  private:
@@ -103,24 +95,18 @@ class JSONVariantSerializer<json::JSONVariantStyle::NewtonsoftFSharp, JSON_FORMA
 
   template <typename X>
   std::enable_if_t<IS_CURRENT_STRUCT_OR_VARIANT(X)> operator()(const X& object) {
-    rapidjson::Value serialized_object;
-    json_stringifier_.Inner(&serialized_object, object);
-
-    json_stringifier_.Current().SetObject();
-    json_stringifier_.Current().AddMember(
-        "Case",
-        rapidjson::StringRef(reflection::CurrentTypeName<X, reflection::NameFormat::Z>()),
-        json_stringifier_.Allocator());
+    const char* case_name = reflection::CurrentTypeName<X, reflection::NameFormat::Z>();
 
+    json_stringifier_.StartObject();
+    json_stringifier_.Key("Case", 4u);
+    json_stringifier_.SetString(case_name, strlen(case_name));
     if (IS_CURRENT_VARIANT(X) || !IS_EMPTY_CURRENT_STRUCT(X)) {
-      rapidjson::Value fields_as_array;
-      fields_as_array.SetArray();
-      fields_as_array.PushBack(std::move(serialized_object.Move()), json_stringifier_.Allocator());
-
-      json_stringifier_.Current().AddMember(std::move(rapidjson::Value("Fields", json_stringifier_.Allocator()).Move()),
-                                            std::move(fields_as_array.Move()),
-                                            json_stringifier_.Allocator());
+      json_stringifier_.Key("Fields", 6u);
+      json_stringifier_.StartArray();
+      json_stringifier_.Inner(object);
+      json_stringifier_.EndArray();
     }
+    json_stringifier_.EndObject();
   }
 
  private:
@@ -408,7 +394,7 @@ struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, T, std::enable_if_t<IS_
       value.Call(impl);
     } else {
       if (json::JSONVariantStyleUseNulls<JSON_FORMAT::variant_style>::value) {
-        json_stringifier.Current().SetNull();
+        json_stringifier.SetNull();
       } else {
         json_stringifier.MarkAsAbsentValue();
       }
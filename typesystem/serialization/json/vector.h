@@ -36,25 +36,23 @@ namespace serialization {
 template <class JSON_FORMAT, typename T, typename TA>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::vector<T, TA>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const std::vector<T>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.StartArray();
     for (const auto& element : value) {
-      rapidjson::Value element_to_push;
-      json_stringifier.Inner(&element_to_push, element);
-      json_stringifier.Current().PushBack(std::move(element_to_push.Move()), json_stringifier.Allocator());
+      json_stringifier.Inner(element);
     }
+    json_stringifier.EndArray();
   }
 };
 
 template <class JSON_FORMAT, typename TA>
 struct SerializeImpl<json::JSONStringifier<JSON_FORMAT>, std::vector<bool, TA>> {
   static void DoSerialize(json::JSONStringifier<JSON_FORMAT>& json_stringifier, const std::vector<bool, TA>& value) {
-    json_stringifier.Current().SetArray();
+    json_stringifier.StartArray();
     for (const auto&& element : value) {
-      rapidjson::Value element_to_push;
       const bool tmp = element;
-      json_stringifier.Inner(&element_to_push, tmp);
-      json_stringifier.Current().PushBack(std::move(element_to_push.Move()), json_stringifier.Allocator());
+      json_stringifier.Inner(tmp);
     }
+    json_stringifier.EndArray();
   }
 };
 
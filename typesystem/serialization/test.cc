@@ -97,6 +97,10 @@ using simple_variant_t = Variant<Empty, AlternativeEmpty, Serializable, ComplexS
 
 CURRENT_STRUCT(ContainsVariant) { CURRENT_FIELD(variant, simple_variant_t); };
 
+using simple_inline_variant_t = InlineVariant<Empty, AlternativeEmpty, Serializable, ComplexSerializable>;
+
+CURRENT_STRUCT(ContainsInlineVariant) { CURRENT_FIELD(variant, simple_inline_variant_t); };
+
 CURRENT_STRUCT(DerivedSerializable, Serializable) { CURRENT_FIELD(d, double); };
 
 CURRENT_STRUCT(WithVectorOfPairs) { CURRENT_FIELD(v, (std::vector<std::pair<int32_t, std::string>>)); };
@@ -179,11 +183,12 @@ CURRENT_VARIANT(NestedQ, InnerA, InnerB);
 CURRENT_VARIANT(InnerVariant, WithVectorOfPairs, WithOptional);
 CURRENT_STRUCT(WithInnerVariant) { CURRENT_FIELD(v, InnerVariant); };
 
+CURRENT_INLINE_VARIANT(InlineInnerA, X, Y);
+CURRENT_INLINE_VARIANT(InlineNestedQ, InlineInnerA, InnerB);
+
 }  // namespace named_variant
 }  // namespace serialization_test
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, Binary) {
   using namespace serialization_test;
 
@@ -254,7 +259,6 @@ TEST(Serialization, Binary) {
     ASSERT_THROW(LoadFromBinary<ComplexSerializable>(is), BinaryLoadFromStreamException);
   }
 }
-#endif
 
 TEST(JSONSerialization, CPPTypes) {
   using namespace serialization_test;
@@ -368,8 +372,6 @@ TEST(JSONSerialization, Tuple) {
   }
 }
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, OptionalAsBinary) {
   using namespace serialization_test;
 
@@ -412,7 +414,6 @@ TEST(Serialization, OptionalAsBinary) {
     EXPECT_TRUE(Value(parsed_with_b.b));
   }
 }
-#endif
 
 TEST(JSONSerialization, CurrentStructs) {
   using namespace serialization_test;
@@ -881,8 +882,6 @@ TEST(JSONSerialization, Time) {
   }
 }
 
-#if 0
-// TODO(dkorolev): DIMA FIXME binary format.
 TEST(Serialization, TimeAsBinary) {
   using namespace serialization_test;
 
@@ -905,7 +904,106 @@ TEST(Serialization, TimeAsBinary) {
     EXPECT_EQ(6ll, parsed.micros.count());
   }
 }
-#endif
+
+TEST(Serialization, BinaryRejectsOversizedContainers) {
+  // A corrupt length of 2^60 elements, followed by a few bytes of input, must not be trusted to allocate upfront.
+  const std::string corrupt = std::string(8u, '\x80') + "\x10" + "abcdefgh";
+  ASSERT_THROW(LoadFromBinary<std::string>(corrupt.data(), corrupt.length()), BinaryLoadFromStreamException);
+  ASSERT_THROW(LoadFromBinary<std::vector<uint64_t>>(corrupt.data(), corrupt.length()),
+               BinaryLoadFromStreamException);
+  ASSERT_THROW(LoadFromBinary<std::vector<bool>>(corrupt.data(), corrupt.length()), BinarySerializationException);
+  ASSERT_THROW(LoadFromBinary<std::vector<std::string>>(corrupt.data(), corrupt.length()),
+               BinaryLoadFromStreamException);
+  ASSERT_THROW((LoadFromBinary<std::unordered_map<std::string, std::string>>(corrupt.data(), corrupt.length())),
+               BinaryLoadFromStreamException);
+  ASSERT_THROW(LoadFromBinary<std::unordered_set<std::string>>(corrupt.data(), corrupt.length()),
+               BinaryLoadFromStreamException);
+  {
+    std::istringstream is(corrupt);
+    ASSERT_THROW(LoadFromBinary<std::string>(is), BinaryLoadFromStreamException);
+  }
+  {
+    std::istringstream is(corrupt);
+    ASSERT_THROW(LoadFromBinary<std::vector<uint64_t>>(is), BinaryLoadFromStreamException);
+  }
+  {
+    std::istringstream is(corrupt);
+    ASSERT_THROW(LoadFromBinary<std::vector<std::string>>(is), BinaryLoadFromStreamException);
+  }
+
+  // The vectors larger than the stream preallocation limit are still read in full.
+  std::vector<uint64_t> large(300000u);
+  for (size_t i = 0; i < large.size(); ++i) {
+    large[i] = i * i;
+  }
+  std::ostringstream os;
+  SaveIntoBinary(os, large);
+  std::istringstream is(os.str());
+  EXPECT_TRUE(LoadFromBinary<std::vector<uint64_t>>(is) == large);
+  EXPECT_TRUE(LoadFromBinary<std::vector<uint64_t>>(os.str().data(), os.str().length()) == large);
+}
+
+TEST(Serialization, BinaryWithSchemaHeader) {
+  using namespace serialization_test;
+
+  {
+    ContainsVariant object;
+    object.variant = ComplexSerializable('a', 'c');
+    Value<ComplexSerializable>(object.variant).z = Serializable(42, "foo", true, Enum::SET);
+    const std::string binary = BinarySerialize(object);
+    const auto parsed = BinaryParse<ContainsVariant>(binary);
+    ASSERT_TRUE(Exists<ComplexSerializable>(parsed.variant));
+    EXPECT_EQ(JSON(object), JSON(parsed));
+    EXPECT_LT(binary.length(), JSON(object).length());
+
+    // The `TypeID` in the header prevents parsing the blob into a different type.
+    ASSERT_THROW(BinaryParse<WithOptional>(binary), BinarySchemaMismatchException);
+
+    // Truncated input and trailing bytes are both errors.
+    ASSERT_THROW(BinaryParse<ContainsVariant>(binary.substr(0u, binary.length() - 1u)),
+                 BinaryLoadFromStreamException);
+    ASSERT_THROW(BinaryParse<ContainsVariant>(binary + '\0'), BinaryMalformedDataException);
+  }
+
+  {
+    ContainsVariant uninitialized;
+    ASSERT_THROW(BinaryParse<ContainsVariant>(BinarySerialize(uninitialized)),
+                 BinaryUninitializedVariantObjectException);
+  }
+
+  {
+    named_variant::WrappedQ object{named_variant::OuterB()};
+    Value<named_variant::OuterB>(object).b = named_variant::T();
+    const auto parsed = BinaryParse<named_variant::WrappedQ>(BinarySerialize(object));
+    ASSERT_TRUE(Exists<named_variant::OuterB>(parsed));
+    ASSERT_TRUE(Exists<named_variant::T>(Value<named_variant::OuterB>(parsed).b));
+    EXPECT_EQ(4, Value<named_variant::T>(Value<named_variant::OuterB>(parsed).b).t);
+  }
+
+  {
+    WithVectorOfPairs with_pairs;
+    with_pairs.v.emplace_back(1, "one");
+    with_pairs.v.emplace_back(-2, std::string(300u, 'x'));
+    EXPECT_EQ(JSON(with_pairs), JSON(BinaryParse<WithVectorOfPairs>(BinarySerialize(with_pairs))));
+
+    WithNontrivialUnorderedMap with_unordered_map;
+    with_unordered_map.q[Serializable(1)] = "one";
+    with_unordered_map.q[Serializable(2)] = "two";
+    // Not every type has a `TypeID`, so the header-less `SaveIntoBinary()` and `LoadFromBinary()` are used here.
+    std::string binary;
+    SaveIntoBinary(binary, with_unordered_map);
+    const auto parsed_unordered_map = LoadFromBinary<WithNontrivialUnorderedMap>(binary.data(), binary.length()).q;
+    ASSERT_EQ(2u, parsed_unordered_map.size());
+    EXPECT_EQ("two", parsed_unordered_map.at(Serializable(2)));
+
+    using tuple_t = std::tuple<int32_t, std::vector<bool>, std::set<std::string>, std::vector<double>>;
+    const tuple_t tuple(-1, {true, false, true}, {"b", "a"}, {0.5, 1.5});
+    std::ostringstream oss;
+    SaveIntoBinary(oss, tuple);
+    std::istringstream iss(oss.str());
+    EXPECT_EQ(JSON(tuple), JSON(LoadFromBinary<tuple_t>(iss)));
+  }
+}
 
 TEST(JSONSerialization, Optional) {
   using namespace serialization_test;
@@ -1195,6 +1293,70 @@ TEST(JSONSerialization, NamedVariant) {
 #endif  // VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
 }
 
+TEST(Serialization, InlineVariant) {
+  using namespace serialization_test;
+  using namespace serialization_test::named_variant;
+
+  // An `InlineVariant` is the same type as the respective `Variant` as far as the schema is concerned.
+  EXPECT_EQ(current::reflection::CurrentTypeID<simple_variant_t>(),
+            current::reflection::CurrentTypeID<simple_inline_variant_t>());
+  EXPECT_STREQ(current::reflection::CurrentTypeName<simple_variant_t>(),
+               current::reflection::CurrentTypeName<simple_inline_variant_t>());
+
+  {
+    ComplexSerializable complex_object;
+    complex_object.j = 43;
+    complex_object.q = "bar";
+    complex_object.v.push_back("one");
+    complex_object.z.s = "foo";
+    const simple_inline_variant_t object = complex_object;
+    const simple_variant_t heap_object = complex_object;
+
+    for (const auto& json :
+         {JSON(object), JSON<JSONFormat::Minimalistic>(object), JSON<JSONFormat::JavaScript>(object)}) {
+      EXPECT_TRUE(json.find("\"ComplexSerializable\":") != std::string::npos) << json;
+    }
+    EXPECT_EQ(JSON(heap_object), JSON(object));
+    EXPECT_EQ(JSON<JSONFormat::NewtonsoftFSharp>(heap_object), JSON<JSONFormat::NewtonsoftFSharp>(object));
+
+    const auto parsed = ParseJSON<simple_inline_variant_t>(JSON(object));
+    ASSERT_TRUE(Exists<ComplexSerializable>(parsed));
+    EXPECT_EQ("bar", Value<ComplexSerializable>(parsed).q);
+    EXPECT_EQ("foo", Value<ComplexSerializable>(parsed).z.s);
+    EXPECT_EQ(JSON(object), JSON(ParseJSON<simple_variant_t>(JSON(object))));
+    EXPECT_EQ(JSON(object),
+              JSON(ParseJSON<simple_inline_variant_t, JSONFormat::NewtonsoftFSharp>(
+                  JSON<JSONFormat::NewtonsoftFSharp>(object))));
+
+    // Binary blobs are interchangeable between `Variant` and `InlineVariant`, including the schema header.
+    const std::string blob = BinarySerialize(object);
+    EXPECT_EQ(BinarySerialize(heap_object), blob);
+    EXPECT_EQ(JSON(object), JSON(BinaryParse<simple_inline_variant_t>(blob)));
+    EXPECT_EQ(JSON(object), JSON(BinaryParse<simple_variant_t>(blob)));
+  }
+
+  {
+    ContainsInlineVariant with_empty;
+    with_empty.variant = Empty();
+    const std::string json = JSON(with_empty);
+    EXPECT_EQ("{\"variant\":{\"Empty\":{},\"\":\"T9200000002835747520\"}}", json);
+    EXPECT_TRUE(Exists<Empty>(ParseJSON<ContainsInlineVariant>(json).variant));
+    EXPECT_TRUE(Exists<Empty>(ParseJSON<ContainsVariant>(json).variant));
+  }
+
+  {
+    // Named inline variants, nested.
+    EXPECT_STREQ("InlineNestedQ", current::reflection::CurrentTypeName<InlineNestedQ>());
+
+    InlineNestedQ q = InlineInnerA(Y());
+    const auto json = JSON<JSONFormat::Minimalistic>(q);
+    EXPECT_EQ("{\"InlineInnerA\":{\"Y\":{\"y\":2}}}", json);
+    const auto result = ParseJSON<InlineNestedQ, JSONFormat::Minimalistic>(json);
+    ASSERT_TRUE(Exists<InlineInnerA>(result));
+    EXPECT_EQ(2, Value<Y>(Value<InlineInnerA>(result)).y);
+  }
+}
+
 TEST(JSONSerialization, PairsInNewtonsoftJSONFSharpFormat) {
   auto a = std::make_pair(1, 2);
   EXPECT_EQ("[1,2]", JSON(a));
@@ -1225,6 +1387,134 @@ TEST(JSONSerialization, OptionalInVariousFormats) {
   EXPECT_FALSE(Exists(ParseJSON<WithOptional, JSONFormat::NewtonsoftFSharp>("{}").b));
 }
 
+namespace serialization_test {
+
+CURRENT_STRUCT(StreamedJSONKitchenSink) {
+  CURRENT_FIELD(s, std::string, "quote\" backslash\\ tab\t unicode \xD0\x9F");
+  CURRENT_FIELD(c, char, 'x');
+  CURRENT_FIELD(i8, int8_t, -8);
+  CURRENT_FIELD(u16, uint16_t, 16u);
+  CURRENT_FIELD(i64, int64_t, -1234567890123ll);
+  CURRENT_FIELD(u64, uint64_t, 18446744073709551615ull);
+  CURRENT_FIELD(f, float, 0.1f);
+  CURRENT_FIELD(d, double, 1e-300);
+  CURRENT_FIELD(us, std::chrono::microseconds, std::chrono::microseconds(-1));
+  CURRENT_FIELD(o, Optional<int32_t>);
+  CURRENT_FIELD(vo, std::vector<Optional<int32_t>>);
+  CURRENT_FIELD(mo, (std::map<std::string, Optional<double>>));
+  CURRENT_FIELD(p, (std::pair<std::string, Optional<bool>>));
+  CURRENT_FIELD(t, (std::tuple<int32_t, std::string, Empty>));
+  CURRENT_FIELD(v, simple_variant_t);
+  CURRENT_FIELD(ov, Optional<simple_variant_t>);
+  CURRENT_FIELD(z, uint32_t, 42u);
+};
+
+}  // namespace serialization_test
+
+TEST(JSONSerialization, StreamingStringifierMatchesRapidJSON) {
+  using namespace serialization_test;
+
+  // Confirms the streaming stringifier produces exactly what `rapidjson::Document::Accept()` would.
+  const auto canonical = [](const std::string& json) {
+    rapidjson::Document document;
+    EXPECT_FALSE(document.Parse(json.c_str()).HasParseError()) << json;
+    rapidjson::StringBuffer string_buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(string_buffer);
+    document.Accept(writer);
+    return std::string(string_buffer.GetString(), string_buffer.GetSize());
+  };
+
+  std::vector<StreamedJSONKitchenSink> objects(3u);
+  objects[0].v = Empty();
+  objects[1].o = 1;
+  objects[1].vo.resize(3u);
+  objects[1].vo[1] = 2;
+  objects[1].mo["none"] = nullptr;
+  objects[1].mo["some"] = 0.5;
+  objects[1].p.second = true;
+  ComplexSerializable complex_object('a', 'c');
+  complex_object.j = 1u;
+  complex_object.z = Serializable(2);
+  objects[1].v = complex_object;
+  objects[1].ov = simple_variant_t(Empty());
+  objects[2].v = AlternativeEmpty();
+
+  for (const auto& object : objects) {
+    const auto json = JSON(object);
+    EXPECT_EQ(canonical(json), json);
+    const auto minimalistic = JSON<JSONFormat::Minimalistic>(object);
+    EXPECT_EQ(canonical(minimalistic), minimalistic);
+    const auto javascript = JSON<JSONFormat::JavaScript>(object);
+    EXPECT_EQ(canonical(javascript), javascript);
+    const auto fsharp = JSON<JSONFormat::NewtonsoftFSharp>(object);
+    EXPECT_EQ(canonical(fsharp), fsharp);
+    EXPECT_EQ(json, JSON(ParseJSON<StreamedJSONKitchenSink>(json)));
+    const auto parsed = ParseJSON<StreamedJSONKitchenSink, JSONFormat::Minimalistic>(minimalistic);
+    EXPECT_EQ(minimalistic, JSON<JSONFormat::Minimalistic>(parsed));
+  }
+
+  EXPECT_EQ(
+      "{\"s\":\"quote\\\" backslash\\\\ tab\\t unicode \xD0\x9F\",\"c\":120,\"i8\":-8,\"u16\":16,"
+      "\"i64\":-1234567890123,\"u64\":18446744073709551615,\"f\":0.10000000149011612,\"d\":1e-300,\"us\":-1,\"o\":1,"
+      "\"vo\":[null,2,null],\"mo\":{\"none\":null,\"some\":0.5},\"p\":[\"\",true],\"t\":[0,\"\",{}],"
+      "\"v\":{\"ComplexSerializable\":{\"j\":1,\"q\":\"\",\"v\":[\"a\",\"b\",\"c\"],"
+      "\"z\":{\"i\":2,\"s\":\"\",\"b\":false,\"e\":0}}},\"ov\":{\"Empty\":{}},\"z\":42}",
+      JSON<JSONFormat::Minimalistic>(objects[1]));
+
+  // Top-level absent values are `null`-s.
+  EXPECT_EQ("null", JSON<JSONFormat::Minimalistic>(Optional<int32_t>()));
+
+  // `AppendJSON()` appends to the existing buffer.
+  std::string buffer = "[";
+  AppendJSON(buffer, Empty());
+  buffer += ',';
+  AppendJSON<JSONFormat::Minimalistic>(buffer, objects[2].v);
+  buffer += ']';
+  EXPECT_EQ("[{},{\"AlternativeEmpty\":{}}]", buffer);
+}
+
+TEST(JSONSerialization, ParseFromRangeInSitu) {
+  using namespace serialization_test;
+
+  // The range does not have to be null-terminated, so a part of a line can be parsed without a substring.
+  const std::string line = "{\"i\":1,\"s\":\"x\\ty\",\"b\":true,\"e\":0}\t{\"i\":2}";
+  const size_t tab_pos = line.find('\t');
+  {
+    const auto parsed = ParseJSON<Serializable>(line.c_str(), tab_pos);
+    EXPECT_EQ(1u, parsed.i);
+    EXPECT_EQ("x\ty", parsed.s);
+    EXPECT_TRUE(parsed.b);
+  }
+  {
+    Serializable parsed;
+    ParseJSON(line.c_str(), tab_pos, parsed);
+    EXPECT_EQ("x\ty", parsed.s);
+  }
+  EXPECT_THROW(ParseJSON<Serializable>(line.c_str(), tab_pos - 1u), InvalidJSONException);
+  EXPECT_THROW(ParseJSON<Serializable>(line.c_str(), line.length()), InvalidJSONException);
+
+  // The fields are matched by name regardless of their order.
+  {
+    const auto parsed = ParseJSON<ComplexSerializable>(
+        "{\"z\":{\"e\":0,\"b\":false,\"s\":\"z\",\"i\":3},\"v\":[\"v\"],\"j\":42,\"q\":\"q\",\"extra\":1}");
+    EXPECT_EQ(42u, parsed.j);
+    EXPECT_EQ("q", parsed.q);
+    ASSERT_EQ(1u, parsed.v.size());
+    EXPECT_EQ("v", parsed.v[0]);
+    EXPECT_EQ(3u, parsed.z.i);
+    EXPECT_EQ("z", parsed.z.s);
+  }
+  {
+    const auto parsed = ParseJSON<ComplexSerializable>(
+        "{\"j\":42,\"extra\":1,\"v\":[],\"q\":\"q\",\"z\":{\"i\":3,\"s\":\"\",\"b\":true,\"e\":0}}");
+    EXPECT_EQ(42u, parsed.j);
+    EXPECT_EQ("q", parsed.q);
+    EXPECT_TRUE(parsed.v.empty());
+    EXPECT_TRUE(parsed.z.b);
+  }
+  EXPECT_THROW(ParseJSON<ComplexSerializable>("{\"j\":42,\"q\":\"q\",\"v\":[]}"), JSONSchemaException);
+}
+
 TEST(JSONSerialization, LiberalOptionalForFSharp) {
   using serialization_test::WithOptional;
 
@@ -1319,6 +1319,108 @@ TEST(TypeSystemTest, VariantSmokeTestMultipleTypes) {
   }
 }
 
+TEST(TypeSystemTest, InlineVariant) {
+  using namespace struct_definition_test;
+
+  struct Visitor {
+    std::string s;
+    void operator()(const Bar&) { s = "Bar"; }
+    void operator()(const Foo& foo) { s = "Foo " + current::ToString(foo.i); }
+    void operator()(const DerivedFromFoo& object) {
+      s = "DerivedFromFoo [" + current::ToString(object.baz.v1.size()) + "]";
+    }
+  };
+  Visitor v;
+
+  using inline_variant_t = InlineVariant<Bar, Foo, DerivedFromFoo>;
+  static_assert(IS_CURRENT_VARIANT(inline_variant_t), "");
+  static_assert(sizeof(inline_variant_t) < sizeof(Bar) + sizeof(Foo) + sizeof(DerivedFromFoo), "");
+  static_assert(sizeof(inline_variant_t::index_t) == 1u, "");
+  // With the cases moving without throwing, so does the variant, and `std::vector` moves, not copies, it as it grows.
+  static_assert(std::is_nothrow_move_constructible_v<inline_variant_t>, "");
+  static_assert(std::is_nothrow_move_assignable_v<inline_variant_t>, "");
+
+  {
+    inline_variant_t p;
+    const inline_variant_t& cp = p;
+    EXPECT_FALSE(Exists(p));
+    EXPECT_FALSE(Exists<Foo>(p));
+    EXPECT_THROW(p.Call(v), UninitializedVariantException);
+
+    p = Bar();
+    EXPECT_TRUE(Exists(p));
+    EXPECT_EQ(0u, p.CaseIndexImpl());
+    p.Call(v);
+    EXPECT_EQ("Bar", v.s);
+
+    p = Foo(1u);
+    EXPECT_EQ(1u, p.CaseIndexImpl());
+    cp.Call(v);
+    EXPECT_EQ("Foo 1", v.s);
+    EXPECT_TRUE(Exists<Foo>(p));
+    EXPECT_FALSE(Exists<Bar>(p));
+    EXPECT_FALSE(Exists<DerivedFromFoo>(p));
+    ++Value<Foo>(p).i;
+    EXPECT_EQ(2u, Value<Foo>(cp).i);
+    EXPECT_THROW(Value<Bar>(p), NoValueOfTypeException<Bar>);
+
+    // Same as with `Variant<>`, the derived case is accessible as its base.
+    p = DerivedFromFoo();
+    EXPECT_EQ(2u, p.CaseIndexImpl());
+    p.Call(v);
+    EXPECT_EQ("DerivedFromFoo [0]", v.s);
+    EXPECT_TRUE(Exists<Foo>(p));
+    EXPECT_TRUE(Exists<DerivedFromFoo>(p));
+    Value<Foo>(p).i = 100u;
+    Value<DerivedFromFoo>(p).baz.v1.resize(3);
+    EXPECT_EQ(100u, Value<DerivedFromFoo>(cp).i);
+    cp.Call(v);
+    EXPECT_EQ("DerivedFromFoo [3]", v.s);
+
+    inline_variant_t copy(p);
+    Value<DerivedFromFoo>(copy).baz.v1.resize(5);
+    copy.Call(v);
+    EXPECT_EQ("DerivedFromFoo [5]", v.s);
+    p.Call(v);
+    EXPECT_EQ("DerivedFromFoo [3]", v.s);
+
+    inline_variant_t moved(std::move(copy));
+    moved.Call(v);
+    EXPECT_EQ("DerivedFromFoo [5]", v.s);
+
+    copy = Foo(7u);
+    moved = copy;
+    moved.Call(v);
+    EXPECT_EQ("Foo 7", v.s);
+
+    p = nullptr;
+    EXPECT_FALSE(Exists(p));
+
+    p.Construct<Foo>(42u);
+    EXPECT_EQ(42u, Value<Foo>(p).i);
+  }
+
+  {
+    inline_variant_t p(current::BypassVariantTypeCheck(), std::make_unique<DerivedFromFoo>());
+    p.Call(v);
+    EXPECT_EQ("DerivedFromFoo [0]", v.s);
+    p.UncheckedMoveFromUniquePtr(std::make_unique<Foo>(103u));
+    EXPECT_EQ(103u, Value<Foo>(p).i);
+    EXPECT_THROW(p.UncheckedMoveFromUniquePtr(std::make_unique<Baz>()),
+                 IncompatibleVariantTypeException<current::variant::object_base_t>);
+    EXPECT_FALSE(Exists(p));
+  }
+
+  {
+    // A regular `Variant<>` converts into an inline one.
+    Variant<Foo, Baz> heap_allocated(Foo(5u));
+    InlineVariant<Bar, Foo> p(heap_allocated);
+    EXPECT_EQ(5u, Value<Foo>(p).i);
+    heap_allocated = Baz();
+    EXPECT_THROW((InlineVariant<Bar, Foo>(heap_allocated)), IncompatibleVariantTypeException<Baz>);
+  }
+}
+
 namespace struct_definition_test {
 CURRENT_STRUCT(WithTimestampUS) {
   CURRENT_FIELD(t, std::chrono::microseconds);
@@ -85,6 +85,16 @@ struct TimestampAccessorImpl<VariantImpl<T, TS...>> {
   static void UpdateDirectlyOrInVariant(UpdateTimestampFunctor& functor, VariantImpl<T, TS...>& p) { p.Call(functor); }
 };
 
+template <typename T, typename... TS>
+struct TimestampAccessorImpl<InlineVariantImpl<T, TS...>> {
+  static void ExtractDirectlyOrFromVariant(ExtractTimestampFunctor& functor, const InlineVariantImpl<T, TS...>& p) {
+    p.Call(functor);
+  }
+  static void UpdateDirectlyOrInVariant(UpdateTimestampFunctor& functor, InlineVariantImpl<T, TS...>& p) {
+    p.Call(functor);
+  }
+};
+
 template <>
 struct TimestampAccessorImpl<std::chrono::microseconds> {
   static void ExtractDirectlyOrFromVariant(ExtractTimestampFunctor& functor, const std::chrono::microseconds& us) {
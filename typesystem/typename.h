@@ -51,6 +51,9 @@ namespace current {
 template <typename NAME, typename TYPE_LIST>
 struct VariantImpl;
 
+template <typename NAME, typename TYPE_LIST>
+struct InlineVariantImpl;
+
 namespace reflection {
 
 struct CurrentVariantDefaultName;
@@ -145,6 +148,11 @@ struct CurrentVariantTypeNameImpl<NameFormat::AsIdentifier,
   }
 };
 
+// An `InlineVariant` is named exactly as the respective `Variant`.
+template <NameFormat NF, typename NAME, typename... TS>
+struct CurrentVariantTypeNameImpl<NF, InlineVariantImpl<NAME, TypeListImpl<TS...>>>
+    : CurrentVariantTypeNameImpl<NF, VariantImpl<NAME, TypeListImpl<TS...>>> {};
+
 template <NameFormat NF, typename T>
 struct CurrentTypeNameImpl<NF, T, false, true, false, false> {
   static std::string GetCurrentTypeName() { return CurrentVariantTypeNameImpl<NF, T>::DoIt(); }
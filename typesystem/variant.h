@@ -34,8 +34,11 @@ SOFTWARE.
 
 #include "../port.h"  // `make_unique`.
 
+#include <algorithm>
 #include <memory>
+#include <new>
 #include <type_traits>
+#include <typeinfo>
 
 #ifdef VARIANT_CHECKS_AT_RUNTIME_INSTEAD_OF_COMPILE_TIME
 // For runtime, not compile-time, extra checks.
@@ -361,17 +364,305 @@ struct VariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePt
   std::unique_ptr<current::variant::object_base_t> object_;
 };
 
+// `InlineVariantImpl<>` is the opt-in, allocation-free alternative to `VariantImpl<>`.
+// The case object lives in aligned storage inside the variant itself, next to a compact index of the case.
+// `Call()`, `Exists<>()`, `Value<>()`, copies and moves dispatch via compile-time jump tables indexed by the case,
+// with no `dynamic_cast<>` and no RTTI lookups. All the cases must be complete types at the point of declaration,
+// thus a `CURRENT_STRUCT` can not (indirectly) contain an `InlineVariant` with itself as one of the cases.
+// For reflection, schema and serialization purposes an `InlineVariant<TS...>` is indistinguishable from
+// the `Variant<TS...>`, and it has the same type ID.
+template <typename NAME, typename TYPE_LIST>
+struct InlineVariantImpl;
+
+template <typename NAME, typename... TYPES>
+struct InlineVariantImpl<NAME, TypeListImpl<TYPES...>> : IHasUncheckedMoveFromUniquePtr {
+  using typelist_t = TypeListImpl<TYPES...>;
+
+  // The heap-allocating `Variant` this one is reflected and named as.
+  using variant_t = VariantImpl<NAME, typelist_t>;
+
+  static constexpr size_t typelist_size = typelist_t::size;
+
+  using index_t = std::conditional_t<(typelist_size < 0xff), uint8_t, uint16_t>;
+  static constexpr index_t kNoCase = static_cast<index_t>(~static_cast<index_t>(0));
+
+  template <typename OTHER_NAME, typename OTHER_TYPE_LIST>
+  friend struct InlineVariantImpl;
+
+  InlineVariantImpl() {}
+
+  InlineVariantImpl(BypassVariantTypeCheck, std::unique_ptr<current::variant::object_base_t>&& rhs) {
+    UncheckedMoveFromUniquePtr(std::move(rhs));
+  }
+
+  InlineVariantImpl(const InlineVariantImpl& rhs) { CopyFrom(rhs); }
+  // Conditionally `noexcept`, so that the containers of inline variants move them, not copy, as they grow.
+  static constexpr bool kNothrowMove = (std::is_nothrow_move_constructible_v<TYPES> && ...);
+  InlineVariantImpl(InlineVariantImpl&& rhs) noexcept(kNothrowMove) { MoveFrom(rhs); }
+
+  // A regular `Variant` can be converted into an inline one, as long as its current case is one of ours.
+  template <typename... RHS, class ENABLE = std::enable_if_t<!TypeListContains<typelist_t, VariantImpl<RHS...>>::value>>
+  InlineVariantImpl(const VariantImpl<RHS...>& rhs) {
+    if (rhs) {
+      TypeAwareAssign assigner(*this);
+      rhs.Call(assigner);
+    }
+  }
+
+  template <typename X, class ENABLE = std::enable_if_t<TypeListContains<typelist_t, current::decay_t<X>>::value>>
+  InlineVariantImpl(X&& input) {
+    Emplace<current::decay_t<X>>(std::forward<X>(input));
+  }
+
+  ~InlineVariantImpl() { Reset(); }
+
+  void operator=(std::nullptr_t) { Reset(); }
+
+  InlineVariantImpl& operator=(const InlineVariantImpl& rhs) {
+    if (&rhs != this) {
+      Reset();
+      CopyFrom(rhs);
+    }
+    return *this;
+  }
+
+  InlineVariantImpl& operator=(InlineVariantImpl&& rhs) noexcept(kNothrowMove) {
+    if (&rhs != this) {
+      Reset();
+      MoveFrom(rhs);
+    }
+    return *this;
+  }
+
+  template <typename X, class ENABLE = std::enable_if_t<TypeListContains<typelist_t, current::decay_t<X>>::value>>
+  InlineVariantImpl& operator=(X&& input) {
+    using decayed_t = current::decay_t<X>;
+    if (index_ == CaseIndex<decayed_t>()) {
+      *CaseOf<decayed_t>(storage_) = std::forward<X>(input);
+    } else {
+      Reset();
+      Emplace<decayed_t>(std::forward<X>(input));
+    }
+    return *this;
+  }
+
+  // The type-erased path, used by deserializers and by `BypassVariantTypeCheck`. The dynamic type of the object
+  // is matched against the cases once, and the object is then moved into the inline storage.
+  void UncheckedMoveFromUniquePtr(std::unique_ptr<current::variant::object_base_t> input) override {
+    Reset();
+    if (input) {
+      static const std::type_info* const types[] = {&typeid(TYPES)...};
+      static constexpr void (*movers[])(storage_t&, current::variant::object_base_t&) = {&MoveCaseFromBase<TYPES>...};
+      const std::type_info& type = typeid(*input);
+      for (size_t i = 0u; i < typelist_size; ++i) {
+        if (*types[i] == type) {
+          movers[i](storage_, *input);
+          index_ = static_cast<index_t>(i);
+          return;
+        }
+      }
+      CURRENT_THROW(IncompatibleVariantTypeException<current::variant::object_base_t>());
+    }
+  }
+
+  template <typename T, typename... ARGS, class ENABLE = std::enable_if_t<TypeListContains<typelist_t, T>::value>>
+  T& Construct(ARGS&&... args) {
+    Reset();
+    return Emplace<T>(std::forward<ARGS>(args)...);
+  }
+
+  operator bool() const { return index_ != kNoCase; }
+
+  // The index of the case in `typelist_t`, or `kNoCase` if the variant is empty.
+  index_t CaseIndexImpl() const { return index_; }
+
+  template <typename F>
+  void Call(F&& f) {
+    if (index_ != kNoCase) {
+      static constexpr void (*calls[])(storage_t&, F&) = {&CallCase<TYPES, F>...};
+      calls[index_](storage_, f);
+    } else {
+      CURRENT_THROW(UninitializedVariantOfTypeException<TYPES...>());
+    }
+  }
+
+  template <typename F>
+  void Call(F&& f) const {
+    if (index_ != kNoCase) {
+      static constexpr void (*calls[])(const storage_t&, F&) = {&CallConstCase<TYPES, F>...};
+      calls[index_](storage_, f);
+    } else {
+      CURRENT_THROW(UninitializedVariantOfTypeException<TYPES...>());
+    }
+  }
+
+  // Same as with `VariantImpl<>`, `VariantExistsImpl<X>()` and `VariantValueImpl<X>()` succeed if the case
+  // is `X` or is derived from `X`, regardless of whether `X` itself is part of `typelist_t`.
+
+  bool ExistsImpl() const { return index_ != kNoCase; }
+
+  template <typename X>
+  bool VariantExistsImpl() const {
+    static constexpr bool matches[] = {std::is_base_of_v<X, TYPES>...};
+    return index_ != kNoCase && matches[index_];
+  }
+
+  template <typename X>
+  std::enable_if_t<!std::is_same_v<X, InlineVariantImpl>, X&> VariantValueImpl() {
+    if (VariantExistsImpl<X>()) {
+      static constexpr X* (*casts[])(storage_t&) = {&CastCase<X, TYPES>...};
+      return *casts[index_](storage_);
+    } else {
+      CURRENT_THROW(NoValueOfTypeException<X>());
+    }
+  }
+
+  template <typename X>
+  std::enable_if_t<!std::is_same_v<X, InlineVariantImpl>, const X&> VariantValueImpl() const {
+    return const_cast<InlineVariantImpl*>(this)->template VariantValueImpl<X>();
+  }
+
+  template <typename X>
+  std::enable_if_t<std::is_same_v<X, InlineVariantImpl>, const InlineVariantImpl&> VariantValueImpl() const {
+    if (ExistsImpl()) {
+      return *this;
+    } else {
+      CURRENT_THROW(NoValueOfTypeException<InlineVariantImpl>());
+    }
+  }
+
+ private:
+  using storage_t = std::aligned_storage_t<std::max({sizeof(TYPES)...}), std::max({alignof(TYPES)...})>;
+
+  template <typename T>
+  static T* CaseOf(storage_t& storage) {
+    return std::launder(reinterpret_cast<T*>(&storage));
+  }
+
+  template <typename T>
+  static const T* CaseOf(const storage_t& storage) {
+    return std::launder(reinterpret_cast<const T*>(&storage));
+  }
+
+  template <typename T>
+  static constexpr index_t CaseIndex() {
+    constexpr bool matches[] = {std::is_same_v<T, TYPES>...};
+    for (size_t i = 0u; i < typelist_size; ++i) {
+      if (matches[i]) {
+        return static_cast<index_t>(i);
+      }
+    }
+    return kNoCase;
+  }
+
+  template <typename T, typename F>
+  static void CallCase(storage_t& storage, F& f) {
+    f(*CaseOf<T>(storage));
+  }
+
+  template <typename T, typename F>
+  static void CallConstCase(const storage_t& storage, F& f) {
+    f(*CaseOf<T>(storage));
+  }
+
+  template <typename X, typename T>
+  static X* CastCase(storage_t& storage) {
+    if constexpr (std::is_base_of_v<X, T>) {
+      return CaseOf<T>(storage);
+    } else {
+      return nullptr;
+    }
+  }
+
+  template <typename T>
+  static void DestroyCase(storage_t& storage) {
+    CaseOf<T>(storage)->~T();
+  }
+
+  template <typename T>
+  static void CopyCase(storage_t& into, const storage_t& from) {
+    new (&into) T(*CaseOf<T>(from));
+  }
+
+  template <typename T>
+  static void MoveCase(storage_t& into, storage_t& from) {
+    new (&into) T(std::move(*CaseOf<T>(from)));
+  }
+
+  template <typename T>
+  static void MoveCaseFromBase(storage_t& into, current::variant::object_base_t& from) {
+    if constexpr (std::is_base_of_v<current::variant::object_base_t, T>) {
+      new (&into) T(std::move(static_cast<T&>(from)));
+    } else {
+      CURRENT_THROW(IncompatibleVariantTypeException<T>());
+    }
+  }
+
+  template <typename T, typename... ARGS>
+  T& Emplace(ARGS&&... args) {
+    T* result = new (&storage_) T(std::forward<ARGS>(args)...);
+    index_ = CaseIndex<T>();
+    return *result;
+  }
+
+  void Reset() {
+    if (index_ != kNoCase) {
+      static constexpr void (*destructors[])(storage_t&) = {&DestroyCase<TYPES>...};
+      const index_t index = index_;
+      index_ = kNoCase;
+      destructors[index](storage_);
+    }
+  }
+
+  void CopyFrom(const InlineVariantImpl& rhs) {
+    if (rhs.index_ != kNoCase) {
+      static constexpr void (*copiers[])(storage_t&, const storage_t&) = {&CopyCase<TYPES>...};
+      copiers[rhs.index_](storage_, rhs.storage_);
+      index_ = rhs.index_;
+    }
+  }
+
+  // The moved-from variant keeps its case, in the moved-from state, same as any other moved-from object would.
+  void MoveFrom(InlineVariantImpl& rhs) {
+    if (rhs.index_ != kNoCase) {
+      static constexpr void (*movers[])(storage_t&, storage_t&) = {&MoveCase<TYPES>...};
+      movers[rhs.index_](storage_, rhs.storage_);
+      index_ = rhs.index_;
+    }
+  }
+
+  struct TypeAwareAssign {
+    InlineVariantImpl& into;
+    TypeAwareAssign(InlineVariantImpl& into) : into(into) {}
+
+    template <typename U>
+    std::enable_if_t<TypeListContains<typelist_t, current::decay_t<U>>::value> operator()(const U& instance) {
+      into.template Emplace<current::decay_t<U>>(instance);
+    }
+
+    template <typename U>
+    std::enable_if_t<!TypeListContains<typelist_t, current::decay_t<U>>::value> operator()(const U&) {
+      CURRENT_THROW(IncompatibleVariantTypeException<current::decay_t<U>>());
+    }
+  };
+
+  storage_t storage_;
+  index_t index_ = kNoCase;
+};
+
 // `Variant<...>` can accept either a list of types, or a `TypeList<...>`.
 template <class NAME, typename T, typename... TS>
 struct VariantSelector {
   using typelist_t = TypeListImpl<T, TS...>;
   using type = VariantImpl<NAME, typelist_t>;
+  using inline_type = InlineVariantImpl<NAME, typelist_t>;
 };
 
 template <class NAME, typename T, typename... TS>
 struct VariantSelector<NAME, TypeListImpl<T, TS...>> {
   using typelist_t = TypeListImpl<T, TS...>;
   using type = VariantImpl<NAME, typelist_t>;
+  using inline_type = InlineVariantImpl<NAME, typelist_t>;
 };
 
 template <typename... TS>
@@ -380,18 +671,27 @@ using Variant = typename VariantSelector<reflection::CurrentVariantDefaultName,
 template <class NAME, class TYPELIST>
 struct NamedVariantTypeSelector {
   using type = VariantImpl<NAME, TYPELIST>;
+  using inline_type = InlineVariantImpl<NAME, TYPELIST>;
 };
 
 template <class NAME, typename... TS>
 struct NamedVariantTypeSelector<NAME, TypeListImpl<TypeListImpl<TS...>>> {
   using type = VariantImpl<NAME, TypeListImpl<TS...>>;
+  using inline_type = InlineVariantImpl<NAME, TypeListImpl<TS...>>;
 };
 
 template <class NAME, typename... TS>
 using NamedVariant = typename NamedVariantTypeSelector<NAME, TypeListImpl<TS...>>::type;
 
+template <typename... TS>
+using InlineVariant = typename VariantSelector<reflection::CurrentVariantDefaultName, TS...>::inline_type;
+
+template <class NAME, typename... TS>
+using NamedInlineVariant = typename NamedVariantTypeSelector<NAME, TypeListImpl<TS...>>::inline_type;
+
 }  // namespace current
 
+using current::InlineVariant;
 using current::Variant;
 
 #define CURRENT_VARIANT(name, ...)                           \
@@ -403,4 +703,13 @@ using current::Variant;
   };                                                         \
   using name = ::current::NamedVariant<CURRENT_VARIANT_MACRO<__COUNTER__ - 1>, __VA_ARGS__>;
 
+#define CURRENT_INLINE_VARIANT(name, ...)                    \
+  template <int>                                             \
+  struct CURRENT_VARIANT_MACRO;                              \
+  template <>                                                \
+  struct CURRENT_VARIANT_MACRO<__COUNTER__> {                \
+    static const char* CustomVariantName() { return #name; } \
+  };                                                         \
+  using name = ::current::NamedInlineVariant<CURRENT_VARIANT_MACRO<__COUNTER__ - 1>, __VA_ARGS__>;
+
 #endif  // CURRENT_TYPE_SYSTEM_VARIANT_H